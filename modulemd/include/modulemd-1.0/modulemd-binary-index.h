@@ -0,0 +1,127 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2017-2018 Stephen Gallagher
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+
+#ifndef MODULEMD_BINARY_INDEX_H
+#define MODULEMD_BINARY_INDEX_H
+
+#include "modulemd.h"
+#include "modulemd-improvedmodule.h"
+
+G_BEGIN_DECLS
+
+/**
+ * SECTION: modulemd-binary-index
+ * @title: Modulemd.BinaryIndex
+ * @short_description: Reads an index of modules from a compact binary file.
+ *
+ * A binary index file is written from an index of #ModulemdImprovedModule
+ * objects by modulemd_dump_index_binary(). It is much faster to load than the
+ * equivalent YAML, and a #ModulemdBinaryIndex reads it without processing
+ * more than the modules that are actually requested: opening the file only
+ * maps it into memory, and each module is decoded when it is looked up.
+ *
+ * The format is versioned and specific to the byte order of the host that
+ * wrote it. Files that don't match are rejected when opened, so they should
+ * be treated as a cache that can be regenerated from the YAML.
+ */
+
+#define MODULEMD_TYPE_BINARY_INDEX (modulemd_binary_index_get_type ())
+
+G_DECLARE_FINAL_TYPE (ModulemdBinaryIndex,
+                      modulemd_binary_index,
+                      MODULEMD,
+                      BINARY_INDEX,
+                      GObject)
+
+
+/**
+ * modulemd_binary_index_new_from_file:
+ * @path: The path to a file written by modulemd_dump_index_binary().
+ * @error: (out): A #GError containing additional information if this function
+ * fails.
+ *
+ * Returns: (transfer full): A newly-allocated #ModulemdBinaryIndex reading
+ * from @path, or NULL if the file could not be opened or is not in a
+ * supported format. This object must be freed with g_object_unref().
+ *
+ * Since: 1.6
+ */
+ModulemdBinaryIndex *
+modulemd_binary_index_new_from_file (const gchar *path, GError **error);
+
+
+/**
+ * modulemd_binary_index_get_n_modules:
+ *
+ * Returns: The number of modules in the index.
+ *
+ * Since: 1.6
+ */
+guint64
+modulemd_binary_index_get_n_modules (ModulemdBinaryIndex *self);
+
+
+/**
+ * modulemd_binary_index_get_module_names:
+ *
+ * Returns: (element-type utf8) (transfer full): The names of the modules in
+ * the index, in sorted order. This array must be freed with
+ * g_ptr_array_unref().
+ *
+ * Since: 1.6
+ */
+GPtrArray *
+modulemd_binary_index_get_module_names (ModulemdBinaryIndex *self);
+
+
+/**
+ * modulemd_binary_index_get_module:
+ * @module_name: The name of the module to read.
+ * @error: (out): A #GError containing additional information if the module
+ * could not be read.
+ *
+ * Reads a single module from the index. Only the data for this module is
+ * decoded.
+ *
+ * Returns: (transfer full): A newly-allocated #ModulemdImprovedModule, or
+ * NULL. If the index does not contain @module_name, NULL is returned without
+ * setting @error. This object must be freed with g_object_unref().
+ *
+ * Since: 1.6
+ */
+ModulemdImprovedModule *
+modulemd_binary_index_get_module (ModulemdBinaryIndex *self,
+                                  const gchar *module_name,
+                                  GError **error);
+
+
+/**
+ * modulemd_binary_index_to_index:
+ * @error: (out): A #GError containing additional information if this function
+ * fails.
+ *
+ * Reads every module from the index.
+ *
+ * Returns: (element-type utf8 ModulemdImprovedModule) (transfer container):
+ * A #GHashTable containing all of the modules, indexed by module name, as
+ * returned by modulemd_index_from_file(). This hash table must be freed with
+ * g_hash_table_unref().
+ *
+ * Since: 1.6
+ */
+GHashTable *
+modulemd_binary_index_to_index (ModulemdBinaryIndex *self, GError **error);
+
+G_END_DECLS
+
+#endif /* MODULEMD_BINARY_INDEX_H */
@@ -0,0 +1,165 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2017-2018 Stephen Gallagher
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+
+#ifndef MODULEMD_CATALOG_H
+#define MODULEMD_CATALOG_H
+
+#include "modulemd.h"
+#include "modulemd-improvedmodule.h"
+#include "modulemd-modulestream.h"
+
+G_BEGIN_DECLS
+
+/**
+ * SECTION: modulemd-catalog
+ * @title: Modulemd.Catalog
+ * @short_description: A lightweight index of the subdocuments in a YAML
+ * stream, whose objects are only parsed on request.
+ *
+ * A #ModulemdCatalog scans a YAML stream once and records, for every
+ * subdocument, its type, its document version, the name, stream, version and
+ * context of the module it describes and where it lives in the input. No
+ * #ModulemdModuleStream or other objects are constructed while doing so. They
+ * are parsed from the retained input only when they are requested by NSVC or
+ * by module name.
+ */
+
+#define MODULEMD_TYPE_CATALOG (modulemd_catalog_get_type ())
+
+G_DECLARE_FINAL_TYPE (
+  ModulemdCatalog, modulemd_catalog, MODULEMD, CATALOG, GObject)
+
+
+/**
+ * modulemd_catalog_new_from_file:
+ * @yaml_file: A YAML file containing the module metadata and other related
+ * information such as default streams.
+ * @error: (out): A #GError containing additional information if this function
+ * fails.
+ *
+ * Scans @yaml_file and records its subdocuments. The file is mapped into
+ * memory and kept until the catalog is freed.
+ *
+ * Returns: (transfer full): A newly-allocated #ModulemdCatalog. This object
+ * must be freed with g_object_unref(). Returns NULL and sets @error if the
+ * file could not be read or is not valid YAML.
+ *
+ * Since: 1.6
+ */
+ModulemdCatalog *
+modulemd_catalog_new_from_file (const gchar *yaml_file, GError **error);
+
+
+/**
+ * modulemd_catalog_new_from_string:
+ * @yaml_string: A YAML string containing the module metadata and other related
+ * information such as default streams.
+ * @error: (out): A #GError containing additional information if this function
+ * fails.
+ *
+ * Scans @yaml_string and records its subdocuments. The catalog keeps its own
+ * copy of the string.
+ *
+ * Returns: (transfer full): A newly-allocated #ModulemdCatalog. This object
+ * must be freed with g_object_unref(). Returns NULL and sets @error if the
+ * string is not valid YAML.
+ *
+ * Since: 1.6
+ */
+ModulemdCatalog *
+modulemd_catalog_new_from_string (const gchar *yaml_string, GError **error);
+
+
+/**
+ * modulemd_catalog_get_n_documents:
+ *
+ * Returns: The number of subdocuments found in the input, including any whose
+ * type was not recognized.
+ *
+ * Since: 1.6
+ */
+guint
+modulemd_catalog_get_n_documents (ModulemdCatalog *self);
+
+
+/**
+ * modulemd_catalog_dup_module_names:
+ *
+ * Returns: (transfer full): A sorted, NULL-terminated list of the module names
+ * referenced by any modulemd, modulemd-defaults or modulemd-translations
+ * subdocument. This must be freed with g_strfreev().
+ *
+ * Since: 1.6
+ */
+gchar **
+modulemd_catalog_dup_module_names (ModulemdCatalog *self);
+
+
+/**
+ * modulemd_catalog_dup_nsvcs:
+ *
+ * Returns: (transfer full): A sorted, NULL-terminated list of the NSVCs of the
+ * modulemd subdocuments, in the same form as returned by
+ * modulemd_modulestream_get_nsvc(). This must be freed with g_strfreev().
+ *
+ * Since: 1.6
+ */
+gchar **
+modulemd_catalog_dup_nsvcs (ModulemdCatalog *self);
+
+
+/**
+ * modulemd_catalog_get_stream_by_nsvc:
+ * @nsvc: The NSVC of the module stream to retrieve, in the form returned by
+ * modulemd_modulestream_get_nsvc().
+ * @error: (out): A #GError containing additional information if this function
+ * fails.
+ *
+ * Parses the modulemd subdocument with the requested NSVC.
+ *
+ * Returns: (transfer full): A newly-parsed #ModulemdModuleStream, or NULL if
+ * no subdocument has this NSVC. If the subdocument fails to parse, returns
+ * NULL and sets @error.
+ *
+ * Since: 1.6
+ */
+ModulemdModuleStream *
+modulemd_catalog_get_stream_by_nsvc (ModulemdCatalog *self,
+                                     const gchar *nsvc,
+                                     GError **error);
+
+
+/**
+ * modulemd_catalog_get_module:
+ * @module_name: The name of the module to retrieve.
+ * @error: (out): A #GError containing additional information if this function
+ * fails.
+ *
+ * Parses every subdocument belonging to @module_name, including its defaults
+ * and translations, and collects them the same way as
+ * modulemd_index_from_file().
+ *
+ * Returns: (transfer full): A newly-allocated #ModulemdImprovedModule, or NULL
+ * if no subdocument refers to @module_name. If any of them fails to parse,
+ * returns NULL and sets @error.
+ *
+ * Since: 1.6
+ */
+ModulemdImprovedModule *
+modulemd_catalog_get_module (ModulemdCatalog *self,
+                             const gchar *module_name,
+                             GError **error);
+
+G_END_DECLS
+
+#endif /* MODULEMD_CATALOG_H */
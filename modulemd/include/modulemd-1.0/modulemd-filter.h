@@ -0,0 +1,180 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2017-2018 Stephen Gallagher
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+
+#ifndef MODULEMD_FILTER_H
+#define MODULEMD_FILTER_H
+
+#include "modulemd.h"
+
+G_BEGIN_DECLS
+
+/**
+ * SECTION: modulemd-filter
+ * @title: Modulemd.Filter
+ * @short_description: Selects which subdocuments of a YAML stream are parsed.
+ *
+ * A #ModulemdFilter is passed to the filtered parsing functions such as
+ * modulemd_objects_from_file_filtered(). Subdocuments that do not match it
+ * are skipped while the YAML is being read, as soon as their type, module
+ * name or architecture is known, and no objects are constructed for them.
+ * Skipped subdocuments are not reported as failures.
+ *
+ * A newly-created filter matches everything. Each criterion that is set
+ * narrows the selection, and a subdocument must match all of them.
+ *
+ * A filter can also restrict which of the larger optional sections of the
+ * selected modulemd subdocuments are parsed. Sections that are not requested
+ * are skipped without being examined, and the corresponding properties of the
+ * resulting #ModulemdModuleStream objects are left unset.
+ */
+
+/**
+ * ModulemdSection:
+ * @MODULEMD_SECTION_DESCRIPTION: The "description" of a module stream.
+ * @MODULEMD_SECTION_XMD: The "xmd" extensible metadata of a module stream.
+ * @MODULEMD_SECTION_COMPONENTS: The RPM and module "components" of a module
+ * stream.
+ * @MODULEMD_SECTION_ARTIFACTS: The "artifacts" of a module stream.
+ * @MODULEMD_SECTION_ALL: All of the above.
+ *
+ * The optional sections of a modulemd subdocument that may be left out when
+ * parsing with a #ModulemdFilter.
+ *
+ * Since: 1.6
+ */
+typedef enum
+{
+  MODULEMD_SECTION_DESCRIPTION = 1 << 0,
+  MODULEMD_SECTION_XMD = 1 << 1,
+  MODULEMD_SECTION_COMPONENTS = 1 << 2,
+  MODULEMD_SECTION_ARTIFACTS = 1 << 3,
+
+  MODULEMD_SECTION_ALL = (1 << 4) - 1
+} ModulemdSection;
+
+#define MODULEMD_TYPE_FILTER (modulemd_filter_get_type ())
+
+G_DECLARE_FINAL_TYPE (
+  ModulemdFilter, modulemd_filter, MODULEMD, FILTER, GObject)
+
+
+/**
+ * modulemd_filter_new:
+ *
+ * Returns: (transfer full): A newly-allocated #ModulemdFilter that matches
+ * every subdocument. This object must be freed with g_object_unref().
+ *
+ * Since: 1.6
+ */
+ModulemdFilter *
+modulemd_filter_new (void);
+
+
+/**
+ * modulemd_filter_add_module_name:
+ * @module_name: The name of a module to select.
+ *
+ * Restricts the filter to subdocuments describing @module_name or any other
+ * module name added by this function. This is the "name" of a modulemd
+ * subdocument and the "module" of a modulemd-defaults or
+ * modulemd-translations subdocument. Subdocuments that don't name a module
+ * are skipped once any module name has been added.
+ *
+ * Since: 1.6
+ */
+void
+modulemd_filter_add_module_name (ModulemdFilter *self,
+                                 const gchar *module_name);
+
+
+/**
+ * modulemd_filter_add_doctype:
+ * @doctype: The #GType of the objects to select: #MODULEMD_TYPE_MODULESTREAM,
+ * #MODULEMD_TYPE_DEFAULTS or #MODULEMD_TYPE_TRANSLATION.
+ *
+ * Restricts the filter to subdocuments of type @doctype or any other type
+ * added by this function.
+ *
+ * Since: 1.6
+ */
+void
+modulemd_filter_add_doctype (ModulemdFilter *self, GType doctype);
+
+
+/**
+ * modulemd_filter_set_arch:
+ * @arch: (nullable): The module artifact architecture to select.
+ *
+ * Restricts the filter to modulemd subdocuments whose "arch" is @arch.
+ * Subdocuments that don't specify an architecture, as well as all
+ * modulemd-defaults and modulemd-translations subdocuments, still match.
+ * Passing NULL removes the restriction.
+ *
+ * Since: 1.6
+ */
+void
+modulemd_filter_set_arch (ModulemdFilter *self, const gchar *arch);
+
+
+/**
+ * modulemd_filter_get_arch:
+ *
+ * Returns: (transfer full): The architecture set with
+ * modulemd_filter_set_arch(), or NULL. This string must be freed with
+ * g_free().
+ *
+ * Since: 1.6
+ */
+gchar *
+modulemd_filter_get_arch (ModulemdFilter *self);
+
+
+/**
+ * modulemd_filter_peek_arch: (skip)
+ *
+ * Returns: The architecture set with modulemd_filter_set_arch(), or NULL. This
+ * string must not be modified or freed.
+ *
+ * Since: 1.6
+ */
+const gchar *
+modulemd_filter_peek_arch (ModulemdFilter *self);
+
+
+/**
+ * modulemd_filter_set_sections:
+ * @sections: A bitmask of #ModulemdSection values to parse.
+ *
+ * Selects which optional sections of modulemd subdocuments are parsed. Any
+ * section that is not included in @sections is skipped. By default, all of
+ * them are parsed.
+ *
+ * Since: 1.6
+ */
+void
+modulemd_filter_set_sections (ModulemdFilter *self, guint sections);
+
+
+/**
+ * modulemd_filter_get_sections:
+ *
+ * Returns: The bitmask of #ModulemdSection values that will be parsed.
+ *
+ * Since: 1.6
+ */
+guint
+modulemd_filter_get_sections (ModulemdFilter *self);
+
+G_END_DECLS
+
+#endif /* MODULEMD_FILTER_H */
@@ -24,6 +24,11 @@ G_BEGIN_DECLS
  * @title: Modulemd.ImprovedModule
  * @short_description: Collects all information about a module: all of its
  * streams, defaults, etc.
+ *
+ * A module may hold many builds of each of its streams, which are told apart
+ * by their version and context. Each of them is kept, and the latest version
+ * of each stream, and of each context of a stream, can be found without
+ * looking at the others.
  */
 
 #define MODULEMD_TYPE_IMPROVEDMODULE (modulemd_improvedmodule_get_type ())
@@ -52,9 +57,10 @@ modulemd_improvedmodule_new (const gchar *name);
  * @stream: (transfer none) (not nullable): A #ModulemdModuleStream of this
  * module.
  *
- * Add a #ModulemdModuleStream to this module. If this stream name is already in
- * use, this function will overwrite the existing value. If the module name does
- * not match, this function will silently ignore this stream.
+ * Add a #ModulemdModuleStream to this module. If this module already has a
+ * stream with the same stream name, version and context, this function will
+ * overwrite it. If the module name does not match, this function will silently
+ * ignore this stream.
  *
  * Since : 1.6
  */
@@ -66,8 +72,9 @@ modulemd_improvedmodule_add_stream (ModulemdImprovedModule *self,
  * modulemd_improvedmodule_get_stream_by_name:
  * @stream_name: The name of the stream to retrieve.
  *
- * Returns: (transfer full): A #ModulemModuleStream representing the requested
- * module stream. NULL if the stream name was not found.
+ * Returns: (transfer full): A #ModulemModuleStream representing the latest
+ * version of the requested module stream. NULL if the stream name was not
+ * found.
  *
  * Since: 1.6
  */
@@ -80,8 +87,9 @@ modulemd_improvedmodule_get_stream_by_name (ModulemdImprovedModule *self,
  * modulemd_improvedmodule_get_streams:
  *
  * Returns: (element-type utf8 ModulemdModuleStream) (transfer container): A
- * #GHashTable containing all #ModulemModuleStream objects for this module.
- * This hash table must be freed with g_hash_table_unref().
+ * #GHashTable containing the latest version of each stream of this module,
+ * indexed by stream name. This hash table must be freed with
+ * g_hash_table_unref().
  *
  * Since: 1.6
  */
@@ -89,6 +97,139 @@ GHashTable *
 modulemd_improvedmodule_get_streams (ModulemdImprovedModule *self);
 
 
+/**
+ * modulemd_improvedmodule_peek_stream_by_version: (skip)
+ * @stream_name: The name of the stream to retrieve.
+ * @version: The version of the stream.
+ * @context: (nullable): The context of the stream, or NULL for a stream that
+ * has no context.
+ *
+ * Returns: (transfer none): The #ModulemdModuleStream with this stream name,
+ * version and context, or NULL if there is none. This object must not be
+ * modified or freed.
+ *
+ * Since: 1.6
+ */
+ModulemdModuleStream *
+modulemd_improvedmodule_peek_stream_by_version (ModulemdImprovedModule *self,
+                                                const gchar *stream_name,
+                                                guint64 version,
+                                                const gchar *context);
+
+
+/**
+ * modulemd_improvedmodule_get_stream_by_version:
+ * @stream_name: The name of the stream to retrieve.
+ * @version: The version of the stream.
+ * @context: (nullable): The context of the stream, or NULL for a stream that
+ * has no context.
+ *
+ * Returns: (transfer full): A copy of the #ModulemdModuleStream with this
+ * stream name, version and context, or NULL if there is none.
+ *
+ * Since: 1.6
+ */
+ModulemdModuleStream *
+modulemd_improvedmodule_get_stream_by_version (ModulemdImprovedModule *self,
+                                               const gchar *stream_name,
+                                               guint64 version,
+                                               const gchar *context);
+
+
+/**
+ * modulemd_improvedmodule_peek_latest_stream: (skip)
+ * @stream_name: The name of the stream to retrieve.
+ * @context: (nullable): The context of the stream, or NULL for any context.
+ *
+ * Returns: (transfer none): The version of the stream with the highest
+ * version number, among those with @context if it is not NULL, or NULL if
+ * there is none. Versions with the same number are ordered by context. This
+ * object must not be modified or freed.
+ *
+ * Since: 1.6
+ */
+ModulemdModuleStream *
+modulemd_improvedmodule_peek_latest_stream (ModulemdImprovedModule *self,
+                                            const gchar *stream_name,
+                                            const gchar *context);
+
+
+/**
+ * modulemd_improvedmodule_get_latest_stream:
+ * @stream_name: The name of the stream to retrieve.
+ * @context: (nullable): The context of the stream, or NULL for any context.
+ *
+ * Returns: (transfer full): A copy of the version of the stream with the
+ * highest version number, among those with @context if it is not NULL, or
+ * NULL if there is none.
+ *
+ * Since: 1.6
+ */
+ModulemdModuleStream *
+modulemd_improvedmodule_get_latest_stream (ModulemdImprovedModule *self,
+                                           const gchar *stream_name,
+                                           const gchar *context);
+
+
+/**
+ * modulemd_improvedmodule_get_stream_versions:
+ * @stream_name: The name of the stream to retrieve.
+ *
+ * Returns: (element-type ModulemdModuleStream) (transfer container): Every
+ * version of the stream, ordered by version and then by context. The array is
+ * empty if the module has no such stream. It must be freed with
+ * g_ptr_array_unref().
+ *
+ * Since: 1.6
+ */
+GPtrArray *
+modulemd_improvedmodule_get_stream_versions (ModulemdImprovedModule *self,
+                                             const gchar *stream_name);
+
+
+/**
+ * modulemd_improvedmodule_get_all_streams:
+ *
+ * Returns: (element-type ModulemdModuleStream) (transfer container): Every
+ * version of every stream of this module, ordered by stream name, version and
+ * context. This array must be freed with g_ptr_array_unref().
+ *
+ * Since: 1.6
+ */
+GPtrArray *
+modulemd_improvedmodule_get_all_streams (ModulemdImprovedModule *self);
+
+
+/**
+ * modulemd_improvedmodule_get_latest_streams:
+ *
+ * Returns: (element-type ModulemdModuleStream) (transfer container): The
+ * latest version of each context of each stream of this module, ordered by
+ * stream name and then by version and context. This array must be freed with
+ * g_ptr_array_unref().
+ *
+ * Since: 1.6
+ */
+GPtrArray *
+modulemd_improvedmodule_get_latest_streams (ModulemdImprovedModule *self);
+
+
+/**
+ * modulemd_improvedmodule_prune_versions:
+ * @n_versions: The number of versions of each stream to keep. Must be at
+ * least one.
+ *
+ * Removes all but the @n_versions newest version numbers of each stream of
+ * this module. Every context of a version that is kept is kept with it, so the
+ * latest version of each stream is never removed.
+ *
+ * Since: 1.6
+ */
+void
+modulemd_improvedmodule_prune_versions (ModulemdImprovedModule *self,
+                                        guint n_versions);
+
+
 /**
  * modulemd_improvedmodule_set_name:
  * @module_name: (transfer none) (not nullable): The name of this module.
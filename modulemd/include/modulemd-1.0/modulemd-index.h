@@ -0,0 +1,299 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2017-2018 Stephen Gallagher
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+
+#ifndef MODULEMD_INDEX_H
+#define MODULEMD_INDEX_H
+
+#include "modulemd.h"
+#include "modulemd-improvedmodule.h"
+#include "modulemd-modulestream.h"
+
+G_BEGIN_DECLS
+
+/**
+ * SECTION: modulemd-index
+ * @title: Modulemd.Index
+ * @short_description: Looks up module streams by NSVC, artifact or profile.
+ *
+ * A #ModulemdIndex wraps an index of #ModulemdImprovedModule objects, as
+ * returned by modulemd_index_from_file(), and keeps hash tables of its
+ * streams by "NAME:STREAM:VERSION[:CONTEXT]", by the NEVRA of each of their
+ * RPM artifacts and by the names of the RPMs in each of their profiles. These
+ * tables are built once, when the #ModulemdIndex is created, so that each
+ * lookup takes constant time instead of visiting every stream.
+ *
+ * It also keeps a reverse index of the dependencies of its streams, so that
+ * the streams that require or buildrequire a given module stream can be found
+ * without visiting every stream. The transitive closure of these dependents
+ * is computed on demand and remembered for later queries.
+ *
+ * The index does not follow later changes to the modules or streams it was
+ * created from.
+ */
+
+/**
+ * ModulemdDependencyKind:
+ * @MODULEMD_DEPENDENCY_REQUIRES: Run-time dependencies: the "requires" of
+ * each #ModulemdDependencies object, or the "requires" property of a stream
+ * in modulemd version 1.
+ * @MODULEMD_DEPENDENCY_BUILDREQUIRES: Build-time dependencies: the
+ * "buildrequires" of each #ModulemdDependencies object, or the
+ * "buildrequires" property of a stream in modulemd version 1.
+ * @MODULEMD_DEPENDENCY_ALL: Both of the above.
+ *
+ * The kinds of dependencies followed by modulemd_index_get_dependents() and
+ * modulemd_index_get_transitive_dependents().
+ *
+ * Since: 1.6
+ */
+typedef enum
+{
+  MODULEMD_DEPENDENCY_REQUIRES = 1 << 0,
+  MODULEMD_DEPENDENCY_BUILDREQUIRES = 1 << 1,
+
+  MODULEMD_DEPENDENCY_ALL = (1 << 2) - 1
+} ModulemdDependencyKind;
+
+#define MODULEMD_TYPE_INDEX (modulemd_index_get_type ())
+
+G_DECLARE_FINAL_TYPE (ModulemdIndex, modulemd_index, MODULEMD, INDEX, GObject)
+
+
+/**
+ * modulemd_index_new:
+ * @index: (element-type utf8 ModulemdImprovedModule) (transfer none): A
+ * #GHashTable of #ModulemdImprovedModule objects indexed by module name, as
+ * returned by modulemd_index_from_file().
+ *
+ * Returns: (transfer full): A newly-allocated #ModulemdIndex of the modules
+ * in @index. This object must be freed with g_object_unref().
+ *
+ * Since: 1.6
+ */
+ModulemdIndex *
+modulemd_index_new (GHashTable *index);
+
+
+/**
+ * modulemd_index_new_from_file:
+ * @yaml_file: A YAML file containing the module metadata and other related
+ * information such as default streams.
+ * @failures: (element-type ModulemdSubdocument) (transfer container) (out):
+ * An array containing any subdocuments from the YAML file that failed to
+ * parse. This must be freed with g_ptr_array_unref().
+ * @error: (out): A #GError containing additional information if this function
+ * fails.
+ *
+ * Reads @yaml_file with modulemd_index_from_file() and indexes the result.
+ *
+ * Returns: (transfer full): A newly-allocated #ModulemdIndex, or NULL if the
+ * file could not be read. This object must be freed with g_object_unref().
+ *
+ * Since: 1.6
+ */
+ModulemdIndex *
+modulemd_index_new_from_file (const gchar *yaml_file,
+                              GPtrArray **failures,
+                              GError **error);
+
+
+/**
+ * modulemd_index_get_modules:
+ *
+ * Returns: (element-type utf8 ModulemdImprovedModule) (transfer container):
+ * A #GHashTable containing all of the modules in the index, indexed by module
+ * name. This hash table must not be modified and must be freed with
+ * g_hash_table_unref().
+ *
+ * Since: 1.6
+ */
+GHashTable *
+modulemd_index_get_modules (ModulemdIndex *self);
+
+
+/**
+ * modulemd_index_peek_module: (skip)
+ * @module_name: The name of the module to look up.
+ *
+ * Returns: (transfer none): The #ModulemdImprovedModule named @module_name,
+ * or NULL if the index does not contain it. This object must not be modified
+ * or freed.
+ *
+ * Since: 1.6
+ */
+ModulemdImprovedModule *
+modulemd_index_peek_module (ModulemdIndex *self, const gchar *module_name);
+
+
+/**
+ * modulemd_index_get_module:
+ * @module_name: The name of the module to look up.
+ *
+ * Returns: (transfer full): The #ModulemdImprovedModule named @module_name,
+ * or NULL if the index does not contain it. This object must be freed with
+ * g_object_unref().
+ *
+ * Since: 1.6
+ */
+ModulemdImprovedModule *
+modulemd_index_get_module (ModulemdIndex *self, const gchar *module_name);
+
+
+/**
+ * modulemd_index_peek_stream_by_nsvc: (skip)
+ * @nsvc: A stream identifier in the form "NAME:STREAM:VERSION[:CONTEXT]", as
+ * returned by modulemd_modulestream_get_nsvc().
+ *
+ * Returns: (transfer none): The #ModulemdModuleStream identified by @nsvc, or
+ * NULL if the index does not contain it. This object must not be modified or
+ * freed.
+ *
+ * Since: 1.6
+ */
+ModulemdModuleStream *
+modulemd_index_peek_stream_by_nsvc (ModulemdIndex *self, const gchar *nsvc);
+
+
+/**
+ * modulemd_index_get_stream_by_nsvc:
+ * @nsvc: A stream identifier in the form "NAME:STREAM:VERSION[:CONTEXT]", as
+ * returned by modulemd_modulestream_get_nsvc().
+ *
+ * Returns: (transfer full): The #ModulemdModuleStream identified by @nsvc, or
+ * NULL if the index does not contain it. This object must be freed with
+ * g_object_unref().
+ *
+ * Since: 1.6
+ */
+ModulemdModuleStream *
+modulemd_index_get_stream_by_nsvc (ModulemdIndex *self, const gchar *nsvc);
+
+
+/**
+ * modulemd_index_peek_streams_by_nevra: (skip)
+ * @nevra: The NEVRA of a binary RPM, as it appears in the "rpm_artifacts" of
+ * a stream.
+ *
+ * Returns: (element-type ModulemdModuleStream) (transfer none): The streams
+ * that list @nevra among their RPM artifacts, ordered by module name, stream
+ * name, version and context, or NULL if there are none. This array and its
+ * contents must not be modified or freed.
+ *
+ * Since: 1.6
+ */
+GPtrArray *
+modulemd_index_peek_streams_by_nevra (ModulemdIndex *self,
+                                      const gchar *nevra);
+
+
+/**
+ * modulemd_index_get_streams_by_nevra:
+ * @nevra: The NEVRA of a binary RPM, as it appears in the "rpm_artifacts" of
+ * a stream.
+ *
+ * Returns: (element-type ModulemdModuleStream) (transfer container): The
+ * streams that list @nevra among their RPM artifacts, ordered by module name,
+ * stream name, version and context. The array is empty if there are none. It
+ * must be freed with g_ptr_array_unref().
+ *
+ * Since: 1.6
+ */
+GPtrArray *
+modulemd_index_get_streams_by_nevra (ModulemdIndex *self, const gchar *nevra);
+
+
+/**
+ * modulemd_index_peek_streams_by_profile_rpm: (skip)
+ * @rpm: The name of an RPM package.
+ *
+ * Returns: (element-type ModulemdModuleStream) (transfer none): The streams
+ * with at least one profile that installs @rpm, ordered by module name, stream
+ * name, version and context, or NULL if there are none. This array and its
+ * contents must not be modified or freed.
+ *
+ * Since: 1.6
+ */
+GPtrArray *
+modulemd_index_peek_streams_by_profile_rpm (ModulemdIndex *self,
+                                            const gchar *rpm);
+
+
+/**
+ * modulemd_index_get_streams_by_profile_rpm:
+ * @rpm: The name of an RPM package.
+ *
+ * Returns: (element-type ModulemdModuleStream) (transfer container): The
+ * streams with at least one profile that installs @rpm, ordered by module
+ * name, stream name, version and context. The array is empty if there are
+ * none. It must be freed with g_ptr_array_unref().
+ *
+ * Since: 1.6
+ */
+GPtrArray *
+modulemd_index_get_streams_by_profile_rpm (ModulemdIndex *self,
+                                           const gchar *rpm);
+
+
+/**
+ * modulemd_index_get_dependents:
+ * @module_name: The name of a module.
+ * @stream_name: The name of a stream of @module_name.
+ * @kinds: The #ModulemdDependencyKind flags of the dependencies to follow.
+ *
+ * Finds the streams that depend directly on @module_name:@stream_name. A
+ * stream depends on it if it lists @stream_name for @module_name, if it lists
+ * only streams of @module_name to exclude, such as "-f27", and @stream_name
+ * is not one of them, or if it depends on @module_name without naming any
+ * streams.
+ *
+ * Returns: (element-type ModulemdModuleStream) (transfer container): The
+ * streams that depend on @module_name:@stream_name, ordered by module name,
+ * stream name, version and context. It must be freed with
+ * g_ptr_array_unref().
+ *
+ * Since: 1.6
+ */
+GPtrArray *
+modulemd_index_get_dependents (ModulemdIndex *self,
+                               const gchar *module_name,
+                               const gchar *stream_name,
+                               ModulemdDependencyKind kinds);
+
+
+/**
+ * modulemd_index_get_transitive_dependents:
+ * @module_name: The name of a module.
+ * @stream_name: The name of a stream of @module_name.
+ * @kinds: The #ModulemdDependencyKind flags of the dependencies to follow.
+ *
+ * Finds the streams that depend on @module_name:@stream_name, directly or
+ * through any number of other streams, as modulemd_index_get_dependents()
+ * does for each step. The result of each query is remembered, and is reused
+ * by later queries that reach the same module stream.
+ *
+ * Returns: (element-type ModulemdModuleStream) (transfer container): The
+ * streams that depend on @module_name:@stream_name, ordered by module name,
+ * stream name, version and context. It must be freed with
+ * g_ptr_array_unref().
+ *
+ * Since: 1.6
+ */
+GPtrArray *
+modulemd_index_get_transitive_dependents (ModulemdIndex *self,
+                                          const gchar *module_name,
+                                          const gchar *stream_name,
+                                          ModulemdDependencyKind kinds);
+
+G_END_DECLS
+
+#endif /* MODULEMD_INDEX_H */
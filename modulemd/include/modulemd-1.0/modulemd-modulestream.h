@@ -62,9 +62,14 @@ modulemd_modulestream_new (void);
 /**
  * modulemd_modulestream_copy:
  *
- * Make a copy of the current module
- *
- * Returns: (transfer full): A deep copy of this #ModulemdModuleStream
+ * Make a copy of the current module. The copy shares its contents with the
+ * original, so copying takes the same time however large the module is.
+ * Either stream takes a private copy of a member the first time it is
+ * modified or returned by a peek function, so peek functions on a copied
+ * stream must not be called while another thread is reading it.
+ *
+ * Returns: (transfer full): A copy of this #ModulemdModuleStream that behaves
+ * as a deep copy.
  *
  * Since: 1.1
  */
@@ -56,6 +56,35 @@ ModulemdPrioritizer *
 modulemd_prioritizer_new (void);
 
 
+/**
+ * modulemd_prioritizer_set_n_threads:
+ * @n_threads: The maximum number of threads to merge module defaults with. If
+ * zero, one thread per available processor is used. The default is one.
+ *
+ * Sets how many threads modulemd_prioritizer_add() and
+ * modulemd_prioritizer_resolve() may use. The defaults of each module are
+ * merged independently of the others, and the results are the same for any
+ * number of threads.
+ *
+ * Since: 1.6
+ */
+void
+modulemd_prioritizer_set_n_threads (ModulemdPrioritizer *self,
+                                    guint n_threads);
+
+
+/**
+ * modulemd_prioritizer_get_n_threads:
+ *
+ * Returns: The maximum number of threads to merge module defaults with, as set
+ * by modulemd_prioritizer_set_n_threads().
+ *
+ * Since: 1.6
+ */
+guint
+modulemd_prioritizer_get_n_threads (ModulemdPrioritizer *self);
+
+
 /**
  * modulemd_prioritizer_add:
  * @objects: (array zero-terminated=1) (element-type GObject): A #GPtrArray of
@@ -66,7 +95,7 @@ modulemd_prioritizer_new (void);
  *
  * Returns: TRUE if the objects could be added without generating a conflict at
  * this priority level. If a conflict was detected, this function returns FALSE
- * and error is set. The internal state is undefined in the case of an error.
+ * and error is set. Nothing is added in the case of an error.
  *
  * Since: 1.3
  */
@@ -80,6 +109,10 @@ modulemd_prioritizer_add (ModulemdPrioritizer *self,
 /**
  * modulemd_prioritizer_resolve:
  *
+ * The result of merging each module's defaults is kept, so calling this again
+ * after adding more objects only merges the defaults of the modules that they
+ * contain.
+ *
  * Returns: (array zero-terminated=1) (element-type GObject) (transfer container):
  * A #GPtrArray of module-related objects with all priorities resolved. This
  * object must be freed with g_ptr_array_unref().
@@ -101,7 +134,7 @@ modulemd_prioritizer_resolve (ModulemdPrioritizer *self, GError **error);
  *
  * Returns: TRUE if the objects could be added without generating a conflict at
  * this priority level. If a conflict was detected, this function returns FALSE
- * and @error is set. The internal state is undefined in the case of an error.
+ * and @error is set. Nothing is added in the case of an error.
  *
  * Since: 1.6
  */
@@ -0,0 +1,103 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2017-2018 Stephen Gallagher
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+
+#ifndef MODULEMD_RESOLVER_H
+#define MODULEMD_RESOLVER_H
+
+#include "modulemd.h"
+#include "modulemd-index.h"
+
+G_BEGIN_DECLS
+
+/**
+ * SECTION: modulemd-resolver
+ * @title: Modulemd.Resolver
+ * @short_description: Selects a consistent set of module streams.
+ *
+ * A #ModulemdResolver chooses at most one stream of each module in a
+ * #ModulemdIndex so that a set of requested streams can be enabled together.
+ * Every selected stream must have the run-time "requires" of at least one of
+ * its #ModulemdDependencies objects satisfied by the other selected streams,
+ * including lists of excluded streams such as "-f27". When a module is
+ * pulled in without a stream being specified, its default stream from its
+ * #ModulemdDefaults is preferred over the others.
+ *
+ * Only the latest version of each stream is considered, but every context
+ * of that version is a separate candidate, since builds for different
+ * contexts usually require different streams of their dependencies.
+ *
+ * The candidates are numbered when the resolver is created, and the ones
+ * that each dependency accepts are kept as bitsets of these numbers, so
+ * that a resolver can be reused for many requests without looking at the
+ * #ModulemdModuleStream objects again.
+ *
+ * Modules that are not in the index, such as "platform", are provided by
+ * naming their stream in the request. They are never selected otherwise.
+ */
+
+#define MODULEMD_RESOLVER_ERROR modulemd_resolver_error_quark ()
+GQuark
+modulemd_resolver_error_quark (void);
+
+enum ModulemdResolverError
+{
+  MODULEMD_RESOLVER_INVALID_REQUEST,
+  MODULEMD_RESOLVER_UNSATISFIABLE
+};
+
+#define MODULEMD_TYPE_RESOLVER (modulemd_resolver_get_type ())
+
+G_DECLARE_FINAL_TYPE (
+  ModulemdResolver, modulemd_resolver, MODULEMD, RESOLVER, GObject)
+
+
+/**
+ * modulemd_resolver_new:
+ * @index: (transfer none): The #ModulemdIndex to select streams from.
+ *
+ * Returns: (transfer full): A newly-allocated #ModulemdResolver for the
+ * streams in @index. This object must be freed with g_object_unref().
+ *
+ * Since: 1.6
+ */
+ModulemdResolver *
+modulemd_resolver_new (ModulemdIndex *index);
+
+
+/**
+ * modulemd_resolver_resolve:
+ * @requests: (array zero-terminated=1) (transfer none): The streams to
+ * select, in the form "NAME:STREAM" or "NAME". When only the module name is
+ * given, its default stream is preferred.
+ * @error: (out): A #GError containing additional information if this function
+ * fails.
+ *
+ * Selects the requested streams and the streams they require.
+ *
+ * Returns: (element-type ModulemdModuleStream) (transfer container): The
+ * selected streams, ordered by module name, or NULL if a request is invalid
+ * or no consistent selection exists. In that case, @error is set to
+ * %MODULEMD_RESOLVER_INVALID_REQUEST or %MODULEMD_RESOLVER_UNSATISFIABLE and
+ * describes the dependency that could not be satisfied. The array must be
+ * freed with g_ptr_array_unref().
+ *
+ * Since: 1.6
+ */
+GPtrArray *
+modulemd_resolver_resolve (ModulemdResolver *self,
+                           const gchar **requests,
+                           GError **error);
+
+G_END_DECLS
+
+#endif /* MODULEMD_RESOLVER_H */
@@ -35,20 +35,26 @@
 
 #include <glib.h>
 #include <glib-object.h>
+#include <gio/gio.h>
 #include <stdio.h>
 
 #include "modulemd-buildopts.h"
+#include "modulemd-binary-index.h"
+#include "modulemd-catalog.h"
 #include "modulemd-component.h"
 #include "modulemd-component-module.h"
 #include "modulemd-component-rpm.h"
 #include "modulemd-defaults.h"
 #include "modulemd-dependencies.h"
+#include "modulemd-filter.h"
 #include "modulemd-improvedmodule.h"
+#include "modulemd-index.h"
 #include "modulemd-intent.h"
 #include "modulemd-module.h"
 #include "modulemd-modulestream.h"
 #include "modulemd-prioritizer.h"
 #include "modulemd-profile.h"
+#include "modulemd-resolver.h"
 #include "modulemd-simpleset.h"
 #include "modulemd-servicelevel.h"
 #include "modulemd-subdocument.h"
@@ -57,6 +63,25 @@
 
 G_BEGIN_DECLS
 
+/**
+ * ModulemdForeachFunc:
+ * @object: (transfer none): The #ModulemdModuleStream, #ModulemdDefaults or
+ * #ModulemdTranslation that was just parsed, or a #ModulemdSubdocument
+ * describing a subdocument that failed to parse. Call g_object_ref() on it to
+ * keep it beyond the callback.
+ * @user_data: The data passed to modulemd_parse_file_foreach().
+ * @error: (out): A #GError to set if parsing should stop because of an error.
+ *
+ * Specifies the type of function passed to modulemd_parse_file_foreach().
+ *
+ * Returns: TRUE to continue parsing, FALSE to stop.
+ *
+ * Since: 1.6
+ */
+typedef gboolean (*ModulemdForeachFunc) (GObject *object,
+                                         gpointer user_data,
+                                         GError **error);
+
 /**
  * modulemd_get_version:
  *
@@ -68,6 +93,41 @@ const gchar *
 modulemd_get_version (void);
 
 
+/**
+ * modulemd_set_cache_dir:
+ * @path: (nullable): The directory in which to cache parsed YAML files, or
+ * NULL to disable caching.
+ *
+ * Enables a persistent cache for modulemd_objects_from_file_ext(),
+ * modulemd_index_from_file() and the other functions that parse the whole of
+ * a YAML file. The result of parsing each file is stored in @path, which is
+ * created if needed. If the file is later parsed again, the stored result is
+ * reused instead of reading the YAML, provided that the file's device, inode,
+ * size and modification time, or else the checksum of its contents, have not
+ * changed since.
+ *
+ * Files containing any subdocuments that failed to parse are never cached.
+ * The cache directory may be shared between processes, since cache files are
+ * always replaced atomically. Caching is disabled by default.
+ *
+ * Since: 1.6
+ */
+void
+modulemd_set_cache_dir (const gchar *path);
+
+
+/**
+ * modulemd_get_cache_dir:
+ *
+ * Returns: (transfer full): The directory set with modulemd_set_cache_dir(),
+ * or NULL if caching is disabled. This string must be freed with g_free().
+ *
+ * Since: 1.6
+ */
+gchar *
+modulemd_get_cache_dir (void);
+
+
 /**
  * modulemd_objects_from_file:
  * @yaml_file: A YAML file containing the module metadata and other related
@@ -137,6 +197,211 @@ modulemd_index_from_file (const gchar *yaml_file,
                           GError **error);
 
 
+/**
+ * modulemd_index_from_file_parallel:
+ * @yaml_file: A YAML file containing the module metadata and other related
+ * information such as default streams.
+ * @n_threads: The maximum number of threads to parse subdocuments with. If
+ * zero, one thread per available processor is used. If one, this behaves
+ * exactly like modulemd_index_from_file().
+ * @failures: (element-type ModulemdSubdocument) (transfer container) (out):
+ * An array containing any subdocuments from the YAML file that failed to
+ * parse. This must be freed with g_ptr_array_unref().
+ * @error: (out): A #GError containing additional information if this function
+ * fails.
+ *
+ * Like modulemd_index_from_file(), but the subdocuments are parsed
+ * concurrently on a thread pool while the file is being read. The result and
+ * the order of @failures are the same as for a serial parse. Because
+ * subdocuments are buffered until they have been parsed, this may use more
+ * memory than modulemd_index_from_file().
+ *
+ * Returns: (element-type utf8 ModulemdImprovedModule) (transfer container):
+ * A #GHashTable containing all of the subdocuments from a YAML file, indexed
+ * by module name. This hash table must be freed with g_hash_table_unref().
+ *
+ * Since: 1.6
+ */
+GHashTable *
+modulemd_index_from_file_parallel (const gchar *yaml_file,
+                                   guint n_threads,
+                                   GPtrArray **failures,
+                                   GError **error);
+
+
+/**
+ * modulemd_index_from_files:
+ * @yaml_files: (array zero-terminated=1): A NULL-terminated list of YAML files
+ * containing module metadata and other related information such as default
+ * streams.
+ * @n_threads: The maximum number of files to parse at once. If zero, one
+ * thread per available processor is used.
+ * @failures: (element-type ModulemdSubdocument) (transfer container) (out):
+ * An array containing any subdocuments from the YAML files that failed to
+ * parse, in the order of @yaml_files. This must be freed with
+ * g_ptr_array_unref().
+ * @error: (out): A #GError containing additional information if this function
+ * fails.
+ *
+ * Parses several YAML files concurrently, one per worker thread, and merges
+ * them into a single index. The result is the same as parsing the
+ * concatenation of the files in the order given with
+ * modulemd_index_from_file(): streams, defaults and translations for the same
+ * module are combined, and if any file cannot be read, no index is returned.
+ *
+ * Returns: (element-type utf8 ModulemdImprovedModule) (transfer container):
+ * A #GHashTable containing all of the subdocuments from the YAML files,
+ * indexed by module name. This hash table must be freed with
+ * g_hash_table_unref().
+ *
+ * Since: 1.6
+ */
+GHashTable *
+modulemd_index_from_files (const gchar **yaml_files,
+                           guint n_threads,
+                           GPtrArray **failures,
+                           GError **error);
+
+
+/**
+ * modulemd_index_from_gfile_async:
+ * @file: A #GFile containing the module metadata and other related
+ * information such as default streams.
+ * @cancellable: (nullable): A #GCancellable, or NULL.
+ * @callback: (scope async): The #GAsyncReadyCallback to call when the index
+ * has been read.
+ * @user_data: (closure): Data to pass to @callback.
+ *
+ * Reads and parses @file on a worker thread, so that the calling thread's
+ * main loop keeps running. @callback is invoked in the thread-default main
+ * context of the calling thread, and must call
+ * modulemd_index_from_gfile_finish() to get the result.
+ *
+ * If @cancellable is cancelled, the parse stops at the next subdocument or
+ * read from @file, and the operation fails with %G_IO_ERROR_CANCELLED.
+ *
+ * Since: 1.6
+ */
+void
+modulemd_index_from_gfile_async (GFile *file,
+                                 GCancellable *cancellable,
+                                 GAsyncReadyCallback callback,
+                                 gpointer user_data);
+
+
+/**
+ * modulemd_index_from_gfile_finish:
+ * @result: The #GAsyncResult passed to the callback of
+ * modulemd_index_from_gfile_async().
+ * @failures: (element-type ModulemdSubdocument) (transfer container) (out):
+ * An array containing any subdocuments from the YAML file that failed to
+ * parse. This must be freed with g_ptr_array_unref().
+ * @error: (out): A #GError containing additional information if the
+ * operation failed or was cancelled.
+ *
+ * Returns: (element-type utf8 ModulemdImprovedModule) (transfer container):
+ * A #GHashTable containing all of the subdocuments from the YAML file,
+ * indexed by module name, as returned by modulemd_index_from_file(). This
+ * hash table must be freed with g_hash_table_unref().
+ *
+ * Since: 1.6
+ */
+GHashTable *
+modulemd_index_from_gfile_finish (GAsyncResult *result,
+                                  GPtrArray **failures,
+                                  GError **error);
+
+
+/**
+ * modulemd_objects_from_file_filtered:
+ * @yaml_file: A YAML file containing the module metadata and other related
+ * information such as default streams.
+ * @filter: (nullable): A #ModulemdFilter selecting the subdocuments to parse.
+ * If NULL, every subdocument is parsed.
+ * @failures: (element-type ModulemdSubdocument) (transfer container) (out):
+ * An array containing any subdocuments from the YAML file that failed to
+ * parse. This must be freed with g_ptr_array_unref().
+ * @error: (out): A #GError containing additional information if this function
+ * fails.
+ *
+ * Allocates a #GPtrArray of the subdocuments from a file that match @filter.
+ * Subdocuments that don't match are skipped as soon as this is known, without
+ * being parsed, and are not reported in @failures.
+ *
+ * Returns: (element-type GObject) (transfer container): A #GPtrArray of
+ * #ModulemdModuleStream, #ModulemdDefaults and #ModulemdTranslation objects.
+ * This array must be freed with g_ptr_array_unref().
+ *
+ * Since: 1.6
+ */
+GPtrArray *
+modulemd_objects_from_file_filtered (const gchar *yaml_file,
+                                     ModulemdFilter *filter,
+                                     GPtrArray **failures,
+                                     GError **error);
+
+
+/**
+ * modulemd_index_from_file_filtered:
+ * @yaml_file: A YAML file containing the module metadata and other related
+ * information such as default streams.
+ * @filter: (nullable): A #ModulemdFilter selecting the subdocuments to parse.
+ * If NULL, every subdocument is parsed.
+ * @failures: (element-type ModulemdSubdocument) (transfer container) (out):
+ * An array containing any subdocuments from the YAML file that failed to
+ * parse. This must be freed with g_ptr_array_unref().
+ * @error: (out): A #GError containing additional information if this function
+ * fails.
+ *
+ * Like modulemd_index_from_file(), but only the subdocuments that match
+ * @filter are parsed and added to the index.
+ *
+ * Returns: (element-type utf8 ModulemdImprovedModule) (transfer container):
+ * A #GHashTable containing the matching subdocuments from a YAML file,
+ * indexed by module name. This hash table must be freed with
+ * g_hash_table_unref().
+ *
+ * Since: 1.6
+ */
+GHashTable *
+modulemd_index_from_file_filtered (const gchar *yaml_file,
+                                   ModulemdFilter *filter,
+                                   GPtrArray **failures,
+                                   GError **error);
+
+
+/**
+ * modulemd_parse_file_foreach:
+ * @yaml_file: A YAML file containing the module metadata and other related
+ * information such as default streams.
+ * @callback: (scope call) (closure user_data): A #ModulemdForeachFunc to call
+ * with each subdocument as soon as it has been read.
+ * @user_data: Data to pass to @callback.
+ * @error: (out): A #GError containing additional information if this function
+ * fails.
+ *
+ * Parses a YAML file one subdocument at a time. Each subdocument is handed to
+ * @callback as soon as it ends, in the order it appears in the file, and
+ * released afterwards unless @callback keeps a reference. Subdocuments that
+ * fail to parse are passed as #ModulemdSubdocument objects. Peak memory use is
+ * therefore bounded by the largest single subdocument rather than by the whole
+ * file.
+ *
+ * If @callback returns FALSE, parsing stops and this function returns FALSE
+ * with the error set by @callback, or a generic error if it set none.
+ *
+ * Returns: TRUE if the whole file was processed. In the event of an error,
+ * sets @error appropriately and returns FALSE.
+ *
+ * Since: 1.6
+ */
+gboolean
+modulemd_parse_file_foreach (const gchar *yaml_file,
+                             ModulemdForeachFunc callback,
+                             gpointer user_data,
+                             GError **error);
+
+
 /**
  * modulemd_objects_from_string:
  * @yaml_string: A YAML string containing the module metadata and other related
@@ -182,6 +447,33 @@ modulemd_objects_from_string_ext (const gchar *yaml_string,
                                   GError **error);
 
 
+/**
+ * modulemd_objects_from_string_filtered:
+ * @yaml_string: A YAML string containing the module metadata and other related
+ * information such as default streams.
+ * @filter: (nullable): A #ModulemdFilter selecting the subdocuments to parse.
+ * If NULL, every subdocument is parsed.
+ * @failures: (element-type ModulemdSubdocument) (transfer container) (out):
+ * An array containing any subdocuments from the YAML string that failed to
+ * parse. This must be freed with g_ptr_array_unref().
+ * @error: (out): A #GError containing additional information if this function
+ * fails.
+ *
+ * Like modulemd_objects_from_file_filtered(), but reads from a string.
+ *
+ * Returns: (element-type GObject) (transfer container): A #GPtrArray of
+ * #ModulemdModuleStream, #ModulemdDefaults and #ModulemdTranslation objects.
+ * This array must be freed with g_ptr_array_unref().
+ *
+ * Since: 1.6
+ */
+GPtrArray *
+modulemd_objects_from_string_filtered (const gchar *yaml_string,
+                                       ModulemdFilter *filter,
+                                       GPtrArray **failures,
+                                       GError **error);
+
+
 /**
  * modulemd_index_from_string:
  * @yaml_string: A YAML string containing the module metadata and other related
@@ -275,6 +567,56 @@ modulemd_index_from_stream (FILE *yaml_stream,
                             GError **error);
 
 
+/**
+ * modulemd_index_from_input_stream_async:
+ * @stream: A #GInputStream containing the module metadata and other related
+ * information such as default streams.
+ * @cancellable: (nullable): A #GCancellable, or NULL.
+ * @callback: (scope async): The #GAsyncReadyCallback to call when the index
+ * has been read.
+ * @user_data: (closure): Data to pass to @callback.
+ *
+ * Reads and parses @stream on a worker thread, using blocking reads, so that
+ * the calling thread's main loop keeps running. @stream must not be used by
+ * anything else until the operation has completed. @callback is invoked in
+ * the thread-default main context of the calling thread, and must call
+ * modulemd_index_from_input_stream_finish() to get the result.
+ *
+ * If @cancellable is cancelled, the parse stops at the next subdocument or
+ * read from @stream, and the operation fails with %G_IO_ERROR_CANCELLED.
+ *
+ * Since: 1.6
+ */
+void
+modulemd_index_from_input_stream_async (GInputStream *stream,
+                                        GCancellable *cancellable,
+                                        GAsyncReadyCallback callback,
+                                        gpointer user_data);
+
+
+/**
+ * modulemd_index_from_input_stream_finish:
+ * @result: The #GAsyncResult passed to the callback of
+ * modulemd_index_from_input_stream_async().
+ * @failures: (element-type ModulemdSubdocument) (transfer container) (out):
+ * An array containing any subdocuments from the YAML stream that failed to
+ * parse. This must be freed with g_ptr_array_unref().
+ * @error: (out): A #GError containing additional information if the
+ * operation failed or was cancelled.
+ *
+ * Returns: (element-type utf8 ModulemdImprovedModule) (transfer container):
+ * A #GHashTable containing all of the subdocuments from the YAML stream,
+ * indexed by module name. This hash table must be freed with
+ * g_hash_table_unref().
+ *
+ * Since: 1.6
+ */
+GHashTable *
+modulemd_index_from_input_stream_finish (GAsyncResult *result,
+                                         GPtrArray **failures,
+                                         GError **error);
+
+
 /**
  * modulemd_dump_index:
  * @index: (element-type utf8 ModulemdImprovedModule) (transfer none): The index
@@ -308,6 +650,49 @@ gchar *
 modulemd_dumps_index (GHashTable *index, GError **error);
 
 
+/**
+ * modulemd_dump_index_binary:
+ * @index: (element-type utf8 ModulemdImprovedModule) (transfer none): The index
+ * of #ModulemdImprovedModule objects to dump to a binary file.
+ * @path: (transfer none): The path to the file that should contain the
+ * resulting binary index.
+ * @error: (out): A #GError containing additional information if this function
+ * fails.
+ *
+ * Writes @index to a file in the compact binary format read by
+ * #ModulemdBinaryIndex and modulemd_index_from_binary_file(). The file is
+ * replaced atomically.
+ *
+ * Returns: TRUE if the file was written successfully. In the event of an error,
+ * sets @error appropriately and returns FALSE.
+ *
+ * Since: 1.6
+ */
+gboolean
+modulemd_dump_index_binary (GHashTable *index,
+                            const gchar *path,
+                            GError **error);
+
+
+/**
+ * modulemd_index_from_binary_file:
+ * @path: The path to a file written by modulemd_dump_index_binary().
+ * @error: (out): A #GError containing additional information if this function
+ * fails.
+ *
+ * Reads a whole index from a binary file. Use #ModulemdBinaryIndex to read
+ * only some of the modules.
+ *
+ * Returns: (element-type utf8 ModulemdImprovedModule) (transfer container):
+ * A #GHashTable containing all of the modules from the binary file, indexed
+ * by module name. This hash table must be freed with g_hash_table_unref().
+ *
+ * Since: 1.6
+ */
+GHashTable *
+modulemd_index_from_binary_file (const gchar *path, GError **error);
+
+
 /**
  * modulemd_dump:
  * @objects: (array zero-terminated=1) (element-type GObject): A #GPtrArray of
@@ -370,6 +755,100 @@ modulemd_merge_defaults (const GPtrArray *first,
                          gboolean override,
                          GError **error);
 
+
+/**
+ * modulemd_merge_defaults_parallel:
+ * @first: (array zero-terminated=1) (element-type GObject): A #GPtrArray of
+ * modulemd-related objects.
+ * @second: (array zero-terminated=1) (element-type GObject) (nullable):
+ * Optional. A #GPtrArray of modulemd-related objects to be merged into the
+ * first list.
+ * @override: Whether entries in @second should override those of @first in the
+ * event of a conflict or whether they should attempt to merge instead.
+ * @n_threads: The maximum number of threads to merge with. If zero, one thread
+ * per available processor is used. If one, this behaves exactly like
+ * modulemd_merge_defaults().
+ * @error: (out): A #GError containing additional information if this function
+ * fails.
+ *
+ * Like modulemd_merge_defaults(), but the defaults for different modules are
+ * merged concurrently on a thread pool. The result is the same as for a serial
+ * merge, including the order of the objects and which error is returned if
+ * the defaults of more than one module cannot be merged.
+ *
+ * Returns: (element-type GObject) (transfer container): A list of
+ * module-related objects with defaults deduplicated and merged. This array is
+ * newly-allocated and must be freed with g_ptr_array_unref().
+ *
+ * Since: 1.6
+ */
+GPtrArray *
+modulemd_merge_defaults_parallel (const GPtrArray *first,
+                                  const GPtrArray *second,
+                                  gboolean override,
+                                  guint n_threads,
+                                  GError **error);
+
+
+/**
+ * modulemd_get_latest_streams:
+ * @index: (element-type utf8 ModulemdImprovedModule) (transfer none): A
+ * #GHashTable of #ModulemdImprovedModule objects indexed by module name, as
+ * returned by modulemd_index_from_file().
+ *
+ * Finds the latest version of every context of every stream in @index, as
+ * modulemd_improvedmodule_get_latest_streams() does for each module.
+ *
+ * Returns: (element-type ModulemdModuleStream) (transfer container): The
+ * latest module streams, ordered by module name, stream name, version and
+ * context. This array must be freed with g_ptr_array_unref().
+ *
+ * Since: 1.6
+ */
+GPtrArray *
+modulemd_get_latest_streams (GHashTable *index);
+
+
+/**
+ * modulemd_prune_index:
+ * @index: (element-type utf8 ModulemdImprovedModule) (transfer none): A
+ * #GHashTable of #ModulemdImprovedModule objects indexed by module name, as
+ * returned by modulemd_index_from_file().
+ * @n_versions: The number of versions of each stream to keep. Must be at
+ * least one.
+ *
+ * Removes all but the @n_versions newest versions of each stream in @index,
+ * as modulemd_improvedmodule_prune_versions() does for each module. The
+ * defaults and translations of the modules are not changed.
+ *
+ * Since: 1.6
+ */
+void
+modulemd_prune_index (GHashTable *index, guint n_versions);
+
+
+/**
+ * modulemd_prune_objects:
+ * @objects: (array zero-terminated=1) (element-type GObject): A #GPtrArray of
+ * modulemd-related objects.
+ * @n_versions: The number of versions of each stream to keep. Must be at
+ * least one.
+ *
+ * Removes the module streams of @objects that are older than the
+ * @n_versions newest version numbers of their module name and stream name.
+ * Every object with one of these versions is kept, whatever its context, as
+ * is every object that is not a module stream, so that the result can be
+ * passed straight to modulemd_dump() without reading it into an index first.
+ *
+ * Returns: (element-type GObject) (transfer container): The objects that are
+ * kept, in their original order. This array is newly-allocated and must be
+ * freed with g_ptr_array_unref().
+ *
+ * Since: 1.6
+ */
+GPtrArray *
+modulemd_prune_objects (const GPtrArray *objects, guint n_versions);
+
 G_END_DECLS
 
 #endif /* MODULEMD_H */
@@ -0,0 +1,55 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2017-2018 Stephen Gallagher
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+
+
+/*
+ * This header includes functions for the on-disk parse cache that should be
+ * considered internal to libmodulemd
+ */
+
+#pragma once
+
+#include "modulemd.h"
+
+G_BEGIN_DECLS
+
+/* Identifies the state of a source file when it was looked up, so that the
+ * result of parsing it can be stored afterwards
+ */
+typedef struct _modulemd_cache_key modulemd_cache_key;
+
+void
+modulemd_cache_key_free (modulemd_cache_key *key);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (modulemd_cache_key, modulemd_cache_key_free)
+
+
+gboolean
+modulemd_cache_enabled (void);
+
+
+/* Returns the payload stored for @path if the file has not changed since it
+ * was stored, or NULL. On a miss, @key is set if the result of parsing @path
+ * may be stored with modulemd_cache_store().
+ */
+GBytes *
+modulemd_cache_lookup (const gchar *path, modulemd_cache_key **key);
+
+
+/* Stores @payload for the file described by @key, unless the file has
+ * changed since the lookup. Failures are not fatal and are only logged.
+ */
+void
+modulemd_cache_store (modulemd_cache_key *key, GByteArray *payload);
+
+G_END_DECLS
@@ -0,0 +1,41 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2017-2018 Stephen Gallagher
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+
+
+/*
+ * This header includes functions for this object that should be considered
+ * internal to libmodulemd
+ */
+
+#pragma once
+
+#include "modulemd.h"
+#include <modulemd-filter.h>
+
+G_BEGIN_DECLS
+
+gboolean
+modulemd_filter_match_doctype (ModulemdFilter *self, GType doctype);
+
+gboolean
+modulemd_filter_match_module_name (ModulemdFilter *self,
+                                   const gchar *module_name);
+
+gboolean
+modulemd_filter_match_arch (ModulemdFilter *self, const gchar *arch);
+
+/* Whether subdocuments without a module name are skipped */
+gboolean
+modulemd_filter_requires_module_name (ModulemdFilter *self);
+
+G_END_DECLS
@@ -18,3 +18,25 @@
 
 GPtrArray *
 modulemd_improvedmodule_serialize (ModulemdImprovedModule *self);
+
+/* Like modulemd_improvedmodule_add_stream(), but takes ownership of @stream
+ * instead of copying it
+ */
+void
+modulemd_improvedmodule_take_stream (ModulemdImprovedModule *self,
+                                     ModulemdModuleStream *stream);
+
+/* Like modulemd_improvedmodule_get_stream_by_name(), but returns the stream
+ * stored in the module, which may be modified in place
+ */
+ModulemdModuleStream *
+modulemd_improvedmodule_peek_stream_by_name (ModulemdImprovedModule *self,
+                                             const gchar *stream_name);
+
+/* Returns the versions of the stream stored in the module, sorted by version
+ * and context, or NULL if there are none. They may be modified in place, as
+ * long as their version and context do not change.
+ */
+GPtrArray *
+modulemd_improvedmodule_peek_stream_versions (ModulemdImprovedModule *self,
+                                              const gchar *stream_name);
@@ -32,3 +32,50 @@ modulemd_module_new_from_modulestream (ModulemdModuleStream *stream);
 
 ModulemdModuleStream *
 modulemd_module_peek_modulestream (ModulemdModule *self);
+
+/* The xmd of a parsed stream is kept as the YAML events it was read from
+ * until it is first accessed, and emitted from them unchanged if it never is
+ */
+void
+modulemd_modulestream_set_xmd_events (ModulemdModuleStream *self,
+                                      GArray *events);
+
+/* Returns a new reference to the events, or NULL if the xmd has been read
+ * or replaced since the stream was parsed
+ */
+GArray *
+modulemd_modulestream_dup_xmd_events (ModulemdModuleStream *self);
+
+/* Gives the stream private copies of the sets it shares with its copies, so
+ * that callers of the deprecated ModulemdModule API may modify them.
+ */
+void
+modulemd_modulestream_unshare (ModulemdModuleStream *self);
+
+/* The public peek functions for the tables of a stream give it a private
+ * copy of a table it shares with its copies, since callers may modify it.
+ * These return the table without copying it, for readers inside the library
+ * that never modify it.
+ */
+GHashTable *
+modulemd_modulestream_peek_buildrequires_readonly (ModulemdModuleStream *self);
+
+GPtrArray *
+modulemd_modulestream_peek_dependencies_readonly (ModulemdModuleStream *self);
+
+GHashTable *
+modulemd_modulestream_peek_module_components_readonly (
+  ModulemdModuleStream *self);
+
+GHashTable *
+modulemd_modulestream_peek_profiles_readonly (ModulemdModuleStream *self);
+
+GHashTable *
+modulemd_modulestream_peek_requires_readonly (ModulemdModuleStream *self);
+
+GHashTable *
+modulemd_modulestream_peek_rpm_components_readonly (
+  ModulemdModuleStream *self);
+
+GHashTable *
+modulemd_modulestream_peek_servicelevels_readonly (ModulemdModuleStream *self);
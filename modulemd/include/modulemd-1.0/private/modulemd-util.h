@@ -49,31 +49,128 @@ _modulemd_ordered_int64_keys (GHashTable *htable);
 void
 modulemd_variant_unref (void *ptr);
 
+/* Whether a stream is selected by a list of streams of a module, as in the
+ * dependencies of a module stream
+ */
+gboolean
+_modulemd_stream_names_match (gchar **stream_names, const gchar *stream_name);
+
 gboolean
 modulemd_validate_nevra (const gchar *nevra);
 
 
+/* == Tracing == */
+
+/*
+ * Tracing is compiled in unless libmodulemd was configured with
+ * -Dtracing=false. When it is compiled in, whether debug messages for the
+ * library domain are enabled is looked up from G_MESSAGES_DEBUG the first time
+ * it is needed and cached, so that a disabled trace point costs a single
+ * branch and never formats its message.
+ */
+enum
+{
+  MMD_TRACE_STATE_UNKNOWN,
+  MMD_TRACE_STATE_OFF,
+  MMD_TRACE_STATE_ON
+};
+
+extern gint _modulemd_trace_state;
+
+gboolean
+modulemd_trace_enabled (void);
+
 typedef struct _modulemd_tracer
 {
-  gchar *function_name;
+  const gchar *function_name;
 } modulemd_tracer;
 
-modulemd_tracer *
-modulemd_trace_init (const gchar *function_name);
+void
+modulemd_trace_init (modulemd_tracer *tracer, const gchar *function_name);
 
 void
-modulemd_trace_free (modulemd_tracer *tracer);
+modulemd_trace_finish (modulemd_tracer *tracer);
+
+static inline void
+modulemd_trace_clear (modulemd_tracer *tracer)
+{
+  if (G_UNLIKELY (tracer->function_name != NULL))
+    modulemd_trace_finish (tracer);
+}
+
+G_DEFINE_AUTO_CLEANUP_CLEAR_FUNC (modulemd_tracer, modulemd_trace_clear);
 
-G_DEFINE_AUTOPTR_CLEANUP_FUNC (modulemd_tracer, modulemd_trace_free);
+#ifdef MMD_ENABLE_TRACING
+
+#define MMD_TRACE_ENABLED                                                     \
+  (G_UNLIKELY (g_atomic_int_get (&_modulemd_trace_state) !=                   \
+               MMD_TRACE_STATE_OFF) &&                                        \
+   modulemd_trace_enabled ())
+
+#define MMD_TRACE(...)                                                        \
+  do                                                                          \
+    {                                                                         \
+      if (MMD_TRACE_ENABLED)                                                  \
+        g_debug (__VA_ARGS__);                                                \
+    }                                                                         \
+  while (0)
 
 #define MODULEMD_INIT_TRACE                                                   \
-  g_autoptr (modulemd_tracer) tracer = modulemd_trace_init (__func__);        \
+  g_auto (modulemd_tracer) tracer = { NULL };                                 \
   do                                                                          \
     {                                                                         \
-      (void)(tracer);                                                         \
+      if (MMD_TRACE_ENABLED)                                                  \
+        modulemd_trace_init (&tracer, __func__);                              \
     }                                                                         \
   while (0);
 
+#else /* MMD_ENABLE_TRACING */
+
+#define MMD_TRACE_ENABLED FALSE
+
+#define MMD_TRACE(...)                                                        \
+  do                                                                          \
+    {                                                                         \
+    }                                                                         \
+  while (0)
+
+#define MODULEMD_INIT_TRACE
+
+#endif /* MMD_ENABLE_TRACING */
+
+
+/* == String Interning == */
+
+/*
+ * A string pool hands out shared, reference-counted copies (GRefString) of the
+ * strings passed to it, so that values repeated throughout an index (licenses,
+ * arches, stream names and so on) are only allocated once. Objects hold their
+ * own references, so the pool only needs to live while they are being built.
+ *
+ * modulemd_string_intern() uses the pool set as the thread default, or simply
+ * allocates a new GRefString if there is none. Either way, its result must be
+ * released with g_ref_string_release().
+ */
+typedef struct _modulemd_string_pool modulemd_string_pool;
+
+modulemd_string_pool *
+modulemd_string_pool_new (void);
+
+void
+modulemd_string_pool_free (modulemd_string_pool *pool);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (modulemd_string_pool,
+                               modulemd_string_pool_free);
+
+modulemd_string_pool *
+modulemd_string_pool_get_thread_default (void);
+
+modulemd_string_pool *
+modulemd_string_pool_set_thread_default (modulemd_string_pool *pool);
+
+gchar *
+modulemd_string_intern (const gchar *str);
+
 
 GPtrArray *
 _modulemd_index_serialize (GHashTable *index, GError **error);
@@ -87,6 +184,61 @@ GHashTable *
 module_index_from_data (GPtrArray *data, GError **error);
 
 
+/* == Merging Defaults == */
+
+/*
+ * The ModulemdDefaults objects for one module, in the order they are to be
+ * merged. Each one is merged into the result of the ones before it, and either
+ * overrides that result or is merged with it. Modules never affect each other,
+ * so modulemd_defaults_groups_merge() can merge many groups concurrently.
+ */
+typedef struct _modulemd_defaults_group
+{
+  gchar *module_name;
+
+  /* Elements of type modulemd_defaults_group_entry */
+  GArray *entries;
+
+  /* Set by modulemd_defaults_groups_merge() */
+  ModulemdDefaults *merged;
+  GError *error;
+  guint error_position;
+} modulemd_defaults_group;
+
+modulemd_defaults_group *
+modulemd_defaults_group_new (const gchar *module_name);
+
+void
+modulemd_defaults_group_free (modulemd_defaults_group *group);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (modulemd_defaults_group,
+                               modulemd_defaults_group_free);
+
+/*
+ * @position orders the entries of all of the groups, so that the error
+ * returned when several groups fail to merge doesn't depend on the order in
+ * which the threads ran.
+ */
+void
+modulemd_defaults_group_add (modulemd_defaults_group *group,
+                             ModulemdDefaults *defaults,
+                             gboolean override,
+                             guint position);
+
+gint
+modulemd_defaults_group_compare (gconstpointer a, gconstpointer b);
+
+/*
+ * Merges each of @groups on a pool of up to @n_threads threads, or one per
+ * processor if @n_threads is zero. If any of them fail, the error for the
+ * entry with the lowest position is returned.
+ */
+gboolean
+modulemd_defaults_groups_merge (GPtrArray *groups,
+                                guint n_threads,
+                                GError **error);
+
+
 G_END_DECLS
 
 #endif /* MODULEMD_UTIL_H */
@@ -17,6 +17,7 @@
 #include "modulemd.h"
 #include <glib.h>
 #include <yaml.h>
+#include "private/modulemd-util.h"
 
 G_BEGIN_DECLS
 
@@ -41,10 +42,129 @@ typedef gboolean (*ModulemdParsingFunc) (yaml_parser_t *parser,
                                          guint64 version,
                                          GError **error);
 
+
+/* == Buffered Event Replay == */
+
+/*
+ * A replay feeds a list of already-parsed events back through a
+ * yaml_parser_t, so that the regular parsing functions can consume a
+ * subdocument without having to re-emit and re-tokenize it. If preserve is
+ * TRUE, the events are copied out and remain available afterwards (for
+ * example to reconstruct the YAML of a failed subdocument).
+ */
+typedef struct _modulemd_yaml_replay
+{
+  GArray *events;
+  guint position;
+  gboolean preserve;
+} modulemd_yaml_replay;
+
+GArray *
+mmd_yaml_event_array_new (void);
+
+void
+mmd_yaml_event_array_take (GArray *events, yaml_event_t *event);
+
+int
+mmd_yaml_event_copy (yaml_event_t *dest, const yaml_event_t *src);
+
+void
+mmd_yaml_parser_set_input_replay (yaml_parser_t *parser,
+                                  modulemd_yaml_replay *replay);
+
+int
+mmd_yaml_parser_parse (yaml_parser_t *parser, yaml_event_t *event);
+
+/* Events can be stored in a compact binary form, so that a subdocument can
+ * be replayed later without tokenizing its YAML again. The form is private
+ * to this host and library version.
+ */
+void
+mmd_yaml_event_array_serialize (GArray *events, GByteArray *out);
+
+GArray *
+mmd_yaml_event_array_deserialize (const guint8 *data,
+                                  gsize length,
+                                  GError **error);
+
+/* Finds the byte offsets at which documents start in a complete YAML buffer,
+ * without tokenizing it, so that each part can be given to its own parser.
+ * The offsets are appended to @boundaries, a GArray of gsize, starting with
+ * zero. Returns FALSE if the buffer cannot be split safely, for instance if
+ * it uses directives or a marker-like line may belong to a block scalar.
+ */
+gboolean
+mmd_yaml_split_documents (const gchar *buffer,
+                          gsize length,
+                          GArray *boundaries);
+
+
+/* == Mapping Key Dispatch == */
+
+/*
+ * Every mapping key (and document type) known to any of the parsers. Scalars
+ * are classified once with mmd_yaml_key_lookup() so that the parsers can
+ * dispatch on an integer instead of comparing the scalar against each
+ * candidate string in turn.
+ */
+typedef enum
+{
+  MMD_YAML_KEY_UNKNOWN = 0,
+  MMD_YAML_KEY_API,
+  MMD_YAML_KEY_ARCH,
+  MMD_YAML_KEY_ARCHES,
+  MMD_YAML_KEY_ARTIFACTS,
+  MMD_YAML_KEY_BUILDOPTS,
+  MMD_YAML_KEY_BUILDORDER,
+  MMD_YAML_KEY_BUILDREQUIRES,
+  MMD_YAML_KEY_CACHE,
+  MMD_YAML_KEY_COMPONENTS,
+  MMD_YAML_KEY_CONTENT,
+  MMD_YAML_KEY_CONTEXT,
+  MMD_YAML_KEY_DATA,
+  MMD_YAML_KEY_DEPENDENCIES,
+  MMD_YAML_KEY_DESCRIPTION,
+  MMD_YAML_KEY_DOCUMENT,
+  MMD_YAML_KEY_EOL,
+  MMD_YAML_KEY_FILTER,
+  MMD_YAML_KEY_INTENTS,
+  MMD_YAML_KEY_LICENSE,
+  MMD_YAML_KEY_MACROS,
+  MMD_YAML_KEY_MODIFIED,
+  MMD_YAML_KEY_MODULE,
+  MMD_YAML_KEY_MODULEMD,
+  MMD_YAML_KEY_MODULEMD_DEFAULTS,
+  MMD_YAML_KEY_MODULEMD_TRANSLATIONS,
+  MMD_YAML_KEY_MODULES,
+  MMD_YAML_KEY_MULTILIB,
+  MMD_YAML_KEY_NAME,
+  MMD_YAML_KEY_PROFILES,
+  MMD_YAML_KEY_RATIONALE,
+  MMD_YAML_KEY_REF,
+  MMD_YAML_KEY_REFERENCES,
+  MMD_YAML_KEY_REPOSITORY,
+  MMD_YAML_KEY_REQUIRES,
+  MMD_YAML_KEY_RPMS,
+  MMD_YAML_KEY_SERVICELEVELS,
+  MMD_YAML_KEY_STREAM,
+  MMD_YAML_KEY_SUMMARY,
+  MMD_YAML_KEY_TRANSLATIONS,
+  MMD_YAML_KEY_VERSION,
+  MMD_YAML_KEY_WHITELIST,
+  MMD_YAML_KEY_XMD
+} ModulemdYamlKey;
+
+ModulemdYamlKey
+mmd_yaml_key_lookup (const gchar *key, gsize length);
+
+#define MMD_YAML_EVENT_KEY(_event)                                            \
+  mmd_yaml_key_lookup ((const gchar *)(_event).data.scalar.value,             \
+                       (_event).data.scalar.length)
+
 #define YAML_PARSER_PARSE_WITH_ERROR_RETURN(parser, event, _error, msg)       \
   do                                                                          \
     {                                                                         \
-      if (!yaml_parser_parse (parser, event))                                 \
+      if (!mmd_yaml_parser_parse (parser, event))                             \
         {                                                                     \
           g_debug (msg);                                                      \
           g_set_error_literal (_error,                                        \
@@ -54,14 +174,15 @@ typedef gboolean (*ModulemdParsingFunc) (yaml_parser_t *parser,
           result = FALSE;                                                     \
           goto error;                                                         \
         }                                                                     \
-      g_debug ("Parser event: %s", mmd_yaml_get_event_name ((event)->type));  \
+      MMD_TRACE ("Parser event: %s",                                          \
+                 mmd_yaml_get_event_name ((event)->type));                    \
     }                                                                         \
   while (0)
 
 #define YAML_PARSER_PARSE_WITH_EXIT(parser, event, _error)                    \
   do                                                                          \
     {                                                                         \
-      if (!yaml_parser_parse (parser, event))                                 \
+      if (!mmd_yaml_parser_parse (parser, event))                             \
         {                                                                     \
           g_debug ("Parser error");                                           \
           g_set_error_literal (_error,                                        \
@@ -70,7 +191,8 @@ typedef gboolean (*ModulemdParsingFunc) (yaml_parser_t *parser,
                                "Parser error");                               \
           return FALSE;                                                       \
         }                                                                     \
-      g_debug ("Parser event: %s", mmd_yaml_get_event_name ((event)->type));  \
+      MMD_TRACE ("Parser event: %s",                                          \
+                 mmd_yaml_get_event_name ((event)->type));                    \
     }                                                                         \
   while (0)
 
@@ -117,14 +239,16 @@ typedef gboolean (*ModulemdParsingFunc) (yaml_parser_t *parser,
           result = FALSE;                                                     \
           goto error;                                                         \
         }                                                                     \
-      g_debug ("Emitter event: %s", mmd_yaml_get_event_name ((event)->type)); \
+      MMD_TRACE ("Emitter event: %s",                                         \
+                 mmd_yaml_get_event_name ((event)->type));                    \
     }                                                                         \
   while (0)
 
 #define MMD_EMIT_WITH_EXIT(emitter, event, _error, ...)                       \
   do                                                                          \
     {                                                                         \
-      g_debug ("Emitter event: %s", mmd_yaml_get_event_name ((event)->type)); \
+      MMD_TRACE ("Emitter event: %s",                                         \
+                 mmd_yaml_get_event_name ((event)->type));                    \
       if (!yaml_emitter_emit (emitter, event))                                \
         {                                                                     \
           g_debug (__VA_ARGS__);                                              \
@@ -276,17 +400,74 @@ parse_yaml_file (const gchar *path,
                  GPtrArray **failures,
                  GError **error);
 
+gboolean
+parse_yaml_file_filtered (const gchar *path,
+                          ModulemdFilter *filter,
+                          GPtrArray **data,
+                          GPtrArray **failures,
+                          GError **error);
+
+gboolean
+parse_yaml_file_foreach (const gchar *path,
+                         ModulemdForeachFunc callback,
+                         gpointer user_data,
+                         GError **error);
+
 GHashTable *
 parse_module_index_from_file (const gchar *path,
                               GPtrArray **failures,
                               GError **error);
 
+GHashTable *
+parse_module_index_from_file_parallel (const gchar *path,
+                                       guint n_threads,
+                                       GPtrArray **failures,
+                                       GError **error);
+
+GHashTable *
+parse_module_index_from_files (const gchar **paths,
+                               guint n_threads,
+                               GPtrArray **failures,
+                               GError **error);
+
+GHashTable *
+parse_module_index_from_file_filtered (const gchar *path,
+                                       ModulemdFilter *filter,
+                                       GPtrArray **failures,
+                                       GError **error);
+
 gboolean
 parse_yaml_string (const gchar *yaml,
                    GPtrArray **data,
                    GPtrArray **failures,
                    GError **error);
 
+gboolean
+parse_yaml_string_len (const gchar *yaml,
+                       gsize length,
+                       GPtrArray **data,
+                       GPtrArray **failures,
+                       GError **error);
+
+gboolean
+parse_yaml_string_filtered (const gchar *yaml,
+                            ModulemdFilter *filter,
+                            GPtrArray **data,
+                            GPtrArray **failures,
+                            GError **error);
+
+/* Parses @yaml, appending a record of the events of each subdocument to
+ * @records. Fails if any subdocument could not be parsed.
+ */
+gboolean
+parse_yaml_string_records (const gchar *yaml,
+                           GByteArray *records,
+                           GError **error);
+
+/* Parses records written by parse_yaml_string_records() */
+gboolean
+parse_yaml_records (GBytes *records, GPtrArray **data, GError **error);
+
 GHashTable *
 parse_module_index_from_string (const gchar *yaml,
                                 GPtrArray **failures,
@@ -298,6 +479,15 @@ parse_yaml_stream (FILE *stream,
                    GPtrArray **failures,
                    GError **error);
 
+/* Reads are made with @cancellable, which is also checked between
+ * subdocuments if it has been pushed with g_cancellable_push_current()
+ */
+GHashTable *
+parse_module_index_from_input_stream (GInputStream *stream,
+                                      GCancellable *cancellable,
+                                      GPtrArray **failures,
+                                      GError **error);
+
 GHashTable *
 parse_module_index_from_stream (FILE *iostream,
                                 GPtrArray **failures,
@@ -368,6 +558,12 @@ _hashtable_from_mapping (yaml_parser_t *parser,
 gboolean
 _parse_skip (yaml_parser_t *parser, GError **error);
 
+/* Converts the events of an xmd mapping, as kept by the modulemd parser,
+ * into the hash table returned by modulemd_modulestream_peek_xmd()
+ */
+GHashTable *
+parse_xmd_events (GArray *events, GError **error);
+
 
 gboolean
 _emit_modulemd_simpleset (yaml_emitter_t *emitter,
@@ -394,6 +590,16 @@ _parse_module_stream (yaml_parser_t *parser,
                       guint64 version,
                       GError **error);
 
+/* Like _parse_module_stream(), but only the optional sections included in
+ * the ModulemdSection bitmask are parsed
+ */
+gboolean
+_parse_module_stream_sections (yaml_parser_t *parser,
+                               GObject **object,
+                               guint64 version,
+                               guint sections,
+                               GError **error);
+
 /* == ModulemdDefaults Parser == */
 gboolean
 _parse_defaults (yaml_parser_t *parser,
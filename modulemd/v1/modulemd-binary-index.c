@@ -0,0 +1,437 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2017-2018 Stephen Gallagher
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+
+#include "modulemd.h"
+#include "modulemd-binary-index.h"
+#include <string.h>
+#include "private/modulemd-improvedmodule-private.h"
+#include "private/modulemd-util.h"
+#include "private/modulemd-yaml.h"
+
+
+/* A binary index file starts with this header. It is followed by the name of
+ * each module and the records of its subdocuments, as written by
+ * parse_yaml_string_records(), and then by a table with one entry for each
+ * module, sorted by name. All offsets are from the start of the file and all
+ * values are in host byte order.
+ */
+#define MMD_BINARY_INDEX_MAGIC "MMDINDEX"
+#define MMD_BINARY_INDEX_FORMAT 1
+#define MMD_BINARY_INDEX_BYTE_ORDER 0x01020304
+
+typedef struct _modulemd_binary_index_header
+{
+  gchar magic[8];
+  guint32 format;
+  guint32 byte_order;
+  guint64 n_modules;
+  guint64 table_offset;
+} modulemd_binary_index_header;
+
+typedef struct _modulemd_binary_index_entry
+{
+  guint64 name_offset;
+  guint64 name_length;
+  guint64 records_offset;
+  guint64 records_length;
+} modulemd_binary_index_entry;
+
+G_STATIC_ASSERT (sizeof (modulemd_binary_index_header) == 32);
+G_STATIC_ASSERT (sizeof (modulemd_binary_index_entry) == 32);
+
+
+struct _ModulemdBinaryIndex
+{
+  GObject parent_instance;
+
+  GBytes *contents;
+
+  /* Points into the contents, which are kept aligned for it */
+  const modulemd_binary_index_entry *table;
+  guint64 n_modules;
+};
+
+G_DEFINE_TYPE (ModulemdBinaryIndex, modulemd_binary_index, G_TYPE_OBJECT)
+
+
+static void
+modulemd_binary_index_finalize (GObject *object)
+{
+  ModulemdBinaryIndex *self = (ModulemdBinaryIndex *)object;
+
+  g_clear_pointer (&self->contents, g_bytes_unref);
+
+  G_OBJECT_CLASS (modulemd_binary_index_parent_class)->finalize (object);
+}
+
+
+static void
+modulemd_binary_index_class_init (ModulemdBinaryIndexClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = modulemd_binary_index_finalize;
+}
+
+
+static void
+modulemd_binary_index_init (ModulemdBinaryIndex *self)
+{
+}
+
+
+static void
+_pad_to_alignment (GByteArray *contents)
+{
+  static const guint8 padding[8] = { 0 };
+
+  if (contents->len % 8)
+    g_byte_array_append (contents, padding, 8 - contents->len % 8);
+}
+
+
+gboolean
+modulemd_dump_index_binary (GHashTable *index,
+                            const gchar *path,
+                            GError **error)
+{
+  g_autoptr (GByteArray) contents = NULL;
+  g_autoptr (GArray) table = NULL;
+  g_autoptr (GPtrArray) keys = NULL;
+  g_autoptr (GPtrArray) objects = NULL;
+  g_autofree gchar *yaml = NULL;
+  modulemd_binary_index_header header = { { 0 } };
+  modulemd_binary_index_entry entry;
+  gpointer module = NULL;
+  const gchar *name = NULL;
+
+  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  if (!index || !path)
+    {
+      g_set_error_literal (error,
+                           MODULEMD_ERROR,
+                           MODULEMD_ERROR_PROGRAMMING,
+                           "Index or path not supplied.");
+      return FALSE;
+    }
+
+  keys = _modulemd_ordered_str_keys (index, _modulemd_strcmp_sort);
+  table = g_array_sized_new (
+    FALSE, FALSE, sizeof (modulemd_binary_index_entry), keys->len);
+
+  /* The header is filled in once the table has been placed */
+  contents = g_byte_array_new ();
+  g_byte_array_append (contents, (const guint8 *)&header, sizeof (header));
+
+  for (gsize i = 0; i < keys->len; i++)
+    {
+      name = g_ptr_array_index (keys, i);
+      module = g_hash_table_lookup (index, name);
+      if (!module || !MODULEMD_IS_IMPROVEDMODULE (module))
+        {
+          g_set_error_literal (
+            error,
+            MODULEMD_ERROR,
+            MODULEMD_ERROR_PROGRAMMING,
+            "Index value was not a ModulemdImprovedModule.");
+          return FALSE;
+        }
+
+      entry.name_offset = contents->len;
+      entry.name_length = strlen (name);
+      g_byte_array_append (
+        contents, (const guint8 *)name, entry.name_length + 1);
+
+      /* Each module is stored as the events of its YAML subdocuments, so
+       * that it can be read back by the same parsers
+       */
+      objects =
+        modulemd_improvedmodule_serialize (MODULEMD_IMPROVEDMODULE (module));
+      if (!emit_yaml_string (objects, &yaml, error))
+        return FALSE;
+
+      entry.records_offset = contents->len;
+      if (!parse_yaml_string_records (yaml, contents, error))
+        return FALSE;
+      entry.records_length = contents->len - entry.records_offset;
+
+      g_array_append_val (table, entry);
+      g_clear_pointer (&objects, g_ptr_array_unref);
+      g_clear_pointer (&yaml, g_free);
+      _pad_to_alignment (contents);
+    }
+
+  memcpy (header.magic, MMD_BINARY_INDEX_MAGIC, sizeof (header.magic));
+  header.format = MMD_BINARY_INDEX_FORMAT;
+  header.byte_order = MMD_BINARY_INDEX_BYTE_ORDER;
+  header.n_modules = table->len;
+  header.table_offset = contents->len;
+  memcpy (contents->data, &header, sizeof (header));
+
+  g_byte_array_append (contents,
+                       (const guint8 *)table->data,
+                       table->len * sizeof (modulemd_binary_index_entry));
+
+  /* This writes a temporary file and renames it into place */
+  return g_file_set_contents (
+    path, (const gchar *)contents->data, contents->len, error);
+}
+
+
+ModulemdBinaryIndex *
+modulemd_binary_index_new_from_file (const gchar *path, GError **error)
+{
+  g_autoptr (ModulemdBinaryIndex) self = NULL;
+  g_autoptr (GMappedFile) mapped_file = NULL;
+  g_autoptr (GError) nested_error = NULL;
+  modulemd_binary_index_header header;
+  const guint8 *data = NULL;
+  gsize length = 0;
+
+  g_return_val_if_fail (path, NULL);
+
+  mapped_file = g_mapped_file_new (path, FALSE, &nested_error);
+  if (!mapped_file)
+    {
+      g_set_error (error,
+                   MODULEMD_YAML_ERROR,
+                   MODULEMD_YAML_ERROR_OPEN,
+                   "Failed to open file: %s",
+                   nested_error->message);
+      return NULL;
+    }
+
+  self = g_object_new (MODULEMD_TYPE_BINARY_INDEX, NULL);
+  self->contents = g_mapped_file_get_bytes (mapped_file);
+  data = g_bytes_get_data (self->contents, &length);
+
+  if (length < sizeof (header))
+    goto unsupported;
+
+  memcpy (&header, data, sizeof (header));
+  if (memcmp (header.magic, MMD_BINARY_INDEX_MAGIC, sizeof (header.magic)) ||
+      header.format != MMD_BINARY_INDEX_FORMAT ||
+      header.byte_order != MMD_BINARY_INDEX_BYTE_ORDER)
+    {
+      goto unsupported;
+    }
+
+  /* Only the table is checked here. The entries are checked as they are
+   * used, so that opening the file doesn't touch all of it.
+   */
+  if (header.table_offset % 8 || header.table_offset > length ||
+      header.n_modules > (length - header.table_offset) /
+                           sizeof (modulemd_binary_index_entry))
+    {
+      goto unsupported;
+    }
+
+  self->table = (const modulemd_binary_index_entry *)(data +
+                                                       header.table_offset);
+  self->n_modules = header.n_modules;
+
+  return g_steal_pointer (&self);
+
+unsupported:
+  g_set_error (error,
+               MODULEMD_YAML_ERROR,
+               MODULEMD_YAML_ERROR_PARSE,
+               "%s is not a binary index in a supported format",
+               path);
+  return NULL;
+}
+
+
+guint64
+modulemd_binary_index_get_n_modules (ModulemdBinaryIndex *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_BINARY_INDEX (self), 0);
+
+  return self->n_modules;
+}
+
+
+/* Returns the name of an entry, or NULL if it lies outside of the file */
+static const gchar *
+_entry_peek_name (ModulemdBinaryIndex *self,
+                  const modulemd_binary_index_entry *entry)
+{
+  gsize length = 0;
+  const gchar *data = g_bytes_get_data (self->contents, &length);
+
+  if (entry->name_offset > length ||
+      entry->name_length >= length - entry->name_offset ||
+      data[entry->name_offset + entry->name_length] != '\0')
+    {
+      return NULL;
+    }
+
+  return data + entry->name_offset;
+}
+
+
+GPtrArray *
+modulemd_binary_index_get_module_names (ModulemdBinaryIndex *self)
+{
+  g_autoptr (GPtrArray) names = NULL;
+  const gchar *name = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_BINARY_INDEX (self), NULL);
+
+  names = g_ptr_array_new_full (self->n_modules, g_free);
+  for (guint64 i = 0; i < self->n_modules; i++)
+    {
+      name = _entry_peek_name (self, &self->table[i]);
+      if (name)
+        g_ptr_array_add (names, g_strdup (name));
+    }
+
+  return g_steal_pointer (&names);
+}
+
+
+static const modulemd_binary_index_entry *
+_find_entry (ModulemdBinaryIndex *self, const gchar *module_name)
+{
+  const modulemd_binary_index_entry *entry = NULL;
+  const gchar *name = NULL;
+  guint64 low = 0;
+  guint64 high = self->n_modules;
+  guint64 middle = 0;
+  gint cmp = 0;
+
+  while (low < high)
+    {
+      middle = low + (high - low) / 2;
+      entry = &self->table[middle];
+
+      name = _entry_peek_name (self, entry);
+      if (!name)
+        return NULL;
+
+      cmp = g_strcmp0 (module_name, name);
+      if (cmp == 0)
+        return entry;
+      else if (cmp < 0)
+        high = middle;
+      else
+        low = middle + 1;
+    }
+
+  return NULL;
+}
+
+
+static gboolean
+_read_entry (ModulemdBinaryIndex *self,
+             const modulemd_binary_index_entry *entry,
+             GPtrArray *objects,
+             GError **error)
+{
+  g_autoptr (GBytes) records = NULL;
+  g_autoptr (GPtrArray) data = NULL;
+  gsize length = g_bytes_get_size (self->contents);
+
+  if (entry->records_offset > length ||
+      entry->records_length > length - entry->records_offset)
+    {
+      g_set_error_literal (error,
+                           MODULEMD_YAML_ERROR,
+                           MODULEMD_YAML_ERROR_PARSE,
+                           "Binary index entry is out of bounds");
+      return FALSE;
+    }
+
+  records = g_bytes_new_from_bytes (
+    self->contents, entry->records_offset, entry->records_length);
+  if (!parse_yaml_records (records, &data, error))
+    return FALSE;
+
+  for (gsize i = 0; i < data->len; i++)
+    g_ptr_array_add (objects, g_object_ref (g_ptr_array_index (data, i)));
+
+  return TRUE;
+}
+
+
+ModulemdImprovedModule *
+modulemd_binary_index_get_module (ModulemdBinaryIndex *self,
+                                  const gchar *module_name,
+                                  GError **error)
+{
+  const modulemd_binary_index_entry *entry = NULL;
+  g_autoptr (GPtrArray) objects = NULL;
+  g_autoptr (GHashTable) index = NULL;
+  ModulemdImprovedModule *module = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_BINARY_INDEX (self), NULL);
+  g_return_val_if_fail (module_name, NULL);
+
+  entry = _find_entry (self, module_name);
+  if (!entry)
+    return NULL;
+
+  objects = g_ptr_array_new_with_free_func (g_object_unref);
+  if (!_read_entry (self, entry, objects, error))
+    return NULL;
+
+  index = module_index_from_data (objects, error);
+  if (!index)
+    return NULL;
+
+  module = g_hash_table_lookup (index, module_name);
+  return module ? g_object_ref (module) : NULL;
+}
+
+
+GHashTable *
+modulemd_binary_index_to_index (ModulemdBinaryIndex *self, GError **error)
+{
+  g_autoptr (GPtrArray) objects = NULL;
+  g_autoptr (modulemd_string_pool) strings = NULL;
+  modulemd_string_pool *previous_strings = NULL;
+  GHashTable *index = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_BINARY_INDEX (self), NULL);
+
+  /* As when reading YAML, the whole index shares one string pool */
+  strings = modulemd_string_pool_new ();
+  previous_strings = modulemd_string_pool_set_thread_default (strings);
+
+  objects = g_ptr_array_new_with_free_func (g_object_unref);
+  for (guint64 i = 0; i < self->n_modules; i++)
+    {
+      if (!_read_entry (self, &self->table[i], objects, error))
+        goto error;
+    }
+
+  index = module_index_from_data (objects, error);
+
+error:
+  modulemd_string_pool_set_thread_default (previous_strings);
+  return index;
+}
+
+
+GHashTable *
+modulemd_index_from_binary_file (const gchar *path, GError **error)
+{
+  g_autoptr (ModulemdBinaryIndex) binary_index = NULL;
+
+  binary_index = modulemd_binary_index_new_from_file (path, error);
+  if (!binary_index)
+    return NULL;
+
+  return modulemd_binary_index_to_index (binary_index, error);
+}
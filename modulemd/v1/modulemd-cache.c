@@ -0,0 +1,329 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2017-2018 Stephen Gallagher
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+
+/* Needed for the nanosecond modification times of struct stat */
+#define _POSIX_C_SOURCE 200809L
+
+#include "config.h"
+#include "modulemd.h"
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <errno.h>
+#include <string.h>
+#include "private/modulemd-cache.h"
+#include "private/modulemd-util.h"
+
+
+/* Each cache file holds the result of parsing one source file. It starts with
+ * this header, describing the source file as it was when the cache file was
+ * written, followed by the payload. Cache files are always replaced as a whole
+ * by renaming a new file over them, so other processes either see the old
+ * contents or the new ones.
+ */
+#define MMD_CACHE_MAGIC "MMDCACHE"
+#define MMD_CACHE_FORMAT 1
+#define MMD_CACHE_BYTE_ORDER 0x01020304
+#define MMD_CACHE_SUFFIX ".mmdcache"
+
+typedef struct _modulemd_cache_header
+{
+  gchar magic[8];
+  guint32 format;
+  guint32 byte_order;
+
+  guint64 device;
+  guint64 inode;
+  guint64 size;
+  gint64 mtime;
+  gint64 mtime_nsec;
+
+  guint8 checksum[32];
+} modulemd_cache_header;
+
+G_STATIC_ASSERT (sizeof (modulemd_cache_header) == 88);
+
+struct _modulemd_cache_key
+{
+  gchar *path;
+  gchar *cache_path;
+  modulemd_cache_header header;
+};
+
+G_LOCK_DEFINE_STATIC (cache_dir);
+static gchar *cache_dir = NULL;
+
+
+void
+modulemd_set_cache_dir (const gchar *path)
+{
+  G_LOCK (cache_dir);
+  g_clear_pointer (&cache_dir, g_free);
+  cache_dir = g_strdup (path);
+  G_UNLOCK (cache_dir);
+}
+
+
+gchar *
+modulemd_get_cache_dir (void)
+{
+  gchar *path = NULL;
+
+  G_LOCK (cache_dir);
+  path = g_strdup (cache_dir);
+  G_UNLOCK (cache_dir);
+
+  return path;
+}
+
+
+gboolean
+modulemd_cache_enabled (void)
+{
+  gboolean enabled = FALSE;
+
+  G_LOCK (cache_dir);
+  enabled = (cache_dir != NULL);
+  G_UNLOCK (cache_dir);
+
+  return enabled;
+}
+
+
+void
+modulemd_cache_key_free (modulemd_cache_key *key)
+{
+  if (key == NULL)
+    return;
+
+  g_clear_pointer (&key->path, g_free);
+  g_clear_pointer (&key->cache_path, g_free);
+  g_free (key);
+}
+
+
+static gboolean
+_modulemd_cache_stat (const gchar *path, modulemd_cache_header *header)
+{
+  GStatBuf buf;
+
+  if (g_stat (path, &buf) != 0)
+    return FALSE;
+
+  header->device = buf.st_dev;
+  header->inode = buf.st_ino;
+  header->size = buf.st_size;
+  header->mtime = buf.st_mtime;
+#ifdef HAVE_STRUCT_STAT_ST_MTIM
+  header->mtime_nsec = buf.st_mtim.tv_nsec;
+#else
+  header->mtime_nsec = 0;
+#endif
+
+  return TRUE;
+}
+
+
+static gboolean
+_modulemd_cache_stat_equal (const modulemd_cache_header *a,
+                            const modulemd_cache_header *b)
+{
+  return a->device == b->device && a->inode == b->inode &&
+         a->size == b->size && a->mtime == b->mtime &&
+         a->mtime_nsec == b->mtime_nsec;
+}
+
+
+static gboolean
+_modulemd_cache_checksum (const gchar *path, modulemd_cache_header *header)
+{
+  g_autoptr (GMappedFile) mapped_file = NULL;
+  g_autoptr (GChecksum) checksum = NULL;
+  gsize length = sizeof (header->checksum);
+
+  mapped_file = g_mapped_file_new (path, FALSE, NULL);
+  if (!mapped_file)
+    return FALSE;
+
+  checksum = g_checksum_new (G_CHECKSUM_SHA256);
+
+  /* Empty files are mapped with NULL contents */
+  if (g_mapped_file_get_length (mapped_file) > 0)
+    {
+      g_checksum_update (
+        checksum,
+        (const guchar *)g_mapped_file_get_contents (mapped_file),
+        g_mapped_file_get_length (mapped_file));
+    }
+
+  g_checksum_get_digest (checksum, header->checksum, &length);
+  return TRUE;
+}
+
+
+static gboolean
+_modulemd_cache_write (const gchar *cache_path,
+                       const modulemd_cache_header *header,
+                       const guint8 *payload,
+                       gsize length)
+{
+  g_autoptr (GByteArray) contents = NULL;
+  g_autofree gchar *dir = NULL;
+  g_autoptr (GError) error = NULL;
+
+  dir = g_path_get_dirname (cache_path);
+  if (g_mkdir_with_parents (dir, 0755) != 0)
+    {
+      g_debug ("Could not create cache directory %s: %s",
+               dir,
+               g_strerror (errno));
+      return FALSE;
+    }
+
+  contents = g_byte_array_sized_new (sizeof (*header) + length);
+  g_byte_array_append (contents, (const guint8 *)header, sizeof (*header));
+  g_byte_array_append (contents, payload, length);
+
+  /* This writes a temporary file and renames it into place */
+  if (!g_file_set_contents (cache_path,
+                            (const gchar *)contents->data,
+                            contents->len,
+                            &error))
+    {
+      g_debug (
+        "Could not write cache file %s: %s", cache_path, error->message);
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+GBytes *
+modulemd_cache_lookup (const gchar *path, modulemd_cache_key **key)
+{
+  g_autoptr (modulemd_cache_key) new_key = NULL;
+  g_autoptr (GMappedFile) mapped_file = NULL;
+  g_autoptr (GBytes) contents = NULL;
+  GBytes *payload = NULL;
+  g_autofree gchar *dir = NULL;
+  g_autofree gchar *canonical_path = NULL;
+  g_autofree gchar *name = NULL;
+  modulemd_cache_header stored;
+  gboolean have_stored = FALSE;
+  gsize length = 0;
+
+  MMD_TRACE ("TRACE: entering modulemd_cache_lookup");
+
+  *key = NULL;
+
+  dir = modulemd_get_cache_dir ();
+  if (!dir)
+    return NULL;
+
+  new_key = g_new0 (modulemd_cache_key, 1);
+  memcpy (new_key->header.magic, MMD_CACHE_MAGIC, 8);
+  new_key->header.format = MMD_CACHE_FORMAT;
+  new_key->header.byte_order = MMD_CACHE_BYTE_ORDER;
+
+  if (!_modulemd_cache_stat (path, &new_key->header))
+    return NULL;
+
+  /* Cache files are named after the absolute path of their source file */
+  canonical_path = g_canonicalize_filename (path, NULL);
+  name =
+    g_compute_checksum_for_string (G_CHECKSUM_SHA256, canonical_path, -1);
+  new_key->path = g_strdup (path);
+  new_key->cache_path =
+    g_strconcat (dir, G_DIR_SEPARATOR_S, name, MMD_CACHE_SUFFIX, NULL);
+
+  mapped_file = g_mapped_file_new (new_key->cache_path, FALSE, NULL);
+  if (mapped_file)
+    {
+      length = g_mapped_file_get_length (mapped_file);
+      if (length >= sizeof (stored))
+        {
+          memcpy (&stored,
+                  g_mapped_file_get_contents (mapped_file),
+                  sizeof (stored));
+
+          /* Files from another version or another host are ignored */
+          have_stored = stored.format == MMD_CACHE_FORMAT &&
+                        stored.byte_order == MMD_CACHE_BYTE_ORDER &&
+                        !memcmp (stored.magic, MMD_CACHE_MAGIC, 8);
+        }
+    }
+
+  if (have_stored)
+    {
+      contents = g_mapped_file_get_bytes (mapped_file);
+
+      if (_modulemd_cache_stat_equal (&stored, &new_key->header))
+        {
+          MMD_TRACE ("TRACE: exiting modulemd_cache_lookup");
+          return g_bytes_new_from_bytes (
+            contents, sizeof (stored), length - sizeof (stored));
+        }
+    }
+
+  /* The file was replaced or touched, so fall back to its contents */
+  if (!_modulemd_cache_checksum (path, &new_key->header))
+    return NULL;
+
+  if (have_stored && memcmp (stored.checksum,
+                             new_key->header.checksum,
+                             sizeof (stored.checksum)) == 0)
+    {
+      payload = g_bytes_new_from_bytes (
+        contents, sizeof (stored), length - sizeof (stored));
+
+      /* Record the new state of the file, so that the checksum doesn't have
+       * to be computed again next time
+       */
+      _modulemd_cache_write (new_key->cache_path,
+                             &new_key->header,
+                             g_bytes_get_data (payload, NULL),
+                             g_bytes_get_size (payload));
+
+      MMD_TRACE ("TRACE: exiting modulemd_cache_lookup");
+      return payload;
+    }
+
+  *key = g_steal_pointer (&new_key);
+
+  MMD_TRACE ("TRACE: exiting modulemd_cache_lookup");
+  return NULL;
+}
+
+
+void
+modulemd_cache_store (modulemd_cache_key *key, GByteArray *payload)
+{
+  modulemd_cache_header current;
+
+  MMD_TRACE ("TRACE: entering modulemd_cache_store");
+
+  /* If the file changed while it was being parsed, the payload may not match
+   * the checksum taken before
+   */
+  if (!_modulemd_cache_stat (key->path, &current) ||
+      !_modulemd_cache_stat_equal (&current, &key->header))
+    {
+      g_debug ("Not caching %s, which changed while being parsed", key->path);
+      return;
+    }
+
+  _modulemd_cache_write (
+    key->cache_path, &key->header, payload->data, payload->len);
+
+  MMD_TRACE ("TRACE: exiting modulemd_cache_store");
+}
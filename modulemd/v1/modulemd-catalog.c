@@ -0,0 +1,718 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2017-2018 Stephen Gallagher
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+
+#include "modulemd.h"
+#include "modulemd-catalog.h"
+#include <inttypes.h>
+#include <string.h>
+#include <yaml.h>
+#include "private/modulemd-util.h"
+#include "private/modulemd-yaml.h"
+
+
+/* Everything recorded about a single subdocument while scanning */
+typedef struct _modulemd_catalog_entry
+{
+  GType doctype;
+  guint64 mdversion;
+
+  gchar *name;
+  gchar *stream;
+  guint64 version;
+  gchar *context;
+
+  /* Location of the subdocument in the input, in bytes */
+  gsize offset;
+  gsize length;
+} modulemd_catalog_entry;
+
+
+/* libyaml reports positions in characters, so they have to be converted to
+ * byte offsets by walking the UTF-8 input. Documents are reported in order,
+ * so a single cursor makes this linear over the whole input.
+ */
+typedef struct _modulemd_catalog_cursor
+{
+  const gchar *data;
+  gsize size;
+  gsize char_index;
+  gsize byte_offset;
+} modulemd_catalog_cursor;
+
+
+struct _ModulemdCatalog
+{
+  GObject parent_instance;
+
+  /* The complete input, kept so subdocuments can be parsed on request */
+  GBytes *input;
+
+  /* All subdocuments, in input order */
+  GPtrArray *entries;
+
+  /* modulemd_catalog_entry (borrowed), indexed by NSVC */
+  GHashTable *by_nsvc;
+
+  /* GPtrArray of modulemd_catalog_entry (borrowed), indexed by module name */
+  GHashTable *by_name;
+};
+
+G_DEFINE_TYPE (ModulemdCatalog, modulemd_catalog, G_TYPE_OBJECT)
+
+
+static void
+modulemd_catalog_entry_free (modulemd_catalog_entry *entry)
+{
+  g_clear_pointer (&entry->name, g_free);
+  g_clear_pointer (&entry->stream, g_free);
+  g_clear_pointer (&entry->context, g_free);
+  g_free (entry);
+}
+
+
+static void
+modulemd_catalog_finalize (GObject *object)
+{
+  ModulemdCatalog *self = (ModulemdCatalog *)object;
+
+  g_clear_pointer (&self->by_nsvc, g_hash_table_unref);
+  g_clear_pointer (&self->by_name, g_hash_table_unref);
+  g_clear_pointer (&self->entries, g_ptr_array_unref);
+  g_clear_pointer (&self->input, g_bytes_unref);
+
+  G_OBJECT_CLASS (modulemd_catalog_parent_class)->finalize (object);
+}
+
+
+static void
+modulemd_catalog_class_init (ModulemdCatalogClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = modulemd_catalog_finalize;
+}
+
+
+static void
+modulemd_catalog_init (ModulemdCatalog *self)
+{
+  self->entries = g_ptr_array_new_with_free_func (
+    (GDestroyNotify)modulemd_catalog_entry_free);
+  self->by_nsvc =
+    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  self->by_name = g_hash_table_new_full (
+    g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_ptr_array_unref);
+}
+
+
+static gsize
+_catalog_cursor_seek (modulemd_catalog_cursor *cursor, gsize char_index)
+{
+  while (cursor->char_index < char_index && cursor->byte_offset < cursor->size)
+    {
+      cursor->byte_offset =
+        g_utf8_next_char (cursor->data + cursor->byte_offset) - cursor->data;
+      cursor->char_index++;
+    }
+
+  return MIN (cursor->byte_offset, cursor->size);
+}
+
+
+/* Consume the remainder of a value whose first event has already been read */
+static gboolean
+_catalog_skip (yaml_parser_t *parser,
+               const yaml_event_t *first,
+               GError **error)
+{
+  gboolean result = FALSE;
+  gsize depth = 0;
+  MMD_INIT_YAML_EVENT (event);
+
+  if (first->type != YAML_MAPPING_START_EVENT &&
+      first->type != YAML_SEQUENCE_START_EVENT)
+    {
+      /* Scalars and aliases are a single event */
+      return TRUE;
+    }
+
+  depth = 1;
+  while (depth > 0)
+    {
+      YAML_PARSER_PARSE_WITH_ERROR_RETURN (
+        parser, &event, error, "Parser error");
+
+      switch (event.type)
+        {
+        case YAML_SEQUENCE_START_EVENT:
+        case YAML_MAPPING_START_EVENT: depth++; break;
+
+        case YAML_SEQUENCE_END_EVENT:
+        case YAML_MAPPING_END_EVENT: depth--; break;
+
+        default:
+          /* Just fall through here. */
+          break;
+        }
+
+      yaml_event_delete (&event);
+    }
+
+  result = TRUE;
+
+error:
+  return result;
+}
+
+
+/* Read a value, returning a copy of it if it is a scalar and skipping over it
+ * otherwise
+ */
+static gboolean
+_catalog_read_value (yaml_parser_t *parser, gchar **scalar, GError **error)
+{
+  gboolean result = FALSE;
+  MMD_INIT_YAML_EVENT (event);
+
+  YAML_PARSER_PARSE_WITH_ERROR_RETURN (parser, &event, error, "Parser error");
+
+  if (event.type == YAML_SCALAR_EVENT)
+    {
+      if (scalar)
+        {
+          g_free (*scalar);
+          *scalar = g_strdup ((const gchar *)event.data.scalar.value);
+        }
+      return TRUE;
+    }
+
+  result = _catalog_skip (parser, &event, error);
+
+error:
+  return result;
+}
+
+
+static gboolean
+_catalog_read_data (yaml_parser_t *parser,
+                    modulemd_catalog_entry *entry,
+                    GError **error)
+{
+  gboolean result = FALSE;
+  gboolean done = FALSE;
+  g_autofree gchar *version = NULL;
+  MMD_INIT_YAML_EVENT (event);
+
+  while (!done)
+    {
+      YAML_PARSER_PARSE_WITH_ERROR_RETURN (
+        parser, &event, error, "Parser error");
+
+      switch (event.type)
+        {
+        case YAML_MAPPING_END_EVENT: done = TRUE; break;
+
+        case YAML_SCALAR_EVENT:
+          switch (MMD_YAML_EVENT_KEY (event))
+            {
+            /* Module streams use "name", while defaults and translations
+             * use "module"
+             */
+            case MMD_YAML_KEY_NAME:
+            case MMD_YAML_KEY_MODULE:
+              result = _catalog_read_value (parser, &entry->name, error);
+              break;
+
+            case MMD_YAML_KEY_STREAM:
+              result = _catalog_read_value (parser, &entry->stream, error);
+              break;
+
+            case MMD_YAML_KEY_VERSION:
+              result = _catalog_read_value (parser, &version, error);
+              break;
+
+            case MMD_YAML_KEY_CONTEXT:
+              result = _catalog_read_value (parser, &entry->context, error);
+              break;
+
+            default: result = _catalog_read_value (parser, NULL, error); break;
+            }
+
+          if (!result)
+            goto error;
+          break;
+
+        default:
+          /* A complex key; skip it and its value */
+          if (!_catalog_skip (parser, &event, error) ||
+              !_catalog_read_value (parser, NULL, error))
+            {
+              MMD_YAML_ERROR_RETURN_RETHROW (error, "Parser error");
+            }
+          break;
+        }
+
+      yaml_event_delete (&event);
+    }
+
+  if (version)
+    entry->version = g_ascii_strtoull (version, NULL, 10);
+
+  result = TRUE;
+
+error:
+  return result;
+}
+
+
+static GType
+_catalog_doctype (const gchar *document)
+{
+  if (document == NULL)
+    return G_TYPE_INVALID;
+
+  switch (mmd_yaml_key_lookup (document, strlen (document)))
+    {
+    case MMD_YAML_KEY_MODULEMD: return MODULEMD_TYPE_MODULESTREAM;
+
+    case MMD_YAML_KEY_MODULEMD_DEFAULTS: return MODULEMD_TYPE_DEFAULTS;
+
+    case MMD_YAML_KEY_MODULEMD_TRANSLATIONS: return MODULEMD_TYPE_TRANSLATION;
+
+    default: return G_TYPE_INVALID;
+    }
+}
+
+
+/* Read one subdocument, starting just after its DOCUMENT_START event and
+ * ending with its DOCUMENT_END event, which is returned in end_event
+ */
+static gboolean
+_catalog_read_document (yaml_parser_t *parser,
+                        modulemd_catalog_entry *entry,
+                        yaml_event_t *end_event,
+                        GError **error)
+{
+  gboolean result = FALSE;
+  gboolean done = FALSE;
+  g_autofree gchar *document = NULL;
+  g_autofree gchar *mdversion = NULL;
+  MMD_INIT_YAML_EVENT (event);
+  MMD_INIT_YAML_EVENT (value_event);
+
+  /* The document root */
+  YAML_PARSER_PARSE_WITH_ERROR_RETURN (parser, &event, error, "Parser error");
+
+  if (event.type != YAML_MAPPING_START_EVENT)
+    {
+      /* Not something we can catalog, but it still needs a record */
+      if (!_catalog_skip (parser, &event, error))
+        {
+          MMD_YAML_ERROR_RETURN_RETHROW (error, "Parser error");
+        }
+      done = TRUE;
+    }
+
+  while (!done)
+    {
+      yaml_event_delete (&event);
+      YAML_PARSER_PARSE_WITH_ERROR_RETURN (
+        parser, &event, error, "Parser error");
+
+      switch (event.type)
+        {
+        case YAML_MAPPING_END_EVENT: done = TRUE; break;
+
+        case YAML_SCALAR_EVENT:
+          switch (MMD_YAML_EVENT_KEY (event))
+            {
+            case MMD_YAML_KEY_DOCUMENT:
+              result = _catalog_read_value (parser, &document, error);
+              break;
+
+            case MMD_YAML_KEY_VERSION:
+              result = _catalog_read_value (parser, &mdversion, error);
+              break;
+
+            case MMD_YAML_KEY_DATA:
+              YAML_PARSER_PARSE_WITH_ERROR_RETURN (
+                parser, &value_event, error, "Parser error");
+
+              if (value_event.type == YAML_MAPPING_START_EVENT)
+                result = _catalog_read_data (parser, entry, error);
+              else
+                result = _catalog_skip (parser, &value_event, error);
+
+              yaml_event_delete (&value_event);
+              break;
+
+            default: result = _catalog_read_value (parser, NULL, error); break;
+            }
+
+          if (!result)
+            goto error;
+          break;
+
+        default:
+          /* A complex key; skip it and its value */
+          if (!_catalog_skip (parser, &event, error) ||
+              !_catalog_read_value (parser, NULL, error))
+            {
+              MMD_YAML_ERROR_RETURN_RETHROW (error, "Parser error");
+            }
+          break;
+        }
+    }
+
+  YAML_PARSER_PARSE_WITH_ERROR_RETURN (
+    parser, end_event, error, "Parser error");
+  if (end_event->type != YAML_DOCUMENT_END_EVENT)
+    {
+      MMD_YAML_ERROR_RETURN (error, "Expected end of document");
+    }
+
+  entry->doctype = _catalog_doctype (document);
+  if (mdversion)
+    entry->mdversion = g_ascii_strtoull (mdversion, NULL, 10);
+
+  result = TRUE;
+
+error:
+  return result;
+}
+
+
+static gchar *
+_catalog_entry_nsvc (modulemd_catalog_entry *entry)
+{
+  /* Matches the format of modulemd_modulestream_get_nsvc () */
+  if (!entry->name || !entry->stream || !entry->version)
+    return NULL;
+
+  if (entry->context)
+    {
+      return g_strdup_printf ("%s:%s:%" PRIx64 ":%s",
+                              entry->name,
+                              entry->stream,
+                              entry->version,
+                              entry->context);
+    }
+
+  return g_strdup_printf (
+    "%s:%s:%" PRIx64, entry->name, entry->stream, entry->version);
+}
+
+
+static void
+_catalog_add_entry (ModulemdCatalog *self, modulemd_catalog_entry *entry)
+{
+  GPtrArray *named = NULL;
+  gchar *nsvc = NULL;
+
+  g_ptr_array_add (self->entries, entry);
+
+  if (entry->doctype == G_TYPE_INVALID || !entry->name)
+    return;
+
+  named = g_hash_table_lookup (self->by_name, entry->name);
+  if (!named)
+    {
+      named = g_ptr_array_new ();
+      g_hash_table_replace (self->by_name, g_strdup (entry->name), named);
+    }
+  g_ptr_array_add (named, entry);
+
+  if (entry->doctype == MODULEMD_TYPE_MODULESTREAM)
+    {
+      nsvc = _catalog_entry_nsvc (entry);
+      if (nsvc)
+        g_hash_table_replace (self->by_nsvc, nsvc, entry);
+    }
+}
+
+
+static gboolean
+_catalog_scan (ModulemdCatalog *self, GError **error)
+{
+  gboolean result = FALSE;
+  gboolean done = FALSE;
+  g_auto (yaml_parser_t) parser;
+  MMD_INIT_YAML_EVENT (event);
+  MMD_INIT_YAML_EVENT (end_event);
+  modulemd_catalog_entry *entry = NULL;
+  modulemd_catalog_cursor cursor = { NULL, 0, 0, 0 };
+
+  MMD_TRACE ("TRACE: entering _catalog_scan");
+
+  cursor.data = g_bytes_get_data (self->input, &cursor.size);
+  if (!cursor.data)
+    cursor.data = "";
+
+  /* libyaml does not count a byte order mark as a character */
+  if (cursor.size >= 3 && memcmp (cursor.data, "\xef\xbb\xbf", 3) == 0)
+    cursor.byte_offset = 3;
+
+  yaml_parser_initialize (&parser);
+  yaml_parser_set_input_string (
+    &parser, (const unsigned char *)cursor.data, cursor.size);
+
+  while (!done)
+    {
+      YAML_PARSER_PARSE_WITH_ERROR_RETURN (
+        &parser, &event, error, "Parser error");
+
+      switch (event.type)
+        {
+        case YAML_STREAM_START_EVENT:
+          /* Offsets can only be computed for UTF-8 input */
+          if (event.data.stream_start.encoding != YAML_UTF8_ENCODING)
+            {
+              MMD_YAML_ERROR_RETURN (error,
+                                     "Catalogs require UTF-8 encoded YAML");
+            }
+          break;
+
+        case YAML_STREAM_END_EVENT: done = TRUE; break;
+
+        case YAML_DOCUMENT_START_EVENT:
+          entry = g_new0 (modulemd_catalog_entry, 1);
+          entry->offset =
+            _catalog_cursor_seek (&cursor, event.start_mark.index);
+
+          if (!_catalog_read_document (&parser, entry, &end_event, error))
+            {
+              modulemd_catalog_entry_free (entry);
+              MMD_YAML_ERROR_RETURN_RETHROW (error, "Parser error");
+            }
+
+          entry->length =
+            _catalog_cursor_seek (&cursor, end_event.end_mark.index) -
+            entry->offset;
+          yaml_event_delete (&end_event);
+
+          _catalog_add_entry (self, entry);
+          entry = NULL;
+          break;
+
+        default:
+          /* We received a YAML event we shouldn't expect at this level */
+          MMD_YAML_ERROR_RETURN (error, "Unexpected YAML event at toplevel");
+          break;
+        }
+
+      yaml_event_delete (&event);
+    }
+
+  result = TRUE;
+
+error:
+  MMD_TRACE ("TRACE: exiting _catalog_scan");
+  return result;
+}
+
+
+static ModulemdCatalog *
+_catalog_new_from_bytes (GBytes *input, GError **error)
+{
+  g_autoptr (ModulemdCatalog) self = NULL;
+
+  self = g_object_new (MODULEMD_TYPE_CATALOG, NULL);
+  self->input = g_bytes_ref (input);
+
+  if (!_catalog_scan (self, error))
+    return NULL;
+
+  return g_steal_pointer (&self);
+}
+
+
+ModulemdCatalog *
+modulemd_catalog_new_from_file (const gchar *yaml_file, GError **error)
+{
+  g_autoptr (GMappedFile) mapped_file = NULL;
+  g_autoptr (GBytes) input = NULL;
+  g_autoptr (GError) nested_error = NULL;
+
+  g_return_val_if_fail (yaml_file, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  mapped_file = g_mapped_file_new (yaml_file, FALSE, &nested_error);
+  if (!mapped_file)
+    {
+      g_set_error (error,
+                   MODULEMD_YAML_ERROR,
+                   MODULEMD_YAML_ERROR_OPEN,
+                   "Failed to open file: %s",
+                   nested_error->message);
+      return NULL;
+    }
+
+  input = g_mapped_file_get_bytes (mapped_file);
+
+  return _catalog_new_from_bytes (input, error);
+}
+
+
+ModulemdCatalog *
+modulemd_catalog_new_from_string (const gchar *yaml_string, GError **error)
+{
+  g_autoptr (GBytes) input = NULL;
+
+  g_return_val_if_fail (yaml_string, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  input = g_bytes_new (yaml_string, strlen (yaml_string));
+
+  return _catalog_new_from_bytes (input, error);
+}
+
+
+guint
+modulemd_catalog_get_n_documents (ModulemdCatalog *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_CATALOG (self), 0);
+
+  return self->entries->len;
+}
+
+
+static gchar **
+_catalog_dup_keys (GHashTable *htable)
+{
+  GPtrArray *keys = _modulemd_ordered_str_keys (htable, _modulemd_strcmp_sort);
+
+  g_ptr_array_add (keys, NULL);
+  return (gchar **)g_ptr_array_free (keys, FALSE);
+}
+
+
+gchar **
+modulemd_catalog_dup_module_names (ModulemdCatalog *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_CATALOG (self), NULL);
+
+  return _catalog_dup_keys (self->by_name);
+}
+
+
+gchar **
+modulemd_catalog_dup_nsvcs (ModulemdCatalog *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_CATALOG (self), NULL);
+
+  return _catalog_dup_keys (self->by_nsvc);
+}
+
+
+/* Parse a single subdocument from the retained input */
+static GObject *
+_catalog_materialize (ModulemdCatalog *self,
+                      modulemd_catalog_entry *entry,
+                      GError **error)
+{
+  const gchar *data = NULL;
+  g_autoptr (GPtrArray) objects = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+
+  MMD_TRACE ("TRACE: entering _catalog_materialize");
+
+  data = g_bytes_get_data (self->input, NULL);
+
+  if (!parse_yaml_string_len (
+        data + entry->offset, entry->length, &objects, &failures, error))
+    return NULL;
+
+  if (failures->len > 0)
+    {
+      g_propagate_error (error,
+                         g_error_copy (modulemd_subdocument_get_gerror (
+                           g_ptr_array_index (failures, 0))));
+      return NULL;
+    }
+
+  if (objects->len != 1)
+    {
+      g_set_error_literal (error,
+                           MODULEMD_YAML_ERROR,
+                           MODULEMD_YAML_ERROR_PARSE,
+                           "Catalog entry did not yield a single document");
+      return NULL;
+    }
+
+  MMD_TRACE ("TRACE: exiting _catalog_materialize");
+  return g_object_ref (g_ptr_array_index (objects, 0));
+}
+
+
+ModulemdModuleStream *
+modulemd_catalog_get_stream_by_nsvc (ModulemdCatalog *self,
+                                     const gchar *nsvc,
+                                     GError **error)
+{
+  modulemd_catalog_entry *entry = NULL;
+  GObject *object = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_CATALOG (self), NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  entry = g_hash_table_lookup (self->by_nsvc, nsvc);
+  if (!entry)
+    return NULL;
+
+  object = _catalog_materialize (self, entry, error);
+  if (!object)
+    return NULL;
+
+  return MODULEMD_MODULESTREAM (object);
+}
+
+
+ModulemdImprovedModule *
+modulemd_catalog_get_module (ModulemdCatalog *self,
+                             const gchar *module_name,
+                             GError **error)
+{
+  GPtrArray *named = NULL;
+  GObject *object = NULL;
+  g_autoptr (GPtrArray) objects = NULL;
+  g_autoptr (GHashTable) module_index = NULL;
+  ModulemdImprovedModule *module = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_CATALOG (self), NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  named = g_hash_table_lookup (self->by_name, module_name);
+  if (!named)
+    return NULL;
+
+  objects = g_ptr_array_new_with_free_func (g_object_unref);
+  for (gsize i = 0; i < named->len; i++)
+    {
+      object =
+        _catalog_materialize (self, g_ptr_array_index (named, i), error);
+      if (!object)
+        return NULL;
+
+      g_ptr_array_add (objects, object);
+    }
+
+  module_index = module_index_from_data (objects, error);
+  if (!module_index)
+    return NULL;
+
+  module = g_hash_table_lookup (module_index, module_name);
+  if (!module)
+    return NULL;
+
+  return g_object_ref (module);
+}
@@ -90,6 +90,212 @@ modulemd_index_from_file (const gchar *yaml_file,
 }
 
 
+GHashTable *
+modulemd_index_from_file_parallel (const gchar *yaml_file,
+                                   guint n_threads,
+                                   GPtrArray **failures,
+                                   GError **error)
+{
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  return parse_module_index_from_file_parallel (
+    yaml_file, n_threads, failures, error);
+}
+
+
+GHashTable *
+modulemd_index_from_files (const gchar **yaml_files,
+                           guint n_threads,
+                           GPtrArray **failures,
+                           GError **error)
+{
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  return parse_module_index_from_files (
+    yaml_files, n_threads, failures, error);
+}
+
+
+/* The result of an asynchronous load, returned through the GTask */
+typedef struct _modulemd_index_result
+{
+  GHashTable *index;
+  GPtrArray *failures;
+} modulemd_index_result;
+
+
+static void
+modulemd_index_result_free (modulemd_index_result *result)
+{
+  g_clear_pointer (&result->index, g_hash_table_unref);
+  g_clear_pointer (&result->failures, g_ptr_array_unref);
+  g_free (result);
+}
+
+
+static void
+_index_task_return (GTask *task,
+                    GHashTable *index,
+                    GPtrArray *failures,
+                    GError *error)
+{
+  modulemd_index_result *result = NULL;
+
+  if (!index)
+    {
+      g_clear_pointer (&failures, g_ptr_array_unref);
+      g_task_return_error (task, error);
+      return;
+    }
+
+  result = g_new0 (modulemd_index_result, 1);
+  result->index = index;
+  result->failures = failures;
+  g_task_return_pointer (
+    task, result, (GDestroyNotify)modulemd_index_result_free);
+}
+
+
+static GHashTable *
+_index_task_finish (GAsyncResult *result,
+                    GPtrArray **failures,
+                    GError **error)
+{
+  modulemd_index_result *task_result = NULL;
+  GHashTable *index = NULL;
+
+  task_result = g_task_propagate_pointer (G_TASK (result), error);
+  if (!task_result)
+    return NULL;
+
+  index = g_steal_pointer (&task_result->index);
+  if (failures)
+    *failures = g_steal_pointer (&task_result->failures);
+  modulemd_index_result_free (task_result);
+
+  return index;
+}
+
+
+static void
+_index_from_gfile_thread (GTask *task,
+                          gpointer source_object,
+                          gpointer task_data,
+                          GCancellable *cancellable)
+{
+  GFile *file = G_FILE (task_data);
+  g_autofree gchar *path = NULL;
+  g_autoptr (GFileInputStream) stream = NULL;
+  GHashTable *index = NULL;
+  GPtrArray *failures = NULL;
+  GError *error = NULL;
+
+  if (g_task_return_error_if_cancelled (task))
+    return;
+
+  /* The parser checks this between subdocuments */
+  if (cancellable)
+    g_cancellable_push_current (cancellable);
+
+  /* Local files can be mapped, and may have been cached */
+  path = g_file_get_path (file);
+  if (path)
+    {
+      index = parse_module_index_from_file (path, &failures, &error);
+    }
+  else
+    {
+      stream = g_file_read (file, cancellable, &error);
+      if (stream)
+        {
+          index = parse_module_index_from_input_stream (
+            G_INPUT_STREAM (stream), cancellable, &failures, &error);
+        }
+    }
+
+  if (cancellable)
+    g_cancellable_pop_current (cancellable);
+
+  _index_task_return (task, index, failures, error);
+}
+
+
+void
+modulemd_index_from_gfile_async (GFile *file,
+                                 GCancellable *cancellable,
+                                 GAsyncReadyCallback callback,
+                                 gpointer user_data)
+{
+  g_autoptr (GTask) task = NULL;
+
+  g_return_if_fail (G_IS_FILE (file));
+  g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+  task = g_task_new (NULL, cancellable, callback, user_data);
+  g_task_set_source_tag (task, modulemd_index_from_gfile_async);
+  g_task_set_task_data (task, g_object_ref (file), g_object_unref);
+  g_task_run_in_thread (task, _index_from_gfile_thread);
+}
+
+
+GHashTable *
+modulemd_index_from_gfile_finish (GAsyncResult *result,
+                                  GPtrArray **failures,
+                                  GError **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, NULL), NULL);
+  g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) ==
+                          modulemd_index_from_gfile_async,
+                        NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  return _index_task_finish (result, failures, error);
+}
+
+
+GPtrArray *
+modulemd_objects_from_file_filtered (const gchar *yaml_file,
+                                     ModulemdFilter *filter,
+                                     GPtrArray **failures,
+                                     GError **error)
+{
+  GPtrArray *data = NULL;
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  if (!parse_yaml_file_filtered (yaml_file, filter, &data, failures, error))
+    {
+      return NULL;
+    }
+
+  return data;
+}
+
+
+GHashTable *
+modulemd_index_from_file_filtered (const gchar *yaml_file,
+                                   ModulemdFilter *filter,
+                                   GPtrArray **failures,
+                                   GError **error)
+{
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  return parse_module_index_from_file_filtered (
+    yaml_file, filter, failures, error);
+}
+
+
+gboolean
+modulemd_parse_file_foreach (const gchar *yaml_file,
+                             ModulemdForeachFunc callback,
+                             gpointer user_data,
+                             GError **error)
+{
+  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  return parse_yaml_file_foreach (yaml_file, callback, user_data, error);
+}
+
+
 GPtrArray *
 modulemd_objects_from_stream (FILE *stream, GError **error)
 {
@@ -131,6 +337,64 @@ modulemd_index_from_stream (FILE *yaml_stream,
 }
 
 
+static void
+_index_from_input_stream_thread (GTask *task,
+                                 gpointer source_object,
+                                 gpointer task_data,
+                                 GCancellable *cancellable)
+{
+  GInputStream *stream = G_INPUT_STREAM (task_data);
+  GHashTable *index = NULL;
+  GPtrArray *failures = NULL;
+  GError *error = NULL;
+
+  if (g_task_return_error_if_cancelled (task))
+    return;
+
+  if (cancellable)
+    g_cancellable_push_current (cancellable);
+  index = parse_module_index_from_input_stream (
+    stream, cancellable, &failures, &error);
+  if (cancellable)
+    g_cancellable_pop_current (cancellable);
+
+  _index_task_return (task, index, failures, error);
+}
+
+
+void
+modulemd_index_from_input_stream_async (GInputStream *stream,
+                                        GCancellable *cancellable,
+                                        GAsyncReadyCallback callback,
+                                        gpointer user_data)
+{
+  g_autoptr (GTask) task = NULL;
+
+  g_return_if_fail (G_IS_INPUT_STREAM (stream));
+  g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+  task = g_task_new (NULL, cancellable, callback, user_data);
+  g_task_set_source_tag (task, modulemd_index_from_input_stream_async);
+  g_task_set_task_data (task, g_object_ref (stream), g_object_unref);
+  g_task_run_in_thread (task, _index_from_input_stream_thread);
+}
+
+
+GHashTable *
+modulemd_index_from_input_stream_finish (GAsyncResult *result,
+                                         GPtrArray **failures,
+                                         GError **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, NULL), NULL);
+  g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) ==
+                          modulemd_index_from_input_stream_async,
+                        NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  return _index_task_finish (result, failures, error);
+}
+
+
 GPtrArray *
 modulemd_objects_from_string (const gchar *yaml_string, GError **error)
 {
@@ -161,6 +425,25 @@ modulemd_objects_from_string_ext (const gchar *yaml_string,
 }
 
 
+GPtrArray *
+modulemd_objects_from_string_filtered (const gchar *yaml_string,
+                                       ModulemdFilter *filter,
+                                       GPtrArray **failures,
+                                       GError **error)
+{
+  GPtrArray *data = NULL;
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  if (!parse_yaml_string_filtered (
+        yaml_string, filter, &data, failures, error))
+    {
+      return NULL;
+    }
+
+  return data;
+}
+
+
 GHashTable *
 modulemd_index_from_string (const gchar *yaml_string,
                             GPtrArray **failures,
@@ -241,133 +524,279 @@ modulemd_merge_defaults (const GPtrArray *first,
                          gboolean override,
                          GError **error)
 {
-  g_autoptr (GPtrArray) merge_base = NULL;
+  return modulemd_merge_defaults_parallel (first, second, override, 1, error);
+}
+
+
+GPtrArray *
+modulemd_merge_defaults_parallel (const GPtrArray *first,
+                                  const GPtrArray *second,
+                                  gboolean override,
+                                  guint n_threads,
+                                  GError **error)
+{
   g_autoptr (GPtrArray) merged = NULL;
-  g_autoptr (GPtrArray) keys = NULL;
+  g_autoptr (GPtrArray) groups = NULL;
+  g_autoptr (GHashTable) groups_by_name = NULL;
+  const GPtrArray *objects = NULL;
+  modulemd_defaults_group *group = NULL;
   GObject *object = NULL;
-  g_autoptr (GHashTable) defaults =
-    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
-  gchar *key = NULL;
-  gpointer value = NULL;
-  ModulemdDefaults *updated_defs = NULL;
+  const gchar *module_name = NULL;
+  gboolean overrides = FALSE;
+  guint position = 0;
   gsize i;
 
-  merge_base = g_ptr_array_new_full (first->len, g_object_unref);
-  for (i = 0; i < first->len; i++)
+  g_return_val_if_fail (first, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  merged = g_ptr_array_new_full (first->len + (second ? second->len : 0),
+                                 g_object_unref);
+  groups = g_ptr_array_new_with_free_func (
+    (GDestroyNotify)modulemd_defaults_group_free);
+  groups_by_name = g_hash_table_new (g_str_hash, g_str_equal);
+
+  /* Sort the defaults by module name, keeping the order in which they will be
+   * merged. The defaults in @first merge with each other. The ones in @second
+   * either override them or, if the repos have the same priority, are treated
+   * as if they had been concatenated to @first. Everything else is added to
+   * the list in its original order.
+   */
+  for (guint list = 0; list < 2; list++)
     {
-      g_ptr_array_add (merge_base,
-                       g_object_ref (g_ptr_array_index (first, i)));
+      objects = list == 0 ? first : second;
+      overrides = list == 1 && override;
+      if (!objects)
+        continue;
+
+      for (i = 0; i < objects->len; i++)
+        {
+          object = g_ptr_array_index (objects, i);
+          if (!MODULEMD_IS_DEFAULTS (object))
+            {
+              /* Not a default object, so just add it to the list */
+              g_ptr_array_add (merged, g_object_ref (object));
+              continue;
+            }
+
+          module_name =
+            modulemd_defaults_peek_module_name (MODULEMD_DEFAULTS (object));
+          group = g_hash_table_lookup (groups_by_name, module_name);
+          if (!group)
+            {
+              group = modulemd_defaults_group_new (module_name);
+              g_ptr_array_add (groups, group);
+              g_hash_table_insert (groups_by_name, group->module_name, group);
+            }
+
+          modulemd_defaults_group_add (
+            group, MODULEMD_DEFAULTS (object), overrides, position++);
+        }
     }
 
-  if (second && !override)
+  /* Each module's defaults are merged independently of the others */
+  if (!modulemd_defaults_groups_merge (groups, n_threads, error))
+    return NULL;
+
+  /* Add all of the defaults to the end of the list */
+  g_ptr_array_sort (groups, modulemd_defaults_group_compare);
+  for (i = 0; i < groups->len; i++)
+    {
+      group = g_ptr_array_index (groups, i);
+      g_ptr_array_add (merged, g_object_ref (group->merged));
+    }
+
+  return g_steal_pointer (&merged);
+}
+
+
+GPtrArray *
+modulemd_get_latest_streams (GHashTable *index)
+{
+  g_autoptr (GPtrArray) module_names = NULL;
+  g_autoptr (GPtrArray) module_streams = NULL;
+  ModulemdImprovedModule *module = NULL;
+  GPtrArray *streams = NULL;
+
+  g_return_val_if_fail (index, NULL);
+
+  module_names = _modulemd_ordered_str_keys (index, _modulemd_strcmp_sort);
+  streams = g_ptr_array_new_with_free_func (g_object_unref);
+
+  for (gsize i = 0; i < module_names->len; i++)
     {
-      /* If the second repo doesn't override the first, then we can just treat
-       * them as concatenated together and save some processing time.
-       */
-      g_ptr_array_set_size (merge_base, first->len + second->len);
-      for (i = 0; i < second->len; i++)
+      module =
+        g_hash_table_lookup (index, g_ptr_array_index (module_names, i));
+      module_streams = modulemd_improvedmodule_get_latest_streams (module);
+      for (gsize j = 0; j < module_streams->len; j++)
         {
-          g_ptr_array_add (merge_base,
-                           g_object_ref (g_ptr_array_index (second, i)));
+          g_ptr_array_add (
+            streams, g_object_ref (g_ptr_array_index (module_streams, j)));
         }
+      g_clear_pointer (&module_streams, g_ptr_array_unref);
+    }
+
+  return streams;
+}
+
+
+void
+modulemd_prune_index (GHashTable *index, guint n_versions)
+{
+  GHashTableIter iter;
+  gpointer value;
+
+  g_return_if_fail (index);
+  g_return_if_fail (n_versions > 0);
+
+  g_hash_table_iter_init (&iter, index);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+      modulemd_improvedmodule_prune_versions (MODULEMD_IMPROVEDMODULE (value),
+                                              n_versions);
     }
+}
+
+
+typedef struct _modulemd_prune_group
+{
+  GArray *versions;
+  guint64 oldest_kept;
+} modulemd_prune_group;
+
+
+static void
+modulemd_prune_group_free (modulemd_prune_group *group)
+{
+  g_array_unref (group->versions);
+  g_free (group);
+}
+
+
+static gint
+_modulemd_compare_versions_desc (gconstpointer a, gconstpointer b)
+{
+  guint64 version_a = *(const guint64 *)a;
+  guint64 version_b = *(const guint64 *)b;
+
+  if (version_a == version_b)
+    return 0;
 
-  merged = g_ptr_array_new_full (merge_base->len, g_object_unref);
-  for (i = 0; i < merge_base->len; i++)
+  return version_a > version_b ? -1 : 1;
+}
+
+
+/* Returns the "NAME:STREAM" key of a module stream object and its version, or
+ * NULL if the object is not a module stream with a name and stream name.
+ */
+static gchar *
+_modulemd_prune_key (GObject *object, guint64 *version)
+{
+  const gchar *name = NULL;
+  const gchar *stream_name = NULL;
+
+  if (MODULEMD_IS_MODULESTREAM (object))
     {
-      object = g_ptr_array_index (merge_base, i);
-      if (MODULEMD_IS_DEFAULTS (object))
+      name = modulemd_modulestream_peek_name (MODULEMD_MODULESTREAM (object));
+      stream_name =
+        modulemd_modulestream_peek_stream (MODULEMD_MODULESTREAM (object));
+      *version =
+        modulemd_modulestream_get_version (MODULEMD_MODULESTREAM (object));
+    }
+  else if (MODULEMD_IS_MODULE (object))
+    {
+      name = modulemd_module_peek_name (MODULEMD_MODULE (object));
+      stream_name = modulemd_module_peek_stream (MODULEMD_MODULE (object));
+      *version = modulemd_module_peek_version (MODULEMD_MODULE (object));
+    }
+
+  if (!name || !stream_name)
+    return NULL;
+
+  return g_strdup_printf ("%s:%s", name, stream_name);
+}
+
+
+GPtrArray *
+modulemd_prune_objects (const GPtrArray *objects, guint n_versions)
+{
+  g_autoptr (GHashTable) groups = NULL;
+  modulemd_prune_group *group = NULL;
+  GPtrArray *pruned = NULL;
+  GObject *object = NULL;
+  GHashTableIter iter;
+  gpointer value;
+  gchar *key = NULL;
+  guint64 version = 0;
+  guint n_kept;
+
+  g_return_val_if_fail (objects, NULL);
+  g_return_val_if_fail (n_versions > 0, NULL);
+
+  groups = g_hash_table_new_full (
+    g_str_hash,
+    g_str_equal,
+    g_free,
+    (GDestroyNotify)modulemd_prune_group_free);
+
+  /* Collect the versions of each stream */
+  for (gsize i = 0; i < objects->len; i++)
+    {
+      key = _modulemd_prune_key (g_ptr_array_index (objects, i), &version);
+      if (!key)
+        continue;
+
+      group = g_hash_table_lookup (groups, key);
+      if (!group)
         {
-          key = modulemd_defaults_dup_module_name (MODULEMD_DEFAULTS (object));
-          value = g_hash_table_lookup (defaults, key);
-          if (!value)
-            {
-              /* This is the first time we've encountered the defaults for this
-               * module.
-               */
-              g_hash_table_replace (defaults, key, g_object_ref (object));
-            }
-          else
-            {
-              /* We've seen this one before. Handle the merge */
-              updated_defs =
-                modulemd_defaults_merge (MODULEMD_DEFAULTS (value),
-                                         MODULEMD_DEFAULTS (object),
-                                         FALSE,
-                                         error);
-
-              if (!updated_defs)
-                {
-                  /* The merge failed. Raise the error */
-                  g_clear_pointer (&key, g_free);
-                  return NULL;
-                }
-
-              g_hash_table_replace (defaults, key, updated_defs);
-            }
+          group = g_new0 (modulemd_prune_group, 1);
+          group->versions = g_array_new (FALSE, FALSE, sizeof (guint64));
+          g_hash_table_insert (groups, key, group);
         }
       else
         {
-          /* Not a default object, so just add it to the list */
-          g_ptr_array_add (merged, g_object_ref (object));
+          g_free (key);
         }
+      g_array_append_val (group->versions, version);
     }
 
-  if (second && override)
+  /* Find the oldest version of each stream that is kept */
+  g_hash_table_iter_init (&iter, groups);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
     {
-      /* The repos had different priorities, so after resolving any conflicts
-       * from the base repo, we will set any needed updates and overrides here.
-       */
-      for (i = 0; i < second->len; i++)
+      group = value;
+      g_array_sort (group->versions, _modulemd_compare_versions_desc);
+
+      n_kept = 0;
+      for (guint i = 0; i < group->versions->len; i++)
         {
-          object = g_ptr_array_index (second, i);
-          if (MODULEMD_IS_DEFAULTS (object))
-            {
-              key =
-                modulemd_defaults_dup_module_name (MODULEMD_DEFAULTS (object));
-              value = g_hash_table_lookup (defaults, key);
-              if (!value)
-                {
-                  /* This is the first time we've encountered the defaults for this
-                   * module.
-                   */
-                  g_hash_table_replace (defaults, key, g_object_ref (object));
-                }
-              else
-                {
-                  /* We've seen this one before. Handle the merge */
-                  updated_defs =
-                    modulemd_defaults_merge (MODULEMD_DEFAULTS (value),
-                                             MODULEMD_DEFAULTS (object),
-                                             TRUE,
-                                             error);
-
-                  if (!updated_defs)
-                    {
-                      /* The merge failed. Raise the error */
-                      return NULL;
-                    }
-
-                  g_hash_table_replace (defaults, key, updated_defs);
-                }
-            }
-          else
-            {
-              /* Not a default object, so just add it to the list */
-              g_ptr_array_add (merged, g_object_ref (object));
-            }
+          version = g_array_index (group->versions, guint64, i);
+          if (i > 0 && version == group->oldest_kept)
+            continue;
+          if (n_kept == n_versions)
+            break;
+          group->oldest_kept = version;
+          n_kept++;
         }
     }
 
-  /* Add all of the defaults to the end of the list */
-  keys = _modulemd_ordered_str_keys (defaults, _modulemd_strcmp_sort);
-  for (i = 0; i < keys->len; i++)
+  /* Everything else keeps its place in the list */
+  pruned = g_ptr_array_new_full (objects->len, g_object_unref);
+  for (gsize i = 0; i < objects->len; i++)
     {
-      value = g_hash_table_lookup (defaults, g_ptr_array_index (keys, i));
-      g_ptr_array_add (merged, g_object_ref (MODULEMD_DEFAULTS (value)));
+      object = g_ptr_array_index (objects, i);
+      key = _modulemd_prune_key (object, &version);
+      if (key)
+        {
+          group = g_hash_table_lookup (groups, key);
+          g_free (key);
+          if (version < group->oldest_kept)
+            continue;
+        }
+
+      g_ptr_array_add (pruned, g_object_ref (object));
     }
 
-  return g_ptr_array_ref (merged);
+  return pruned;
 }
 
 
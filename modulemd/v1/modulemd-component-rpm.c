@@ -14,6 +14,7 @@
 
 #include "modulemd.h"
 #include "modulemd-component-rpm.h"
+#include "private/modulemd-util.h"
 
 struct _ModulemdComponentRpm
 {
@@ -21,10 +22,10 @@ struct _ModulemdComponentRpm
 
   /* == Members == */
   ModulemdSimpleSet *arches;
-  gchar *cache;
+  gchar *cache; /* GRefString */
   ModulemdSimpleSet *multilib;
   gchar *ref;
-  gchar *repo;
+  gchar *repo; /* GRefString */
 };
 
 G_DEFINE_TYPE (ModulemdComponentRpm,
@@ -58,10 +59,10 @@ modulemd_component_rpm_finalize (GObject *object)
   ModulemdComponentRpm *self = (ModulemdComponentRpm *)object;
 
   g_clear_pointer (&self->arches, g_object_unref);
-  g_clear_pointer (&self->cache, g_free);
+  g_clear_pointer (&self->cache, g_ref_string_release);
   g_clear_pointer (&self->multilib, g_object_unref);
   g_clear_pointer (&self->ref, g_free);
-  g_clear_pointer (&self->repo, g_free);
+  g_clear_pointer (&self->repo, g_ref_string_release);
 
   G_OBJECT_CLASS (modulemd_component_rpm_parent_class)->finalize (object);
 }
@@ -115,8 +116,8 @@ modulemd_component_rpm_set_cache (ModulemdComponentRpm *self,
 
   if (g_strcmp0 (self->cache, cache) != 0)
     {
-      g_free (self->cache);
-      self->cache = g_strdup (cache);
+      g_clear_pointer (&self->cache, g_ref_string_release);
+      self->cache = modulemd_string_intern (cache);
 
       g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_CACHE]);
     }
@@ -237,8 +238,8 @@ modulemd_component_rpm_set_repository (ModulemdComponentRpm *self,
 
   if (g_strcmp0 (self->repo, repository) != 0)
     {
-      g_free (self->repo);
-      self->repo = g_strdup (repository);
+      g_clear_pointer (&self->repo, g_ref_string_release);
+      self->repo = modulemd_string_intern (repository);
 
       g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_REPO]);
     }
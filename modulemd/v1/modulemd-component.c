@@ -13,6 +13,7 @@
 
 #include "modulemd.h"
 #include "modulemd-component.h"
+#include "private/modulemd-util.h"
 
 
 enum
@@ -35,7 +36,7 @@ typedef struct
 {
   guint64 buildorder;
   gchar *name;
-  gchar *rationale;
+  gchar *rationale; /* GRefString */
 } ModulemdComponentPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (ModulemdComponent,
@@ -102,8 +103,10 @@ modulemd_component_default_set_rationale (ModulemdComponent *self,
   g_return_if_fail (MODULEMD_IS_COMPONENT (self));
   ModulemdComponentPrivate *priv =
     modulemd_component_get_instance_private (self);
+  gchar *interned = modulemd_string_intern (rationale);
 
-  priv->rationale = g_strdup (rationale);
+  g_clear_pointer (&priv->rationale, g_ref_string_release);
+  priv->rationale = interned;
 }
 
 static const gchar *
@@ -347,7 +350,7 @@ modulemd_component_finalize (GObject *gobject)
     modulemd_component_get_instance_private (self);
 
   g_clear_pointer (&priv->name, g_free);
-  g_clear_pointer (&priv->rationale, g_free);
+  g_clear_pointer (&priv->rationale, g_ref_string_release);
 }
 
 static void
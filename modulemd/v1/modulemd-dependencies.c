@@ -62,7 +62,7 @@ _modulemd_dependencies_add_streams (GHashTable *reqs,
       modulemd_simpleset_add (streamset, streams[i]);
     }
 
-  g_hash_table_replace (reqs, g_strdup (module), streamset);
+  g_hash_table_replace (reqs, modulemd_string_intern (module), streamset);
 }
 
 static void
@@ -129,8 +129,9 @@ modulemd_dependencies_set_buildrequires (ModulemdDependencies *self,
         {
           modulemd_simpleset_copy ((ModulemdSimpleSet *)value, &copy);
 
-          g_hash_table_replace (
-            self->buildrequires, g_strdup ((gchar *)key), g_object_ref (copy));
+          g_hash_table_replace (self->buildrequires,
+                                modulemd_string_intern ((gchar *)key),
+                                g_object_ref (copy));
 
           g_clear_pointer (&copy, g_object_unref);
         }
@@ -242,8 +243,9 @@ modulemd_dependencies_set_requires (ModulemdDependencies *self,
         {
           modulemd_simpleset_copy ((ModulemdSimpleSet *)value, &copy);
 
-          g_hash_table_replace (
-            self->requires, g_strdup ((gchar *)key), g_object_ref (copy));
+          g_hash_table_replace (self->requires,
+                                modulemd_string_intern ((gchar *)key),
+                                g_object_ref (copy));
 
           g_clear_pointer (&copy, g_object_unref);
         }
@@ -404,9 +406,17 @@ modulemd_dependencies_class_init (ModulemdDependenciesClass *klass)
 static void
 modulemd_dependencies_init (ModulemdDependencies *self)
 {
-  /* Allocate the members */
+  /* Allocate the members. The module names are GRefStrings, so that they can
+   * be shared through a string pool.
+   */
   self->buildrequires =
-    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+    g_hash_table_new_full (g_str_hash,
+                           g_str_equal,
+                           (GDestroyNotify)g_ref_string_release,
+                           g_object_unref);
   self->requires =
-    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+    g_hash_table_new_full (g_str_hash,
+                           g_str_equal,
+                           (GDestroyNotify)g_ref_string_release,
+                           g_object_unref);
 }
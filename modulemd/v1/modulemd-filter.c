@@ -0,0 +1,207 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2017-2018 Stephen Gallagher
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+
+#include "modulemd.h"
+#include "modulemd-filter.h"
+#include "private/modulemd-filter-private.h"
+
+
+struct _ModulemdFilter
+{
+  GObject parent_instance;
+
+  /* Set of module names, or NULL to match any module */
+  GHashTable *module_names;
+
+  /* GTypes of the selected subdocuments, or NULL to match any type */
+  GArray *doctypes;
+
+  gchar *arch;
+
+  /* ModulemdSection bitmask of the optional sections to parse */
+  guint sections;
+};
+
+G_DEFINE_TYPE (ModulemdFilter, modulemd_filter, G_TYPE_OBJECT)
+
+
+ModulemdFilter *
+modulemd_filter_new (void)
+{
+  return g_object_new (MODULEMD_TYPE_FILTER, NULL);
+}
+
+
+static void
+modulemd_filter_finalize (GObject *object)
+{
+  ModulemdFilter *self = (ModulemdFilter *)object;
+
+  g_clear_pointer (&self->module_names, g_hash_table_unref);
+  g_clear_pointer (&self->doctypes, g_array_unref);
+  g_clear_pointer (&self->arch, g_free);
+
+  G_OBJECT_CLASS (modulemd_filter_parent_class)->finalize (object);
+}
+
+
+static void
+modulemd_filter_class_init (ModulemdFilterClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = modulemd_filter_finalize;
+}
+
+
+static void
+modulemd_filter_init (ModulemdFilter *self)
+{
+  self->sections = MODULEMD_SECTION_ALL;
+}
+
+
+void
+modulemd_filter_add_module_name (ModulemdFilter *self,
+                                 const gchar *module_name)
+{
+  g_return_if_fail (MODULEMD_IS_FILTER (self));
+  g_return_if_fail (module_name);
+
+  if (!self->module_names)
+    {
+      self->module_names =
+        g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    }
+
+  g_hash_table_add (self->module_names, g_strdup (module_name));
+}
+
+
+void
+modulemd_filter_add_doctype (ModulemdFilter *self, GType doctype)
+{
+  g_return_if_fail (MODULEMD_IS_FILTER (self));
+  g_return_if_fail (doctype == MODULEMD_TYPE_MODULESTREAM ||
+                    doctype == MODULEMD_TYPE_DEFAULTS ||
+                    doctype == MODULEMD_TYPE_TRANSLATION);
+
+  if (!self->doctypes)
+    self->doctypes = g_array_sized_new (FALSE, FALSE, sizeof (GType), 3);
+  else if (modulemd_filter_match_doctype (self, doctype))
+    return;
+
+  g_array_append_val (self->doctypes, doctype);
+}
+
+
+void
+modulemd_filter_set_arch (ModulemdFilter *self, const gchar *arch)
+{
+  g_return_if_fail (MODULEMD_IS_FILTER (self));
+
+  if (g_strcmp0 (self->arch, arch) != 0)
+    {
+      g_free (self->arch);
+      self->arch = g_strdup (arch);
+    }
+}
+
+
+gchar *
+modulemd_filter_get_arch (ModulemdFilter *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_FILTER (self), NULL);
+
+  return g_strdup (self->arch);
+}
+
+
+const gchar *
+modulemd_filter_peek_arch (ModulemdFilter *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_FILTER (self), NULL);
+
+  return self->arch;
+}
+
+
+void
+modulemd_filter_set_sections (ModulemdFilter *self, guint sections)
+{
+  g_return_if_fail (MODULEMD_IS_FILTER (self));
+
+  self->sections = sections & MODULEMD_SECTION_ALL;
+}
+
+
+guint
+modulemd_filter_get_sections (ModulemdFilter *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_FILTER (self), MODULEMD_SECTION_ALL);
+
+  return self->sections;
+}
+
+
+gboolean
+modulemd_filter_match_doctype (ModulemdFilter *self, GType doctype)
+{
+  g_return_val_if_fail (MODULEMD_IS_FILTER (self), FALSE);
+
+  if (!self->doctypes)
+    return TRUE;
+
+  for (gsize i = 0; i < self->doctypes->len; i++)
+    {
+      if (g_array_index (self->doctypes, GType, i) == doctype)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+
+gboolean
+modulemd_filter_match_module_name (ModulemdFilter *self,
+                                   const gchar *module_name)
+{
+  g_return_val_if_fail (MODULEMD_IS_FILTER (self), FALSE);
+
+  if (!self->module_names)
+    return TRUE;
+
+  return module_name != NULL &&
+         g_hash_table_contains (self->module_names, module_name);
+}
+
+
+gboolean
+modulemd_filter_match_arch (ModulemdFilter *self, const gchar *arch)
+{
+  g_return_val_if_fail (MODULEMD_IS_FILTER (self), FALSE);
+
+  if (!self->arch || !arch)
+    return TRUE;
+
+  return g_str_equal (self->arch, arch);
+}
+
+
+gboolean
+modulemd_filter_requires_module_name (ModulemdFilter *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_FILTER (self), FALSE);
+
+  return self->module_names != NULL;
+}
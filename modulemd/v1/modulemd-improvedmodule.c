@@ -25,9 +25,24 @@ struct _ModulemdImprovedModule
   /* The name of this module */
   gchar *name;
 
-  /* Hash table of streams available in this module, indexed by stream name */
+  /* Hash table of every stream in this module, indexed by stream name,
+   * version and context, as made by _modulemd_improvedmodule_stream_key()
+   */
+  GHashTable *all_streams;
+
+  /* Hash table of GPtrArrays of the versions of each stream, sorted by
+   * version and context, indexed by stream name
+   */
+  GHashTable *versions;
+
+  /* Hash table of the latest version of each stream, indexed by stream name */
   GHashTable *streams;
 
+  /* Hash table of the latest version of each context of each stream, indexed
+   * by stream name and context
+   */
+  GHashTable *latest;
+
   /* The defaults for this module */
   ModulemdDefaults *defaults;
 };
@@ -58,7 +73,10 @@ modulemd_improvedmodule_finalize (GObject *object)
   ModulemdImprovedModule *self = (ModulemdImprovedModule *)object;
 
   g_clear_pointer (&self->name, g_free);
+  g_clear_pointer (&self->all_streams, g_hash_table_unref);
+  g_clear_pointer (&self->versions, g_hash_table_unref);
   g_clear_pointer (&self->streams, g_hash_table_unref);
+  g_clear_pointer (&self->latest, g_hash_table_unref);
   g_clear_pointer (&self->defaults, g_object_unref);
 
   G_OBJECT_CLASS (modulemd_improvedmodule_parent_class)->finalize (object);
@@ -135,11 +153,76 @@ modulemd_improvedmodule_peek_defaults (ModulemdImprovedModule *self)
 }
 
 
+static gchar *
+_modulemd_improvedmodule_stream_key (const gchar *stream_name,
+                                     guint64 version,
+                                     const gchar *context)
+{
+  if (!context)
+    return g_strdup_printf ("%s:%" G_GUINT64_FORMAT, stream_name, version);
+
+  return g_strdup_printf (
+    "%s:%" G_GUINT64_FORMAT ":%s", stream_name, version, context);
+}
+
+
+static gchar *
+_modulemd_improvedmodule_context_key (const gchar *stream_name,
+                                      const gchar *context)
+{
+  if (!context)
+    return g_strdup (stream_name);
+
+  return g_strdup_printf ("%s:%s", stream_name, context);
+}
+
+
+/* Orders the versions of a stream by version and then by context */
+static gint
+_modulemd_improvedmodule_compare_versions (ModulemdModuleStream *a,
+                                           ModulemdModuleStream *b)
+{
+  guint64 version_a = modulemd_modulestream_get_version (a);
+  guint64 version_b = modulemd_modulestream_get_version (b);
+
+  if (version_a != version_b)
+    return version_a < version_b ? -1 : 1;
+
+  return g_strcmp0 (modulemd_modulestream_peek_context (a),
+                    modulemd_modulestream_peek_context (b));
+}
+
+
 void
 modulemd_improvedmodule_add_stream (ModulemdImprovedModule *self,
                                     ModulemdModuleStream *stream)
+{
+  g_return_if_fail (MODULEMD_IS_IMPROVEDMODULE (self));
+  g_return_if_fail (MODULEMD_IS_MODULESTREAM (stream));
+
+
+  if (g_strcmp0 (self->name, modulemd_modulestream_peek_name (stream)))
+    {
+      /* This stream doesn't match this module. Ignore it */
+      return;
+    }
+
+  modulemd_improvedmodule_take_stream (self,
+                                       modulemd_modulestream_copy (stream));
+}
+
+
+void
+modulemd_improvedmodule_take_stream (ModulemdImprovedModule *self,
+                                     ModulemdModuleStream *stream)
 {
   g_autofree gchar *stream_name = NULL;
+  g_autofree gchar *key = NULL;
+  GPtrArray *versions = NULL;
+  ModulemdModuleStream *old = NULL;
+  ModulemdModuleStream *latest = NULL;
+  gchar *context_key = NULL;
+  guint low, high, mid;
   g_return_if_fail (MODULEMD_IS_IMPROVEDMODULE (self));
   g_return_if_fail (MODULEMD_IS_MODULESTREAM (stream));
 
@@ -147,6 +230,7 @@ modulemd_improvedmodule_add_stream (ModulemdImprovedModule *self,
   if (g_strcmp0 (self->name, modulemd_modulestream_peek_name (stream)))
     {
       /* This stream doesn't match this module. Ignore it */
+      g_object_unref (stream);
       return;
     }
 
@@ -161,9 +245,63 @@ modulemd_improvedmodule_add_stream (ModulemdImprovedModule *self,
         g_strdup_printf ("__unknown_%d__", g_hash_table_size (self->streams));
     }
 
-  g_hash_table_replace (self->streams,
-                        g_strdup (stream_name),
-                        modulemd_modulestream_copy (stream));
+  versions = g_hash_table_lookup (self->versions, stream_name);
+  if (!versions)
+    {
+      versions = g_ptr_array_new_with_free_func (g_object_unref);
+      g_hash_table_insert (self->versions, g_strdup (stream_name), versions);
+    }
+
+  key = _modulemd_improvedmodule_stream_key (
+    stream_name,
+    modulemd_modulestream_get_version (stream),
+    modulemd_modulestream_peek_context (stream));
+  old = g_hash_table_lookup (self->all_streams, key);
+
+  /* Find where this version belongs. Streams are usually added in order, so
+   * this is most often the end of the array.
+   */
+  low = 0;
+  high = versions->len;
+  while (low < high)
+    {
+      mid = low + (high - low) / 2;
+      if (_modulemd_improvedmodule_compare_versions (
+            g_ptr_array_index (versions, mid), stream) <= 0)
+        low = mid + 1;
+      else
+        high = mid;
+    }
+
+  if (old)
+    {
+      /* The stream it replaces has the same version and context */
+      g_object_unref (g_ptr_array_index (versions, low - 1));
+      versions->pdata[low - 1] = g_object_ref (stream);
+    }
+  else
+    {
+      g_ptr_array_insert (versions, low, g_object_ref (stream));
+    }
+
+  latest = g_ptr_array_index (versions, versions->len - 1);
+  g_hash_table_replace (
+    self->streams, g_strdup (stream_name), g_object_ref (latest));
+
+  context_key = _modulemd_improvedmodule_context_key (
+    stream_name, modulemd_modulestream_peek_context (stream));
+  latest = g_hash_table_lookup (self->latest, context_key);
+  if (!latest || latest == old ||
+      _modulemd_improvedmodule_compare_versions (latest, stream) < 0)
+    {
+      g_hash_table_replace (self->latest, context_key, g_object_ref (stream));
+    }
+  else
+    {
+      g_free (context_key);
+    }
+
+  g_hash_table_replace (self->all_streams, g_steal_pointer (&key), stream);
 }
 
 
@@ -183,6 +321,16 @@ modulemd_improvedmodule_get_stream_by_name (ModulemdImprovedModule *self,
 }
 
 
+ModulemdModuleStream *
+modulemd_improvedmodule_peek_stream_by_name (ModulemdImprovedModule *self,
+                                             const gchar *stream_name)
+{
+  g_return_val_if_fail (MODULEMD_IS_IMPROVEDMODULE (self), NULL);
+
+  return g_hash_table_lookup (self->streams, stream_name);
+}
+
+
 GHashTable *
 modulemd_improvedmodule_get_streams (ModulemdImprovedModule *self)
 {
@@ -192,11 +340,241 @@ modulemd_improvedmodule_get_streams (ModulemdImprovedModule *self)
 }
 
 
-ModulemdImprovedModule *
-modulemd_improvedmodule_copy (ModulemdImprovedModule *self)
+ModulemdModuleStream *
+modulemd_improvedmodule_peek_stream_by_version (ModulemdImprovedModule *self,
+                                                const gchar *stream_name,
+                                                guint64 version,
+                                                const gchar *context)
+{
+  g_autofree gchar *key = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_IMPROVEDMODULE (self), NULL);
+
+  key = _modulemd_improvedmodule_stream_key (stream_name, version, context);
+  return g_hash_table_lookup (self->all_streams, key);
+}
+
+
+ModulemdModuleStream *
+modulemd_improvedmodule_get_stream_by_version (ModulemdImprovedModule *self,
+                                               const gchar *stream_name,
+                                               guint64 version,
+                                               const gchar *context)
+{
+  ModulemdModuleStream *stream = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_IMPROVEDMODULE (self), NULL);
+
+  stream = modulemd_improvedmodule_peek_stream_by_version (
+    self, stream_name, version, context);
+  if (!stream)
+    return NULL;
+
+  return modulemd_modulestream_copy (stream);
+}
+
+
+ModulemdModuleStream *
+modulemd_improvedmodule_peek_latest_stream (ModulemdImprovedModule *self,
+                                            const gchar *stream_name,
+                                            const gchar *context)
+{
+  g_autofree gchar *key = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_IMPROVEDMODULE (self), NULL);
+
+  if (!context)
+    return g_hash_table_lookup (self->streams, stream_name);
+
+  key = _modulemd_improvedmodule_context_key (stream_name, context);
+  return g_hash_table_lookup (self->latest, key);
+}
+
+
+ModulemdModuleStream *
+modulemd_improvedmodule_get_latest_stream (ModulemdImprovedModule *self,
+                                           const gchar *stream_name,
+                                           const gchar *context)
+{
+  ModulemdModuleStream *stream = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_IMPROVEDMODULE (self), NULL);
+
+  stream =
+    modulemd_improvedmodule_peek_latest_stream (self, stream_name, context);
+  if (!stream)
+    return NULL;
+
+  return modulemd_modulestream_copy (stream);
+}
+
+
+GPtrArray *
+modulemd_improvedmodule_peek_stream_versions (ModulemdImprovedModule *self,
+                                              const gchar *stream_name)
+{
+  g_return_val_if_fail (MODULEMD_IS_IMPROVEDMODULE (self), NULL);
+
+  return g_hash_table_lookup (self->versions, stream_name);
+}
+
+
+GPtrArray *
+modulemd_improvedmodule_get_stream_versions (ModulemdImprovedModule *self,
+                                             const gchar *stream_name)
+{
+  GPtrArray *versions = NULL;
+  GPtrArray *copy = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_IMPROVEDMODULE (self), NULL);
+
+  versions = modulemd_improvedmodule_peek_stream_versions (self, stream_name);
+  if (!versions)
+    return g_ptr_array_new_with_free_func (g_object_unref);
+
+  copy = g_ptr_array_new_full (versions->len, g_object_unref);
+  for (gsize i = 0; i < versions->len; i++)
+    g_ptr_array_add (copy, g_object_ref (g_ptr_array_index (versions, i)));
+
+  return copy;
+}
+
+
+GPtrArray *
+modulemd_improvedmodule_get_all_streams (ModulemdImprovedModule *self)
+{
+  g_autoptr (GPtrArray) keys = NULL;
+  GPtrArray *versions = NULL;
+  GPtrArray *streams = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_IMPROVEDMODULE (self), NULL);
+
+  keys = _modulemd_ordered_str_keys (self->versions, _modulemd_strcmp_sort);
+  streams = g_ptr_array_new_full (g_hash_table_size (self->all_streams),
+                                  g_object_unref);
+
+  for (gsize i = 0; i < keys->len; i++)
+    {
+      versions = g_hash_table_lookup (self->versions,
+                                      g_ptr_array_index (keys, i));
+      for (gsize j = 0; j < versions->len; j++)
+        {
+          g_ptr_array_add (streams,
+                           g_object_ref (g_ptr_array_index (versions, j)));
+        }
+    }
+
+  return streams;
+}
+
+
+GPtrArray *
+modulemd_improvedmodule_get_latest_streams (ModulemdImprovedModule *self)
+{
+  g_autoptr (GPtrArray) keys = NULL;
+  GPtrArray *versions = NULL;
+  GPtrArray *streams = NULL;
+  ModulemdModuleStream *stream = NULL;
+  gchar *context_key = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_IMPROVEDMODULE (self), NULL);
+
+  keys = _modulemd_ordered_str_keys (self->versions, _modulemd_strcmp_sort);
+  streams =
+    g_ptr_array_new_full (g_hash_table_size (self->latest), g_object_unref);
+
+  for (gsize i = 0; i < keys->len; i++)
+    {
+      versions = g_hash_table_lookup (self->versions,
+                                      g_ptr_array_index (keys, i));
+      for (gsize j = 0; j < versions->len; j++)
+        {
+          stream = g_ptr_array_index (versions, j);
+          context_key = _modulemd_improvedmodule_context_key (
+            g_ptr_array_index (keys, i),
+            modulemd_modulestream_peek_context (stream));
+          if (g_hash_table_lookup (self->latest, context_key) == stream)
+            g_ptr_array_add (streams, g_object_ref (stream));
+          g_free (context_key);
+        }
+    }
+
+  return streams;
+}
+
+
+void
+modulemd_improvedmodule_prune_versions (ModulemdImprovedModule *self,
+                                        guint n_versions)
 {
   GHashTableIter iter;
   gpointer key, value;
+  GPtrArray *versions = NULL;
+  ModulemdModuleStream *stream = NULL;
+  guint64 version = 0;
+  guint64 previous = 0;
+  guint n_kept = 0;
+  guint first_kept;
+  gchar *stream_key = NULL;
+
+  g_return_if_fail (MODULEMD_IS_IMPROVEDMODULE (self));
+  g_return_if_fail (n_versions > 0);
+
+  g_hash_table_iter_init (&iter, self->versions);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      versions = value;
+
+      /* The versions are sorted, so walk back from the newest one until
+       * n_versions different version numbers have been seen.
+       */
+      n_kept = 0;
+      first_kept = versions->len;
+      while (first_kept > 0)
+        {
+          version = modulemd_modulestream_get_version (
+            g_ptr_array_index (versions, first_kept - 1));
+          if (first_kept == versions->len || version != previous)
+            {
+              if (n_kept == n_versions)
+                break;
+              n_kept++;
+            }
+          previous = version;
+          first_kept--;
+        }
+
+      /* Every context of the older versions goes, so the latest stream of a
+       * context is dropped only along with the whole context.
+       */
+      for (guint i = 0; i < first_kept; i++)
+        {
+          stream = g_ptr_array_index (versions, i);
+
+          stream_key = _modulemd_improvedmodule_context_key (
+            key, modulemd_modulestream_peek_context (stream));
+          if (g_hash_table_lookup (self->latest, stream_key) == stream)
+            g_hash_table_remove (self->latest, stream_key);
+          g_free (stream_key);
+
+          stream_key = _modulemd_improvedmodule_stream_key (
+            key,
+            modulemd_modulestream_get_version (stream),
+            modulemd_modulestream_peek_context (stream));
+          g_hash_table_remove (self->all_streams, stream_key);
+          g_free (stream_key);
+        }
+
+      if (first_kept > 0)
+        g_ptr_array_remove_range (versions, 0, first_kept);
+    }
+}
+
+
+ModulemdImprovedModule *
+modulemd_improvedmodule_copy (ModulemdImprovedModule *self)
+{
+  g_autoptr (GPtrArray) streams = NULL;
   ModulemdImprovedModule *new_module = NULL;
 
   if (!self)
@@ -205,14 +583,13 @@ modulemd_improvedmodule_copy (ModulemdImprovedModule *self)
   new_module =
     modulemd_improvedmodule_new (modulemd_improvedmodule_peek_name (self));
 
-  /* Copy all of the streams */
-  g_hash_table_iter_init (&iter, self->streams);
-  while (g_hash_table_iter_next (&iter, &key, &value))
+  /* Copy all of the streams, in order so that each is added at the end */
+  streams = modulemd_improvedmodule_get_all_streams (self);
+  for (gsize i = 0; i < streams->len; i++)
     {
-      g_hash_table_replace (
-        new_module->streams,
-        g_strdup ((const gchar *)key),
-        modulemd_modulestream_copy ((MODULEMD_MODULESTREAM (value))));
+      modulemd_improvedmodule_take_stream (
+        new_module,
+        modulemd_modulestream_copy (g_ptr_array_index (streams, i)));
     }
 
   /* Copy the defaults data */
@@ -298,8 +675,14 @@ modulemd_improvedmodule_class_init (ModulemdImprovedModuleClass *klass)
 static void
 modulemd_improvedmodule_init (ModulemdImprovedModule *self)
 {
+  self->all_streams =
+    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+  self->versions = g_hash_table_new_full (
+    g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_ptr_array_unref);
   self->streams =
     g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+  self->latest =
+    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
 }
 
 
@@ -307,27 +690,34 @@ GPtrArray *
 modulemd_improvedmodule_serialize (ModulemdImprovedModule *self)
 {
   g_autoptr (GPtrArray) objects = NULL;
-  g_autoptr (GPtrArray) keys = NULL;
+  g_autoptr (GPtrArray) streams = NULL;
   ModulemdModuleStream *stream = NULL;
+  ModulemdModuleStream *latest = NULL;
   ModulemdTranslation *translation = NULL;
 
   g_return_val_if_fail (MODULEMD_IS_IMPROVEDMODULE (self), NULL);
 
   /* First export all of the ModuleStream objects */
-  keys = _modulemd_ordered_str_keys (self->streams, _modulemd_strcmp_sort);
+  streams = modulemd_improvedmodule_get_all_streams (self);
 
   /* Preallocate the array to hold the full set of streams, plus the defaults */
-  objects = g_ptr_array_new_full (keys->len + 1, g_object_unref);
+  objects = g_ptr_array_new_full (streams->len + 1, g_object_unref);
 
-  for (gsize i = 0; i < keys->len; i++)
+  for (gsize i = 0; i < streams->len; i++)
     {
-      stream = modulemd_improvedmodule_get_stream_by_name (
-        self, g_ptr_array_index (keys, i));
+      latest = g_hash_table_lookup (
+        self->streams,
+        modulemd_modulestream_peek_stream (g_ptr_array_index (streams, i)));
+      stream = modulemd_modulestream_copy (g_ptr_array_index (streams, i));
       g_ptr_array_add (objects, stream);
 
       /* If there are translated strings associated with this stream, make sure
-       * to include those.
+       * to include those. Every version of a stream carries the same
+       * translations, so they are only written out with the latest one.
        */
+      if (latest != g_ptr_array_index (streams, i))
+        continue;
+
       translation = modulemd_modulestream_get_translation (stream);
       if (translation)
         g_ptr_array_add (objects, translation);
@@ -0,0 +1,642 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2017-2018 Stephen Gallagher
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+
+#include "modulemd.h"
+#include "modulemd-index.h"
+#include "private/modulemd-private.h"
+#include "private/modulemd-util.h"
+
+
+struct _ModulemdIndex
+{
+  GObject parent_instance;
+
+  /* The index this object was created from, by module name */
+  GHashTable *modules;
+
+  /* nsvc -> ModulemdModuleStream */
+  GHashTable *by_nsvc;
+
+  /* NEVRA -> GPtrArray of ModulemdModuleStream */
+  GHashTable *by_nevra;
+
+  /* RPM name -> GPtrArray of ModulemdModuleStream */
+  GHashTable *by_profile_rpm;
+
+  /* Module name -> GPtrArray of modulemd_index_dependent */
+  GHashTable *dependents;
+
+  /* "kinds:name:stream" -> sorted GPtrArray of ModulemdModuleStream, filled
+   * in as transitive queries are made
+   */
+  GMutex transitive_lock;
+  GHashTable *transitive;
+};
+
+/* One list of streams of a module that a stream depends on */
+typedef struct _modulemd_index_dependent
+{
+  ModulemdModuleStream *stream;
+  ModulemdDependencyKind kind;
+  gchar **stream_names;
+} modulemd_index_dependent;
+
+G_DEFINE_TYPE (ModulemdIndex, modulemd_index, G_TYPE_OBJECT)
+
+
+static void
+modulemd_index_finalize (GObject *object)
+{
+  ModulemdIndex *self = (ModulemdIndex *)object;
+
+  g_clear_pointer (&self->modules, g_hash_table_unref);
+  g_clear_pointer (&self->by_nsvc, g_hash_table_unref);
+  g_clear_pointer (&self->by_nevra, g_hash_table_unref);
+  g_clear_pointer (&self->by_profile_rpm, g_hash_table_unref);
+  g_clear_pointer (&self->dependents, g_hash_table_unref);
+  g_clear_pointer (&self->transitive, g_hash_table_unref);
+  g_mutex_clear (&self->transitive_lock);
+
+  G_OBJECT_CLASS (modulemd_index_parent_class)->finalize (object);
+}
+
+
+static void
+modulemd_index_class_init (ModulemdIndexClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = modulemd_index_finalize;
+}
+
+
+static void
+modulemd_index_init (ModulemdIndex *self)
+{
+  self->by_nsvc =
+    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+  self->by_nevra = g_hash_table_new_full (
+    g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_ptr_array_unref);
+  self->by_profile_rpm = g_hash_table_new_full (
+    g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_ptr_array_unref);
+  self->dependents = g_hash_table_new_full (
+    g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_ptr_array_unref);
+  self->transitive = g_hash_table_new_full (
+    g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_ptr_array_unref);
+  g_mutex_init (&self->transitive_lock);
+}
+
+
+static void
+_modulemd_index_dependent_free (modulemd_index_dependent *dependent)
+{
+  g_clear_object (&dependent->stream);
+  g_clear_pointer (&dependent->stream_names, g_strfreev);
+  g_free (dependent);
+}
+
+
+/* Records that the stream depends on the given streams of a module, taking
+ * ownership of the stream names
+ */
+static void
+_modulemd_index_add_dependent (ModulemdIndex *self,
+                               ModulemdModuleStream *stream,
+                               ModulemdDependencyKind kind,
+                               const gchar *module_name,
+                               gchar **stream_names)
+{
+  GPtrArray *dependents = NULL;
+  modulemd_index_dependent *dependent = NULL;
+
+  dependents = g_hash_table_lookup (self->dependents, module_name);
+  if (!dependents)
+    {
+      dependents = g_ptr_array_new_with_free_func (
+        (GDestroyNotify)_modulemd_index_dependent_free);
+      g_hash_table_insert (
+        self->dependents, g_strdup (module_name), dependents);
+    }
+
+  dependent = g_new0 (modulemd_index_dependent, 1);
+  dependent->stream = g_object_ref (stream);
+  dependent->kind = kind;
+  dependent->stream_names = stream_names;
+  g_ptr_array_add (dependents, dependent);
+}
+
+
+static void
+_modulemd_index_add_dependencies (ModulemdIndex *self,
+                                  ModulemdModuleStream *stream,
+                                  ModulemdDependencyKind kind,
+                                  GHashTable *modules)
+{
+  GHashTableIter iter;
+  gpointer key;
+  gpointer value;
+
+  if (!modules)
+    return;
+
+  g_hash_table_iter_init (&iter, modules);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      _modulemd_index_add_dependent (
+        self,
+        stream,
+        kind,
+        key,
+        modulemd_simpleset_dup (MODULEMD_SIMPLESET (value)));
+    }
+}
+
+
+/* Version 1 streams name exactly one stream of each module */
+static void
+_modulemd_index_add_v1_dependencies (ModulemdIndex *self,
+                                     ModulemdModuleStream *stream,
+                                     ModulemdDependencyKind kind,
+                                     GHashTable *modules)
+{
+  GHashTableIter iter;
+  gpointer key;
+  gpointer value;
+  gchar **stream_names = NULL;
+
+  if (!modules)
+    return;
+
+  g_hash_table_iter_init (&iter, modules);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      stream_names = g_new0 (gchar *, 2);
+      stream_names[0] = g_strdup (value);
+      _modulemd_index_add_dependent (self, stream, kind, key, stream_names);
+    }
+}
+
+
+static void
+_modulemd_index_add_stream_dependencies (ModulemdIndex *self,
+                                         ModulemdModuleStream *stream)
+{
+  GPtrArray *dependencies = NULL;
+  ModulemdDependencies *deps = NULL;
+
+  dependencies = modulemd_modulestream_peek_dependencies_readonly (stream);
+  for (gsize i = 0; dependencies && i < dependencies->len; i++)
+    {
+      deps = g_ptr_array_index (dependencies, i);
+      _modulemd_index_add_dependencies (
+        self,
+        stream,
+        MODULEMD_DEPENDENCY_REQUIRES,
+        modulemd_dependencies_peek_requires (deps));
+      _modulemd_index_add_dependencies (
+        self,
+        stream,
+        MODULEMD_DEPENDENCY_BUILDREQUIRES,
+        modulemd_dependencies_peek_buildrequires (deps));
+    }
+
+  _modulemd_index_add_v1_dependencies (
+    self,
+    stream,
+    MODULEMD_DEPENDENCY_REQUIRES,
+    modulemd_modulestream_peek_requires_readonly (stream));
+  _modulemd_index_add_v1_dependencies (
+    self,
+    stream,
+    MODULEMD_DEPENDENCY_BUILDREQUIRES,
+    modulemd_modulestream_peek_buildrequires_readonly (stream));
+}
+
+
+/* Adds the stream to the list stored under the key, taking ownership of the
+ * key. Streams are added one at a time, so a stream that is added under the
+ * same key more than once is always the last one in the list.
+ */
+static void
+_modulemd_index_add_stream (GHashTable *table,
+                            gchar *key,
+                            ModulemdModuleStream *stream)
+{
+  GPtrArray *streams = g_hash_table_lookup (table, key);
+
+  if (!streams)
+    {
+      streams = g_ptr_array_new_with_free_func (g_object_unref);
+      g_hash_table_insert (table, key, streams);
+    }
+  else
+    {
+      g_free (key);
+      if (g_ptr_array_index (streams, streams->len - 1) == stream)
+        return;
+    }
+
+  g_ptr_array_add (streams, g_object_ref (stream));
+}
+
+
+static void
+_modulemd_index_add_module (ModulemdIndex *self,
+                            ModulemdImprovedModule *module)
+{
+  g_autoptr (GPtrArray) streams = NULL;
+  ModulemdModuleStream *stream = NULL;
+  ModulemdSimpleSet *artifacts = NULL;
+  GHashTable *profiles = NULL;
+  GHashTableIter iter;
+  gpointer value;
+  gchar **strv = NULL;
+  gchar *nsvc = NULL;
+
+  /* Every version and context of each stream is indexed */
+  streams = modulemd_improvedmodule_get_all_streams (module);
+
+  for (gsize i = 0; i < streams->len; i++)
+    {
+      stream = g_ptr_array_index (streams, i);
+
+      /* Streams without a name, stream name and version have no NSVC */
+      nsvc = modulemd_modulestream_get_nsvc (stream);
+      if (nsvc)
+        g_hash_table_replace (self->by_nsvc, nsvc, g_object_ref (stream));
+
+      _modulemd_index_add_stream_dependencies (self, stream);
+
+      /* The keys are taken from the copies of the sets */
+      artifacts = modulemd_modulestream_peek_rpm_artifacts (stream);
+      if (artifacts)
+        {
+          strv = modulemd_simpleset_dup (artifacts);
+          for (gsize j = 0; strv[j]; j++)
+            _modulemd_index_add_stream (self->by_nevra, strv[j], stream);
+          g_free (strv);
+        }
+
+      profiles = modulemd_modulestream_peek_profiles_readonly (stream);
+      if (!profiles)
+        continue;
+
+      g_hash_table_iter_init (&iter, profiles);
+      while (g_hash_table_iter_next (&iter, NULL, &value))
+        {
+          strv = modulemd_simpleset_dup (
+            modulemd_profile_peek_rpms (MODULEMD_PROFILE (value)));
+          for (gsize j = 0; strv[j]; j++)
+            _modulemd_index_add_stream (
+              self->by_profile_rpm, strv[j], stream);
+          g_free (strv);
+        }
+    }
+}
+
+
+ModulemdIndex *
+modulemd_index_new (GHashTable *index)
+{
+  ModulemdIndex *self = NULL;
+  g_autoptr (GPtrArray) module_names = NULL;
+  ModulemdImprovedModule *module = NULL;
+  const gchar *name = NULL;
+
+  g_return_val_if_fail (index, NULL);
+
+  MMD_TRACE ("TRACE: entering modulemd_index_new");
+
+  self = g_object_new (MODULEMD_TYPE_INDEX, NULL);
+  self->modules = g_hash_table_new_full (
+    g_str_hash, g_str_equal, g_free, g_object_unref);
+
+  /* Modules are visited in order so that the lists of streams are sorted */
+  module_names = _modulemd_ordered_str_keys (index, _modulemd_strcmp_sort);
+  for (gsize i = 0; i < module_names->len; i++)
+    {
+      name = g_ptr_array_index (module_names, i);
+      module = g_hash_table_lookup (index, name);
+
+      g_hash_table_insert (
+        self->modules, g_strdup (name), g_object_ref (module));
+      _modulemd_index_add_module (self, module);
+    }
+
+  MMD_TRACE ("TRACE: exiting modulemd_index_new");
+  return self;
+}
+
+
+ModulemdIndex *
+modulemd_index_new_from_file (const gchar *yaml_file,
+                              GPtrArray **failures,
+                              GError **error)
+{
+  g_autoptr (GHashTable) index = NULL;
+
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  index = modulemd_index_from_file (yaml_file, failures, error);
+  if (!index)
+    return NULL;
+
+  return modulemd_index_new (index);
+}
+
+
+GHashTable *
+modulemd_index_get_modules (ModulemdIndex *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_INDEX (self), NULL);
+
+  return g_hash_table_ref (self->modules);
+}
+
+
+ModulemdImprovedModule *
+modulemd_index_peek_module (ModulemdIndex *self, const gchar *module_name)
+{
+  g_return_val_if_fail (MODULEMD_IS_INDEX (self), NULL);
+
+  return g_hash_table_lookup (self->modules, module_name);
+}
+
+
+ModulemdImprovedModule *
+modulemd_index_get_module (ModulemdIndex *self, const gchar *module_name)
+{
+  ModulemdImprovedModule *module = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_INDEX (self), NULL);
+
+  module = modulemd_index_peek_module (self, module_name);
+  if (!module)
+    return NULL;
+
+  return g_object_ref (module);
+}
+
+
+ModulemdModuleStream *
+modulemd_index_peek_stream_by_nsvc (ModulemdIndex *self, const gchar *nsvc)
+{
+  g_return_val_if_fail (MODULEMD_IS_INDEX (self), NULL);
+
+  return g_hash_table_lookup (self->by_nsvc, nsvc);
+}
+
+
+ModulemdModuleStream *
+modulemd_index_get_stream_by_nsvc (ModulemdIndex *self, const gchar *nsvc)
+{
+  ModulemdModuleStream *stream = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_INDEX (self), NULL);
+
+  stream = modulemd_index_peek_stream_by_nsvc (self, nsvc);
+  if (!stream)
+    return NULL;
+
+  return g_object_ref (stream);
+}
+
+
+static GPtrArray *
+_modulemd_index_dup_streams (GPtrArray *streams)
+{
+  GPtrArray *copy = NULL;
+
+  if (!streams)
+    return g_ptr_array_new_with_free_func (g_object_unref);
+
+  copy = g_ptr_array_new_full (streams->len, g_object_unref);
+  for (gsize i = 0; i < streams->len; i++)
+    g_ptr_array_add (copy, g_object_ref (g_ptr_array_index (streams, i)));
+
+  return copy;
+}
+
+
+GPtrArray *
+modulemd_index_peek_streams_by_nevra (ModulemdIndex *self, const gchar *nevra)
+{
+  g_return_val_if_fail (MODULEMD_IS_INDEX (self), NULL);
+
+  return g_hash_table_lookup (self->by_nevra, nevra);
+}
+
+
+GPtrArray *
+modulemd_index_get_streams_by_nevra (ModulemdIndex *self, const gchar *nevra)
+{
+  g_return_val_if_fail (MODULEMD_IS_INDEX (self), NULL);
+
+  return _modulemd_index_dup_streams (
+    modulemd_index_peek_streams_by_nevra (self, nevra));
+}
+
+
+GPtrArray *
+modulemd_index_peek_streams_by_profile_rpm (ModulemdIndex *self,
+                                            const gchar *rpm)
+{
+  g_return_val_if_fail (MODULEMD_IS_INDEX (self), NULL);
+
+  return g_hash_table_lookup (self->by_profile_rpm, rpm);
+}
+
+
+GPtrArray *
+modulemd_index_get_streams_by_profile_rpm (ModulemdIndex *self,
+                                           const gchar *rpm)
+{
+  g_return_val_if_fail (MODULEMD_IS_INDEX (self), NULL);
+
+  return _modulemd_index_dup_streams (
+    modulemd_index_peek_streams_by_profile_rpm (self, rpm));
+}
+
+
+static gint
+_modulemd_index_compare_streams (gconstpointer a, gconstpointer b)
+{
+  ModulemdModuleStream *stream_a = *(ModulemdModuleStream **)a;
+  ModulemdModuleStream *stream_b = *(ModulemdModuleStream **)b;
+  guint64 version_a = modulemd_modulestream_get_version (stream_a);
+  guint64 version_b = modulemd_modulestream_get_version (stream_b);
+  gint cmp;
+
+  cmp = g_strcmp0 (modulemd_modulestream_peek_name (stream_a),
+                   modulemd_modulestream_peek_name (stream_b));
+  if (cmp)
+    return cmp;
+
+  cmp = g_strcmp0 (modulemd_modulestream_peek_stream (stream_a),
+                   modulemd_modulestream_peek_stream (stream_b));
+  if (cmp)
+    return cmp;
+
+  if (version_a != version_b)
+    return version_a < version_b ? -1 : 1;
+
+  return g_strcmp0 (modulemd_modulestream_peek_context (stream_a),
+                    modulemd_modulestream_peek_context (stream_b));
+}
+
+
+/* Adds the direct dependents to the array without taking references.
+ * Dependencies are recorded one stream at a time, so a stream that depends on
+ * the module stream more than once is always the last one added.
+ */
+static void
+_modulemd_index_collect_dependents (ModulemdIndex *self,
+                                    const gchar *module_name,
+                                    const gchar *stream_name,
+                                    ModulemdDependencyKind kinds,
+                                    GPtrArray *result)
+{
+  GPtrArray *dependents = NULL;
+  modulemd_index_dependent *dependent = NULL;
+  ModulemdModuleStream *last = NULL;
+
+  dependents = g_hash_table_lookup (self->dependents, module_name);
+  if (!dependents)
+    return;
+
+  for (gsize i = 0; i < dependents->len; i++)
+    {
+      dependent = g_ptr_array_index (dependents, i);
+      if (!(dependent->kind & kinds) || dependent->stream == last)
+        continue;
+
+      if (_modulemd_stream_names_match (dependent->stream_names, stream_name))
+        {
+          last = dependent->stream;
+          g_ptr_array_add (result, last);
+        }
+    }
+}
+
+
+GPtrArray *
+modulemd_index_get_dependents (ModulemdIndex *self,
+                               const gchar *module_name,
+                               const gchar *stream_name,
+                               ModulemdDependencyKind kinds)
+{
+  g_autoptr (GPtrArray) dependents = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_INDEX (self), NULL);
+  g_return_val_if_fail (module_name && stream_name, NULL);
+
+  dependents = g_ptr_array_new ();
+  _modulemd_index_collect_dependents (
+    self, module_name, stream_name, kinds, dependents);
+  g_ptr_array_sort (dependents, _modulemd_index_compare_streams);
+
+  return _modulemd_index_dup_streams (dependents);
+}
+
+
+/* Must be called with the transitive_lock held */
+static GPtrArray *
+_modulemd_index_transitive_dependents (ModulemdIndex *self,
+                                       const gchar *module_name,
+                                       const gchar *stream_name,
+                                       ModulemdDependencyKind kinds)
+{
+  g_autoptr (GHashTable) found = NULL;
+  g_autoptr (GPtrArray) pending = NULL;
+  g_autofree gchar *query = NULL;
+  g_autofree gchar *key = NULL;
+  GPtrArray *cached = NULL;
+  GPtrArray *result = NULL;
+  ModulemdModuleStream *stream = NULL;
+  const gchar *name = NULL;
+  GHashTableIter iter;
+  gpointer value;
+
+  query = g_strdup_printf ("%u:%s:%s", kinds, module_name, stream_name);
+  cached = g_hash_table_lookup (self->transitive, query);
+  if (cached)
+    return cached;
+
+  found = g_hash_table_new (g_direct_hash, g_direct_equal);
+  pending = g_ptr_array_new ();
+  _modulemd_index_collect_dependents (
+    self, module_name, stream_name, kinds, pending);
+
+  while (pending->len > 0)
+    {
+      stream = g_ptr_array_remove_index_fast (pending, pending->len - 1);
+      if (!g_hash_table_add (found, stream))
+        continue;
+
+      name = modulemd_modulestream_peek_name (stream);
+      if (!name || !modulemd_modulestream_peek_stream (stream))
+        continue;
+
+      /* A stream whose dependents are already known doesn't need to be
+       * followed again: everything that depends on it is in its result.
+       */
+      g_clear_pointer (&key, g_free);
+      key = g_strdup_printf (
+        "%u:%s:%s", kinds, name, modulemd_modulestream_peek_stream (stream));
+      cached = g_hash_table_lookup (self->transitive, key);
+      if (cached)
+        {
+          for (gsize i = 0; i < cached->len; i++)
+            g_hash_table_add (found, g_ptr_array_index (cached, i));
+          continue;
+        }
+
+      _modulemd_index_collect_dependents (
+        self,
+        name,
+        modulemd_modulestream_peek_stream (stream),
+        kinds,
+        pending);
+    }
+
+  result = g_ptr_array_new_full (g_hash_table_size (found), g_object_unref);
+  g_hash_table_iter_init (&iter, found);
+  while (g_hash_table_iter_next (&iter, &value, NULL))
+    g_ptr_array_add (result, g_object_ref (value));
+  g_ptr_array_sort (result, _modulemd_index_compare_streams);
+
+  g_hash_table_insert (self->transitive, g_steal_pointer (&query), result);
+
+  return result;
+}
+
+
+GPtrArray *
+modulemd_index_get_transitive_dependents (ModulemdIndex *self,
+                                          const gchar *module_name,
+                                          const gchar *stream_name,
+                                          ModulemdDependencyKind kinds)
+{
+  GPtrArray *dependents = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_INDEX (self), NULL);
+  g_return_val_if_fail (module_name && stream_name, NULL);
+
+  g_mutex_lock (&self->transitive_lock);
+  dependents = _modulemd_index_dup_streams (
+    _modulemd_index_transitive_dependents (
+      self, module_name, stream_name, kinds));
+  g_mutex_unlock (&self->transitive_lock);
+
+  return dependents;
+}
@@ -426,6 +426,9 @@ modulemd_module_peek_content_licenses (ModulemdModule *self)
 {
   g_return_val_if_fail (MODULEMD_IS_MODULE (self), NULL);
 
+  /* Callers of this API may modify the set in place */
+  modulemd_modulestream_unshare (self->stream);
+
   return modulemd_modulestream_peek_content_licenses (self->stream);
 }
 
@@ -1057,6 +1060,9 @@ modulemd_module_peek_module_licenses (ModulemdModule *self)
 {
   g_return_val_if_fail (MODULEMD_IS_MODULE (self), NULL);
 
+  /* Callers of this API may modify the set in place */
+  modulemd_modulestream_unshare (self->stream);
+
   return modulemd_modulestream_peek_module_licenses (self->stream);
 }
 
@@ -1395,6 +1401,9 @@ modulemd_module_peek_rpm_api (ModulemdModule *self)
 {
   g_return_val_if_fail (MODULEMD_IS_MODULE (self), NULL);
 
+  /* Callers of this API may modify the set in place */
+  modulemd_modulestream_unshare (self->stream);
+
   return modulemd_modulestream_peek_rpm_api (self->stream);
 }
 
@@ -1475,6 +1484,9 @@ modulemd_module_peek_rpm_artifacts (ModulemdModule *self)
 {
   g_return_val_if_fail (MODULEMD_IS_MODULE (self), NULL);
 
+  /* Callers of this API may modify the set in place */
+  modulemd_modulestream_unshare (self->stream);
+
   return modulemd_modulestream_peek_rpm_artifacts (self->stream);
 }
 
@@ -1779,6 +1791,9 @@ modulemd_module_peek_rpm_filter (ModulemdModule *self)
 {
   g_return_val_if_fail (MODULEMD_IS_MODULE (self), NULL);
 
+  /* Callers of this API may modify the set in place */
+  modulemd_modulestream_unshare (self->stream);
+
   return modulemd_modulestream_peek_rpm_filter (self->stream);
 }
 
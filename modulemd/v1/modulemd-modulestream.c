@@ -61,6 +61,33 @@ static GParamSpec *properties[MD_N_PROPERTIES] = {
   NULL,
 };
 
+/* Members that copies of a stream share with the original, instead of copying
+ * them. The sets are documented as read-only to callers, so a stream only
+ * needs a private copy of one when a setter replaces it. The tables may be
+ * modified in place by callers, so a stream also takes a private copy of one
+ * before handing it out from its peek function. Members that are only ever
+ * replaced as a whole (buildopts, translation and the parsed xmd events) can
+ * be shared without being tracked here.
+ */
+enum
+{
+  MMD_SHARED_CONTENT_LICENSES = 1 << 0,
+  MMD_SHARED_MODULE_LICENSES = 1 << 1,
+  MMD_SHARED_RPM_API = 1 << 2,
+  MMD_SHARED_RPM_ARTIFACTS = 1 << 3,
+  MMD_SHARED_RPM_FILTER = 1 << 4,
+  MMD_SHARED_BUILDREQUIRES = 1 << 5,
+  MMD_SHARED_DEPENDENCIES = 1 << 6,
+  MMD_SHARED_MODULE_COMPONENTS = 1 << 7,
+  MMD_SHARED_PROFILES = 1 << 8,
+  MMD_SHARED_REQUIRES = 1 << 9,
+  MMD_SHARED_RPM_COMPONENTS = 1 << 10,
+  MMD_SHARED_SERVICELEVELS = 1 << 11,
+  MMD_SHARED_XMD = 1 << 12,
+
+  MMD_SHARED_ALL = (1 << 13) - 1
+};
+
 struct _ModulemdModuleStream
 {
   GObject parent_instance;
@@ -93,6 +120,21 @@ struct _ModulemdModuleStream
   ModulemdTranslation *translation;
   guint64 version;
   GHashTable *xmd;
+
+  /* The xmd as it was parsed, until it is first accessed. Reading the xmd
+   * replaces the events with the hash table, so both are protected by
+   * xmd_lock to let several threads read the same stream.
+   */
+  GArray *xmd_events;
+  GMutex xmd_lock;
+
+  /* MMD_SHARED_* flags for the members that may be shared with other streams.
+   * This is updated atomically, since copying a stream marks the members of
+   * the original as shared too. share_lock is held while a table is replaced
+   * by a private copy, so that concurrent peeks only copy it once.
+   */
+  guint shared;
+  GMutex share_lock;
 };
 
 G_DEFINE_TYPE (ModulemdModuleStream, modulemd_modulestream, G_TYPE_OBJECT)
@@ -106,43 +148,186 @@ modulemd_modulestream_new (void)
 
 
 static void
-_modulemd_modulestream_copy_internal (ModulemdModuleStream *dest,
-                                      ModulemdModuleStream *src)
+_modulemd_modulestream_share (gpointer *dest_member,
+                              gpointer src_member,
+                              GBoxedCopyFunc ref_func,
+                              GDestroyNotify unref_func)
 {
-  /* Set mdversion first */
-  modulemd_modulestream_set_mdversion (dest, src->mdversion);
+  gpointer old = *dest_member;
 
-  modulemd_modulestream_set_arch (dest, src->arch);
+  *dest_member = src_member ? ref_func (src_member) : NULL;
+  if (old)
+    unref_func (old);
+}
 
-  modulemd_modulestream_set_buildopts (dest, src->buildopts);
 
-  modulemd_modulestream_set_community (dest, src->community);
+/* Replaces the contents of *@set_member with those of @set. If the member is
+ * shared with other streams, a new set is allocated for it instead of
+ * modifying it in place. @set is copied before the old member is released,
+ * since it may be the member itself.
+ */
+static void
+_modulemd_modulestream_replace_set (ModulemdModuleStream *self,
+                                    guint member,
+                                    ModulemdSimpleSet **set_member,
+                                    ModulemdSimpleSet *set)
+{
+  ModulemdSimpleSet *new_set = NULL;
 
-  modulemd_modulestream_set_content_licenses (dest, src->content_licenses);
+  if (!(g_atomic_int_get (&self->shared) & member))
+    {
+      modulemd_simpleset_copy (set, set_member);
+      return;
+    }
 
-  modulemd_modulestream_set_context (dest, src->context);
+  modulemd_simpleset_copy (set, &new_set);
+  g_clear_pointer (set_member, g_object_unref);
+  *set_member = new_set;
 
-  modulemd_modulestream_set_description (dest, src->description);
+  g_atomic_int_and (&self->shared, ~member);
+}
 
-  modulemd_modulestream_set_documentation (dest, src->documentation);
 
-  modulemd_modulestream_set_module_components (dest, src->module_components);
+static void
+_modulemd_modulestream_swap_table (GHashTable **member, GHashTable *table)
+{
+  g_hash_table_unref (*member);
+  *member = table;
+}
 
-  modulemd_modulestream_set_module_licenses (dest, src->module_licenses);
 
-  modulemd_modulestream_set_name (dest, src->name);
+/* Gives the stream a private copy of one of the tables it may share with
+ * other streams, before the table is modified in place or handed out by a
+ * public peek function. If the caller replaces its contents anyway, the new
+ * table is left empty.
+ */
+static void
+_modulemd_modulestream_own_table (ModulemdModuleStream *self,
+                                  guint member,
+                                  gboolean keep_contents)
+{
+  GPtrArray *dependencies = NULL;
+
+  if (!(g_atomic_int_get (&self->shared) & member))
+    return;
+
+  g_mutex_lock (&self->share_lock);
+  if (!(g_atomic_int_get (&self->shared) & member))
+    {
+      g_mutex_unlock (&self->share_lock);
+      return;
+    }
+
+  switch (member)
+    {
+    case MMD_SHARED_BUILDREQUIRES:
+      _modulemd_modulestream_swap_table (
+        &self->buildrequires,
+        keep_contents ?
+          _modulemd_hash_table_deep_str_copy (self->buildrequires) :
+          g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free));
+      break;
+
+    case MMD_SHARED_REQUIRES:
+      _modulemd_modulestream_swap_table (
+        &self->requires,
+        keep_contents ?
+          _modulemd_hash_table_deep_str_copy (self->requires) :
+          g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free));
+      break;
+
+    case MMD_SHARED_MODULE_COMPONENTS:
+      _modulemd_modulestream_swap_table (
+        &self->module_components,
+        keep_contents ? modulemd_modulestream_get_module_components (self) :
+                        g_hash_table_new_full (
+                          g_str_hash, g_str_equal, g_free, g_object_unref));
+      break;
+
+    case MMD_SHARED_PROFILES:
+      _modulemd_modulestream_swap_table (
+        &self->profiles,
+        keep_contents ? modulemd_modulestream_get_profiles (self) :
+                        g_hash_table_new_full (
+                          g_str_hash, g_str_equal, g_free, g_object_unref));
+      break;
+
+    case MMD_SHARED_RPM_COMPONENTS:
+      _modulemd_modulestream_swap_table (
+        &self->rpm_components,
+        keep_contents ? modulemd_modulestream_get_rpm_components (self) :
+                        g_hash_table_new_full (
+                          g_str_hash, g_str_equal, g_free, g_object_unref));
+      break;
+
+    case MMD_SHARED_SERVICELEVELS:
+      _modulemd_modulestream_swap_table (
+        &self->servicelevels,
+        keep_contents ? modulemd_modulestream_get_servicelevels (self) :
+                        g_hash_table_new_full (
+                          g_str_hash, g_str_equal, g_free, g_object_unref));
+      break;
+
+    case MMD_SHARED_DEPENDENCIES:
+      dependencies = keep_contents ?
+                       modulemd_modulestream_get_dependencies (self) :
+                       g_ptr_array_new_with_free_func (g_object_unref);
+      g_ptr_array_unref (self->dependencies);
+      self->dependencies = dependencies;
+      break;
+
+    default: g_assert_not_reached ();
+    }
+
+  g_atomic_int_and (&self->shared, ~member);
+  g_mutex_unlock (&self->share_lock);
+}
+
+
+void
+modulemd_modulestream_unshare (ModulemdModuleStream *self)
+{
+  g_return_if_fail (MODULEMD_IS_MODULESTREAM (self));
+
+  _modulemd_modulestream_replace_set (self,
+                                      MMD_SHARED_CONTENT_LICENSES,
+                                      &self->content_licenses,
+                                      self->content_licenses);
+  _modulemd_modulestream_replace_set (self,
+                                      MMD_SHARED_MODULE_LICENSES,
+                                      &self->module_licenses,
+                                      self->module_licenses);
+  _modulemd_modulestream_replace_set (
+    self, MMD_SHARED_RPM_API, &self->rpm_api, self->rpm_api);
+  _modulemd_modulestream_replace_set (self,
+                                      MMD_SHARED_RPM_ARTIFACTS,
+                                      &self->rpm_artifacts,
+                                      self->rpm_artifacts);
+  _modulemd_modulestream_replace_set (
+    self, MMD_SHARED_RPM_FILTER, &self->rpm_filter, self->rpm_filter);
+}
 
-  modulemd_modulestream_set_profiles (dest, src->profiles);
 
-  modulemd_modulestream_set_rpm_api (dest, src->rpm_api);
+static void
+_modulemd_modulestream_copy_internal (ModulemdModuleStream *dest,
+                                      ModulemdModuleStream *src)
+{
+  guint shared = MMD_SHARED_ALL;
 
-  modulemd_modulestream_set_rpm_artifacts (dest, src->rpm_artifacts);
+  /* Set mdversion first */
+  modulemd_modulestream_set_mdversion (dest, src->mdversion);
 
-  modulemd_modulestream_set_rpm_components (dest, src->rpm_components);
+  modulemd_modulestream_set_arch (dest, src->arch);
+
+  modulemd_modulestream_set_community (dest, src->community);
+
+  modulemd_modulestream_set_context (dest, src->context);
+
+  modulemd_modulestream_set_description (dest, src->description);
 
-  modulemd_modulestream_set_rpm_filter (dest, src->rpm_filter);
+  modulemd_modulestream_set_documentation (dest, src->documentation);
 
-  modulemd_modulestream_set_servicelevels (dest, src->servicelevels);
+  modulemd_modulestream_set_name (dest, src->name);
 
   modulemd_modulestream_set_stream (dest, src->stream);
 
@@ -150,18 +335,87 @@ _modulemd_modulestream_copy_internal (ModulemdModuleStream *dest,
 
   modulemd_modulestream_set_tracker (dest, src->tracker);
 
-  modulemd_modulestream_set_translation (dest, src->translation);
-
   modulemd_modulestream_set_version (dest, src->version);
 
-  modulemd_modulestream_set_xmd (dest, src->xmd);
+  /* Everything else is shared with the source, so that copying a stream
+   * takes the same time however large it is. Each stream takes a private
+   * copy of a member before it changes it or hands it out for changing.
+   */
+  _modulemd_modulestream_share ((gpointer *)&dest->buildopts,
+                                src->buildopts,
+                                g_object_ref,
+                                g_object_unref);
+  _modulemd_modulestream_share ((gpointer *)&dest->content_licenses,
+                                src->content_licenses,
+                                g_object_ref,
+                                g_object_unref);
+  _modulemd_modulestream_share ((gpointer *)&dest->module_licenses,
+                                src->module_licenses,
+                                g_object_ref,
+                                g_object_unref);
+  _modulemd_modulestream_share ((gpointer *)&dest->rpm_api,
+                                src->rpm_api,
+                                g_object_ref,
+                                g_object_unref);
+  _modulemd_modulestream_share ((gpointer *)&dest->rpm_artifacts,
+                                src->rpm_artifacts,
+                                g_object_ref,
+                                g_object_unref);
+  _modulemd_modulestream_share ((gpointer *)&dest->rpm_filter,
+                                src->rpm_filter,
+                                g_object_ref,
+                                g_object_unref);
+  _modulemd_modulestream_share ((gpointer *)&dest->translation,
+                                src->translation,
+                                g_object_ref,
+                                g_object_unref);
+  _modulemd_modulestream_share ((gpointer *)&dest->module_components,
+                                src->module_components,
+                                (GBoxedCopyFunc)g_hash_table_ref,
+                                (GDestroyNotify)g_hash_table_unref);
+  _modulemd_modulestream_share ((gpointer *)&dest->profiles,
+                                src->profiles,
+                                (GBoxedCopyFunc)g_hash_table_ref,
+                                (GDestroyNotify)g_hash_table_unref);
+  _modulemd_modulestream_share ((gpointer *)&dest->rpm_components,
+                                src->rpm_components,
+                                (GBoxedCopyFunc)g_hash_table_ref,
+                                (GDestroyNotify)g_hash_table_unref);
+  _modulemd_modulestream_share ((gpointer *)&dest->servicelevels,
+                                src->servicelevels,
+                                (GBoxedCopyFunc)g_hash_table_ref,
+                                (GDestroyNotify)g_hash_table_unref);
+
+  g_mutex_lock (&src->xmd_lock);
+  if (src->xmd_events)
+    {
+      /* The events are never modified, so they aren't tracked as shared */
+      modulemd_modulestream_set_xmd_events (dest, src->xmd_events);
+      shared &= ~MMD_SHARED_XMD;
+    }
+  else
+    {
+      g_mutex_lock (&dest->xmd_lock);
+      _modulemd_modulestream_share ((gpointer *)&dest->xmd,
+                                    src->xmd,
+                                    (GBoxedCopyFunc)g_hash_table_ref,
+                                    (GDestroyNotify)g_hash_table_unref);
+      g_mutex_unlock (&dest->xmd_lock);
+    }
+  g_mutex_unlock (&src->xmd_lock);
 
 
   /* Version-specific content */
   if (src->mdversion == MD_VERSION_1)
     {
-      modulemd_modulestream_set_buildrequires (dest, src->buildrequires);
-      modulemd_modulestream_set_requires (dest, src->requires);
+      _modulemd_modulestream_share ((gpointer *)&dest->buildrequires,
+                                    src->buildrequires,
+                                    (GBoxedCopyFunc)g_hash_table_ref,
+                                    (GDestroyNotify)g_hash_table_unref);
+      _modulemd_modulestream_share ((gpointer *)&dest->requires,
+                                    src->requires,
+                                    (GBoxedCopyFunc)g_hash_table_ref,
+                                    (GDestroyNotify)g_hash_table_unref);
       if (modulemd_modulestream_peek_eol (src))
         {
           modulemd_modulestream_set_eol (dest, src->eol);
@@ -169,8 +423,25 @@ _modulemd_modulestream_copy_internal (ModulemdModuleStream *dest,
     }
   else if (src->mdversion >= MD_VERSION_2)
     {
-      modulemd_modulestream_set_dependencies (dest, src->dependencies);
+      _modulemd_modulestream_share ((gpointer *)&dest->dependencies,
+                                    src->dependencies,
+                                    (GBoxedCopyFunc)g_ptr_array_ref,
+                                    (GDestroyNotify)g_ptr_array_unref);
+      g_object_notify_by_pspec (G_OBJECT (dest), properties[PROP_DEPS]);
     }
+
+  /* Neither stream knows when the other one goes away, so both of them copy
+   * the shared members the next time they change them.
+   */
+  g_atomic_int_or (&src->shared, shared);
+  g_atomic_int_or (&dest->shared, shared);
+
+  g_object_notify_by_pspec (G_OBJECT (dest), properties[PROP_BUILDOPTS]);
+  g_object_notify_by_pspec (G_OBJECT (dest), properties[PROP_CONTENT_LIC]);
+  g_object_notify_by_pspec (G_OBJECT (dest), properties[PROP_MODULE_LIC]);
+  g_object_notify_by_pspec (G_OBJECT (dest), properties[PROP_RPM_API]);
+  g_object_notify_by_pspec (G_OBJECT (dest), properties[PROP_RPM_ARTIFACTS]);
+  g_object_notify_by_pspec (G_OBJECT (dest), properties[PROP_RPM_FILTER]);
 }
 
 
@@ -522,6 +793,7 @@ modulemd_modulestream_set_buildrequires (ModulemdModuleStream *self,
       return;
     }
 
+  _modulemd_modulestream_own_table (self, MMD_SHARED_BUILDREQUIRES, FALSE);
   g_hash_table_remove_all (self->buildrequires);
 
   if (buildrequires)
@@ -551,6 +823,18 @@ modulemd_modulestream_peek_buildrequires (ModulemdModuleStream *self)
 {
   g_return_val_if_fail (MODULEMD_IS_MODULESTREAM (self), NULL);
 
+  /* Callers of this API may modify the buildrequires in place */
+  _modulemd_modulestream_own_table (self, MMD_SHARED_BUILDREQUIRES, TRUE);
+
+  return self->buildrequires;
+}
+
+
+GHashTable *
+modulemd_modulestream_peek_buildrequires_readonly (ModulemdModuleStream *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_MODULESTREAM (self), NULL);
+
   return self->buildrequires;
 }
 
@@ -595,7 +879,8 @@ modulemd_modulestream_set_content_licenses (ModulemdModuleStream *self,
   g_return_if_fail (MODULEMD_IS_MODULESTREAM (self));
   g_return_if_fail (!licenses || MODULEMD_IS_SIMPLESET (licenses));
 
-  modulemd_simpleset_copy (licenses, &self->content_licenses);
+  _modulemd_modulestream_replace_set (
+    self, MMD_SHARED_CONTENT_LICENSES, &self->content_licenses, licenses);
 
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_CONTENT_LIC]);
 }
@@ -673,6 +958,11 @@ modulemd_modulestream_set_dependencies (ModulemdModuleStream *self,
       return;
     }
 
+  /* deps may be the shared array that is released here */
+  if (deps)
+    g_ptr_array_ref (deps);
+
+  _modulemd_modulestream_own_table (self, MMD_SHARED_DEPENDENCIES, FALSE);
   g_ptr_array_set_size (self->dependencies, 0);
 
   if (deps)
@@ -683,6 +973,7 @@ modulemd_modulestream_set_dependencies (ModulemdModuleStream *self,
           g_ptr_array_add (self->dependencies, g_object_ref (copy));
           g_clear_pointer (&copy, g_object_unref);
         }
+      g_ptr_array_unref (deps);
     }
 
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_DEPS]);
@@ -707,6 +998,7 @@ modulemd_modulestream_add_dependencies (ModulemdModuleStream *self,
       return;
     }
 
+  _modulemd_modulestream_own_table (self, MMD_SHARED_DEPENDENCIES, TRUE);
   modulemd_dependencies_copy (dep, &copy);
   g_ptr_array_add (self->dependencies, g_object_ref (copy));
   g_clear_pointer (&copy, g_object_unref);
@@ -743,6 +1035,18 @@ modulemd_modulestream_peek_dependencies (ModulemdModuleStream *self)
 {
   g_return_val_if_fail (MODULEMD_IS_MODULESTREAM (self), NULL);
 
+  /* Callers of this API may modify the dependencies in place */
+  _modulemd_modulestream_own_table (self, MMD_SHARED_DEPENDENCIES, TRUE);
+
+  return self->dependencies;
+}
+
+
+GPtrArray *
+modulemd_modulestream_peek_dependencies_readonly (ModulemdModuleStream *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_MODULESTREAM (self), NULL);
+
   return self->dependencies;
 }
 
@@ -926,6 +1230,7 @@ modulemd_modulestream_add_module_component (ModulemdModuleStream *self,
   g_return_if_fail (MODULEMD_IS_MODULESTREAM (self));
   g_return_if_fail (MODULEMD_IS_COMPONENT_MODULE (component));
 
+  _modulemd_modulestream_own_table (self, MMD_SHARED_MODULE_COMPONENTS, TRUE);
   g_hash_table_replace (
     self->module_components,
     modulemd_component_dup_name ((ModulemdComponent *)component),
@@ -939,6 +1244,7 @@ modulemd_modulestream_clear_module_components (ModulemdModuleStream *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULESTREAM (self));
 
+  _modulemd_modulestream_own_table (self, MMD_SHARED_MODULE_COMPONENTS, FALSE);
   g_hash_table_remove_all (self->module_components);
 }
 
@@ -958,7 +1264,12 @@ modulemd_modulestream_set_module_components (ModulemdModuleStream *self,
       return;
     }
 
-  /* For any other case, we'll assume a full replacement */
+  /* For any other case, we'll assume a full replacement. The table may be
+   * the shared one that is released when it is cleared.
+   */
+  if (components)
+    g_hash_table_ref (components);
+
   modulemd_modulestream_clear_module_components (self);
 
   if (components)
@@ -975,6 +1286,7 @@ modulemd_modulestream_set_module_components (ModulemdModuleStream *self,
             MODULEMD_COMPONENT_MODULE (
               modulemd_component_copy (MODULEMD_COMPONENT (value))));
         }
+      g_hash_table_unref (components);
     }
 }
 
@@ -1007,6 +1319,19 @@ modulemd_modulestream_peek_module_components (ModulemdModuleStream *self)
 {
   g_return_val_if_fail (MODULEMD_IS_MODULESTREAM (self), NULL);
 
+  /* Callers of this API may modify the module components in place */
+  _modulemd_modulestream_own_table (self, MMD_SHARED_MODULE_COMPONENTS, TRUE);
+
+  return self->module_components;
+}
+
+
+GHashTable *
+modulemd_modulestream_peek_module_components_readonly (
+  ModulemdModuleStream *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_MODULESTREAM (self), NULL);
+
   return self->module_components;
 }
 
@@ -1018,7 +1343,8 @@ modulemd_modulestream_set_module_licenses (ModulemdModuleStream *self,
   g_return_if_fail (MODULEMD_IS_MODULESTREAM (self));
   g_return_if_fail (!licenses || MODULEMD_IS_SIMPLESET (licenses));
 
-  modulemd_simpleset_copy (licenses, &self->module_licenses);
+  _modulemd_modulestream_replace_set (
+    self, MMD_SHARED_MODULE_LICENSES, &self->module_licenses, licenses);
 
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_MODULE_LIC]);
 }
@@ -1089,6 +1415,7 @@ modulemd_modulestream_add_profile (ModulemdModuleStream *self,
     modulemd_profile_associate_translation (profile, self->translation);
 
 
+  _modulemd_modulestream_own_table (self, MMD_SHARED_PROFILES, TRUE);
   g_hash_table_replace (self->profiles,
                         modulemd_profile_dup_name ((ModulemdProfile *)profile),
                         modulemd_profile_copy (profile));
@@ -1100,6 +1427,7 @@ modulemd_modulestream_clear_profiles (ModulemdModuleStream *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULESTREAM (self));
 
+  _modulemd_modulestream_own_table (self, MMD_SHARED_PROFILES, FALSE);
   g_hash_table_remove_all (self->profiles);
 }
 
@@ -1120,7 +1448,12 @@ modulemd_modulestream_set_profiles (ModulemdModuleStream *self,
       return;
     }
 
-  /* For any other case, we'll assume a full replacement */
+  /* For any other case, we'll assume a full replacement. The table may be
+   * the shared one that is released when it is cleared.
+   */
+  if (profiles)
+    g_hash_table_ref (profiles);
+
   modulemd_modulestream_clear_profiles (self);
 
   if (profiles)
@@ -1130,6 +1463,7 @@ modulemd_modulestream_set_profiles (ModulemdModuleStream *self,
         {
           modulemd_modulestream_add_profile (self, (MODULEMD_PROFILE (value)));
         }
+      g_hash_table_unref (profiles);
     }
 }
 
@@ -1161,6 +1495,18 @@ modulemd_modulestream_peek_profiles (ModulemdModuleStream *self)
 {
   g_return_val_if_fail (MODULEMD_IS_MODULESTREAM (self), NULL);
 
+  /* Callers of this API may modify the profiles in place */
+  _modulemd_modulestream_own_table (self, MMD_SHARED_PROFILES, TRUE);
+
+  return self->profiles;
+}
+
+
+GHashTable *
+modulemd_modulestream_peek_profiles_readonly (ModulemdModuleStream *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_MODULESTREAM (self), NULL);
+
   return self->profiles;
 }
 
@@ -1184,6 +1530,7 @@ modulemd_modulestream_set_requires (ModulemdModuleStream *self,
       return;
     }
 
+  _modulemd_modulestream_own_table (self, MMD_SHARED_REQUIRES, FALSE);
   g_hash_table_remove_all (self->requires);
 
   if (requires)
@@ -1213,6 +1560,18 @@ modulemd_modulestream_peek_requires (ModulemdModuleStream *self)
 {
   g_return_val_if_fail (MODULEMD_IS_MODULESTREAM (self), NULL);
 
+  /* Callers of this API may modify the requires in place */
+  _modulemd_modulestream_own_table (self, MMD_SHARED_REQUIRES, TRUE);
+
+  return self->requires;
+}
+
+
+GHashTable *
+modulemd_modulestream_peek_requires_readonly (ModulemdModuleStream *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_MODULESTREAM (self), NULL);
+
   return self->requires;
 }
 
@@ -1224,7 +1583,8 @@ modulemd_modulestream_set_rpm_api (ModulemdModuleStream *self,
   g_return_if_fail (MODULEMD_IS_MODULESTREAM (self));
   g_return_if_fail (!apis || MODULEMD_IS_SIMPLESET (apis));
 
-  modulemd_simpleset_copy (apis, &self->rpm_api);
+  _modulemd_modulestream_replace_set (
+    self, MMD_SHARED_RPM_API, &self->rpm_api, apis);
 
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_RPM_API]);
 }
@@ -1257,7 +1617,8 @@ modulemd_modulestream_set_rpm_artifacts (ModulemdModuleStream *self,
   g_return_if_fail (MODULEMD_IS_MODULESTREAM (self));
   g_return_if_fail (!artifacts || MODULEMD_IS_SIMPLESET (artifacts));
 
-  modulemd_simpleset_copy (artifacts, &self->rpm_artifacts);
+  _modulemd_modulestream_replace_set (
+    self, MMD_SHARED_RPM_ARTIFACTS, &self->rpm_artifacts, artifacts);
 
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_RPM_ARTIFACTS]);
 }
@@ -1291,6 +1652,7 @@ modulemd_modulestream_add_rpm_component (ModulemdModuleStream *self,
   g_return_if_fail (MODULEMD_IS_MODULESTREAM (self));
   g_return_if_fail (MODULEMD_IS_COMPONENT_RPM (component));
 
+  _modulemd_modulestream_own_table (self, MMD_SHARED_RPM_COMPONENTS, TRUE);
   g_hash_table_replace (
     self->rpm_components,
     modulemd_component_dup_name (MODULEMD_COMPONENT (component)),
@@ -1304,6 +1666,7 @@ modulemd_modulestream_clear_rpm_components (ModulemdModuleStream *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULESTREAM (self));
 
+  _modulemd_modulestream_own_table (self, MMD_SHARED_RPM_COMPONENTS, FALSE);
   g_hash_table_remove_all (self->rpm_components);
 }
 
@@ -1323,7 +1686,12 @@ modulemd_modulestream_set_rpm_components (ModulemdModuleStream *self,
       return;
     }
 
-  /* For any other case, we'll assume a full replacement */
+  /* For any other case, we'll assume a full replacement. The table may be
+   * the shared one that is released when it is cleared.
+   */
+  if (components)
+    g_hash_table_ref (components);
+
   modulemd_modulestream_clear_rpm_components (self);
 
   if (components)
@@ -1341,6 +1709,7 @@ modulemd_modulestream_set_rpm_components (ModulemdModuleStream *self,
             MODULEMD_COMPONENT_RPM (
               modulemd_component_copy (MODULEMD_COMPONENT (value))));
         }
+      g_hash_table_unref (components);
     }
 }
 
@@ -1373,6 +1742,18 @@ modulemd_modulestream_peek_rpm_components (ModulemdModuleStream *self)
 {
   g_return_val_if_fail (MODULEMD_IS_MODULESTREAM (self), NULL);
 
+  /* Callers of this API may modify the rpm components in place */
+  _modulemd_modulestream_own_table (self, MMD_SHARED_RPM_COMPONENTS, TRUE);
+
+  return self->rpm_components;
+}
+
+
+GHashTable *
+modulemd_modulestream_peek_rpm_components_readonly (ModulemdModuleStream *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_MODULESTREAM (self), NULL);
+
   return self->rpm_components;
 }
 
@@ -1384,7 +1765,8 @@ modulemd_modulestream_set_rpm_filter (ModulemdModuleStream *self,
   g_return_if_fail (MODULEMD_IS_MODULESTREAM (self));
   g_return_if_fail (!filter || MODULEMD_IS_SIMPLESET (filter));
 
-  modulemd_simpleset_copy (filter, &self->rpm_filter);
+  _modulemd_modulestream_replace_set (
+    self, MMD_SHARED_RPM_FILTER, &self->rpm_filter, filter);
 
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_RPM_FILTER]);
 }
@@ -1416,6 +1798,7 @@ modulemd_modulestream_clear_servicelevels (ModulemdModuleStream *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULESTREAM (self));
 
+  _modulemd_modulestream_own_table (self, MMD_SHARED_SERVICELEVELS, FALSE);
   g_hash_table_remove_all (self->servicelevels);
 }
 
@@ -1436,7 +1819,12 @@ modulemd_modulestream_set_servicelevels (ModulemdModuleStream *self,
       return;
     }
 
-  /* For any other case, we'll assume a full replacement */
+  /* For any other case, we'll assume a full replacement. The table may be
+   * the shared one that is released when it is cleared.
+   */
+  if (servicelevels)
+    g_hash_table_ref (servicelevels);
+
   modulemd_modulestream_clear_servicelevels (self);
 
   if (servicelevels)
@@ -1468,6 +1856,7 @@ modulemd_modulestream_set_servicelevels (ModulemdModuleStream *self,
             g_strdup (name),
             modulemd_servicelevel_copy (MODULEMD_SERVICELEVEL (value)));
         }
+      g_hash_table_unref (servicelevels);
     }
 }
 
@@ -1494,6 +1883,7 @@ modulemd_modulestream_add_servicelevel (ModulemdModuleStream *self,
       return;
     }
 
+  _modulemd_modulestream_own_table (self, MMD_SHARED_SERVICELEVELS, TRUE);
   g_hash_table_replace (self->servicelevels,
                         g_strdup (name),
                         modulemd_servicelevel_copy (servicelevel));
@@ -1528,6 +1918,18 @@ modulemd_modulestream_peek_servicelevels (ModulemdModuleStream *self)
 {
   g_return_val_if_fail (MODULEMD_IS_MODULESTREAM (self), NULL);
 
+  /* Callers of this API may modify the servicelevels in place */
+  _modulemd_modulestream_own_table (self, MMD_SHARED_SERVICELEVELS, TRUE);
+
+  return self->servicelevels;
+}
+
+
+GHashTable *
+modulemd_modulestream_peek_servicelevels_readonly (ModulemdModuleStream *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_MODULESTREAM (self), NULL);
+
   return self->servicelevels;
 }
 
@@ -1697,6 +2099,7 @@ modulemd_modulestream_set_translation (ModulemdModuleStream *self,
       self->translation = modulemd_translation_copy (translation);
 
       /* Associate this translation with profiles */
+      _modulemd_modulestream_own_table (self, MMD_SHARED_PROFILES, TRUE);
       g_hash_table_iter_init (&iter, self->profiles);
       while (g_hash_table_iter_next (&iter, &key, &value))
         {
@@ -1743,6 +2146,10 @@ modulemd_modulestream_set_xmd (ModulemdModuleStream *self, GHashTable *xmd)
 {
   g_return_if_fail (MODULEMD_IS_MODULESTREAM (self));
 
+  g_mutex_lock (&self->xmd_lock);
+
+  g_clear_pointer (&self->xmd_events, g_array_unref);
+
   if (xmd != self->xmd)
     {
       if (self->xmd)
@@ -1758,25 +2165,110 @@ modulemd_modulestream_set_xmd (ModulemdModuleStream *self, GHashTable *xmd)
         {
           self->xmd = NULL;
         }
+
+      g_atomic_int_and (&self->shared, ~MMD_SHARED_XMD);
     }
+
+  g_mutex_unlock (&self->xmd_lock);
+}
+
+
+void
+modulemd_modulestream_set_xmd_events (ModulemdModuleStream *self,
+                                      GArray *events)
+{
+  g_return_if_fail (MODULEMD_IS_MODULESTREAM (self));
+
+  /* The events are never modified, so copies of the stream share them */
+  g_array_ref (events);
+
+  g_mutex_lock (&self->xmd_lock);
+  g_clear_pointer (&self->xmd_events, g_array_unref);
+  self->xmd_events = events;
+
+  g_clear_pointer (&self->xmd, g_hash_table_unref);
+  g_atomic_int_and (&self->shared, ~MMD_SHARED_XMD);
+  g_mutex_unlock (&self->xmd_lock);
+}
+
+
+GArray *
+modulemd_modulestream_dup_xmd_events (ModulemdModuleStream *self)
+{
+  GArray *events = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_MODULESTREAM (self), NULL);
+
+  g_mutex_lock (&self->xmd_lock);
+  if (self->xmd_events)
+    events = g_array_ref (self->xmd_events);
+  g_mutex_unlock (&self->xmd_lock);
+
+  return events;
+}
+
+
+/* Must be called with xmd_lock held */
+static void
+_modulemd_modulestream_load_xmd (ModulemdModuleStream *self)
+{
+  g_autoptr (GError) error = NULL;
+
+  if (!self->xmd_events)
+    return;
+
+  /* The events were validated when they were parsed */
+  self->xmd = parse_xmd_events (self->xmd_events, &error);
+  if (!self->xmd)
+    {
+      g_warning ("Could not read the xmd: %s", error->message);
+      self->xmd = g_hash_table_new_full (
+        g_str_hash, g_str_equal, g_free, modulemd_variant_unref);
+    }
+
+  g_clear_pointer (&self->xmd_events, g_array_unref);
 }
 
 
 GHashTable *
 modulemd_modulestream_get_xmd (ModulemdModuleStream *self)
 {
+  GHashTable *xmd = NULL;
+
   g_return_val_if_fail (MODULEMD_IS_MODULESTREAM (self), NULL);
 
-  return _modulemd_hash_table_deep_variant_copy (self->xmd);
+  g_mutex_lock (&self->xmd_lock);
+  _modulemd_modulestream_load_xmd (self);
+  xmd = _modulemd_hash_table_deep_variant_copy (self->xmd);
+  g_mutex_unlock (&self->xmd_lock);
+
+  return xmd;
 }
 
 
 GHashTable *
 modulemd_modulestream_peek_xmd (ModulemdModuleStream *self)
 {
+  GHashTable *xmd = NULL;
+
   g_return_val_if_fail (MODULEMD_IS_MODULESTREAM (self), NULL);
 
-  return self->xmd;
+  g_mutex_lock (&self->xmd_lock);
+  _modulemd_modulestream_load_xmd (self);
+
+  /* Callers of this API may modify the xmd in place */
+  if (self->xmd && (g_atomic_int_get (&self->shared) & MMD_SHARED_XMD))
+    {
+      xmd = _modulemd_hash_table_deep_variant_copy (self->xmd);
+      g_hash_table_unref (self->xmd);
+      self->xmd = xmd;
+    }
+  g_atomic_int_and (&self->shared, ~MMD_SHARED_XMD);
+
+  xmd = self->xmd;
+  g_mutex_unlock (&self->xmd_lock);
+
+  return xmd;
 }
 
 
@@ -2032,6 +2524,9 @@ modulemd_modulestream_finalize (GObject *gobject)
   g_clear_pointer (&self->summary, g_free);
   g_clear_pointer (&self->tracker, g_free);
   g_clear_pointer (&self->xmd, g_hash_table_unref);
+  g_clear_pointer (&self->xmd_events, g_array_unref);
+  g_mutex_clear (&self->xmd_lock);
+  g_mutex_clear (&self->share_lock);
 
   G_OBJECT_CLASS (modulemd_modulestream_parent_class)->finalize (gobject);
 }
@@ -2230,6 +2725,9 @@ modulemd_modulestream_init (ModulemdModuleStream *self)
   /* Allocate the members */
   self->buildopts = modulemd_buildopts_new ();
 
+  g_mutex_init (&self->xmd_lock);
+  g_mutex_init (&self->share_lock);
+
   self->buildrequires =
     g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
 
@@ -23,11 +23,37 @@ modulemd_prioritizer_error_quark (void)
   return g_quark_from_static_string ("modulemd-prioritizer-error-quark");
 }
 
+/* The objects added at one priority level. The defaults are merged as they
+ * are added, so that only the modules whose defaults changed have to be
+ * merged again.
+ */
+typedef struct _modulemd_priority_level
+{
+  /* Everything but the defaults, in the order they were added */
+  GPtrArray *objects;
+
+  /* The merged ModulemdDefaults at this level, by module name */
+  GHashTable *defaults;
+} modulemd_priority_level;
+
 struct _ModulemdPrioritizer
 {
   GObject parent_instance;
 
   GHashTable *priorities;
+
+  /* The maximum number of threads to merge defaults with */
+  guint n_threads;
+
+  /* The ModulemdDefaults merged across all priority levels, by module name,
+   * as of the last call to modulemd_prioritizer_resolve()
+   */
+  GHashTable *resolved_defaults;
+
+  /* The names of the modules whose defaults have been added since they were
+   * last resolved
+   */
+  GHashTable *unresolved;
 };
 
 G_DEFINE_TYPE (ModulemdPrioritizer, modulemd_prioritizer, G_TYPE_OBJECT)
@@ -44,6 +70,8 @@ modulemd_prioritizer_finalize (GObject *object)
   ModulemdPrioritizer *self = (ModulemdPrioritizer *)object;
 
   g_clear_pointer (&self->priorities, g_hash_table_unref);
+  g_clear_pointer (&self->resolved_defaults, g_hash_table_unref);
+  g_clear_pointer (&self->unresolved, g_hash_table_unref);
 
   G_OBJECT_CLASS (modulemd_prioritizer_parent_class)->finalize (object);
 }
@@ -60,17 +88,57 @@ modulemd_prioritizer_class_init (ModulemdPrioritizerClass *klass)
   object_class->set_property = NULL;
 }
 
+static modulemd_priority_level *
+_modulemd_priority_level_new (void)
+{
+  modulemd_priority_level *level = g_new0 (modulemd_priority_level, 1);
+
+  level->objects = g_ptr_array_new_with_free_func (g_object_unref);
+  level->defaults =
+    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+
+  return level;
+}
+
 static void
-_modulemd_ptr_array_unref (gpointer ptr)
+_modulemd_priority_level_free (gpointer ptr)
 {
-  g_ptr_array_unref ((GPtrArray *)ptr);
+  modulemd_priority_level *level = (modulemd_priority_level *)ptr;
+
+  g_clear_pointer (&level->objects, g_ptr_array_unref);
+  g_clear_pointer (&level->defaults, g_hash_table_unref);
+  g_free (level);
 }
 
 static void
 modulemd_prioritizer_init (ModulemdPrioritizer *self)
 {
+  self->n_threads = 1;
   self->priorities = g_hash_table_new_full (
-    g_int64_hash, g_int64_equal, g_free, _modulemd_ptr_array_unref);
+    g_int64_hash, g_int64_equal, g_free, _modulemd_priority_level_free);
+  self->resolved_defaults =
+    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+  self->unresolved =
+    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+}
+
+
+void
+modulemd_prioritizer_set_n_threads (ModulemdPrioritizer *self,
+                                    guint n_threads)
+{
+  g_return_if_fail (MODULEMD_IS_PRIORITIZER (self));
+
+  self->n_threads = n_threads;
+}
+
+
+guint
+modulemd_prioritizer_get_n_threads (ModulemdPrioritizer *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_PRIORITIZER (self), 1);
+
+  return self->n_threads;
 }
 
 
@@ -80,9 +148,13 @@ modulemd_prioritizer_add (ModulemdPrioritizer *self,
                           gint64 priority,
                           GError **error)
 {
-  GPtrArray *current_objects = NULL;
-  g_autoptr (GPtrArray) concat_objects = NULL;
-  g_autoptr (GPtrArray) merged_objects = NULL;
+  modulemd_priority_level *level = NULL;
+  g_autoptr (GPtrArray) groups = NULL;
+  g_autoptr (GHashTable) groups_by_name = NULL;
+  modulemd_defaults_group *group = NULL;
+  GObject *object = NULL;
+  ModulemdDefaults *current = NULL;
+  const gchar *module_name = NULL;
   gint64 *prio = NULL;
   gsize i;
 
@@ -110,57 +182,69 @@ modulemd_prioritizer_add (ModulemdPrioritizer *self,
       return FALSE;
     }
 
-  prio = g_new0 (gint64, 1);
-  *prio = priority;
+  level = g_hash_table_lookup (self->priorities, &priority);
 
-  current_objects = g_hash_table_lookup (self->priorities, prio);
-
-  /* All values at the same priority level can be concatenated together
-   * because the merge routine will handle it cleanly that way and with
-   * less memory-usage. Any duplication will be cleaned up as part of the
-   * merge logic. For performance reasons, we'll assume the common case that
-   * there is no deduplication to happen and allocate enough memory for all
-   * of the possible elements of the array up front.
+  /* Merge the new defaults with the ones already at this level, in the same
+   * order as modulemd_merge_defaults() would if the level were merged again
+   * from scratch. Nothing is stored until all of them have merged cleanly, so
+   * a conflict leaves the prioritizer as it was.
    */
-  if (current_objects)
-    {
-      concat_objects = g_ptr_array_new_full (
-        current_objects->len + objects->len, g_object_unref);
-    }
-  else
+  groups = g_ptr_array_new_with_free_func (
+    (GDestroyNotify)modulemd_defaults_group_free);
+  groups_by_name = g_hash_table_new (g_str_hash, g_str_equal);
+  for (i = 0; i < objects->len; i++)
     {
-      concat_objects = g_ptr_array_new_full (objects->len, g_object_unref);
+      object = g_ptr_array_index (objects, i);
+      if (!MODULEMD_IS_DEFAULTS (object))
+        continue;
+
+      module_name =
+        modulemd_defaults_peek_module_name (MODULEMD_DEFAULTS (object));
+      group = g_hash_table_lookup (groups_by_name, module_name);
+      if (!group)
+        {
+          group = modulemd_defaults_group_new (module_name);
+          g_ptr_array_add (groups, group);
+          g_hash_table_insert (groups_by_name, group->module_name, group);
+
+          current =
+            level ? g_hash_table_lookup (level->defaults, module_name) : NULL;
+          if (current)
+            modulemd_defaults_group_add (group, current, FALSE, i);
+        }
+
+      modulemd_defaults_group_add (
+        group, MODULEMD_DEFAULTS (object), FALSE, i);
     }
 
-  if (current_objects)
+  if (!modulemd_defaults_groups_merge (groups, self->n_threads, error))
+    return FALSE;
+
+  if (!level)
     {
-      for (i = 0; i < current_objects->len; i++)
-        {
-          g_ptr_array_add (
-            concat_objects,
-            g_object_ref (g_ptr_array_index (current_objects, i)));
-        }
+      prio = g_new0 (gint64, 1);
+      *prio = priority;
+      level = _modulemd_priority_level_new ();
+      g_hash_table_replace (self->priorities, prio, level);
     }
 
   for (i = 0; i < objects->len; i++)
     {
-      g_ptr_array_add (concat_objects,
-                       g_object_ref (g_ptr_array_index (objects, i)));
+      object = g_ptr_array_index (objects, i);
+      if (!MODULEMD_IS_DEFAULTS (object))
+        g_ptr_array_add (level->objects, g_object_ref (object));
     }
 
-  merged_objects =
-    modulemd_merge_defaults (concat_objects, NULL, FALSE, error);
-  if (!merged_objects)
+  /* Only these modules need to be resolved again */
+  for (i = 0; i < groups->len; i++)
     {
-      /* Something went wrong. Return the error here. */
-      g_clear_pointer (&prio, g_free);
-      return FALSE;
+      group = g_ptr_array_index (groups, i);
+      g_hash_table_replace (level->defaults,
+                            g_strdup (group->module_name),
+                            g_object_ref (group->merged));
+      g_hash_table_add (self->unresolved, g_strdup (group->module_name));
     }
 
-  /* Replace or insert the new objects at this priority level */
-  g_hash_table_replace (
-    self->priorities, prio, g_ptr_array_ref (merged_objects));
-
   return TRUE;
 }
 
@@ -187,19 +271,24 @@ modulemd_prioritizer_add_index (ModulemdPrioritizer *self,
 GPtrArray *
 modulemd_prioritizer_resolve (ModulemdPrioritizer *self, GError **error)
 {
-  g_autoptr (GPtrArray) current = NULL;
-  g_autoptr (GPtrArray) next = NULL;
-  g_autoptr (GPtrArray) tmp = NULL;
+  g_autoptr (GPtrArray) resolved = NULL;
+  g_autoptr (GPtrArray) unresolved_names = NULL;
+  g_autoptr (GPtrArray) module_names = NULL;
+  g_autoptr (GPtrArray) groups = NULL;
   g_autoptr (GList) priority_levels = NULL;
-  GList *current_level = NULL;
+  modulemd_priority_level *level = NULL;
+  modulemd_defaults_group *group = NULL;
+  ModulemdDefaults *defaults = NULL;
+  const gchar *module_name = NULL;
+  guint position = 0;
+  gsize i;
 
   g_return_val_if_fail (MODULEMD_IS_PRIORITIZER (self), FALSE);
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  current_level = priority_levels =
-    _modulemd_ordered_int64_keys (self->priorities);
+  priority_levels = _modulemd_ordered_int64_keys (self->priorities);
 
-  if (!current_level)
+  if (!priority_levels)
     {
       /* Nothing has been added to the resolver. */
       g_set_error (error,
@@ -210,30 +299,69 @@ modulemd_prioritizer_resolve (ModulemdPrioritizer *self, GError **error)
       return NULL;
     }
 
-  current = g_ptr_array_ref (
-    g_hash_table_lookup (self->priorities, priority_levels->data));
+  /* Only the modules whose defaults were added since the last call are merged
+   * again. The others keep the result from before. Higher priority levels
+   * override the lower ones.
+   */
+  unresolved_names =
+    _modulemd_ordered_str_keys (self->unresolved, _modulemd_strcmp_sort);
+  groups = g_ptr_array_new_full (unresolved_names->len,
+                                 (GDestroyNotify)modulemd_defaults_group_free);
+  for (i = 0; i < unresolved_names->len; i++)
+    {
+      module_name = g_ptr_array_index (unresolved_names, i);
+      group = modulemd_defaults_group_new (module_name);
+      g_ptr_array_add (groups, group);
+
+      for (GList *current = priority_levels; current; current = current->next)
+        {
+          level = g_hash_table_lookup (self->priorities, current->data);
+          defaults = g_hash_table_lookup (level->defaults, module_name);
+          if (defaults)
+            modulemd_defaults_group_add (group, defaults, TRUE, position++);
+        }
+    }
+
+  if (!modulemd_defaults_groups_merge (groups, self->n_threads, error))
+    {
+      /* Something went wrong with the merge. Return the error */
+      return NULL;
+    }
 
-  while (current_level->next)
+  for (i = 0; i < groups->len; i++)
     {
-      next = g_ptr_array_ref (
-        g_hash_table_lookup (self->priorities, current_level->next->data));
+      group = g_ptr_array_index (groups, i);
+      g_hash_table_replace (self->resolved_defaults,
+                            g_strdup (group->module_name),
+                            g_object_ref (group->merged));
+    }
+  g_hash_table_remove_all (self->unresolved);
 
-      /* Merge the values, replacing any conflicts */
-      tmp = modulemd_merge_defaults (current, next, TRUE, error);
-      if (!tmp)
+  /* The other objects are never merged. They come first, from the lowest
+   * priority level to the highest, followed by the defaults in order of
+   * module name.
+   */
+  resolved = g_ptr_array_new_with_free_func (g_object_unref);
+  for (GList *current = priority_levels; current; current = current->next)
+    {
+      level = g_hash_table_lookup (self->priorities, current->data);
+      for (i = 0; i < level->objects->len; i++)
         {
-          /* Something went wrong with the merge. Return the error */
-          return NULL;
+          g_ptr_array_add (
+            resolved, g_object_ref (g_ptr_array_index (level->objects, i)));
         }
-      g_clear_pointer (&current, g_ptr_array_unref);
-      current = g_ptr_array_ref (tmp);
-      g_clear_pointer (&tmp, g_ptr_array_unref);
-      g_clear_pointer (&next, g_ptr_array_unref);
+    }
 
-      current_level = current_level->next;
+  module_names = _modulemd_ordered_str_keys (self->resolved_defaults,
+                                             _modulemd_strcmp_sort);
+  for (i = 0; i < module_names->len; i++)
+    {
+      defaults = g_hash_table_lookup (self->resolved_defaults,
+                                      g_ptr_array_index (module_names, i));
+      g_ptr_array_add (resolved, g_object_ref (defaults));
     }
 
-  return g_ptr_array_ref (current);
+  return g_steal_pointer (&resolved);
 }
 
 
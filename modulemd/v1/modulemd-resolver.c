@@ -0,0 +1,698 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2017-2018 Stephen Gallagher
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+
+#include "modulemd.h"
+#include "modulemd-resolver.h"
+#include <string.h>
+#include "private/modulemd-improvedmodule-private.h"
+#include "private/modulemd-private.h"
+#include "private/modulemd-util.h"
+
+
+GQuark
+modulemd_resolver_error_quark (void)
+{
+  return g_quark_from_static_string ("modulemd-resolver-error-quark");
+}
+
+
+#define MMD_BITSET_WORDS(n) (((n) + 63) / 64)
+#define MMD_BITSET_TEST(set, i) (((set)[(i) / 64] >> ((i) % 64)) & 1)
+#define MMD_BITSET_SET(set, i)                                                \
+  ((set)[(i) / 64] |= G_GUINT64_CONSTANT (1) << ((i) % 64))
+
+
+/* The streams of a module are numbered consecutively, in the order of their
+ * names and contexts, from first. Each context of the latest version of a
+ * stream is a separate candidate. Stream numbers within the module are
+ * relative to first.
+ */
+typedef struct _modulemd_resolver_module
+{
+  gchar *name;
+  guint first;
+  guint n_streams;
+  gchar *default_stream;
+
+  /* Stream name -> number of its first context within the module, plus one */
+  GHashTable *stream_ids;
+} modulemd_resolver_module;
+
+typedef struct _modulemd_resolver_stream
+{
+  gchar *name;
+  guint module;
+  ModulemdModuleStream *stream;
+
+  /* GPtrArray of requirements for each of the stream's ModulemdDependencies,
+   * any one of which is enough, or NULL if it has no dependencies
+   */
+  GPtrArray *alternatives;
+} modulemd_resolver_stream;
+
+/* A dependency on some of the streams of a module. Modules that are not in
+ * the index have no stream numbers, so their streams are matched by name.
+ */
+typedef struct _modulemd_resolver_requirement
+{
+  gint module;
+  gchar *module_name;
+  gchar **stream_names;
+
+  /* The stream numbers within the module that are accepted */
+  guint64 *accepted;
+} modulemd_resolver_requirement;
+
+
+struct _ModulemdResolver
+{
+  GObject parent_instance;
+
+  /* Module name -> module number, plus one */
+  GHashTable *module_ids;
+
+  GArray *modules;
+  GArray *streams;
+};
+
+G_DEFINE_TYPE (ModulemdResolver, modulemd_resolver, G_TYPE_OBJECT)
+
+
+static void
+modulemd_resolver_finalize (GObject *object)
+{
+  ModulemdResolver *self = (ModulemdResolver *)object;
+
+  g_clear_pointer (&self->module_ids, g_hash_table_unref);
+  g_clear_pointer (&self->streams, g_array_unref);
+  g_clear_pointer (&self->modules, g_array_unref);
+
+  G_OBJECT_CLASS (modulemd_resolver_parent_class)->finalize (object);
+}
+
+
+static void
+modulemd_resolver_class_init (ModulemdResolverClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = modulemd_resolver_finalize;
+}
+
+
+static void
+_modulemd_resolver_module_clear (gpointer data)
+{
+  modulemd_resolver_module *module = data;
+
+  g_clear_pointer (&module->name, g_free);
+  g_clear_pointer (&module->default_stream, g_free);
+  g_clear_pointer (&module->stream_ids, g_hash_table_unref);
+}
+
+
+static void
+_modulemd_resolver_stream_clear (gpointer data)
+{
+  modulemd_resolver_stream *stream = data;
+
+  g_clear_pointer (&stream->name, g_free);
+  g_clear_object (&stream->stream);
+  g_clear_pointer (&stream->alternatives, g_ptr_array_unref);
+}
+
+
+static void
+_modulemd_resolver_requirement_free (modulemd_resolver_requirement *req)
+{
+  g_clear_pointer (&req->module_name, g_free);
+  g_clear_pointer (&req->stream_names, g_strfreev);
+  g_clear_pointer (&req->accepted, g_free);
+  g_free (req);
+}
+
+
+static void
+modulemd_resolver_init (ModulemdResolver *self)
+{
+  self->module_ids =
+    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+  self->modules =
+    g_array_new (FALSE, FALSE, sizeof (modulemd_resolver_module));
+  g_array_set_clear_func (self->modules, _modulemd_resolver_module_clear);
+
+  self->streams =
+    g_array_new (FALSE, FALSE, sizeof (modulemd_resolver_stream));
+  g_array_set_clear_func (self->streams, _modulemd_resolver_stream_clear);
+}
+
+
+/* Takes ownership of the stream names */
+static modulemd_resolver_requirement *
+_modulemd_resolver_requirement_new (ModulemdResolver *self,
+                                    const gchar *module_name,
+                                    gchar **stream_names)
+{
+  modulemd_resolver_requirement *req = NULL;
+  modulemd_resolver_module *module = NULL;
+  modulemd_resolver_stream *stream = NULL;
+  guint id;
+
+  req = g_new0 (modulemd_resolver_requirement, 1);
+  req->module_name = g_strdup (module_name);
+  req->stream_names = stream_names;
+
+  id = GPOINTER_TO_UINT (g_hash_table_lookup (self->module_ids, module_name));
+  if (!id)
+    {
+      req->module = -1;
+      return req;
+    }
+
+  req->module = id - 1;
+  module = &g_array_index (self->modules, modulemd_resolver_module, id - 1);
+  req->accepted = g_new0 (guint64, MMD_BITSET_WORDS (module->n_streams));
+  for (guint i = 0; i < module->n_streams; i++)
+    {
+      stream = &g_array_index (
+        self->streams, modulemd_resolver_stream, module->first + i);
+      if (_modulemd_stream_names_match (stream_names, stream->name))
+        MMD_BITSET_SET (req->accepted, i);
+    }
+
+  return req;
+}
+
+
+static GPtrArray *
+_modulemd_resolver_get_alternatives (ModulemdResolver *self,
+                                     ModulemdModuleStream *stream)
+{
+  g_autoptr (GPtrArray) alternatives = NULL;
+  GPtrArray *requirements = NULL;
+  GPtrArray *dependencies = NULL;
+  GHashTable *requires = NULL;
+  GHashTableIter iter;
+  gpointer key;
+  gpointer value;
+  gchar **stream_names = NULL;
+
+  alternatives =
+    g_ptr_array_new_with_free_func ((GDestroyNotify)g_ptr_array_unref);
+
+  dependencies = modulemd_modulestream_peek_dependencies_readonly (stream);
+  for (gsize i = 0; dependencies && i < dependencies->len; i++)
+    {
+      requirements = g_ptr_array_new_with_free_func (
+        (GDestroyNotify)_modulemd_resolver_requirement_free);
+      g_ptr_array_add (alternatives, requirements);
+
+      requires = modulemd_dependencies_peek_requires (
+        g_ptr_array_index (dependencies, i));
+      if (!requires)
+        continue;
+
+      g_hash_table_iter_init (&iter, requires);
+      while (g_hash_table_iter_next (&iter, &key, &value))
+        {
+          stream_names = modulemd_simpleset_dup (MODULEMD_SIMPLESET (value));
+          g_ptr_array_add (
+            requirements,
+            _modulemd_resolver_requirement_new (self, key, stream_names));
+        }
+    }
+
+  /* Version 1 streams require exactly one stream of each module */
+  requires = modulemd_modulestream_peek_requires_readonly (stream);
+  if (alternatives->len == 0 && requires && g_hash_table_size (requires))
+    {
+      requirements = g_ptr_array_new_with_free_func (
+        (GDestroyNotify)_modulemd_resolver_requirement_free);
+      g_ptr_array_add (alternatives, requirements);
+
+      g_hash_table_iter_init (&iter, requires);
+      while (g_hash_table_iter_next (&iter, &key, &value))
+        {
+          stream_names = g_new0 (gchar *, 2);
+          stream_names[0] = g_strdup (value);
+          g_ptr_array_add (
+            requirements,
+            _modulemd_resolver_requirement_new (self, key, stream_names));
+        }
+    }
+
+  if (alternatives->len == 0)
+    return NULL;
+
+  return g_steal_pointer (&alternatives);
+}
+
+
+ModulemdResolver *
+modulemd_resolver_new (ModulemdIndex *index)
+{
+  ModulemdResolver *self = NULL;
+  g_autoptr (GHashTable) modules = NULL;
+  g_autoptr (GPtrArray) module_names = NULL;
+  g_autoptr (GHashTable) streams = NULL;
+  g_autoptr (GPtrArray) stream_names = NULL;
+  ModulemdImprovedModule *improved = NULL;
+  ModulemdDefaults *defaults = NULL;
+  const gchar *default_stream = NULL;
+  GPtrArray *versions = NULL;
+  modulemd_resolver_module module;
+  modulemd_resolver_stream stream;
+  modulemd_resolver_stream *entry = NULL;
+  guint64 latest;
+  guint first;
+
+  g_return_val_if_fail (MODULEMD_IS_INDEX (index), NULL);
+
+  MMD_TRACE ("TRACE: entering modulemd_resolver_new");
+
+  self = g_object_new (MODULEMD_TYPE_RESOLVER, NULL);
+
+  /* Number the modules and their streams in order of their names */
+  modules = modulemd_index_get_modules (index);
+  module_names = _modulemd_ordered_str_keys (modules, _modulemd_strcmp_sort);
+  for (guint i = 0; i < module_names->len; i++)
+    {
+      improved = g_hash_table_lookup (modules,
+                                      g_ptr_array_index (module_names, i));
+
+      memset (&module, 0, sizeof (module));
+      module.name = g_strdup (g_ptr_array_index (module_names, i));
+      module.first = self->streams->len;
+      module.stream_ids = g_hash_table_new (g_str_hash, g_str_equal);
+
+      streams = modulemd_improvedmodule_get_streams (improved);
+      stream_names =
+        _modulemd_ordered_str_keys (streams, _modulemd_strcmp_sort);
+      for (guint j = 0; j < stream_names->len; j++)
+        {
+          /* Builds of the latest version for different contexts may have
+           * different dependencies, so each of them is a candidate
+           */
+          versions = modulemd_improvedmodule_peek_stream_versions (
+            improved, g_ptr_array_index (stream_names, j));
+          latest = modulemd_modulestream_get_version (
+            g_ptr_array_index (versions, versions->len - 1));
+          first = versions->len - 1;
+          while (first > 0 &&
+                 modulemd_modulestream_get_version (
+                   g_ptr_array_index (versions, first - 1)) == latest)
+            first--;
+
+          for (guint k = first; k < versions->len; k++)
+            {
+              memset (&stream, 0, sizeof (stream));
+              stream.name = g_strdup (g_ptr_array_index (stream_names, j));
+              stream.module = i;
+              stream.stream = g_object_ref (g_ptr_array_index (versions, k));
+              g_array_append_val (self->streams, stream);
+
+              if (k == first)
+                g_hash_table_insert (
+                  module.stream_ids,
+                  stream.name,
+                  GUINT_TO_POINTER (self->streams->len - module.first));
+            }
+        }
+      module.n_streams = self->streams->len - module.first;
+
+      defaults = modulemd_improvedmodule_peek_defaults (improved);
+      default_stream =
+        defaults ? modulemd_defaults_peek_default_stream (defaults) : NULL;
+      if (default_stream &&
+          g_hash_table_contains (module.stream_ids, default_stream))
+        module.default_stream = g_strdup (default_stream);
+
+      g_array_append_val (self->modules, module);
+      g_hash_table_insert (
+        self->module_ids, g_strdup (module.name), GUINT_TO_POINTER (i + 1));
+
+      g_clear_pointer (&stream_names, g_ptr_array_unref);
+      g_clear_pointer (&streams, g_hash_table_unref);
+    }
+
+  /* Every module is numbered before any dependency is encoded */
+  for (guint i = 0; i < self->streams->len; i++)
+    {
+      entry = &g_array_index (self->streams, modulemd_resolver_stream, i);
+      entry->alternatives =
+        _modulemd_resolver_get_alternatives (self, entry->stream);
+    }
+
+  MMD_TRACE ("TRACE: exiting modulemd_resolver_new");
+  return self;
+}
+
+
+typedef struct _modulemd_resolver_state
+{
+  ModulemdResolver *resolver;
+
+  /* The selected stream number within each module, or -1 */
+  gint *selected;
+
+  /* Module name -> stream name, for the requested modules that are not in
+   * the index
+   */
+  GHashTable *provided;
+
+  /* The selected streams, in the order they were selected. The dependencies
+   * of those before the current position are satisfied.
+   */
+  GArray *pending;
+
+  /* The dependency that could not be satisfied with the most streams
+   * selected, and the stream that has it or -1 for the request
+   */
+  const modulemd_resolver_requirement *conflict;
+  gint conflict_stream;
+  guint conflict_depth;
+} modulemd_resolver_state;
+
+
+static void
+_modulemd_resolver_record_conflict (modulemd_resolver_state *state,
+                                    gint requirer,
+                                    const modulemd_resolver_requirement *req)
+{
+  if (state->conflict && state->pending->len < state->conflict_depth)
+    return;
+
+  state->conflict = req;
+  state->conflict_stream = requirer;
+  state->conflict_depth = state->pending->len;
+}
+
+
+static gboolean
+_modulemd_resolver_resolve_from (modulemd_resolver_state *state, guint next);
+
+
+/* Satisfies the requirements from the i-th on, selecting streams as needed,
+ * and then the dependencies of the selected streams from the next one on. On
+ * failure, every stream selected by this call is deselected again.
+ */
+static gboolean
+_modulemd_resolver_resolve_requirements (modulemd_resolver_state *state,
+                                         GPtrArray *requirements,
+                                         guint i,
+                                         gint requirer,
+                                         guint next)
+{
+  modulemd_resolver_requirement *req = NULL;
+  modulemd_resolver_module *module = NULL;
+  modulemd_resolver_stream *candidate = NULL;
+  const gchar *provided = NULL;
+  gboolean is_default;
+  gint selected;
+  guint stream_id;
+
+  if (i == requirements->len)
+    return _modulemd_resolver_resolve_from (state, next);
+
+  req = g_ptr_array_index (requirements, i);
+
+  if (req->module < 0)
+    {
+      provided = g_hash_table_lookup (state->provided, req->module_name);
+      if (provided &&
+          _modulemd_stream_names_match (req->stream_names, provided))
+        {
+          return _modulemd_resolver_resolve_requirements (
+            state, requirements, i + 1, requirer, next);
+        }
+
+      _modulemd_resolver_record_conflict (state, requirer, req);
+      return FALSE;
+    }
+
+  selected = state->selected[req->module];
+  if (selected >= 0)
+    {
+      if (MMD_BITSET_TEST (req->accepted, selected))
+        {
+          return _modulemd_resolver_resolve_requirements (
+            state, requirements, i + 1, requirer, next);
+        }
+
+      _modulemd_resolver_record_conflict (state, requirer, req);
+      return FALSE;
+    }
+
+  /* The contexts of the default stream are tried first, and then the
+   * others in order
+   */
+  module = &g_array_index (
+    state->resolver->modules, modulemd_resolver_module, req->module);
+  for (guint pass = 0; pass < 2; pass++)
+    {
+      for (guint n = 0; n < module->n_streams; n++)
+        {
+          stream_id = module->first + n;
+          candidate = &g_array_index (
+            state->resolver->streams, modulemd_resolver_stream, stream_id);
+          is_default =
+            g_strcmp0 (candidate->name, module->default_stream) == 0;
+          if (is_default != (pass == 0) ||
+              !MMD_BITSET_TEST (req->accepted, n))
+            continue;
+
+          state->selected[req->module] = n;
+          g_array_append_val (state->pending, stream_id);
+
+          if (_modulemd_resolver_resolve_requirements (
+                state, requirements, i + 1, requirer, next))
+            return TRUE;
+
+          g_array_set_size (state->pending, state->pending->len - 1);
+          state->selected[req->module] = -1;
+        }
+    }
+
+  _modulemd_resolver_record_conflict (state, requirer, req);
+  return FALSE;
+}
+
+
+static gboolean
+_modulemd_resolver_resolve_from (modulemd_resolver_state *state, guint next)
+{
+  modulemd_resolver_stream *stream = NULL;
+  guint stream_id;
+
+  if (next == state->pending->len)
+    return TRUE;
+
+  stream_id = g_array_index (state->pending, guint, next);
+  stream = &g_array_index (
+    state->resolver->streams, modulemd_resolver_stream, stream_id);
+
+  if (!stream->alternatives)
+    return _modulemd_resolver_resolve_from (state, next + 1);
+
+  for (guint i = 0; i < stream->alternatives->len; i++)
+    {
+      if (_modulemd_resolver_resolve_requirements (
+            state,
+            g_ptr_array_index (stream->alternatives, i),
+            0,
+            stream_id,
+            next + 1))
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+
+static void
+_modulemd_resolver_set_conflict_error (ModulemdResolver *self,
+                                       modulemd_resolver_state *state,
+                                       GError **error)
+{
+  const modulemd_resolver_requirement *req = state->conflict;
+  modulemd_resolver_stream *stream = NULL;
+  modulemd_resolver_module *module = NULL;
+  const gchar *context = NULL;
+  g_autofree gchar *requirer = NULL;
+  g_autofree gchar *stream_names = NULL;
+
+  if (state->conflict_stream < 0)
+    {
+      requirer = g_strdup ("the request");
+    }
+  else
+    {
+      stream = &g_array_index (
+        self->streams, modulemd_resolver_stream, state->conflict_stream);
+      module = &g_array_index (
+        self->modules, modulemd_resolver_module, stream->module);
+      context = modulemd_modulestream_peek_context (stream->stream);
+      requirer = g_strdup_printf ("%s:%s%s%s",
+                                  module->name,
+                                  stream->name,
+                                  context ? ":" : "",
+                                  context ? context : "");
+    }
+
+  if (req->stream_names[0])
+    stream_names = g_strjoinv (", ", req->stream_names);
+  else
+    stream_names = g_strdup ("any stream");
+
+  g_set_error (error,
+               MODULEMD_RESOLVER_ERROR,
+               MODULEMD_RESOLVER_UNSATISFIABLE,
+               "Could not satisfy the dependency of %s on module %s [%s]",
+               requirer,
+               req->module_name,
+               stream_names);
+}
+
+
+GPtrArray *
+modulemd_resolver_resolve (ModulemdResolver *self,
+                           const gchar **requests,
+                           GError **error)
+{
+  g_autoptr (GPtrArray) requirements = NULL;
+  g_autoptr (GHashTable) provided = NULL;
+  g_autoptr (GArray) pending = NULL;
+  g_autofree gint *selected = NULL;
+  g_auto (GStrv) request = NULL;
+  modulemd_resolver_state state = { 0 };
+  modulemd_resolver_module *module = NULL;
+  const gchar *existing = NULL;
+  gchar **stream_names = NULL;
+  GPtrArray *result = NULL;
+  ModulemdModuleStream *stream = NULL;
+  guint id;
+
+  g_return_val_if_fail (MODULEMD_IS_RESOLVER (self), NULL);
+  g_return_val_if_fail (requests, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  MMD_TRACE ("TRACE: entering modulemd_resolver_resolve");
+
+  requirements = g_ptr_array_new_with_free_func (
+    (GDestroyNotify)_modulemd_resolver_requirement_free);
+  provided = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+  for (gsize i = 0; requests[i]; i++)
+    {
+      g_clear_pointer (&request, g_strfreev);
+      request = g_strsplit (requests[i], ":", 2);
+      if (!request[0] || !request[0][0] || (request[1] && !request[1][0]))
+        {
+          g_set_error (error,
+                       MODULEMD_RESOLVER_ERROR,
+                       MODULEMD_RESOLVER_INVALID_REQUEST,
+                       "Invalid request \"%s\"",
+                       requests[i]);
+          return NULL;
+        }
+
+      id = GPOINTER_TO_UINT (
+        g_hash_table_lookup (self->module_ids, request[0]));
+      if (!id)
+        {
+          /* Modules that are not in the index are provided by the request */
+          if (!request[1])
+            {
+              g_set_error (error,
+                           MODULEMD_RESOLVER_ERROR,
+                           MODULEMD_RESOLVER_INVALID_REQUEST,
+                           "Module %s is not in the index",
+                           request[0]);
+              return NULL;
+            }
+
+          existing = g_hash_table_lookup (provided, request[0]);
+          if (existing && !g_str_equal (existing, request[1]))
+            {
+              g_set_error (error,
+                           MODULEMD_RESOLVER_ERROR,
+                           MODULEMD_RESOLVER_UNSATISFIABLE,
+                           "Both %s:%s and %s:%s were requested",
+                           request[0],
+                           existing,
+                           request[0],
+                           request[1]);
+              return NULL;
+            }
+
+          g_hash_table_replace (
+            provided, g_strdup (request[0]), g_strdup (request[1]));
+          continue;
+        }
+
+      module =
+        &g_array_index (self->modules, modulemd_resolver_module, id - 1);
+      if (request[1] &&
+          !g_hash_table_contains (module->stream_ids, request[1]))
+        {
+          g_set_error (error,
+                       MODULEMD_RESOLVER_ERROR,
+                       MODULEMD_RESOLVER_INVALID_REQUEST,
+                       "Module %s has no stream %s",
+                       request[0],
+                       request[1]);
+          return NULL;
+        }
+
+      stream_names = g_new0 (gchar *, 2);
+      stream_names[0] = g_strdup (request[1]);
+      g_ptr_array_add (
+        requirements,
+        _modulemd_resolver_requirement_new (self, request[0], stream_names));
+    }
+
+  selected = g_new (gint, self->modules->len);
+  for (guint i = 0; i < self->modules->len; i++)
+    selected[i] = -1;
+  pending = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  state.resolver = self;
+  state.selected = selected;
+  state.provided = provided;
+  state.pending = pending;
+
+  if (!_modulemd_resolver_resolve_requirements (
+        &state, requirements, 0, -1, 0))
+    {
+      _modulemd_resolver_set_conflict_error (self, &state, error);
+      return NULL;
+    }
+
+  result = g_ptr_array_new_full (pending->len, g_object_unref);
+  for (guint i = 0; i < self->modules->len; i++)
+    {
+      if (selected[i] < 0)
+        continue;
+
+      module = &g_array_index (self->modules, modulemd_resolver_module, i);
+      stream = g_array_index (self->streams,
+                              modulemd_resolver_stream,
+                              module->first + selected[i])
+                 .stream;
+      g_ptr_array_add (result, g_object_ref (stream));
+    }
+
+  MMD_TRACE ("TRACE: exiting modulemd_resolver_resolve");
+  return result;
+}
@@ -103,7 +103,7 @@ modulemd_simpleset_set (ModulemdSimpleSet *self, gchar **set)
   /* Add in the whole new set to make sure we have everything */
   for (gsize i = 0; set[i]; i++)
     {
-      if (g_hash_table_add (self->set, g_strdup (set[i])))
+      if (g_hash_table_add (self->set, modulemd_string_intern (set[i])))
         {
           /* This key didn't previously exist */
           do_notify = TRUE;
@@ -148,7 +148,7 @@ modulemd_simpleset_dup (ModulemdSimpleSet *self)
 void
 modulemd_simpleset_add (ModulemdSimpleSet *self, const gchar *value)
 {
-  if (g_hash_table_add (self->set, g_strdup (value)))
+  if (g_hash_table_add (self->set, modulemd_string_intern (value)))
     {
       /* This key didn't previously exist */
       g_object_notify_by_pspec (G_OBJECT (self), set_properties[SET_PROP_SET]);
@@ -278,7 +278,11 @@ modulemd_simpleset_init (ModulemdSimpleSet *self)
 {
   /* Allocate the hash table */
   /* Free only once, since the key and value will be the same */
-  self->set = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  /* The values are GRefStrings, so that they can be shared with other sets
+   * through a string pool
+   */
+  self->set = g_hash_table_new_full (
+    g_str_hash, g_str_equal, (GDestroyNotify)g_ref_string_release, NULL);
 }
 
 ModulemdSimpleSet *
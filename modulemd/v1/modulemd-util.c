@@ -146,6 +146,34 @@ modulemd_variant_unref (void *ptr)
   g_variant_unref ((GVariant *)ptr);
 }
 
+/* A stream matches a list that names it, a list of exclusions such as "-f27"
+ * that does not exclude it, or an empty list
+ */
+gboolean
+_modulemd_stream_names_match (gchar **stream_names, const gchar *stream_name)
+{
+  gboolean have_exclusions = FALSE;
+
+  if (!stream_names[0])
+    return TRUE;
+
+  for (gsize i = 0; stream_names[i]; i++)
+    {
+      if (stream_names[i][0] == '-')
+        {
+          if (g_str_equal (stream_names[i] + 1, stream_name))
+            return FALSE;
+          have_exclusions = TRUE;
+        }
+      else if (g_str_equal (stream_names[i], stream_name))
+        {
+          return TRUE;
+        }
+    }
+
+  return have_exclusions;
+}
+
 gboolean
 modulemd_validate_nevra (const gchar *nevra)
 {
@@ -244,24 +272,129 @@ modulemd_validate_nevra (const gchar *nevra)
 }
 
 
-modulemd_tracer *
-modulemd_trace_init (const gchar *function_name)
+gint _modulemd_trace_state = MMD_TRACE_STATE_UNKNOWN;
+
+
+gboolean
+modulemd_trace_enabled (void)
 {
-  modulemd_tracer *self = g_malloc0_n (1, sizeof (modulemd_tracer));
-  self->function_name = g_strdup (function_name);
+  gint state = g_atomic_int_get (&_modulemd_trace_state);
+  const gchar *domains = NULL;
+
+  if (G_LIKELY (state != MMD_TRACE_STATE_UNKNOWN))
+    return state == MMD_TRACE_STATE_ON;
+
+  /* Mirror the check done by the default GLib log writer */
+  domains = g_getenv ("G_MESSAGES_DEBUG");
+  if (domains != NULL &&
+      (strstr (domains, "all") != NULL ||
+       strstr (domains, G_LOG_DOMAIN) != NULL))
+    state = MMD_TRACE_STATE_ON;
+  else
+    state = MMD_TRACE_STATE_OFF;
 
-  g_debug ("TRACE: Entering %s", self->function_name);
+  g_atomic_int_set (&_modulemd_trace_state, state);
 
-  return self;
+  return state == MMD_TRACE_STATE_ON;
 }
 
 
 void
-modulemd_trace_free (modulemd_tracer *tracer)
+modulemd_trace_init (modulemd_tracer *tracer, const gchar *function_name)
+{
+  tracer->function_name = function_name;
+
+  g_debug ("TRACE: Entering %s", tracer->function_name);
+}
+
+
+void
+modulemd_trace_finish (modulemd_tracer *tracer)
 {
   g_debug ("TRACE: Exiting %s", tracer->function_name);
-  g_clear_pointer (&tracer->function_name, g_free);
-  g_free (tracer);
+  tracer->function_name = NULL;
+}
+
+
+struct _modulemd_string_pool
+{
+  GMutex lock;
+  GHashTable *strings;
+};
+
+static GPrivate string_pool_thread_default;
+
+
+modulemd_string_pool *
+modulemd_string_pool_new (void)
+{
+  modulemd_string_pool *pool = g_new0 (modulemd_string_pool, 1);
+
+  g_mutex_init (&pool->lock);
+  pool->strings = g_hash_table_new_full (
+    g_str_hash, g_str_equal, (GDestroyNotify)g_ref_string_release, NULL);
+
+  return pool;
+}
+
+
+void
+modulemd_string_pool_free (modulemd_string_pool *pool)
+{
+  if (pool == NULL)
+    return;
+
+  /* Strings still referenced by other objects survive this */
+  g_clear_pointer (&pool->strings, g_hash_table_unref);
+  g_mutex_clear (&pool->lock);
+  g_free (pool);
+}
+
+
+modulemd_string_pool *
+modulemd_string_pool_get_thread_default (void)
+{
+  return g_private_get (&string_pool_thread_default);
+}
+
+
+modulemd_string_pool *
+modulemd_string_pool_set_thread_default (modulemd_string_pool *pool)
+{
+  modulemd_string_pool *previous = g_private_get (&string_pool_thread_default);
+
+  g_private_set (&string_pool_thread_default, pool);
+
+  return previous;
+}
+
+
+gchar *
+modulemd_string_intern (const gchar *str)
+{
+  modulemd_string_pool *pool = NULL;
+  gchar *interned = NULL;
+
+  if (str == NULL)
+    return NULL;
+
+  pool = g_private_get (&string_pool_thread_default);
+  if (pool == NULL)
+    return g_ref_string_new (str);
+
+  g_mutex_lock (&pool->lock);
+
+  interned = g_hash_table_lookup (pool->strings, str);
+  if (interned == NULL)
+    {
+      interned = g_ref_string_new (str);
+      g_hash_table_add (pool->strings, interned);
+    }
+  interned = g_ref_string_acquire (interned);
+
+  g_mutex_unlock (&pool->lock);
+
+  return interned;
 }
 
 
@@ -343,21 +476,18 @@ _modulemd_index_serialize (GHashTable *index, GError **error)
 }
 
 
+/* Returns the module stored in the index, which is updated in place */
 static ModulemdImprovedModule *
 get_or_create_module_from_index (GHashTable *htable, const gchar *module_name)
 {
-  ModulemdImprovedModule *stored_module = NULL;
   ModulemdImprovedModule *module = NULL;
 
-  stored_module = g_hash_table_lookup (htable, module_name);
-  if (stored_module)
-    {
-      module = modulemd_improvedmodule_copy (stored_module);
-    }
-  else
+  module = g_hash_table_lookup (htable, module_name);
+  if (!module)
     {
       /* This is the first encounter of this module */
       module = modulemd_improvedmodule_new (module_name);
+      g_hash_table_insert (htable, g_strdup (module_name), module);
     }
   return module;
 }
@@ -369,10 +499,11 @@ module_index_from_data (GPtrArray *data, GError **error)
   GObject *item = NULL;
   gsize i = 0;
   g_autofree gchar *module_name = NULL;
-  g_autoptr (ModulemdImprovedModule) module = NULL;
+  ModulemdImprovedModule *module = NULL;
   ModulemdImprovedModule *stored_module = NULL;
   ModulemdModuleStream *stream = NULL;
-  g_autoptr (ModulemdModuleStream) retrieved_stream = NULL;
+  ModulemdModuleStream *stored_stream = NULL;
+  GPtrArray *stored_streams = NULL;
   ModulemdDefaults *defaults = NULL;
   g_autoptr (GHashTable) module_index = NULL;
   GError *merge_error = NULL;
@@ -404,15 +535,13 @@ module_index_from_data (GPtrArray *data, GError **error)
           module_name = modulemd_modulestream_get_name (stream);
           module = get_or_create_module_from_index (module_index, module_name);
 
-          /* Add the stream to this module. Note: if the same stream name
-           * appears in the data more than once, the last one encountered wins.
+          /* Add the stream to this module. Note: every version and context
+           * of a stream is kept, but if the same stream name, version and
+           * context appear in the data more than once, the last one
+           * encountered wins. Only the new stream is copied, so building the
+           * index is linear in the number of streams.
            */
           modulemd_improvedmodule_add_stream (module, stream);
-
-          /* Save it back to the index */
-          g_hash_table_replace (module_index,
-                                g_strdup (module_name),
-                                modulemd_improvedmodule_copy (module));
         }
       else if (MODULEMD_IS_DEFAULTS (item))
         {
@@ -422,11 +551,6 @@ module_index_from_data (GPtrArray *data, GError **error)
 
           /* Update the defaults. */
           modulemd_improvedmodule_set_defaults (module, defaults);
-
-          /* Save it back to the index */
-          g_hash_table_replace (module_index,
-                                g_strdup (module_name),
-                                modulemd_improvedmodule_copy (module));
         }
       else if (MODULEMD_IS_TRANSLATION (item))
         {
@@ -437,7 +561,6 @@ module_index_from_data (GPtrArray *data, GError **error)
                            g_object_ref (MODULEMD_TRANSLATION (item)));
         }
 
-      g_clear_pointer (&module, g_object_unref);
       g_clear_pointer (&module_name, g_free);
     }
 
@@ -457,9 +580,9 @@ module_index_from_data (GPtrArray *data, GError **error)
           continue;
         }
 
-      retrieved_stream = modulemd_improvedmodule_get_stream_by_name (
+      stored_streams = modulemd_improvedmodule_peek_stream_versions (
         stored_module, modulemd_translation_peek_module_stream (translation));
-      if (!retrieved_stream)
+      if (!stored_streams)
         {
           /* This stream of this module wasn't processed, so ignore this set of
            * translations.
@@ -467,16 +590,186 @@ module_index_from_data (GPtrArray *data, GError **error)
           continue;
         }
 
-      /* Assign this translation to the object.
+      /* Assign this translation to every version of the stream.
        * Note: This will be ignored if there is a higher modified value already
-       * assigned to this object.
+       * assigned to an object.
        */
-      modulemd_modulestream_set_translation (retrieved_stream, translation);
-
-      /* Save the updated stream back to the index */
-      modulemd_improvedmodule_add_stream (stored_module, retrieved_stream);
+      for (gsize j = 0; j < stored_streams->len; j++)
+        {
+          stored_stream = g_ptr_array_index (stored_streams, j);
+          modulemd_modulestream_set_translation (stored_stream, translation);
+        }
     }
 
 
   return g_hash_table_ref (module_index);
 }
+
+
+typedef struct _modulemd_defaults_group_entry
+{
+  ModulemdDefaults *defaults;
+  gboolean override;
+  guint position;
+} modulemd_defaults_group_entry;
+
+
+static void
+_defaults_group_entry_clear (gpointer data)
+{
+  modulemd_defaults_group_entry *entry = data;
+
+  g_clear_pointer (&entry->defaults, g_object_unref);
+}
+
+
+modulemd_defaults_group *
+modulemd_defaults_group_new (const gchar *module_name)
+{
+  modulemd_defaults_group *group = g_new0 (modulemd_defaults_group, 1);
+
+  group->module_name = g_strdup (module_name);
+  group->entries =
+    g_array_new (FALSE, FALSE, sizeof (modulemd_defaults_group_entry));
+  g_array_set_clear_func (group->entries, _defaults_group_entry_clear);
+
+  return group;
+}
+
+
+void
+modulemd_defaults_group_free (modulemd_defaults_group *group)
+{
+  if (group == NULL)
+    return;
+
+  g_clear_pointer (&group->module_name, g_free);
+  g_clear_pointer (&group->entries, g_array_unref);
+  g_clear_pointer (&group->merged, g_object_unref);
+  g_clear_error (&group->error);
+  g_free (group);
+}
+
+
+void
+modulemd_defaults_group_add (modulemd_defaults_group *group,
+                             ModulemdDefaults *defaults,
+                             gboolean override,
+                             guint position)
+{
+  modulemd_defaults_group_entry entry;
+
+  entry.defaults = g_object_ref (defaults);
+  entry.override = override;
+  entry.position = position;
+  g_array_append_val (group->entries, entry);
+}
+
+
+gint
+modulemd_defaults_group_compare (gconstpointer a, gconstpointer b)
+{
+  const modulemd_defaults_group *group_a =
+    *(const modulemd_defaults_group **)a;
+  const modulemd_defaults_group *group_b =
+    *(const modulemd_defaults_group **)b;
+
+  return g_strcmp0 (group_a->module_name, group_b->module_name);
+}
+
+
+static void
+_defaults_group_merge (gpointer data, gpointer user_data)
+{
+  modulemd_defaults_group *group = (modulemd_defaults_group *)data;
+  modulemd_defaults_group_entry *entry = NULL;
+  ModulemdDefaults *merged = NULL;
+
+  for (guint i = 0; i < group->entries->len; i++)
+    {
+      entry =
+        &g_array_index (group->entries, modulemd_defaults_group_entry, i);
+
+      /* This is the first time we've encountered the defaults for this
+       * module
+       */
+      if (!group->merged)
+        {
+          group->merged = g_object_ref (entry->defaults);
+          continue;
+        }
+
+      merged = modulemd_defaults_merge (
+        group->merged, entry->defaults, entry->override, &group->error);
+      if (!merged)
+        {
+          group->error_position = entry->position;
+          g_clear_pointer (&group->merged, g_object_unref);
+          return;
+        }
+
+      g_object_unref (group->merged);
+      group->merged = merged;
+    }
+}
+
+
+gboolean
+modulemd_defaults_groups_merge (GPtrArray *groups,
+                                guint n_threads,
+                                GError **error)
+{
+  g_autoptr (GError) push_error = NULL;
+  GThreadPool *pool = NULL;
+  modulemd_defaults_group *group = NULL;
+  modulemd_defaults_group *failed = NULL;
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+  n_threads = MIN (n_threads, groups->len);
+
+  if (n_threads > 1)
+    {
+      pool = g_thread_pool_new (
+        _defaults_group_merge, NULL, n_threads, FALSE, error);
+      if (!pool)
+        return FALSE;
+
+      for (guint i = 0; i < groups->len; i++)
+        {
+          group = g_ptr_array_index (groups, i);
+          if (!g_thread_pool_push (pool, group, &push_error))
+            {
+              /* The group is still queued even if no new thread could be
+               * started for it, so the running ones will merge it
+               */
+              g_debug ("Could not start a merge thread: %s",
+                       push_error->message);
+              g_clear_error (&push_error);
+            }
+        }
+
+      g_thread_pool_free (pool, FALSE, TRUE);
+    }
+  else
+    {
+      for (guint i = 0; i < groups->len; i++)
+        _defaults_group_merge (g_ptr_array_index (groups, i), NULL);
+    }
+
+  for (guint i = 0; i < groups->len; i++)
+    {
+      group = g_ptr_array_index (groups, i);
+      if (group->error &&
+          (!failed || group->error_position < failed->error_position))
+        failed = group;
+    }
+
+  if (failed)
+    {
+      g_propagate_error (error, g_error_copy (failed->error));
+      return FALSE;
+    }
+
+  return TRUE;
+}
@@ -56,7 +56,7 @@ _emit_defaults (yaml_emitter_t *emitter,
   gboolean result = FALSE;
   yaml_event_t event;
 
-  g_debug ("TRACE: entering _emit_defaults");
+  MMD_TRACE ("TRACE: entering _emit_defaults");
   yaml_document_start_event_initialize (&event, NULL, NULL, NULL, 0);
 
   YAML_EMITTER_EMIT_WITH_ERROR_RETURN (
@@ -75,7 +75,7 @@ _emit_defaults (yaml_emitter_t *emitter,
 
 error:
 
-  g_debug ("TRACE: exiting _emit_defaults");
+  MMD_TRACE ("TRACE: exiting _emit_defaults");
   return result;
 }
 
@@ -91,7 +91,7 @@ _emit_defaults_root (yaml_emitter_t *emitter,
   gchar *name = NULL;
   gchar *value = NULL;
 
-  g_debug ("TRACE: entering _emit_defaults_root");
+  MMD_TRACE ("TRACE: entering _emit_defaults_root");
   if (mdversion < 1)
     {
       /* The mdversion is required and has not been specified.
@@ -145,7 +145,7 @@ error:
   g_clear_pointer (&name, g_free);
   g_clear_pointer (&value, g_free);
 
-  g_debug ("TRACE: exiting _emit_defaults_root");
+  MMD_TRACE ("TRACE: exiting _emit_defaults_root");
   return result;
 }
 
@@ -159,7 +159,7 @@ _emit_defaults_data (yaml_emitter_t *emitter,
   gchar *name = NULL;
   gchar *value = NULL;
 
-  g_debug ("TRACE: entering _emit_defaults_data");
+  MMD_TRACE ("TRACE: entering _emit_defaults_data");
 
   yaml_mapping_start_event_initialize (
     &event, NULL, NULL, 1, YAML_BLOCK_MAPPING_STYLE);
@@ -209,7 +209,7 @@ error:
   g_clear_pointer (&name, g_free);
   g_clear_pointer (&value, g_free);
 
-  g_debug ("TRACE: exiting _emit_defaults_data");
+  MMD_TRACE ("TRACE: exiting _emit_defaults_data");
   return result;
 }
 
@@ -225,7 +225,7 @@ _emit_defaults_profiles (yaml_emitter_t *emitter,
   GPtrArray *keys = NULL;
   ModulemdSimpleSet *set = NULL;
 
-  g_debug ("TRACE: entering _emit_defaults_profiles");
+  MMD_TRACE ("TRACE: entering _emit_defaults_profiles");
 
   name = g_strdup ("profiles");
   MMD_YAML_EMIT_SCALAR (&event, name, YAML_PLAIN_SCALAR_STYLE);
@@ -258,7 +258,7 @@ error:
   g_clear_pointer (&name, g_free);
   g_clear_pointer (&keys, g_ptr_array_unref);
 
-  g_debug ("TRACE: exiting _emit_defaults_profiles");
+  MMD_TRACE ("TRACE: exiting _emit_defaults_profiles");
   return result;
 }
 
@@ -275,7 +275,7 @@ _emit_defaults_intents (yaml_emitter_t *emitter,
   g_autoptr (GPtrArray) keys = NULL;
   ModulemdIntent *intent = NULL;
 
-  g_debug ("TRACE: entering _emit_defaults_intents");
+  MMD_TRACE ("TRACE: entering _emit_defaults_intents");
 
   name = g_strdup ("intents");
   MMD_YAML_EMIT_SCALAR (&event, name, YAML_PLAIN_SCALAR_STYLE);
@@ -311,7 +311,7 @@ _emit_defaults_intents (yaml_emitter_t *emitter,
 error:
   yaml_event_delete (&event);
 
-  g_debug ("TRACE: exiting _emit_defaults_intents");
+  MMD_TRACE ("TRACE: exiting _emit_defaults_intents");
   return result;
 }
 
@@ -324,7 +324,7 @@ _emit_intent (yaml_emitter_t *emitter, ModulemdIntent *intent, GError **error)
   g_autofree gchar *value = NULL;
   yaml_event_t event;
 
-  g_debug ("TRACE: entering _emit_intent");
+  MMD_TRACE ("TRACE: entering _emit_intent");
 
   /* Start the map */
   yaml_mapping_start_event_initialize (
@@ -358,7 +358,7 @@ _emit_intent (yaml_emitter_t *emitter, ModulemdIntent *intent, GError **error)
 error:
   yaml_event_delete (&event);
 
-  g_debug ("TRACE: exiting _emit_intent");
+  MMD_TRACE ("TRACE: exiting _emit_intent");
   return result;
 }
 
@@ -374,7 +374,7 @@ _emit_intent_profiles (yaml_emitter_t *emitter,
   GPtrArray *keys = NULL;
   ModulemdSimpleSet *set = NULL;
 
-  g_debug ("TRACE: entering _emit_intent_profiles");
+  MMD_TRACE ("TRACE: entering _emit_intent_profiles");
 
   name = g_strdup ("profiles");
   MMD_YAML_EMIT_SCALAR (&event, name, YAML_PLAIN_SCALAR_STYLE);
@@ -407,6 +407,6 @@ error:
   g_clear_pointer (&name, g_free);
   g_clear_pointer (&keys, g_ptr_array_unref);
 
-  g_debug ("TRACE: exiting _emit_intent_profiles");
+  MMD_TRACE ("TRACE: exiting _emit_intent_profiles");
   return result;
 }
@@ -17,6 +17,7 @@
 #include <yaml.h>
 #include <errno.h>
 #include <inttypes.h>
+#include "private/modulemd-private.h"
 #include "private/modulemd-yaml.h"
 #include "private/modulemd-util.h"
 
@@ -99,7 +100,7 @@ _emit_modulestream (yaml_emitter_t *emitter,
   gboolean result = FALSE;
   yaml_event_t event;
 
-  g_debug ("TRACE: entering _emit_modulemd");
+  MMD_TRACE ("TRACE: entering _emit_modulemd");
   yaml_document_start_event_initialize (&event, NULL, NULL, NULL, 0);
 
   YAML_EMITTER_EMIT_WITH_ERROR_RETURN (
@@ -118,7 +119,7 @@ _emit_modulestream (yaml_emitter_t *emitter,
 
 error:
 
-  g_debug ("TRACE: exiting _emit_modulemd");
+  MMD_TRACE ("TRACE: exiting _emit_modulemd");
   return result;
 }
 
@@ -133,7 +134,7 @@ _emit_modulemd_root (yaml_emitter_t *emitter,
   gchar *name = NULL;
   gchar *value = NULL;
 
-  g_debug ("TRACE: entering _emit_modulemd_root");
+  MMD_TRACE ("TRACE: entering _emit_modulemd_root");
   if (mdversion < 1)
     {
       /* The mdversion is required and has not been specified.
@@ -192,7 +193,7 @@ error:
   g_free (name);
   g_free (value);
 
-  g_debug ("TRACE: exiting _emit_modulemd_root");
+  MMD_TRACE ("TRACE: exiting _emit_modulemd_root");
   return result;
 }
 
@@ -208,7 +209,7 @@ _emit_modulemd_data (yaml_emitter_t *emitter,
   guint64 version = 0;
   const GDate *eol;
 
-  g_debug ("TRACE: entering _emit_modulemd_data");
+  MMD_TRACE ("TRACE: entering _emit_modulemd_data");
 
   yaml_mapping_start_event_initialize (
     &event, NULL, NULL, 1, YAML_BLOCK_MAPPING_STYLE);
@@ -402,7 +403,7 @@ error:
   g_free (name);
   g_free (value);
 
-  g_debug ("TRACE: exiting _emit_modulemd_data");
+  MMD_TRACE ("TRACE: exiting _emit_modulemd_data");
   return result;
 }
 
@@ -419,9 +420,10 @@ _emit_modulemd_servicelevels (yaml_emitter_t *emitter,
   ModulemdServiceLevel *sl = NULL;
   GPtrArray *keys = NULL;
 
-  g_debug ("TRACE: entering _emit_modulemd_servicelevels");
+  MMD_TRACE ("TRACE: entering _emit_modulemd_servicelevels");
 
-  servicelevels = modulemd_modulestream_get_servicelevels (modulestream);
+  servicelevels = g_hash_table_ref (
+    modulemd_modulestream_peek_servicelevels_readonly (modulestream));
 
   if (!servicelevels || g_hash_table_size (servicelevels) < 1)
     {
@@ -465,7 +467,7 @@ error:
       g_ptr_array_unref (keys);
     }
 
-  g_debug ("TRACE: exiting _emit_modulemd_servicelevels");
+  MMD_TRACE ("TRACE: exiting _emit_modulemd_servicelevels");
   return result;
 }
 
@@ -526,7 +528,7 @@ _emit_modulemd_licenses (yaml_emitter_t *emitter,
   gchar *name = NULL;
   g_autoptr (ModulemdSimpleSet) set = NULL;
 
-  g_debug ("TRACE: entering _emit_modulemd_licenses");
+  MMD_TRACE ("TRACE: entering _emit_modulemd_licenses");
 
   name = g_strdup ("license");
   MMD_YAML_EMIT_SCALAR (&event, name, YAML_PLAIN_SCALAR_STYLE);
@@ -583,7 +585,7 @@ _emit_modulemd_licenses (yaml_emitter_t *emitter,
 error:
   g_free (name);
 
-  g_debug ("TRACE: exiting _emit_modulemd_licenses");
+  MMD_TRACE ("TRACE: exiting _emit_modulemd_licenses");
   return result;
 }
 
@@ -596,27 +598,57 @@ _emit_modulemd_xmd (yaml_emitter_t *emitter,
   yaml_event_t event;
   gchar *name = NULL;
   g_autoptr (GHashTable) htable = NULL;
+  g_autoptr (GArray) events = NULL;
 
-  g_debug ("TRACE: entering _emit_modulemd_xmd");
+  MMD_TRACE ("TRACE: entering _emit_modulemd_xmd");
 
-  htable = modulemd_modulestream_get_xmd (modulestream);
-  if (htable && g_hash_table_size (htable) > 0)
+  /* If nothing has read the xmd since it was parsed, it is written out
+   * exactly as it was read
+   */
+  events = modulemd_modulestream_dup_xmd_events (modulestream);
+  if (events)
     {
-      name = g_strdup ("xmd");
-      MMD_YAML_EMIT_SCALAR (&event, name, YAML_PLAIN_SCALAR_STYLE);
+      /* An empty mapping is only its start and end events */
+      if (events->len > 2)
+        {
+          name = g_strdup ("xmd");
+          MMD_YAML_EMIT_SCALAR (&event, name, YAML_PLAIN_SCALAR_STYLE);
 
-      /* Start the YAML mapping */
-      if (!_emit_modulemd_variant_hashtable (emitter, htable, error))
+          for (guint i = 0; i < events->len; i++)
+            {
+              /* The emitter takes ownership of the event it is given */
+              if (!mmd_yaml_event_copy (
+                    &event, &g_array_index (events, yaml_event_t, i)))
+                {
+                  MMD_YAML_ERROR_RETURN (error, "Could not copy xmd event");
+                }
+
+              YAML_EMITTER_EMIT_WITH_ERROR_RETURN (
+                emitter, &event, error, "Error emitting xmd");
+            }
+        }
+    }
+  else
+    {
+      htable = modulemd_modulestream_get_xmd (modulestream);
+      if (htable && g_hash_table_size (htable) > 0)
         {
-          MMD_YAML_ERROR_RETURN_RETHROW (error,
-                                         "Error emitting variant hashtable");
+          name = g_strdup ("xmd");
+          MMD_YAML_EMIT_SCALAR (&event, name, YAML_PLAIN_SCALAR_STYLE);
+
+          /* Start the YAML mapping */
+          if (!_emit_modulemd_variant_hashtable (emitter, htable, error))
+            {
+              MMD_YAML_ERROR_RETURN_RETHROW (
+                error, "Error emitting variant hashtable");
+            }
         }
     }
   result = TRUE;
 error:
   g_free (name);
 
-  g_debug ("TRACE: exiting _emit_modulemd_xmd");
+  MMD_TRACE ("TRACE: exiting _emit_modulemd_xmd");
   return result;
 }
 
@@ -631,10 +663,12 @@ _emit_modulemd_deps_v1 (yaml_emitter_t *emitter,
   g_autoptr (GHashTable) buildrequires = NULL;
   g_autoptr (GHashTable) requires = NULL;
 
-  g_debug ("TRACE: entering _emit_modulemd_deps_v1");
+  MMD_TRACE ("TRACE: entering _emit_modulemd_deps_v1");
 
-  buildrequires = modulemd_modulestream_get_buildrequires (modulestream);
-  requires = modulemd_modulestream_get_requires (modulestream);
+  buildrequires = g_hash_table_ref (
+    modulemd_modulestream_peek_buildrequires_readonly (modulestream));
+  requires = g_hash_table_ref (
+    modulemd_modulestream_peek_requires_readonly (modulestream));
   if (!(buildrequires && g_hash_table_size (buildrequires) > 0) &&
       !(requires && g_hash_table_size (requires) > 0))
     {
@@ -688,7 +722,7 @@ _emit_modulemd_deps_v1 (yaml_emitter_t *emitter,
 error:
   g_free (name);
 
-  g_debug ("TRACE: exiting _emit_modulemd_deps_v1");
+  MMD_TRACE ("TRACE: exiting _emit_modulemd_deps_v1");
   return result;
 }
 
@@ -708,9 +742,10 @@ _emit_modulemd_deps_v2 (yaml_emitter_t *emitter,
   ModulemdDependencies *dep = NULL;
   g_autoptr (GHashTable) reqs = NULL;
 
-  g_debug ("TRACE: entering _emit_modulemd_deps_v2");
+  MMD_TRACE ("TRACE: entering _emit_modulemd_deps_v2");
 
-  dependencies = modulemd_modulestream_get_dependencies (modulestream);
+  dependencies = g_ptr_array_ref (
+    modulemd_modulestream_peek_dependencies_readonly (modulestream));
   if (!(dependencies && dependencies->len > 0))
     {
       /* Unlikely, but not impossible */
@@ -779,7 +814,7 @@ _emit_modulemd_deps_v2 (yaml_emitter_t *emitter,
 error:
   g_free (name);
 
-  g_debug ("TRACE: exiting _emit_modulemd_deps_v2");
+  MMD_TRACE ("TRACE: exiting _emit_modulemd_deps_v2");
   return result;
 }
 
@@ -794,7 +829,7 @@ _modulemd_emit_dep_stream_mapping (yaml_emitter_t *emitter,
   gchar *name;
   ModulemdSimpleSet *val;
 
-  g_debug ("TRACE: entering _modulemd_emit_dep_stream_mapping");
+  MMD_TRACE ("TRACE: entering _modulemd_emit_dep_stream_mapping");
 
   yaml_mapping_start_event_initialize (
     &event, NULL, NULL, 1, YAML_BLOCK_MAPPING_STYLE);
@@ -827,7 +862,7 @@ _modulemd_emit_dep_stream_mapping (yaml_emitter_t *emitter,
   result = TRUE;
 error:
 
-  g_debug ("TRACE: exiting _modulemd_emit_dep_stream_mapping");
+  MMD_TRACE ("TRACE: exiting _modulemd_emit_dep_stream_mapping");
   return result;
 }
 
@@ -844,7 +879,7 @@ _emit_modulemd_refs (yaml_emitter_t *emitter,
   g_autofree gchar *documentation = NULL;
   g_autofree gchar *tracker = NULL;
 
-  g_debug ("TRACE: entering _emit_modulemd_refs");
+  MMD_TRACE ("TRACE: entering _emit_modulemd_refs");
 
   community = modulemd_modulestream_get_community (modulestream);
   documentation = modulemd_modulestream_get_documentation (modulestream);
@@ -894,7 +929,7 @@ _emit_modulemd_refs (yaml_emitter_t *emitter,
   result = TRUE;
 error:
 
-  g_debug ("TRACE: exiting _emit_modulemd_refs");
+  MMD_TRACE ("TRACE: exiting _emit_modulemd_refs");
   return result;
 }
 
@@ -967,9 +1002,10 @@ _emit_modulemd_profiles (yaml_emitter_t *emitter,
   ModulemdProfile *profile = NULL;
   GPtrArray *keys = NULL;
 
-  g_debug ("TRACE: entering _emit_modulemd_profiles");
+  MMD_TRACE ("TRACE: entering _emit_modulemd_profiles");
 
-  profiles = modulemd_modulestream_get_profiles (modulestream);
+  profiles = g_hash_table_ref (
+    modulemd_modulestream_peek_profiles_readonly (modulestream));
 
   if (!(profiles && g_hash_table_size (profiles) > 0))
     {
@@ -1008,7 +1044,7 @@ error:
   g_clear_pointer (&keys, g_ptr_array_unref);
   g_clear_pointer (&name, g_free);
 
-  g_debug ("TRACE: exiting _emit_modulemd_profiles");
+  MMD_TRACE ("TRACE: exiting _emit_modulemd_profiles");
   return result;
 }
 
@@ -1022,7 +1058,7 @@ _emit_modulemd_api (yaml_emitter_t *emitter,
   g_autofree gchar *name = NULL;
   g_autoptr (ModulemdSimpleSet) api = NULL;
 
-  g_debug ("TRACE: entering _emit_modulemd_api");
+  MMD_TRACE ("TRACE: entering _emit_modulemd_api");
   api = modulemd_modulestream_get_rpm_api (modulestream);
 
   if (!(api && modulemd_simpleset_size (api) > 0))
@@ -1057,7 +1093,7 @@ _emit_modulemd_api (yaml_emitter_t *emitter,
   result = TRUE;
 error:
 
-  g_debug ("TRACE: exiting _emit_modulemd_api");
+  MMD_TRACE ("TRACE: exiting _emit_modulemd_api");
   return result;
 }
 
@@ -1071,7 +1107,7 @@ _emit_modulemd_filters (yaml_emitter_t *emitter,
   g_autofree gchar *name = NULL;
   g_autoptr (ModulemdSimpleSet) filters = NULL;
 
-  g_debug ("TRACE: entering _emit_modulemd_filters");
+  MMD_TRACE ("TRACE: entering _emit_modulemd_filters");
   filters = modulemd_modulestream_get_rpm_filter (modulestream);
 
   if (!(filters && modulemd_simpleset_size (filters) > 0))
@@ -1106,7 +1142,7 @@ _emit_modulemd_filters (yaml_emitter_t *emitter,
   result = TRUE;
 error:
 
-  g_debug ("TRACE: exiting _emit_modulemd_filters");
+  MMD_TRACE ("TRACE: exiting _emit_modulemd_filters");
   return result;
 }
 
@@ -1120,7 +1156,7 @@ _emit_modulemd_buildopts (yaml_emitter_t *emitter,
   g_autofree gchar *name = NULL;
   g_autoptr (ModulemdBuildopts) buildopts = NULL;
 
-  g_debug ("TRACE: entering _emit_modulemd_buildopts");
+  MMD_TRACE ("TRACE: entering _emit_modulemd_buildopts");
   buildopts = modulemd_modulestream_get_buildopts (modulestream);
   if (!buildopts)
     {
@@ -1149,7 +1185,7 @@ _emit_modulemd_buildopts (yaml_emitter_t *emitter,
   result = TRUE;
 error:
 
-  g_debug ("TRACE: exiting _emit_modulemd_buildopts");
+  MMD_TRACE ("TRACE: exiting _emit_modulemd_buildopts");
   return result;
 }
 
@@ -1164,7 +1200,7 @@ _emit_modulemd_rpm_buildopts (yaml_emitter_t *emitter,
   g_autofree gchar *value = NULL;
   g_autoptr (ModulemdSimpleSet) set = NULL;
 
-  g_debug ("TRACE: entering _emit_modulemd_buildopts");
+  MMD_TRACE ("TRACE: entering _emit_modulemd_buildopts");
 
   name = g_strdup ("rpms");
   MMD_YAML_EMIT_SCALAR (&event, name, YAML_PLAIN_SCALAR_STYLE);
@@ -1205,7 +1241,7 @@ _emit_modulemd_rpm_buildopts (yaml_emitter_t *emitter,
   result = TRUE;
 error:
 
-  g_debug ("TRACE: exiting _emit_modulemd_buildopts");
+  MMD_TRACE ("TRACE: exiting _emit_modulemd_buildopts");
   return result;
 }
 
@@ -1411,16 +1447,17 @@ _emit_modulemd_components (yaml_emitter_t *emitter,
   g_autoptr (GPtrArray) module_keys = NULL;
   gsize i;
 
-  g_debug ("TRACE: entering _emit_modulemd_components");
+  MMD_TRACE ("TRACE: entering _emit_modulemd_components");
 
-  rpm_components = modulemd_modulestream_get_rpm_components (modulestream);
+  rpm_components = g_hash_table_ref (
+    modulemd_modulestream_peek_rpm_components_readonly (modulestream));
   if (rpm_components && g_hash_table_size (rpm_components) < 1)
     {
       g_clear_pointer (&rpm_components, g_hash_table_unref);
     }
 
-  module_components =
-    modulemd_modulestream_get_module_components (modulestream);
+  module_components = g_hash_table_ref (
+    modulemd_modulestream_peek_module_components_readonly (modulestream));
   if (module_components && g_hash_table_size (module_components) < 1)
     {
       g_clear_pointer (&module_components, g_hash_table_unref);
@@ -1509,7 +1546,7 @@ _emit_modulemd_components (yaml_emitter_t *emitter,
   result = TRUE;
 error:
 
-  g_debug ("TRACE: exiting _emit_modulemd_components");
+  MMD_TRACE ("TRACE: exiting _emit_modulemd_components");
   return result;
 }
 
@@ -1523,7 +1560,7 @@ _emit_modulemd_artifacts (yaml_emitter_t *emitter,
   g_autofree gchar *name = NULL;
   g_autoptr (ModulemdSimpleSet) artifacts = NULL;
 
-  g_debug ("TRACE: entering _emit_modulemd_artifacts");
+  MMD_TRACE ("TRACE: entering _emit_modulemd_artifacts");
 
   artifacts = modulemd_modulestream_get_rpm_artifacts (modulestream);
   if (!(artifacts && modulemd_simpleset_size (artifacts) > 0))
@@ -1558,6 +1595,6 @@ _emit_modulemd_artifacts (yaml_emitter_t *emitter,
   result = TRUE;
 error:
 
-  g_debug ("TRACE: exiting _emit_modulemd_artifacts");
+  MMD_TRACE ("TRACE: exiting _emit_modulemd_artifacts");
   return result;
 }
@@ -175,7 +175,7 @@ _emit_modulemd_simpleset (yaml_emitter_t *emitter,
   gchar **array = modulemd_simpleset_dup (set);
   gchar *item;
 
-  g_debug ("TRACE: entering _emit_modulemd_simpleset");
+  MMD_TRACE ("TRACE: entering _emit_modulemd_simpleset");
 
   yaml_sequence_start_event_initialize (&event, NULL, NULL, 1, style);
   YAML_EMITTER_EMIT_WITH_ERROR_RETURN (
@@ -199,7 +199,7 @@ error:
     }
   g_free (array);
 
-  g_debug ("TRACE: exiting _emit_modulemd_simpleset");
+  MMD_TRACE ("TRACE: exiting _emit_modulemd_simpleset");
   return result;
 }
 
@@ -218,7 +218,7 @@ _emit_modulemd_hashtable (yaml_emitter_t *emitter,
   gchar *name;
   gchar *val;
 
-  g_debug ("TRACE: entering _emit_modulemd_hashtable");
+  MMD_TRACE ("TRACE: entering _emit_modulemd_hashtable");
 
   yaml_mapping_start_event_initialize (
     &event, NULL, NULL, 1, YAML_BLOCK_MAPPING_STYLE);
@@ -250,7 +250,7 @@ _emit_modulemd_hashtable (yaml_emitter_t *emitter,
   result = TRUE;
 error:
 
-  g_debug ("TRACE: exiting _emit_modulemd_hashtable");
+  MMD_TRACE ("TRACE: exiting _emit_modulemd_hashtable");
   return result;
 }
 
@@ -267,7 +267,7 @@ _emit_modulemd_variant_hashtable (yaml_emitter_t *emitter,
   gchar *name;
   GVariant *val;
 
-  g_debug ("TRACE: entering _emit_modulemd_variant_hashtable");
+  MMD_TRACE ("TRACE: entering _emit_modulemd_variant_hashtable");
 
   yaml_mapping_start_event_initialize (
     &event, NULL, NULL, 1, YAML_BLOCK_MAPPING_STYLE);
@@ -307,6 +307,6 @@ _emit_modulemd_variant_hashtable (yaml_emitter_t *emitter,
   result = TRUE;
 error:
 
-  g_debug ("TRACE: exiting _emit_modulemd_variant_hashtable");
+  MMD_TRACE ("TRACE: exiting _emit_modulemd_variant_hashtable");
   return result;
 }
@@ -71,7 +71,7 @@ _parse_defaults (yaml_parser_t *parser,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_defaults");
+  MMD_TRACE ("TRACE: entering _parse_defaults");
 
   defaults = modulemd_defaults_new ();
 
@@ -104,26 +104,26 @@ _parse_defaults (yaml_parser_t *parser,
 
         case YAML_SCALAR_EVENT:
 
-          /* Handle "document: modulemd-defaults" */
-          if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "document"))
+          switch (MMD_YAML_EVENT_KEY (event))
             {
-              g_debug ("TRACE: root entry [document]");
+            /* Handle "document: modulemd-defaults" */
+            case MMD_YAML_KEY_DOCUMENT:
+              MMD_TRACE ("TRACE: root entry [document]");
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT ||
-                  g_strcmp0 ((const gchar *)value_event.data.scalar.value,
-                             "modulemd-defaults"))
+                  MMD_YAML_EVENT_KEY (value_event) !=
+                    MMD_YAML_KEY_MODULEMD_DEFAULTS)
                 {
                   yaml_event_delete (&value_event);
                   MMD_YAML_ERROR_RETURN (error, "Document type mismatch");
                 }
               yaml_event_delete (&value_event);
-            }
-          /* Record the modulemd version for the parser */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "version"))
-            {
-              g_debug ("TRACE: root entry [version]");
+              break;
+
+            /* Record the modulemd version for the parser */
+            case MMD_YAML_KEY_VERSION:
+              MMD_TRACE ("TRACE: root entry [version]");
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -150,20 +150,19 @@ _parse_defaults (yaml_parser_t *parser,
                     "ModuleMD defaults version doesn't match preprocessing");
                 }
               modulemd_defaults_set_version (defaults, mdversion);
-            }
+              break;
 
-          /* Process the data section */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "data"))
-            {
-              g_debug ("TRACE: root entry [data]");
+            /* Process the data section */
+            case MMD_YAML_KEY_DATA:
+              MMD_TRACE ("TRACE: root entry [data]");
               _yaml_parser_defaults_recurse_down (_parse_defaults_data);
-            }
+              break;
 
-          else
-            {
+            default:
               g_debug ("Unexpected key in root: %s",
                        (const gchar *)event.data.scalar.value);
               MMD_YAML_ERROR_RETURN (error, "Unexpected key in root");
+              break;
             }
           break;
 
@@ -194,7 +193,7 @@ _parse_defaults (yaml_parser_t *parser,
 error:
   g_clear_pointer (&defaults, g_object_unref);
 
-  g_debug ("TRACE: exiting _parse_defaults");
+  MMD_TRACE ("TRACE: exiting _parse_defaults");
   return result;
 }
 
@@ -209,7 +208,7 @@ _parse_defaults_data (ModulemdDefaults *defaults,
   gboolean result = FALSE;
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
-  g_debug ("TRACE: entering _parse_defaults_data");
+  MMD_TRACE ("TRACE: entering _parse_defaults_data");
 
 
   while (!done)
@@ -228,9 +227,10 @@ _parse_defaults_data (ModulemdDefaults *defaults,
           break;
 
         case YAML_SCALAR_EVENT:
-          /* Module Name */
-          if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "module"))
+          switch (MMD_YAML_EVENT_KEY (event))
             {
+            /* Module Name */
+            case MMD_YAML_KEY_MODULE:
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -241,12 +241,10 @@ _parse_defaults_data (ModulemdDefaults *defaults,
               modulemd_defaults_set_module_name (
                 defaults, (const gchar *)value_event.data.scalar.value);
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          /* Module default stream */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "stream"))
-            {
+            /* Module default stream */
+            case MMD_YAML_KEY_STREAM:
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -258,20 +256,21 @@ _parse_defaults_data (ModulemdDefaults *defaults,
               modulemd_defaults_set_default_stream (
                 defaults, (const gchar *)value_event.data.scalar.value);
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          /* Profile defaults */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "profiles"))
-            {
+            /* Profile defaults */
+            case MMD_YAML_KEY_PROFILES:
               _yaml_parser_defaults_recurse_down (_parse_defaults_profiles);
-            }
+              break;
 
-          /* Intents (Not currently supported) */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "intents"))
-            {
+            /* Intents (Not currently supported) */
+            case MMD_YAML_KEY_INTENTS:
               _yaml_parser_defaults_recurse_down (_parse_defaults_intents);
+              break;
+
+            default:
+              /* Nothing to do */
+              break;
             }
           break;
 
@@ -293,7 +292,7 @@ error:
       g_clear_pointer (&defaults, g_object_unref);
     }
 
-  g_debug ("TRACE: exiting _parse_defaults_data");
+  MMD_TRACE ("TRACE: exiting _parse_defaults_data");
   return result;
 }
 
@@ -311,7 +310,7 @@ _parse_defaults_profiles (ModulemdDefaults *defaults,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_defaults_profiles");
+  MMD_TRACE ("TRACE: entering _parse_defaults_profiles");
 
   while (!done)
     {
@@ -366,7 +365,7 @@ _parse_defaults_profiles (ModulemdDefaults *defaults,
 error:
   g_clear_pointer (&set, g_object_unref);
   g_clear_pointer (&stream_name, g_free);
-  g_debug ("TRACE: exiting _parse_defaults_profiles");
+  MMD_TRACE ("TRACE: exiting _parse_defaults_profiles");
   return result;
 }
 
@@ -384,7 +383,7 @@ _parse_defaults_intents (ModulemdDefaults *defaults,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_defaults_intents");
+  MMD_TRACE ("TRACE: entering _parse_defaults_intents");
 
   while (!done)
     {
@@ -437,7 +436,7 @@ _parse_defaults_intents (ModulemdDefaults *defaults,
   result = TRUE;
 
 error:
-  g_debug ("TRACE: exiting _parse_defaults_intents");
+  MMD_TRACE ("TRACE: exiting _parse_defaults_intents");
   return result;
 }
 
@@ -455,7 +454,7 @@ _parse_intent (yaml_parser_t *parser,
   g_autoptr (ModulemdIntent) _intent = NULL;
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
-  g_debug ("TRACE: entering _parse_intent");
+  MMD_TRACE ("TRACE: entering _parse_intent");
 
   _intent = modulemd_intent_new (name);
 
@@ -484,11 +483,10 @@ _parse_intent (yaml_parser_t *parser,
               break;
             }
 
-          /* Default Stream */
-
-          if (g_strcmp0 ("stream", (const gchar *)event.data.scalar.value) ==
-              0)
+          switch (MMD_YAML_EVENT_KEY (event))
             {
+            /* Default Stream */
+            case MMD_YAML_KEY_STREAM:
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -501,18 +499,17 @@ _parse_intent (yaml_parser_t *parser,
                 _intent, (const gchar *)value_event.data.scalar.value);
 
               yaml_event_delete (&value_event);
-            }
-          else if (g_strcmp0 ("profiles",
-                              (const gchar *)event.data.scalar.value) == 0)
-            {
+              break;
+
+            case MMD_YAML_KEY_PROFILES:
               if (!_parse_intent_profiles (_intent, parser, error))
                 {
                   MMD_YAML_ERROR_RETURN_RETHROW (
                     error, "Could not parse intent profiles");
                 }
-            }
-          else
-            {
+              break;
+
+            default:
               /* Unexpected key in the map */
               MMD_YAML_ERROR_RETURN (error, "Unexpected key in intent");
               break;
@@ -535,7 +532,7 @@ _parse_intent (yaml_parser_t *parser,
     }
 
 error:
-  g_debug ("TRACE: exiting _parse_intent");
+  MMD_TRACE ("TRACE: exiting _parse_intent");
   return result;
 }
 
@@ -554,7 +551,7 @@ _parse_intent_profiles (ModulemdIntent *intent,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_intent_profiles");
+  MMD_TRACE ("TRACE: entering _parse_intent_profiles");
 
   while (!done)
     {
@@ -609,6 +606,6 @@ _parse_intent_profiles (ModulemdIntent *intent,
 error:
   g_clear_pointer (&set, g_object_unref);
   g_clear_pointer (&stream_name, g_free);
-  g_debug ("TRACE: exiting _parse_intent_profiles");
+  MMD_TRACE ("TRACE: exiting _parse_intent_profiles");
   return result;
 }
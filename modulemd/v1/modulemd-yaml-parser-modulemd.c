@@ -37,9 +37,21 @@ enum ModulemdReqType
     }                                                                         \
   while (0)
 
+/* Skip over the value of a section that wasn't requested */
+#define _yaml_parser_modulemd_skip()                                          \
+  do                                                                          \
+    {                                                                         \
+      if (!_parse_skip (parser, error))                                       \
+        {                                                                     \
+          goto error;                                                         \
+        }                                                                     \
+    }                                                                         \
+  while (0)
+
 static gboolean
 _parse_modulemd_data (ModulemdModuleStream *modulestream,
                       yaml_parser_t *parser,
+                      guint sections,
                       GError **error);
 static gboolean
 _parse_modulemd_licenses (ModulemdModuleStream *modulestream,
@@ -123,6 +135,17 @@ _parse_module_stream (yaml_parser_t *parser,
                       GObject **object,
                       guint64 version,
                       GError **error)
+{
+  return _parse_module_stream_sections (
+    parser, object, version, MODULEMD_SECTION_ALL, error);
+}
+
+gboolean
+_parse_module_stream_sections (yaml_parser_t *parser,
+                               GObject **object,
+                               guint64 version,
+                               guint sections,
+                               GError **error)
 {
   MMD_INIT_YAML_EVENT (event);
   MMD_INIT_YAML_EVENT (value_event);
@@ -133,7 +156,7 @@ _parse_module_stream (yaml_parser_t *parser,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_module_stream");
+  MMD_TRACE ("TRACE: entering _parse_module_stream");
 
   modulestream = modulemd_modulestream_new ();
 
@@ -167,26 +190,25 @@ _parse_module_stream (yaml_parser_t *parser,
 
         case YAML_SCALAR_EVENT:
 
-          /* Handle "document: modulemd" */
-          if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "document"))
+          switch (MMD_YAML_EVENT_KEY (event))
             {
-              g_debug ("TRACE: root entry [document]");
+            /* Handle "document: modulemd" */
+            case MMD_YAML_KEY_DOCUMENT:
+              MMD_TRACE ("TRACE: root entry [document]");
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT ||
-                  g_strcmp0 ((const gchar *)value_event.data.scalar.value,
-                             "modulemd"))
+                  MMD_YAML_EVENT_KEY (value_event) !=
+                    MMD_YAML_KEY_MODULEMD)
                 {
                   MMD_YAML_ERROR_RETURN (error, "Unknown document type");
                 }
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          /* Record the modulemd version for the parser */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "version"))
-            {
-              g_debug ("TRACE: root entry [mdversion]");
+            /* Record the modulemd version for the parser */
+            case MMD_YAML_KEY_VERSION:
+              MMD_TRACE ("TRACE: root entry [mdversion]");
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -211,20 +233,23 @@ _parse_module_stream (yaml_parser_t *parser,
                     error, "ModuleMD version doesn't match preprocessing");
                 }
               modulemd_modulestream_set_mdversion (modulestream, mdversion);
-            }
+              break;
 
-          /* Process the data section */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "data"))
-            {
-              g_debug ("TRACE: root entry [data]");
-              _yaml_parser_modulemd_recurse_down (_parse_modulemd_data);
-            }
+            /* Process the data section */
+            case MMD_YAML_KEY_DATA:
+              MMD_TRACE ("TRACE: root entry [data]");
+              if (!_parse_modulemd_data (
+                    modulestream, parser, sections, error))
+                {
+                  goto error;
+                }
+              break;
 
-          else
-            {
+            default:
               g_debug ("Unexpected key in root: %s",
                        (const gchar *)event.data.scalar.value);
               MMD_YAML_ERROR_RETURN (error, "Unexpected key in root");
+              break;
             }
           break;
 
@@ -240,13 +265,14 @@ _parse_module_stream (yaml_parser_t *parser,
   *object = g_object_ref ((GObject *)modulestream);
 
 error:
-  g_debug ("TRACE: exiting _parse_module_stream");
+  MMD_TRACE ("TRACE: exiting _parse_module_stream");
   return result;
 }
 
 static gboolean
 _parse_modulemd_data (ModulemdModuleStream *modulestream,
                       yaml_parser_t *parser,
+                      guint sections,
                       GError **error)
 {
   gboolean result = FALSE;
@@ -257,7 +283,7 @@ _parse_modulemd_data (ModulemdModuleStream *modulestream,
   GDate *eol = NULL;
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
-  g_debug ("TRACE: entering _parse_modulemd_data");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_data");
 
   while (!done)
     {
@@ -276,9 +302,10 @@ _parse_modulemd_data (ModulemdModuleStream *modulestream,
           break;
 
         case YAML_SCALAR_EVENT:
-          /* Module name */
-          if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "name"))
+          switch (MMD_YAML_EVENT_KEY (event))
             {
+            /* Module name */
+            case MMD_YAML_KEY_NAME:
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -289,12 +316,10 @@ _parse_modulemd_data (ModulemdModuleStream *modulestream,
               modulemd_modulestream_set_name (
                 modulestream, (const gchar *)value_event.data.scalar.value);
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          /* Module stream */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "stream"))
-            {
+            /* Module stream */
+            case MMD_YAML_KEY_STREAM:
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -306,12 +331,10 @@ _parse_modulemd_data (ModulemdModuleStream *modulestream,
               modulemd_modulestream_set_stream (
                 modulestream, (const gchar *)value_event.data.scalar.value);
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          /* Module version */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "version"))
-            {
+            /* Module version */
+            case MMD_YAML_KEY_VERSION:
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -329,13 +352,10 @@ _parse_modulemd_data (ModulemdModuleStream *modulestream,
 
               modulemd_modulestream_set_version (modulestream, version);
               yaml_event_delete (&value_event);
-            }
-
-          /* Module Context */
+              break;
 
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "context"))
-            {
+            /* Module Context */
+            case MMD_YAML_KEY_CONTEXT:
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -347,11 +367,10 @@ _parse_modulemd_data (ModulemdModuleStream *modulestream,
               modulemd_modulestream_set_context (
                 modulestream, (const gchar *)value_event.data.scalar.value);
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          /* Module Artifact Architecture */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "arch"))
-            {
+            /* Module Artifact Architecture */
+            case MMD_YAML_KEY_ARCH:
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -364,12 +383,10 @@ _parse_modulemd_data (ModulemdModuleStream *modulestream,
                 modulestream, (const gchar *)value_event.data.scalar.value);
 
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          /* Module summary */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "summary"))
-            {
+            /* Module summary */
+            case MMD_YAML_KEY_SUMMARY:
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -382,12 +399,16 @@ _parse_modulemd_data (ModulemdModuleStream *modulestream,
                 modulestream, (const gchar *)value_event.data.scalar.value);
 
               yaml_event_delete (&value_event);
-            }
+              break;
+
+            /* Module description */
+            case MMD_YAML_KEY_DESCRIPTION:
+              if (!(sections & MODULEMD_SECTION_DESCRIPTION))
+                {
+                  _yaml_parser_modulemd_skip ();
+                  break;
+                }
 
-          /* Module description */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "description"))
-            {
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -400,11 +421,10 @@ _parse_modulemd_data (ModulemdModuleStream *modulestream,
                 modulestream, (const gchar *)value_event.data.scalar.value);
 
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          /* Module EOL (obsolete) */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "eol"))
-            {
+            /* Module EOL (obsolete) */
+            case MMD_YAML_KEY_EOL:
               if (modulemd_modulestream_get_mdversion (modulestream) >
                   MD_VERSION_1)
                 {
@@ -423,99 +443,94 @@ _parse_modulemd_data (ModulemdModuleStream *modulestream,
 
               modulemd_modulestream_set_eol (modulestream, eol);
               g_date_free (eol);
-            }
+              break;
 
-          /* Service Levels */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "servicelevels"))
-            {
+            /* Service Levels */
+            case MMD_YAML_KEY_SERVICELEVELS:
               _yaml_parser_modulemd_recurse_down (
                 _parse_modulemd_servicelevels);
-            }
+              break;
 
-          /* licenses */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "license"))
-            {
+            /* licenses */
+            case MMD_YAML_KEY_LICENSE:
               /* Process the module and content licenses */
               _yaml_parser_modulemd_recurse_down (_parse_modulemd_licenses);
-            }
+              break;
 
-          /* xmd */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "xmd"))
-            {
+            /* xmd */
+            case MMD_YAML_KEY_XMD:
               /* Process the extensible metadata block */
+              if (!(sections & MODULEMD_SECTION_XMD))
+                {
+                  _yaml_parser_modulemd_skip ();
+                  break;
+                }
               _yaml_parser_modulemd_recurse_down (_parse_modulemd_xmd);
-            }
+              break;
 
-          /* dependencies */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "dependencies"))
-            {
+            /* dependencies */
+            case MMD_YAML_KEY_DEPENDENCIES:
               /* Process the build and runtime dependencies of this module */
               _yaml_parser_modulemd_recurse_down (_parse_modulemd_deps);
-            }
+              break;
 
-          /* references */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "references"))
-            {
+            /* references */
+            case MMD_YAML_KEY_REFERENCES:
               /* Process the reference links for this module */
               _yaml_parser_modulemd_recurse_down (_parse_modulemd_refs);
-            }
+              break;
 
-          /* profiles */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "profiles"))
-            {
+            /* profiles */
+            case MMD_YAML_KEY_PROFILES:
               /* Process the install profiles for this module */
               _yaml_parser_modulemd_recurse_down (_parse_modulemd_profiles);
-            }
+              break;
 
-          /* api */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "api"))
-            {
+            /* api */
+            case MMD_YAML_KEY_API:
               /* Process the API list */
               _yaml_parser_modulemd_recurse_down (_parse_modulemd_api);
-            }
+              break;
 
-          /* filter */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "filter"))
-            {
+            /* filter */
+            case MMD_YAML_KEY_FILTER:
               /* Process the filtered-out output components */
               _yaml_parser_modulemd_recurse_down (_parse_modulemd_filters);
-            }
+              break;
 
-          /* buildopts */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "buildopts"))
-            {
+            /* buildopts */
+            case MMD_YAML_KEY_BUILDOPTS:
               /* Process special build options for this module */
               _yaml_parser_modulemd_recurse_down (_parse_modulemd_buildopts);
-            }
+              break;
 
-          /* Components */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "components"))
-            {
+            /* Components */
+            case MMD_YAML_KEY_COMPONENTS:
               /* Process the components that comprise this module */
+              if (!(sections & MODULEMD_SECTION_COMPONENTS))
+                {
+                  _yaml_parser_modulemd_skip ();
+                  break;
+                }
               _yaml_parser_modulemd_recurse_down (_parse_modulemd_components);
-            }
+              break;
 
-          /* Artifacts */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "artifacts"))
-            {
+            /* Artifacts */
+            case MMD_YAML_KEY_ARTIFACTS:
               /* Process the output artifacts of this module */
+              if (!(sections & MODULEMD_SECTION_ARTIFACTS))
+                {
+                  _yaml_parser_modulemd_skip ();
+                  break;
+                }
               _yaml_parser_modulemd_recurse_down (_parse_modulemd_artifacts);
-            }
+              break;
 
-          else
-            {
+            default:
               g_debug ("Unexpected key in data: %s",
                        (const gchar *)event.data.scalar.value);
               MMD_YAML_ERROR_RETURN (error, "Unexpected key in data");
+              break;
             }
           break;
 
@@ -532,7 +547,7 @@ _parse_modulemd_data (ModulemdModuleStream *modulestream,
 
 error:
 
-  g_debug ("TRACE: exiting _parse_modulemd_data");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_data");
   return result;
 }
 
@@ -548,7 +563,7 @@ _parse_modulemd_licenses (ModulemdModuleStream *modulestream,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_modulemd_licenses");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_licenses");
 
   while (!done)
     {
@@ -573,18 +588,19 @@ _parse_modulemd_licenses (ModulemdModuleStream *modulestream,
               MMD_YAML_ERROR_RETURN_RETHROW (error, "Invalid sequence");
             }
 
-          if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "module"))
+          switch (MMD_YAML_EVENT_KEY (event))
             {
+            case MMD_YAML_KEY_MODULE:
               modulemd_modulestream_set_module_licenses (modulestream, set);
-            }
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "content"))
-            {
+              break;
+
+            case MMD_YAML_KEY_CONTENT:
               modulemd_modulestream_set_content_licenses (modulestream, set);
-            }
-          else
-            {
+              break;
+
+            default:
               MMD_YAML_ERROR_RETURN (error, "Unknown license type");
+              break;
             }
 
           g_clear_pointer (&set, g_object_unref);
@@ -603,14 +619,108 @@ _parse_modulemd_licenses (ModulemdModuleStream *modulestream,
 error:
   g_clear_pointer (&set, g_object_unref);
 
-  g_debug ("TRACE: exiting _parse_modulemd_licenses");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_licenses");
   return result;
 }
 
+/* Where the next node of an xmd collection may appear */
+enum
+{
+  MMD_XMD_KEY,
+  MMD_XMD_VALUE,
+  MMD_XMD_ITEM
+};
+
 static gboolean
 _parse_modulemd_xmd (ModulemdModuleStream *modulestream,
                      yaml_parser_t *parser,
                      GError **error)
+{
+  gboolean result = FALSE;
+  g_autoptr (GArray) events = NULL;
+  g_autoptr (GByteArray) states = NULL;
+  MMD_INIT_YAML_EVENT (event);
+  guint8 *state = NULL;
+  guint8 item = MMD_XMD_KEY;
+
+  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+  MMD_TRACE ("TRACE: entering _parse_modulemd_xmd");
+
+  /* Most consumers never look at the xmd, which is often the largest part of
+   * a document, so its events are only buffered here. They are checked for
+   * anything parse_xmd_events() would reject, so that errors are still
+   * reported while parsing.
+   */
+  events = mmd_yaml_event_array_new ();
+  states = g_byte_array_new ();
+
+  YAML_PARSER_PARSE_WITH_ERROR_RETURN (parser, &event, error, "Parser error");
+  if (!(event.type == YAML_MAPPING_START_EVENT))
+    {
+      MMD_YAML_ERROR_RETURN (error, "Invalid mapping");
+    }
+  g_byte_array_append (states, &item, 1);
+  mmd_yaml_event_array_take (events, &event);
+
+  while (states->len > 0)
+    {
+      YAML_PARSER_PARSE_WITH_ERROR_RETURN (
+        parser, &event, error, "Parser error");
+      state = &states->data[states->len - 1];
+
+      switch (event.type)
+        {
+        case YAML_MAPPING_END_EVENT:
+        case YAML_SEQUENCE_END_EVENT:
+          g_byte_array_set_size (states, states->len - 1);
+          break;
+
+        case YAML_SCALAR_EVENT:
+        case YAML_MAPPING_START_EVENT:
+        case YAML_SEQUENCE_START_EVENT:
+          /* Mapping keys must be scalars */
+          if (*state == MMD_XMD_KEY && event.type != YAML_SCALAR_EVENT)
+            {
+              MMD_YAML_ERROR_RETURN (error,
+                                     "Unexpected YAML event in raw mapping");
+            }
+
+          if (*state == MMD_XMD_KEY)
+            *state = MMD_XMD_VALUE;
+          else if (*state == MMD_XMD_VALUE)
+            *state = MMD_XMD_KEY;
+
+          if (event.type != YAML_SCALAR_EVENT)
+            {
+              item = event.type == YAML_MAPPING_START_EVENT ? MMD_XMD_KEY :
+                                                              MMD_XMD_ITEM;
+              g_byte_array_append (states, &item, 1);
+            }
+          break;
+
+        default:
+          /* Aliases are not supported */
+          MMD_YAML_ERROR_RETURN (error,
+                                 "Unexpected YAML event in raw mapping");
+          break;
+        }
+
+      mmd_yaml_event_array_take (events, &event);
+    }
+
+  modulemd_modulestream_set_xmd_events (modulestream, events);
+
+  result = TRUE;
+
+error:
+  yaml_event_delete (&event);
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_xmd");
+  return result;
+}
+
+
+static gboolean
+_xmd_from_parser (yaml_parser_t *parser, GHashTable **_xmd, GError **error)
 {
   gboolean result = FALSE;
   g_autoptr (GHashTable) xmd = NULL;
@@ -620,8 +730,7 @@ _parse_modulemd_xmd (ModulemdModuleStream *modulestream,
   gchar *key;
   GVariant *value;
 
-  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
-  g_debug ("TRACE: entering _parse_modulemd_xmd");
+  MMD_TRACE ("TRACE: entering _xmd_from_parser");
 
   YAML_PARSER_PARSE_WITH_ERROR_RETURN (parser, &event, error, "Parser error");
   if (!(event.type == YAML_MAPPING_START_EVENT))
@@ -649,17 +758,36 @@ _parse_modulemd_xmd (ModulemdModuleStream *modulestream,
       g_free (key);
     }
 
-  /* Save this hash table as the xmd property */
-  modulemd_modulestream_set_xmd (modulestream, xmd);
+  *_xmd = g_steal_pointer (&xmd);
 
   result = TRUE;
 
 error:
-  g_debug ("TRACE: exiting _parse_modulemd_xmd");
+  MMD_TRACE ("TRACE: exiting _xmd_from_parser");
   return result;
 }
 
 
+GHashTable *
+parse_xmd_events (GArray *events, GError **error)
+{
+  modulemd_yaml_replay replay = { events, 0, TRUE };
+  g_auto (yaml_parser_t) parser;
+  GHashTable *xmd = NULL;
+
+  /* The events may be shared between copies of a stream, so they are
+   * replayed without being consumed
+   */
+  yaml_parser_initialize (&parser);
+  mmd_yaml_parser_set_input_replay (&parser, &replay);
+
+  if (!_xmd_from_parser (&parser, &xmd, error))
+    return NULL;
+
+  return xmd;
+}
+
+
 static gboolean
 _parse_modulemd_deps_v1 (ModulemdModuleStream *modulestream,
                          yaml_parser_t *parser,
@@ -672,7 +800,7 @@ _parse_modulemd_deps_v1 (ModulemdModuleStream *modulestream,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_modulemd_deps_v1");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_deps_v1");
 
   while (!done)
     {
@@ -696,19 +824,19 @@ _parse_modulemd_deps_v1 (ModulemdModuleStream *modulestream,
               MMD_YAML_ERROR_RETURN_RETHROW (error, "Invalid mapping");
             }
 
-          if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                          "buildrequires"))
+          switch (MMD_YAML_EVENT_KEY (event))
             {
+            case MMD_YAML_KEY_BUILDREQUIRES:
               modulemd_modulestream_set_buildrequires (modulestream, reqs);
-            }
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "requires"))
-            {
+              break;
+
+            case MMD_YAML_KEY_REQUIRES:
               modulemd_modulestream_set_requires (modulestream, reqs);
-            }
-          else
-            {
+              break;
+
+            default:
               MMD_YAML_ERROR_RETURN (error, "Unknown dependency type");
+              break;
             }
 
           g_clear_pointer (&reqs, g_hash_table_unref);
@@ -727,7 +855,7 @@ _parse_modulemd_deps_v1 (ModulemdModuleStream *modulestream,
 error:
   g_clear_pointer (&reqs, g_hash_table_unref);
 
-  g_debug ("TRACE: exiting _parse_modulemd_deps_v1");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_deps_v1");
   return result;
 }
 
@@ -748,7 +876,7 @@ _parse_modulemd_deps_v2 (ModulemdModuleStream *modulestream,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_modulemd_deps_v2");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_deps_v2");
 
   while (!done)
     {
@@ -788,7 +916,7 @@ _parse_modulemd_deps_v2 (ModulemdModuleStream *modulestream,
 
 error:
 
-  g_debug ("TRACE: exiting _parse_modulemd_deps_v2");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_deps_v2");
   return result;
 }
 
@@ -813,7 +941,7 @@ _parse_modulemd_v2_dep (ModulemdModuleStream *modulestream,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_modulemd_v2_dep");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_v2_dep");
 
   dep = modulemd_dependencies_new ();
   if (dep == NULL)
@@ -836,21 +964,21 @@ _parse_modulemd_v2_dep (ModulemdModuleStream *modulestream,
           break;
 
         case YAML_SCALAR_EVENT:
-          if (g_strcmp0 ((const gchar *)event.data.scalar.value,
-                         "buildrequires") == 0)
+          switch (MMD_YAML_EVENT_KEY (event))
             {
+            case MMD_YAML_KEY_BUILDREQUIRES:
               reqtype = MODULEMD_REQ_BUILDREQUIRES;
-            }
-          else if (g_strcmp0 ((const gchar *)event.data.scalar.value,
-                              "requires") == 0)
-            {
+              break;
+
+            case MMD_YAML_KEY_REQUIRES:
               reqtype = MODULEMD_REQ_REQUIRES;
-            }
-          else
-            {
+              break;
+
+            default:
               MMD_YAML_ERROR_RETURN (error,
                                      "Dependency map had key other than "
                                      "'requires' or 'buildrequires'");
+              break;
             }
 
           if (!_parse_modulemd_v2_dep_map (
@@ -876,7 +1004,7 @@ _parse_modulemd_v2_dep (ModulemdModuleStream *modulestream,
 
   result = TRUE;
 error:
-  g_debug ("TRACE: exiting _parse_modulemd_v2_dep");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_v2_dep");
   return result;
 }
 
@@ -898,7 +1026,7 @@ _parse_modulemd_v2_dep_map (ModulemdModuleStream *modulestream,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_modulemd_v2_dep_map");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_v2_dep_map");
 
   while (!done)
     {
@@ -966,7 +1094,7 @@ _parse_modulemd_v2_dep_map (ModulemdModuleStream *modulestream,
   result = TRUE;
 error:
   g_clear_pointer (&module_name, g_free);
-  g_debug ("TRACE: exiting _parse_modulemd_v2_dep_map");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_v2_dep_map");
   return result;
 }
 
@@ -980,7 +1108,7 @@ _parse_modulemd_deps (ModulemdModuleStream *modulestream,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_modulemd_deps");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_deps");
 
   if (modulemd_modulestream_get_mdversion (modulestream) == MD_VERSION_1)
     {
@@ -998,7 +1126,7 @@ _parse_modulemd_deps (ModulemdModuleStream *modulestream,
     }
 
 error:
-  g_debug ("TRACE: exiting _parse_modulemd_deps");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_deps");
   return result;
 }
 
@@ -1014,7 +1142,7 @@ _parse_modulemd_refs (ModulemdModuleStream *modulestream,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_modulemd_refs");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_refs");
 
   if (!_hashtable_from_mapping (parser, &refs, error))
     {
@@ -1050,7 +1178,7 @@ _parse_modulemd_refs (ModulemdModuleStream *modulestream,
 
 error:
   g_clear_pointer (&refs, g_hash_table_unref);
-  g_debug ("TRACE: exiting _parse_modulemd_refs");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_refs");
   return result;
 }
 
@@ -1068,7 +1196,7 @@ _parse_modulemd_profiles (ModulemdModuleStream *modulestream,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_modulemd_profiles");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_profiles");
 
   profiles =
     g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
@@ -1117,7 +1245,7 @@ _parse_modulemd_profiles (ModulemdModuleStream *modulestream,
 error:
   g_hash_table_unref (profiles);
 
-  g_debug ("TRACE: exiting _parse_modulemd_profiles");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_profiles");
   return result;
 }
 
@@ -1136,7 +1264,7 @@ _parse_modulemd_profile (yaml_parser_t *parser,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_modulemd_profile");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_profile");
 
   profile = modulemd_profile_new ();
   modulemd_profile_set_name (profile, name);
@@ -1159,8 +1287,9 @@ _parse_modulemd_profile (yaml_parser_t *parser,
 
         case YAML_SCALAR_EVENT:
           /* Each entry must be one of "rpms" or "description" */
-          if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "rpms"))
+          switch (MMD_YAML_EVENT_KEY (event))
             {
+            case MMD_YAML_KEY_RPMS:
               /* Get the set of RPMs */
               if (!_simpleset_from_sequence (parser, &set, error))
                 {
@@ -1169,11 +1298,9 @@ _parse_modulemd_profile (yaml_parser_t *parser,
                 }
               modulemd_profile_set_rpms (profile, set);
               g_object_unref (set);
-            }
+              break;
 
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "description"))
-            {
+            case MMD_YAML_KEY_DESCRIPTION:
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -1185,11 +1312,12 @@ _parse_modulemd_profile (yaml_parser_t *parser,
                 profile, (const gchar *)value_event.data.scalar.value);
 
               yaml_event_delete (&value_event);
-            }
-          else
-            {
+              break;
+
+            default:
               /* Unknown field in profile */
               MMD_YAML_ERROR_RETURN (error, "Unknown key in profile body");
+              break;
             }
           break;
 
@@ -1209,7 +1337,7 @@ _parse_modulemd_profile (yaml_parser_t *parser,
 error:
   g_object_unref (profile);
 
-  g_debug ("TRACE: exiting _parse_modulemd_profile");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_profile");
   return result;
 }
 
@@ -1225,7 +1353,7 @@ _parse_modulemd_api (ModulemdModuleStream *modulestream,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_modulemd_api");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_api");
 
   while (!done)
     {
@@ -1245,17 +1373,19 @@ _parse_modulemd_api (ModulemdModuleStream *modulestream,
 
         case YAML_SCALAR_EVENT:
           /* Currently, we only support "rpms" here */
-          if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "rpms"))
+          switch (MMD_YAML_EVENT_KEY (event))
             {
+            case MMD_YAML_KEY_RPMS:
               if (!_simpleset_from_sequence (parser, &set, error))
                 {
                   MMD_YAML_ERROR_RETURN_RETHROW (error, "Parse error in API");
                 }
               modulemd_modulestream_set_rpm_api (modulestream, set);
-            }
-          else
-            {
+              break;
+
+            default:
               MMD_YAML_ERROR_RETURN (error, "Unknown API type");
+              break;
             }
           break;
 
@@ -1273,7 +1403,7 @@ _parse_modulemd_api (ModulemdModuleStream *modulestream,
 error:
   g_object_unref (set);
 
-  g_debug ("TRACE: exiting _parse_modulemd_api");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_api");
   return result;
 }
 
@@ -1289,7 +1419,7 @@ _parse_modulemd_filters (ModulemdModuleStream *modulestream,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_modulemd_filters");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_filters");
 
   while (!done)
     {
@@ -1309,18 +1439,20 @@ _parse_modulemd_filters (ModulemdModuleStream *modulestream,
 
         case YAML_SCALAR_EVENT:
           /* Currently, we only support "rpms" here */
-          if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "rpms"))
+          switch (MMD_YAML_EVENT_KEY (event))
             {
+            case MMD_YAML_KEY_RPMS:
               if (!_simpleset_from_sequence (parser, &set, error))
                 {
                   MMD_YAML_ERROR_RETURN_RETHROW (error,
                                                  "Parse error in filters");
                 }
               modulemd_modulestream_set_rpm_filter (modulestream, set);
-            }
-          else
-            {
+              break;
+
+            default:
               MMD_YAML_ERROR_RETURN (error, "Unknown filter type");
+              break;
             }
           break;
 
@@ -1338,7 +1470,7 @@ _parse_modulemd_filters (ModulemdModuleStream *modulestream,
 error:
   g_clear_pointer (&set, g_object_unref);
 
-  g_debug ("TRACE: exiting _parse_modulemd_filters");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_filters");
   return result;
 }
 
@@ -1354,7 +1486,7 @@ _parse_modulemd_buildopts (ModulemdModuleStream *modulestream,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_modulemd_buildopts");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_buildopts");
 
   buildopts = modulemd_buildopts_new ();
 
@@ -1376,17 +1508,19 @@ _parse_modulemd_buildopts (ModulemdModuleStream *modulestream,
 
         case YAML_SCALAR_EVENT:
           /* Currently, we only support "rpms" here */
-          if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "rpms"))
+          switch (MMD_YAML_EVENT_KEY (event))
             {
+            case MMD_YAML_KEY_RPMS:
               if (!_parse_modulemd_rpm_buildopts (buildopts, parser, error))
                 {
                   MMD_YAML_ERROR_RETURN_RETHROW (
                     error, "Parse error in RPM buildopts");
                 }
-            }
-          else
-            {
+              break;
+
+            default:
               MMD_YAML_ERROR_RETURN (error, "Unknown buildopt type");
+              break;
             }
           break;
 
@@ -1405,7 +1539,7 @@ _parse_modulemd_buildopts (ModulemdModuleStream *modulestream,
 
 error:
 
-  g_debug ("TRACE: exiting _parse_modulemd_buildopts");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_buildopts");
   return result;
 }
 
@@ -1424,7 +1558,7 @@ _parse_modulemd_rpm_buildopts (ModulemdBuildopts *buildopts,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_modulemd_rpm_buildopts");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_rpm_buildopts");
 
   while (!done)
     {
@@ -1451,8 +1585,9 @@ _parse_modulemd_rpm_buildopts (ModulemdBuildopts *buildopts,
               break;
             }
 
-          if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "macros"))
+          switch (MMD_YAML_EVENT_KEY (event))
             {
+            case MMD_YAML_KEY_MACROS:
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -1462,20 +1597,20 @@ _parse_modulemd_rpm_buildopts (ModulemdBuildopts *buildopts,
               modulemd_buildopts_set_rpm_macros (
                 buildopts, (const gchar *)value_event.data.scalar.value);
               yaml_event_delete (&value_event);
-            }
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "whitelist"))
-            {
+              break;
+
+            case MMD_YAML_KEY_WHITELIST:
               if (!_simpleset_from_sequence (parser, &set, error))
                 {
                   MMD_YAML_ERROR_RETURN_RETHROW (
                     error, "Parse error in RPM whitelist");
                 }
               modulemd_buildopts_set_rpm_whitelist_simpleset (buildopts, set);
-            }
-          else
-            {
+              break;
+
+            default:
               MMD_YAML_ERROR_RETURN (error, "Unknown RPM buildopt key");
+              break;
             }
 
           break;
@@ -1492,7 +1627,7 @@ _parse_modulemd_rpm_buildopts (ModulemdBuildopts *buildopts,
   result = TRUE;
 error:
 
-  g_debug ("TRACE: exiting _parse_modulemd_rpm_buildopts");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_rpm_buildopts");
   return result;
 }
 
@@ -1508,7 +1643,7 @@ _parse_modulemd_components (ModulemdModuleStream *modulestream,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_modulemd_components");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_components");
 
   while (!done)
     {
@@ -1530,8 +1665,9 @@ _parse_modulemd_components (ModulemdModuleStream *modulestream,
           /* Each key is a type of component */
           g_debug ("Component type: %s",
                    (const gchar *)event.data.scalar.value);
-          if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "rpms"))
+          switch (MMD_YAML_EVENT_KEY (event))
             {
+            case MMD_YAML_KEY_RPMS:
               if (!_parse_modulemd_rpm_components (parser, &components, error))
                 {
                   MMD_YAML_ERROR_RETURN_RETHROW (
@@ -1540,10 +1676,9 @@ _parse_modulemd_components (ModulemdModuleStream *modulestream,
               modulemd_modulestream_set_rpm_components (modulestream,
                                                         components);
               g_hash_table_unref (components);
-            }
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "modules"))
-            {
+              break;
+
+            case MMD_YAML_KEY_MODULES:
               if (!_parse_modulemd_modulestream_components (
                     parser, &components, error))
                 {
@@ -1553,10 +1688,11 @@ _parse_modulemd_components (ModulemdModuleStream *modulestream,
               modulemd_modulestream_set_module_components (modulestream,
                                                            components);
               g_hash_table_unref (components);
-            }
-          else
-            {
+              break;
+
+            default:
               MMD_YAML_ERROR_RETURN (error, "Unknown component type");
+              break;
             }
           break;
 
@@ -1573,7 +1709,7 @@ _parse_modulemd_components (ModulemdModuleStream *modulestream,
 
 error:
 
-  g_debug ("TRACE: exiting _parse_modulemd_components");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_components");
   return result;
 }
 
@@ -1590,7 +1726,7 @@ _parse_modulemd_rpm_components (yaml_parser_t *parser,
   ModulemdComponentRpm *component = NULL;
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
-  g_debug ("TRACE: entering _parse_modulemd_rpm_components");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_rpm_components");
 
   components =
     g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
@@ -1639,7 +1775,7 @@ _parse_modulemd_rpm_components (yaml_parser_t *parser,
 error:
   g_hash_table_unref (components);
 
-  g_debug ("TRACE: exiting _parse_modulemd_rpm_components");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_rpm_components");
   return result;
 }
 
@@ -1658,7 +1794,7 @@ _parse_modulemd_rpm_component (yaml_parser_t *parser,
   guint64 buildorder = 0;
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
-  g_debug ("TRACE: entering _parse_modulemd_rpm_component");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_rpm_component");
 
   component = modulemd_component_rpm_new ();
   modulemd_component_set_name (MODULEMD_COMPONENT (component), name);
@@ -1680,9 +1816,9 @@ _parse_modulemd_rpm_component (yaml_parser_t *parser,
           break;
 
         case YAML_SCALAR_EVENT:
-          if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                          "buildorder"))
+          switch (MMD_YAML_EVENT_KEY (event))
             {
+            case MMD_YAML_KEY_BUILDORDER:
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -1697,11 +1833,9 @@ _parse_modulemd_rpm_component (yaml_parser_t *parser,
                 MODULEMD_COMPONENT (component), buildorder);
 
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "rationale"))
-            {
+            case MMD_YAML_KEY_RATIONALE:
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -1715,22 +1849,18 @@ _parse_modulemd_rpm_component (yaml_parser_t *parser,
                 (const gchar *)value_event.data.scalar.value);
 
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "arches"))
-            {
+            case MMD_YAML_KEY_ARCHES:
               if (!_simpleset_from_sequence (parser, &set, error))
                 {
                   MMD_YAML_ERROR_RETURN_RETHROW (
                     error, "Error parsing component arches");
                 }
               modulemd_component_rpm_set_arches (component, set);
-            }
+              break;
 
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "cache"))
-            {
+            case MMD_YAML_KEY_CACHE:
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -1742,21 +1872,18 @@ _parse_modulemd_rpm_component (yaml_parser_t *parser,
                 component, (const gchar *)value_event.data.scalar.value);
 
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "multilib"))
-            {
+            case MMD_YAML_KEY_MULTILIB:
               if (!_simpleset_from_sequence (parser, &set, error))
                 {
                   MMD_YAML_ERROR_RETURN_RETHROW (
                     error, "Error parsing multilib arches");
                 }
               modulemd_component_rpm_set_multilib (component, set);
-            }
+              break;
 
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "ref"))
-            {
+            case MMD_YAML_KEY_REF:
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -1768,11 +1895,9 @@ _parse_modulemd_rpm_component (yaml_parser_t *parser,
                 component, (const gchar *)value_event.data.scalar.value);
 
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "repository"))
-            {
+            case MMD_YAML_KEY_REPOSITORY:
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -1785,11 +1910,11 @@ _parse_modulemd_rpm_component (yaml_parser_t *parser,
                 component, (const gchar *)value_event.data.scalar.value);
 
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          else
-            {
+            default:
               MMD_YAML_ERROR_RETURN (error, "Unexpected key in component");
+              break;
             }
 
           break;
@@ -1810,7 +1935,7 @@ _parse_modulemd_rpm_component (yaml_parser_t *parser,
 error:
   g_object_unref (component);
 
-  g_debug ("TRACE: exiting _parse_modulemd_modulestream_components");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_modulestream_components");
   return result;
 }
 
@@ -1827,7 +1952,7 @@ _parse_modulemd_modulestream_components (yaml_parser_t *parser,
   ModulemdComponentModule *component = NULL;
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
-  g_debug ("TRACE: entering _parse_modulemd_modulestream_components");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_modulestream_components");
 
   components =
     g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
@@ -1877,7 +2002,7 @@ _parse_modulemd_modulestream_components (yaml_parser_t *parser,
 error:
   g_hash_table_unref (components);
 
-  g_debug ("TRACE: exiting _parse_modulemd_modulestream_components");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_modulestream_components");
   return result;
 }
 
@@ -1895,7 +2020,7 @@ _parse_modulemd_modulestream_component (yaml_parser_t *parser,
   guint64 buildorder = 0;
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
-  g_debug ("TRACE: entering _parse_modulemd_rpm_component");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_rpm_component");
 
   component = modulemd_component_module_new ();
   modulemd_component_set_name (MODULEMD_COMPONENT (component), name);
@@ -1917,9 +2042,9 @@ _parse_modulemd_modulestream_component (yaml_parser_t *parser,
           break;
 
         case YAML_SCALAR_EVENT:
-          if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                          "buildorder"))
+          switch (MMD_YAML_EVENT_KEY (event))
             {
+            case MMD_YAML_KEY_BUILDORDER:
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -1934,11 +2059,9 @@ _parse_modulemd_modulestream_component (yaml_parser_t *parser,
                 MODULEMD_COMPONENT (component), buildorder);
 
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "rationale"))
-            {
+            case MMD_YAML_KEY_RATIONALE:
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -1952,10 +2075,9 @@ _parse_modulemd_modulestream_component (yaml_parser_t *parser,
                 (const gchar *)value_event.data.scalar.value);
 
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "ref"))
-            {
+            case MMD_YAML_KEY_REF:
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -1967,11 +2089,9 @@ _parse_modulemd_modulestream_component (yaml_parser_t *parser,
                 component, (const gchar *)value_event.data.scalar.value);
 
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "repository"))
-            {
+            case MMD_YAML_KEY_REPOSITORY:
               YAML_PARSER_PARSE_WITH_ERROR_RETURN (
                 parser, &value_event, error, "Parser error");
               if (value_event.type != YAML_SCALAR_EVENT)
@@ -1984,11 +2104,11 @@ _parse_modulemd_modulestream_component (yaml_parser_t *parser,
                 component, (const gchar *)value_event.data.scalar.value);
 
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          else
-            {
+            default:
               MMD_YAML_ERROR_RETURN (error, "Unexpected key in component");
+              break;
             }
 
           break;
@@ -2008,7 +2128,7 @@ _parse_modulemd_modulestream_component (yaml_parser_t *parser,
 error:
   g_object_unref (component);
 
-  g_debug ("TRACE: exiting _parse_modulemd_modulestream_component");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_modulestream_component");
   return result;
 }
 
@@ -2024,7 +2144,7 @@ _parse_modulemd_artifacts (ModulemdModuleStream *modulestream,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_modulemd_artifacts");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_artifacts");
 
   while (!done)
     {
@@ -2044,8 +2164,9 @@ _parse_modulemd_artifacts (ModulemdModuleStream *modulestream,
 
         case YAML_SCALAR_EVENT:
           /* Currently, we only support "rpms" here */
-          if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "rpms"))
+          switch (MMD_YAML_EVENT_KEY (event))
             {
+            case MMD_YAML_KEY_RPMS:
               if (!_simpleset_from_sequence (parser, &set, error))
                 {
                   MMD_YAML_ERROR_RETURN_RETHROW (error,
@@ -2060,10 +2181,11 @@ _parse_modulemd_artifacts (ModulemdModuleStream *modulestream,
                 }
 
               modulemd_modulestream_set_rpm_artifacts (modulestream, set);
-            }
-          else
-            {
+              break;
+
+            default:
               MMD_YAML_ERROR_RETURN (error, "Unknown artifact type");
+              break;
             }
           break;
 
@@ -2081,7 +2203,7 @@ _parse_modulemd_artifacts (ModulemdModuleStream *modulestream,
 error:
   g_object_unref (set);
 
-  g_debug ("TRACE: exiting _parse_modulemd_artifacts");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_artifacts");
   return result;
 }
 
@@ -2099,7 +2221,7 @@ _parse_modulemd_servicelevels (ModulemdModuleStream *modulestream,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_modulemd_servicelevels");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_servicelevels");
 
   servicelevels =
     g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
@@ -2149,7 +2271,7 @@ _parse_modulemd_servicelevels (ModulemdModuleStream *modulestream,
 error:
   g_hash_table_unref (servicelevels);
 
-  g_debug ("TRACE: exiting _parse_modulemd_servicelevels");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_servicelevels");
   return result;
 }
 
@@ -2167,7 +2289,7 @@ _parse_modulemd_servicelevel (yaml_parser_t *parser,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _parse_modulemd_servicelevel");
+  MMD_TRACE ("TRACE: entering _parse_modulemd_servicelevel");
 
   sl = modulemd_servicelevel_new ();
   modulemd_servicelevel_set_name (sl, name);
@@ -2190,8 +2312,9 @@ _parse_modulemd_servicelevel (yaml_parser_t *parser,
 
         case YAML_SCALAR_EVENT:
           /* Only "eol" is supported right now */
-          if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "eol"))
+          switch (MMD_YAML_EVENT_KEY (event))
             {
+            case MMD_YAML_KEY_EOL:
               /* Get the EOL date */
               if (!_parse_modulemd_date (parser, &eol, error))
                 {
@@ -2201,13 +2324,13 @@ _parse_modulemd_servicelevel (yaml_parser_t *parser,
 
               modulemd_servicelevel_set_eol (sl, eol);
               g_date_free (eol);
-            }
+              break;
 
-          else
-            {
+            default:
               /* Unknown field in service level */
               MMD_YAML_ERROR_RETURN (error,
                                      "Unknown key in service level body");
+              break;
             }
           break;
 
@@ -2228,6 +2351,6 @@ _parse_modulemd_servicelevel (yaml_parser_t *parser,
 error:
   g_object_unref (sl);
 
-  g_debug ("TRACE: exiting _parse_modulemd_servicelevel");
+  MMD_TRACE ("TRACE: exiting _parse_modulemd_servicelevel");
   return result;
 }
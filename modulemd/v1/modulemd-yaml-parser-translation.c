@@ -103,29 +103,28 @@ _parse_translation (yaml_parser_t *parser,
               return FALSE;
             }
 
-          /* Handle "document: modulemd-translations" */
-          if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "document"))
+          switch (MMD_YAML_EVENT_KEY (event))
             {
-              g_debug ("TRACE: root entry [document]");
+            /* Handle "document: modulemd-translations" */
+            case MMD_YAML_KEY_DOCUMENT:
+              MMD_TRACE ("TRACE: root entry [document]");
 
               YAML_PARSER_PARSE_WITH_EXIT (parser, &value_event, error);
 
               if (value_event.type != YAML_SCALAR_EVENT ||
-                  g_strcmp0 ((const gchar *)value_event.data.scalar.value,
-                             "modulemd-translations"))
+                  MMD_YAML_EVENT_KEY (value_event) !=
+                    MMD_YAML_KEY_MODULEMD_TRANSLATIONS)
                 {
                   yaml_event_delete (&value_event);
                   MMD_YAML_SET_ERROR (error, "Document type mismatch");
                   return FALSE;
                 }
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          /* Record the modulemd version for the parser */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "version"))
-            {
-              g_debug ("TRACE: root entry [version]");
+            /* Record the modulemd version for the parser */
+            case MMD_YAML_KEY_VERSION:
+              MMD_TRACE ("TRACE: root entry [version]");
               YAML_PARSER_PARSE_WITH_EXIT (parser, &value_event, error);
               if (value_event.type != YAML_SCALAR_EVENT)
                 {
@@ -153,16 +152,14 @@ _parse_translation (yaml_parser_t *parser,
                                       "match preprocessing");
                   return FALSE;
                 }
-            }
+              break;
 
-          /* Process the data section */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "data"))
-            {
+            /* Process the data section */
+            case MMD_YAML_KEY_DATA:
               _yaml_parser_translation_recurse_down (_parse_translation_data);
-            }
+              break;
 
-          else
-            {
+            default:
               MMD_YAML_SET_ERROR (error,
                                   "Unexpected key in root: %s",
                                   (const gchar *)event.data.scalar.value);
@@ -227,9 +224,10 @@ _parse_translation_data (ModulemdTranslation *translation,
               return FALSE;
             }
 
-          /* Module Name */
-          if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "module"))
+          switch (MMD_YAML_EVENT_KEY (event))
             {
+            /* Module Name */
+            case MMD_YAML_KEY_MODULE:
               YAML_PARSER_PARSE_WITH_EXIT (parser, &value_event, error);
               if (value_event.type != YAML_SCALAR_EVENT)
                 {
@@ -240,12 +238,10 @@ _parse_translation_data (ModulemdTranslation *translation,
               modulemd_translation_set_module_name (
                 translation, (const gchar *)value_event.data.scalar.value);
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          /* Module stream */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "stream"))
-            {
+            /* Module stream */
+            case MMD_YAML_KEY_STREAM:
               YAML_PARSER_PARSE_WITH_EXIT (parser, &value_event, error);
               if (value_event.type != YAML_SCALAR_EVENT)
                 {
@@ -256,12 +252,10 @@ _parse_translation_data (ModulemdTranslation *translation,
               modulemd_translation_set_module_stream (
                 translation, (const gchar *)value_event.data.scalar.value);
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          /* Modified */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "modified"))
-            {
+            /* Modified */
+            case MMD_YAML_KEY_MODIFIED:
               YAML_PARSER_PARSE_WITH_EXIT (parser, &value_event, error);
               if (value_event.type != YAML_SCALAR_EVENT)
                 {
@@ -281,18 +275,15 @@ _parse_translation_data (ModulemdTranslation *translation,
                 }
 
               modulemd_translation_set_modified (translation, modified);
-            }
+              break;
 
-          /* Translation Entries */
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "translations"))
-            {
+            /* Translation Entries */
+            case MMD_YAML_KEY_TRANSLATIONS:
               _yaml_parser_translation_recurse_down (
                 _parse_translation_entries);
-            }
+              break;
 
-          else
-            {
+            default:
               MMD_YAML_SET_ERROR (error,
                                   "Unexpected key in root: %s",
                                   (const gchar *)event.data.scalar.value);
@@ -425,9 +416,10 @@ _parse_translation_entry (yaml_parser_t *parser,
               return NULL;
             }
 
-          /* Summary */
-          if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "summary"))
+          switch (MMD_YAML_EVENT_KEY (event))
             {
+            /* Summary */
+            case MMD_YAML_KEY_SUMMARY:
               YAML_PARSER_PARSE_WITH_EXIT (parser, &value_event, error);
               if (value_event.type != YAML_SCALAR_EVENT)
                 {
@@ -438,11 +430,9 @@ _parse_translation_entry (yaml_parser_t *parser,
               modulemd_translation_entry_set_summary (
                 entry, (const gchar *)value_event.data.scalar.value);
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          else if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                               "description"))
-            {
+            case MMD_YAML_KEY_DESCRIPTION:
               YAML_PARSER_PARSE_WITH_EXIT (parser, &value_event, error);
               if (value_event.type != YAML_SCALAR_EVENT)
                 {
@@ -453,10 +443,9 @@ _parse_translation_entry (yaml_parser_t *parser,
               modulemd_translation_entry_set_description (
                 entry, (const gchar *)value_event.data.scalar.value);
               yaml_event_delete (&value_event);
-            }
+              break;
 
-          if (!g_strcmp0 ((const gchar *)event.data.scalar.value, "profiles"))
-            {
+            case MMD_YAML_KEY_PROFILES:
               if (!_hashtable_from_mapping (parser, &profiles, error))
                 return NULL;
 
@@ -467,6 +456,11 @@ _parse_translation_entry (yaml_parser_t *parser,
                     entry, (const gchar *)key, (const gchar *)value);
                 }
               g_clear_pointer (&profiles, g_hash_table_unref);
+              break;
+
+            default:
+              /* Nothing to do */
+              break;
             }
 
           break;
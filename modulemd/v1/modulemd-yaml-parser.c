@@ -11,14 +11,23 @@
  * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
  */
 
+/* Needed for posix_madvise () with -std=c11 */
+#define _POSIX_C_SOURCE 200112L
+
+#include "config.h"
 #include "modulemd.h"
 #include <glib.h>
 #include <glib/gstdio.h>
 #include <inttypes.h>
 #include <yaml.h>
 #include <errno.h>
+#ifdef HAVE_POSIX_MADVISE
+#include <sys/mman.h>
+#endif
 #include "private/modulemd-yaml.h"
 #include "private/modulemd-util.h"
+#include "private/modulemd-cache.h"
+#include "private/modulemd-filter-private.h"
 #include "private/modulemd-subdocument-private.h"
 
 GQuark
@@ -28,20 +37,131 @@ modulemd_yaml_error_quark (void)
 }
 
 
+/* A subdocument waiting to be handed to the parser for its type */
+typedef struct _modulemd_parse_job
+{
+  ModulemdSubdocument *document;
+  GArray *events;
+  gboolean preserve;
+  guint sections;
+
+  gboolean result;
+  GObject *object;
+  GError *error;
+} modulemd_parse_job;
+
+/* A whole file waiting to be parsed by parse_module_index_from_files() */
+typedef struct _modulemd_file_job
+{
+  const gchar *path;
+
+  gboolean result;
+  GPtrArray *data;
+  GPtrArray *failures;
+  GError *error;
+} modulemd_file_job;
+
+/* A run of whole documents from a mapped file, parsed with its own
+ * yaml_parser_t by _parse_yaml_chunks()
+ */
+typedef struct _modulemd_chunk_job
+{
+  const gchar *contents;
+  gsize length;
+  ModulemdFilter *filter;
+  modulemd_string_pool *strings;
+  GCancellable *cancellable;
+  gboolean want_failures;
+
+  gboolean result;
+  GByteArray *records;
+  GPtrArray *data;
+  GPtrArray *failures;
+  GError *error;
+} modulemd_chunk_job;
+
+/* Each thread gets several chunks, so that a few large documents don't leave
+ * the other threads idle
+ */
+#define MMD_CHUNKS_PER_THREAD 4
+
 static gboolean
 _parse_yaml (yaml_parser_t *parser,
+             guint n_threads,
+             ModulemdFilter *filter,
+             GByteArray *cache_records,
+             ModulemdForeachFunc callback,
+             gpointer user_data,
              GPtrArray **data,
              GPtrArray **failures,
              GError **error);
 
 static gboolean
-_read_yaml_and_type (yaml_parser_t *parser, ModulemdSubdocument **subdocument);
+_parse_yaml_string (const gchar *yaml,
+                    gsize length,
+                    ModulemdFilter *filter,
+                    GPtrArray **data,
+                    GPtrArray **failures,
+                    GError **error);
+
+static gboolean
+_parse_yaml_path (const gchar *path,
+                  guint n_threads,
+                  ModulemdFilter *filter,
+                  GPtrArray **data,
+                  GPtrArray **failures,
+                  GError **error);
+
+static gboolean
+_parse_yaml_chunks (const gchar *contents,
+                    gsize length,
+                    guint n_threads,
+                    ModulemdFilter *filter,
+                    GByteArray *cache_records,
+                    GPtrArray **data,
+                    GPtrArray **failures);
+
+static GHashTable *
+_module_index_from_file (const gchar *path,
+                         guint n_threads,
+                         ModulemdFilter *filter,
+                         GPtrArray **failures,
+                         GError **error);
+
+static GHashTable *
+_module_index_from_parser (yaml_parser_t *parser,
+                           guint n_threads,
+                           ModulemdFilter *filter,
+                           GPtrArray **failures,
+                           GError **error);
+
+static gboolean
+_parser_set_input_path (yaml_parser_t *parser,
+                        const gchar *path,
+                        GMappedFile **mapped_file,
+                        FILE **yaml_file,
+                        GError **error);
+
+static gboolean
+_read_yaml_and_type (yaml_parser_t *parser,
+                     ModulemdFilter *filter,
+                     ModulemdSubdocument **subdocument,
+                     GArray **events);
+
+static void
+_set_subdocument_yaml (ModulemdSubdocument *subdocument, GArray *events);
+
+static void
+_cache_record_append (GByteArray *records,
+                      ModulemdSubdocument *subdocument,
+                      GArray *events);
 
 static gboolean
 _parse_subdocument (ModulemdSubdocument *subdocument,
-                    ModulemdParsingFunc parse_func,
+                    GArray *events,
+                    gboolean preserve,
+                    guint sections,
                     GObject **data,
-                    guint64 version,
                     GError **error);
 
 
@@ -50,12 +170,21 @@ parse_yaml_file (const gchar *path,
                  GPtrArray **data,
                  GPtrArray **failures,
                  GError **error)
+{
+  return parse_yaml_file_filtered (path, NULL, data, failures, error);
+}
+
+
+gboolean
+parse_yaml_file_filtered (const gchar *path,
+                          ModulemdFilter *filter,
+                          GPtrArray **data,
+                          GPtrArray **failures,
+                          GError **error)
 {
   gboolean result = FALSE;
-  FILE *yaml_file = NULL;
-  yaml_parser_t parser;
 
-  g_debug ("TRACE: entering parse_yaml_file");
+  MMD_TRACE ("TRACE: entering parse_yaml_file_filtered");
 
   if (error != NULL && *error != NULL)
     {
@@ -69,23 +198,63 @@ parse_yaml_file (const gchar *path,
         error, MODULEMD_YAML_ERROR_PROGRAMMING, "Path not supplied.");
     }
 
+  if (!_parse_yaml_path (path, 1, filter, data, failures, error))
+    {
+      MMD_YAML_ERROR_RETURN_RETHROW (error, "Could not parse YAML");
+    }
+
+  result = TRUE;
+
+error:
+  MMD_TRACE ("TRACE: exiting parse_yaml_file_filtered");
+  return result;
+}
+
+
+gboolean
+parse_yaml_file_foreach (const gchar *path,
+                         ModulemdForeachFunc callback,
+                         gpointer user_data,
+                         GError **error)
+{
+  gboolean result = FALSE;
+  g_autoptr (FILE) yaml_file = NULL;
+  g_autoptr (GMappedFile) mapped_file = NULL;
+  g_auto (yaml_parser_t) parser;
+
+  MMD_TRACE ("TRACE: entering parse_yaml_file_foreach");
+
   yaml_parser_initialize (&parser);
 
-  errno = 0;
-  yaml_file = g_fopen (path, "rb");
-  if (!yaml_file)
+  if (error != NULL && *error != NULL)
     {
-      g_set_error (error,
-                   MODULEMD_YAML_ERROR,
-                   MODULEMD_YAML_ERROR_OPEN,
-                   "Failed to open file: %s",
-                   g_strerror (errno));
-      goto error;
+      MMD_ERROR_RETURN_FULL (
+        error, MODULEMD_YAML_ERROR_PROGRAMMING, "GError is initialized.");
+    }
+
+  if (!path)
+    {
+      MMD_ERROR_RETURN_FULL (
+        error, MODULEMD_YAML_ERROR_PROGRAMMING, "Path not supplied.");
     }
 
-  yaml_parser_set_input_file (&parser, yaml_file);
+  if (!callback)
+    {
+      MMD_ERROR_RETURN_FULL (
+        error, MODULEMD_YAML_ERROR_PROGRAMMING, "Callback not supplied.");
+    }
 
-  if (!_parse_yaml (&parser, data, failures, error))
+  if (!_parser_set_input_path (
+        &parser, path, &mapped_file, &yaml_file, error))
+    {
+      goto error;
+    }
+
+  /* Results are handed to the callback as each subdocument completes, so
+   * nothing is accumulated here
+   */
+  if (!_parse_yaml (
+        &parser, 1, NULL, NULL, callback, user_data, NULL, NULL, error))
     {
       MMD_YAML_ERROR_RETURN_RETHROW (error, "Could not parse YAML");
     }
@@ -93,12 +262,7 @@ parse_yaml_file (const gchar *path,
   result = TRUE;
 
 error:
-  yaml_parser_delete (&parser);
-  if (yaml_file)
-    {
-      fclose (yaml_file);
-    }
-  g_debug ("TRACE: exiting parse_yaml_file");
+  MMD_TRACE ("TRACE: exiting parse_yaml_file_foreach");
   return result;
 }
 
@@ -107,11 +271,87 @@ parse_yaml_string (const gchar *yaml,
                    GPtrArray **data,
                    GPtrArray **failures,
                    GError **error)
+{
+  return parse_yaml_string_len (
+    yaml, yaml ? strlen (yaml) : 0, data, failures, error);
+}
+
+
+gboolean
+parse_yaml_string_len (const gchar *yaml,
+                       gsize length,
+                       GPtrArray **data,
+                       GPtrArray **failures,
+                       GError **error)
+{
+  return _parse_yaml_string (yaml, length, NULL, data, failures, error);
+}
+
+
+gboolean
+parse_yaml_string_filtered (const gchar *yaml,
+                            ModulemdFilter *filter,
+                            GPtrArray **data,
+                            GPtrArray **failures,
+                            GError **error)
+{
+  return _parse_yaml_string (
+    yaml, yaml ? strlen (yaml) : 0, filter, data, failures, error);
+}
+
+
+gboolean
+parse_yaml_string_records (const gchar *yaml,
+                           GByteArray *records,
+                           GError **error)
+{
+  g_autoptr (GPtrArray) failures = NULL;
+  g_auto (yaml_parser_t) parser;
+  ModulemdSubdocument *failure = NULL;
+
+  MMD_TRACE ("TRACE: entering parse_yaml_string_records");
+  yaml_parser_initialize (&parser);
+
+  yaml_parser_set_input_string (
+    &parser, (const unsigned char *)yaml, strlen (yaml));
+
+  if (!_parse_yaml (
+        &parser, 1, NULL, records, NULL, NULL, NULL, &failures, error))
+    {
+      return FALSE;
+    }
+
+  /* Records are only useful if every subdocument can be read back */
+  if (failures->len > 0)
+    {
+      failure = g_ptr_array_index (failures, 0);
+      g_set_error (error,
+                   MODULEMD_YAML_ERROR,
+                   MODULEMD_YAML_ERROR_PARSE,
+                   "Subdocument could not be parsed: %s",
+                   modulemd_subdocument_get_gerror (failure) ?
+                     modulemd_subdocument_get_gerror (failure)->message :
+                     "unknown error");
+      return FALSE;
+    }
+
+  MMD_TRACE ("TRACE: exiting parse_yaml_string_records");
+  return TRUE;
+}
+
+
+static gboolean
+_parse_yaml_string (const gchar *yaml,
+                    gsize length,
+                    ModulemdFilter *filter,
+                    GPtrArray **data,
+                    GPtrArray **failures,
+                    GError **error)
 {
   gboolean result = FALSE;
   yaml_parser_t parser;
 
-  g_debug ("TRACE: entering parse_yaml_string");
+  MMD_TRACE ("TRACE: entering _parse_yaml_string");
 
   if (error != NULL && *error != NULL)
     {
@@ -127,10 +367,10 @@ parse_yaml_string (const gchar *yaml,
 
   yaml_parser_initialize (&parser);
 
-  yaml_parser_set_input_string (
-    &parser, (const unsigned char *)yaml, strlen (yaml));
+  yaml_parser_set_input_string (&parser, (const unsigned char *)yaml, length);
 
-  if (!_parse_yaml (&parser, data, failures, error))
+  if (!_parse_yaml (
+        &parser, 1, filter, NULL, NULL, NULL, data, failures, error))
     {
       MMD_YAML_ERROR_RETURN_RETHROW (error, "Could not parse YAML");
     }
@@ -140,7 +380,7 @@ parse_yaml_string (const gchar *yaml,
 error:
   yaml_parser_delete (&parser);
 
-  g_debug ("TRACE: exiting parse_yaml_string");
+  MMD_TRACE ("TRACE: exiting _parse_yaml_string");
   return result;
 }
 
@@ -154,7 +394,7 @@ parse_yaml_stream (FILE *stream,
   gboolean result = FALSE;
   yaml_parser_t parser;
 
-  g_debug ("TRACE: entering parse_yaml_stream");
+  MMD_TRACE ("TRACE: entering parse_yaml_stream");
 
   if (error != NULL && *error != NULL)
     {
@@ -172,7 +412,8 @@ parse_yaml_stream (FILE *stream,
 
   yaml_parser_set_input_file (&parser, stream);
 
-  if (!_parse_yaml (&parser, data, failures, error))
+  if (!_parse_yaml (
+        &parser, 1, NULL, NULL, NULL, NULL, data, failures, error))
     {
       MMD_YAML_ERROR_RETURN_RETHROW (error, "Could not parse YAML");
     }
@@ -181,7 +422,7 @@ parse_yaml_stream (FILE *stream,
 
 error:
   yaml_parser_delete (&parser);
-  g_debug ("TRACE: exiting parse_yaml_stream");
+  MMD_TRACE ("TRACE: exiting parse_yaml_stream");
   return result;
 }
 
@@ -191,14 +432,65 @@ parse_module_index_from_file (const gchar *path,
                               GPtrArray **failures,
                               GError **error)
 {
-  g_autoptr (FILE) yaml_file = NULL;
+  return parse_module_index_from_file_parallel (path, 1, failures, error);
+}
+
+
+GHashTable *
+parse_module_index_from_file_parallel (const gchar *path,
+                                       guint n_threads,
+                                       GPtrArray **failures,
+                                       GError **error)
+{
+  return _module_index_from_file (path, n_threads, NULL, failures, error);
+}
+
+
+static void
+_file_job_free (modulemd_file_job *job)
+{
+  g_clear_pointer (&job->data, g_ptr_array_unref);
+  g_clear_pointer (&job->failures, g_ptr_array_unref);
+  g_clear_error (&job->error);
+  g_free (job);
+}
+
+
+static void
+_file_job_run (gpointer data, gpointer user_data)
+{
+  modulemd_file_job *job = (modulemd_file_job *)data;
+  modulemd_string_pool *strings = (modulemd_string_pool *)user_data;
+  modulemd_string_pool *previous_strings = NULL;
+
+  /* Every file shares the string pool of the index being built */
+  previous_strings = modulemd_string_pool_set_thread_default (strings);
+
+  job->result = _parse_yaml_path (
+    job->path, 1, NULL, &job->data, &job->failures, &job->error);
+
+  modulemd_string_pool_set_thread_default (previous_strings);
+}
+
+
+GHashTable *
+parse_module_index_from_files (const gchar **paths,
+                               guint n_threads,
+                               GPtrArray **failures,
+                               GError **error)
+{
+  g_autoptr (GPtrArray) jobs = NULL;
   g_autoptr (GPtrArray) data = NULL;
-  g_auto (yaml_parser_t) parser;
+  g_autoptr (GPtrArray) all_failures = NULL;
+  g_autoptr (modulemd_string_pool) strings = NULL;
+  modulemd_string_pool *previous_strings = NULL;
+  g_autoptr (GError) push_error = NULL;
+  GThreadPool *pool = NULL;
+  modulemd_file_job *job = NULL;
   GHashTable *module_index = NULL;
-  g_autoptr (GError) nested_error = NULL;
+  guint n_paths = 0;
 
-  g_debug ("TRACE: entering parse_module_index_from_file");
-  yaml_parser_initialize (&parser);
+  MMD_TRACE ("TRACE: entering parse_module_index_from_files");
 
   if (error != NULL && *error != NULL)
     {
@@ -209,60 +501,470 @@ parse_module_index_from_file (const gchar *path,
       return NULL;
     }
 
-  if (!path)
+  if (!paths)
     {
       g_set_error_literal (error,
                            MODULEMD_YAML_ERROR,
                            MODULEMD_YAML_ERROR_PROGRAMMING,
-                           "Path not supplied.");
+                           "Paths not supplied.");
       return NULL;
     }
 
-  errno = 0;
-  yaml_file = g_fopen (path, "rb");
-  if (!yaml_file)
+  n_paths = g_strv_length ((gchar **)paths);
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+  n_threads = MIN (n_threads, n_paths);
+
+  jobs = g_ptr_array_new_full (n_paths, (GDestroyNotify)_file_job_free);
+  for (guint i = 0; i < n_paths; i++)
     {
-      g_set_error (error,
-                   MODULEMD_YAML_ERROR,
-                   MODULEMD_YAML_ERROR_OPEN,
-                   "Failed to open file: %s",
-                   g_strerror (errno));
+      job = g_new0 (modulemd_file_job, 1);
+      job->path = paths[i];
+      g_ptr_array_add (jobs, job);
+    }
+
+  strings = modulemd_string_pool_new ();
+  previous_strings = modulemd_string_pool_set_thread_default (strings);
+
+  if (n_threads > 1)
+    {
+      pool =
+        g_thread_pool_new (_file_job_run, strings, n_threads, FALSE, error);
+      if (!pool)
+        goto error;
+
+      for (guint i = 0; i < n_paths; i++)
+        {
+          job = g_ptr_array_index (jobs, i);
+          if (!g_thread_pool_push (pool, job, &push_error))
+            {
+              /* The job is still queued even if no new thread could be
+               * started for it, so the running ones will parse the file
+               */
+              g_debug ("Could not start a thread for %s: %s",
+                       job->path,
+                       push_error->message);
+              g_clear_error (&push_error);
+            }
+        }
+
+      g_thread_pool_free (pool, FALSE, TRUE);
+    }
+  else
+    {
+      for (guint i = 0; i < n_paths; i++)
+        _file_job_run (g_ptr_array_index (jobs, i), strings);
+    }
+
+  /* Combine the results in the order the files were given, so that the merge
+   * is the same as for a serial parse
+   */
+  data = g_ptr_array_new_with_free_func (g_object_unref);
+  all_failures = g_ptr_array_new_with_free_func (g_object_unref);
+  for (guint i = 0; i < n_paths; i++)
+    {
+      job = g_ptr_array_index (jobs, i);
+      if (!job->result)
+        {
+          g_propagate_prefixed_error (
+            error, g_steal_pointer (&job->error), "%s: ", job->path);
+          goto error;
+        }
+
+      for (gsize j = 0; j < job->data->len; j++)
+        {
+          g_ptr_array_add (data,
+                           g_object_ref (g_ptr_array_index (job->data, j)));
+        }
+
+      for (gsize j = 0; j < job->failures->len; j++)
+        {
+          g_ptr_array_add (
+            all_failures, g_object_ref (g_ptr_array_index (job->failures, j)));
+        }
+    }
+
+  module_index = module_index_from_data (data, error);
+
+  if (failures)
+    *failures = g_ptr_array_ref (all_failures);
+
+error:
+  modulemd_string_pool_set_thread_default (previous_strings);
+  MMD_TRACE ("TRACE: exiting parse_module_index_from_files");
+  return module_index;
+}
+
+
+GHashTable *
+parse_module_index_from_file_filtered (const gchar *path,
+                                       ModulemdFilter *filter,
+                                       GPtrArray **failures,
+                                       GError **error)
+{
+  return _module_index_from_file (path, 1, filter, failures, error);
+}
+
+
+static GHashTable *
+_module_index_from_file (const gchar *path,
+                         guint n_threads,
+                         ModulemdFilter *filter,
+                         GPtrArray **failures,
+                         GError **error)
+{
+  g_autoptr (GPtrArray) data = NULL;
+  g_autoptr (modulemd_string_pool) strings = NULL;
+  g_autoptr (GError) nested_error = NULL;
+  modulemd_string_pool *previous_strings = NULL;
+  GHashTable *module_index = NULL;
+
+  MMD_TRACE ("TRACE: entering _module_index_from_file");
+
+  if (error != NULL && *error != NULL)
+    {
+      g_set_error_literal (error,
+                           MODULEMD_YAML_ERROR,
+                           MODULEMD_YAML_ERROR_PROGRAMMING,
+                           "GError is initialized.");
+      return NULL;
+    }
+
+  if (!path)
+    {
+      g_set_error_literal (error,
+                           MODULEMD_YAML_ERROR,
+                           MODULEMD_YAML_ERROR_PROGRAMMING,
+                           "Path not supplied.");
       return NULL;
     }
 
-  yaml_parser_set_input_file (&parser, yaml_file);
+  /* This matches _module_index_from_parser(), except that the parse may be
+   * answered from the cache
+   */
+  strings = modulemd_string_pool_new ();
+  previous_strings = modulemd_string_pool_set_thread_default (strings);
 
-  if (!_parse_yaml (&parser, &data, failures, &nested_error))
+  if (!_parse_yaml_path (
+        path, n_threads, filter, &data, failures, &nested_error))
     {
       g_debug ("Could not parse YAML: %s", nested_error->message);
-      g_propagate_error (error, nested_error);
-      return NULL;
+      g_propagate_error (error, g_steal_pointer (&nested_error));
+      goto error;
     }
 
   module_index = module_index_from_data (data, &nested_error);
   if (!module_index)
     {
       g_debug ("Could not get module_index: %s", nested_error->message);
-      g_propagate_error (error, nested_error);
-      return NULL;
+      g_propagate_error (error, g_steal_pointer (&nested_error));
+      goto error;
     }
 
-  g_debug ("TRACE: exiting parse_module_index_from_file");
+error:
+  modulemd_string_pool_set_thread_default (previous_strings);
+  MMD_TRACE ("TRACE: exiting _module_index_from_file");
   return module_index;
 }
 
 
+static gboolean
+_parse_yaml_path (const gchar *path,
+                  guint n_threads,
+                  ModulemdFilter *filter,
+                  GPtrArray **data,
+                  GPtrArray **failures,
+                  GError **error)
+{
+  g_autoptr (FILE) yaml_file = NULL;
+  g_autoptr (GMappedFile) mapped_file = NULL;
+  g_auto (yaml_parser_t) parser;
+  g_autoptr (modulemd_cache_key) cache_key = NULL;
+  g_autoptr (GBytes) cached = NULL;
+  g_autoptr (GByteArray) cache_records = NULL;
+  g_autoptr (GPtrArray) cache_failures = NULL;
+  g_autoptr (GError) cache_error = NULL;
+
+  MMD_TRACE ("TRACE: entering _parse_yaml_path");
+  yaml_parser_initialize (&parser);
+
+  /* Only complete parses are cached */
+  if (!filter && modulemd_cache_enabled ())
+    {
+      cached = modulemd_cache_lookup (path, &cache_key);
+      if (cached)
+        {
+          if (parse_yaml_records (cached, data, &cache_error))
+            {
+              if (failures)
+                {
+                  *failures = g_ptr_array_new_with_free_func (g_object_unref);
+                }
+
+              MMD_TRACE ("TRACE: exiting _parse_yaml_path");
+              return TRUE;
+            }
+
+          g_debug ("Ignoring the cached parse of %s: %s",
+                   path,
+                   cache_error->message);
+        }
+
+      if (cache_key)
+        {
+          cache_records = g_byte_array_new ();
+
+          /* The failures decide whether the result can be cached */
+          if (!failures)
+            failures = &cache_failures;
+        }
+    }
+
+  if (!_parser_set_input_path (
+        &parser, path, &mapped_file, &yaml_file, error))
+    {
+      return FALSE;
+    }
+
+  /* Mapped files can be split into documents up front, so that tokenizing
+   * them is spread across the threads as well
+   */
+  if (n_threads == 1 || !mapped_file ||
+      !_parse_yaml_chunks (g_mapped_file_get_contents (mapped_file),
+                           g_mapped_file_get_length (mapped_file),
+                           n_threads,
+                           filter,
+                           cache_records,
+                           data,
+                           failures))
+    {
+      if (!_parse_yaml (&parser,
+                        n_threads,
+                        filter,
+                        cache_records,
+                        NULL,
+                        NULL,
+                        data,
+                        failures,
+                        error))
+        {
+          return FALSE;
+        }
+    }
+
+  if (cache_records && (*failures)->len == 0)
+    modulemd_cache_store (cache_key, cache_records);
+
+  MMD_TRACE ("TRACE: exiting _parse_yaml_path");
+  return TRUE;
+}
+
+
+static void
+_chunk_job_free (modulemd_chunk_job *job)
+{
+  g_clear_pointer (&job->records, g_byte_array_unref);
+  g_clear_pointer (&job->data, g_ptr_array_unref);
+  g_clear_pointer (&job->failures, g_ptr_array_unref);
+  g_clear_error (&job->error);
+  g_free (job);
+}
+
+
+static void
+_chunk_job_run (gpointer data, gpointer user_data)
+{
+  modulemd_chunk_job *job = (modulemd_chunk_job *)data;
+  modulemd_string_pool *previous_strings = NULL;
+  g_auto (yaml_parser_t) parser;
+
+  yaml_parser_initialize (&parser);
+  yaml_parser_set_input_string (
+    &parser, (const unsigned char *)job->contents, job->length);
+
+  previous_strings = modulemd_string_pool_set_thread_default (job->strings);
+  if (job->cancellable)
+    g_cancellable_push_current (job->cancellable);
+
+  job->result = _parse_yaml (&parser,
+                             1,
+                             job->filter,
+                             job->records,
+                             NULL,
+                             NULL,
+                             &job->data,
+                             job->want_failures ? &job->failures : NULL,
+                             &job->error);
+
+  if (job->cancellable)
+    g_cancellable_pop_current (job->cancellable);
+  modulemd_string_pool_set_thread_default (previous_strings);
+}
+
+
+/* Parses a complete buffer by splitting it into runs of documents and
+ * giving each run its own parser on a thread pool. Returns FALSE without
+ * touching the output if the buffer can't be split or any run fails to
+ * parse; the caller then parses it serially, which reports the error exactly
+ * as it would have been otherwise.
+ */
+static gboolean
+_parse_yaml_chunks (const gchar *contents,
+                    gsize length,
+                    guint n_threads,
+                    ModulemdFilter *filter,
+                    GByteArray *cache_records,
+                    GPtrArray **data,
+                    GPtrArray **failures)
+{
+  g_autoptr (GArray) boundaries = NULL;
+  g_autoptr (GPtrArray) jobs = NULL;
+  g_autoptr (GPtrArray) objects = NULL;
+  g_autoptr (GPtrArray) invalid_subdocuments = NULL;
+  g_autoptr (GPtrArray) failed_subdocuments = NULL;
+  g_autoptr (GError) push_error = NULL;
+  ModulemdSubdocument *document = NULL;
+  modulemd_chunk_job *job = NULL;
+  GThreadPool *pool = NULL;
+  gsize target = 0;
+  gsize start = 0;
+  gsize next = 0;
+
+  MMD_TRACE ("TRACE: entering _parse_yaml_chunks");
+
+  if (!contents)
+    return FALSE;
+
+  boundaries = g_array_new (FALSE, FALSE, sizeof (gsize));
+  if (!mmd_yaml_split_documents (contents, length, boundaries) ||
+      boundaries->len < 2)
+    {
+      return FALSE;
+    }
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+  target = length / (n_threads * MMD_CHUNKS_PER_THREAD);
+
+  /* Group consecutive documents into chunks of roughly equal size */
+  jobs = g_ptr_array_new_with_free_func ((GDestroyNotify)_chunk_job_free);
+  for (guint i = 1; i <= boundaries->len; i++)
+    {
+      next = i < boundaries->len ? g_array_index (boundaries, gsize, i) :
+                                   length;
+      if (next - start < target && i < boundaries->len)
+        continue;
+
+      job = g_new0 (modulemd_chunk_job, 1);
+      job->contents = contents + start;
+      job->length = next - start;
+      job->filter = filter;
+      job->strings = modulemd_string_pool_get_thread_default ();
+      job->cancellable = g_cancellable_get_current ();
+      job->want_failures = (failures != NULL);
+      if (cache_records)
+        job->records = g_byte_array_new ();
+      g_ptr_array_add (jobs, job);
+
+      start = next;
+    }
+
+  if (jobs->len < 2)
+    return FALSE;
+
+  pool = g_thread_pool_new (
+    _chunk_job_run, NULL, MIN (n_threads, jobs->len), FALSE, NULL);
+  if (!pool)
+    return FALSE;
+
+  for (guint i = 0; i < jobs->len; i++)
+    {
+      job = g_ptr_array_index (jobs, i);
+      if (!g_thread_pool_push (pool, job, &push_error))
+        {
+          /* The job is still queued even if no new thread could be started
+           * for it, so the running ones will parse the chunk
+           */
+          g_debug ("Could not start a parser thread: %s", push_error->message);
+          g_clear_error (&push_error);
+        }
+    }
+  g_thread_pool_free (pool, FALSE, TRUE);
+
+  for (guint i = 0; i < jobs->len; i++)
+    {
+      job = g_ptr_array_index (jobs, i);
+      if (!job->result)
+        {
+          g_debug ("Parsing documents separately failed: %s",
+                   job->error ? job->error->message : "unknown error");
+          return FALSE;
+        }
+    }
+
+  /* Combine the chunks in order. A serial parse reports the documents whose
+   * type could not be determined before those that failed to parse, so the
+   * failures are regrouped the same way.
+   */
+  objects = g_ptr_array_new_with_free_func (g_object_unref);
+  failed_subdocuments = g_ptr_array_new_with_free_func (g_object_unref);
+  invalid_subdocuments = g_ptr_array_new_with_free_func (g_object_unref);
+  for (guint i = 0; i < jobs->len; i++)
+    {
+      job = g_ptr_array_index (jobs, i);
+
+      for (gsize j = 0; j < job->data->len; j++)
+        {
+          g_ptr_array_add (objects,
+                           g_object_ref (g_ptr_array_index (job->data, j)));
+        }
+
+      for (gsize j = 0; job->failures && j < job->failures->len; j++)
+        {
+          document = g_ptr_array_index (job->failures, j);
+          if (modulemd_subdocument_get_doctype (document) == G_TYPE_INVALID)
+            g_ptr_array_add (failed_subdocuments, g_object_ref (document));
+          else
+            g_ptr_array_add (invalid_subdocuments, g_object_ref (document));
+        }
+
+      if (cache_records)
+        {
+          g_byte_array_append (
+            cache_records, job->records->data, job->records->len);
+        }
+    }
+
+  if (data)
+    *data = g_steal_pointer (&objects);
+
+  if (failures)
+    {
+      for (gsize i = 0; i < invalid_subdocuments->len; i++)
+        {
+          g_ptr_array_add (
+            failed_subdocuments,
+            g_object_ref (g_ptr_array_index (invalid_subdocuments, i)));
+        }
+
+      *failures = g_steal_pointer (&failed_subdocuments);
+    }
+
+  MMD_TRACE ("TRACE: exiting _parse_yaml_chunks");
+  return TRUE;
+}
+
+
 GHashTable *
 parse_module_index_from_string (const gchar *yaml,
                                 GPtrArray **failures,
                                 GError **error)
 {
-  g_autoptr (GPtrArray) data = NULL;
   g_auto (yaml_parser_t) parser;
   GHashTable *module_index = NULL;
-  g_autoptr (GError) nested_error = NULL;
 
-  g_debug ("TRACE: entering parse_module_index_from_string");
+  MMD_TRACE ("TRACE: entering parse_module_index_from_string");
   yaml_parser_initialize (&parser);
 
   if (error != NULL && *error != NULL)
@@ -287,37 +989,95 @@ parse_module_index_from_string (const gchar *yaml,
   yaml_parser_set_input_string (
     &parser, (const unsigned char *)yaml, strlen (yaml));
 
-  if (!_parse_yaml (&parser, &data, failures, &nested_error))
+  module_index =
+    _module_index_from_parser (&parser, 1, NULL, failures, error);
+
+  MMD_TRACE ("TRACE: exiting parse_module_index_from_string");
+  return module_index;
+}
+
+
+GHashTable *
+parse_module_index_from_stream (FILE *iostream,
+                                GPtrArray **failures,
+                                GError **error)
+{
+  g_auto (yaml_parser_t) parser;
+  GHashTable *module_index = NULL;
+
+  MMD_TRACE ("TRACE: entering parse_module_index_from_stream");
+  yaml_parser_initialize (&parser);
+
+  if (error != NULL && *error != NULL)
     {
-      g_debug ("Could not parse YAML: %s", nested_error->message);
-      g_propagate_error (error, nested_error);
+      g_set_error_literal (error,
+                           MODULEMD_YAML_ERROR,
+                           MODULEMD_YAML_ERROR_PROGRAMMING,
+                           "GError is initialized.");
       return NULL;
     }
 
-  module_index = module_index_from_data (data, &nested_error);
-  if (!module_index)
+  if (!iostream)
     {
-      g_debug ("Could not get module_index: %s", nested_error->message);
-      g_propagate_error (error, nested_error);
+      g_set_error_literal (error,
+                           MODULEMD_YAML_ERROR,
+                           MODULEMD_YAML_ERROR_PROGRAMMING,
+                           "Stream not supplied.");
       return NULL;
     }
 
-  g_debug ("TRACE: exiting parse_module_index_from_string");
+  yaml_parser_set_input_file (&parser, iostream);
+
+  module_index =
+    _module_index_from_parser (&parser, 1, NULL, failures, error);
+
+  MMD_TRACE ("TRACE: exiting parse_module_index_from_stream");
+
   return module_index;
 }
 
 
+typedef struct _modulemd_input_stream_reader
+{
+  GInputStream *stream;
+  GCancellable *cancellable;
+  GError *error;
+} modulemd_input_stream_reader;
+
+
+static int
+_read_input_stream (void *data,
+                    unsigned char *buffer,
+                    size_t size,
+                    size_t *size_read)
+{
+  modulemd_input_stream_reader *reader =
+    (modulemd_input_stream_reader *)data;
+  gssize n_read = 0;
+
+  /* libyaml only reports a generic input error, so keep the real one */
+  n_read = g_input_stream_read (
+    reader->stream, buffer, size, reader->cancellable, &reader->error);
+  if (n_read < 0)
+    return 0;
+
+  *size_read = n_read;
+  return 1;
+}
+
+
 GHashTable *
-parse_module_index_from_stream (FILE *iostream,
-                                GPtrArray **failures,
-                                GError **error)
+parse_module_index_from_input_stream (GInputStream *stream,
+                                      GCancellable *cancellable,
+                                      GPtrArray **failures,
+                                      GError **error)
 {
-  g_autoptr (GPtrArray) data = NULL;
   g_auto (yaml_parser_t) parser;
-  GHashTable *module_index = NULL;
   g_autoptr (GError) nested_error = NULL;
+  modulemd_input_stream_reader reader = { stream, cancellable, NULL };
+  GHashTable *module_index = NULL;
 
-  g_debug ("TRACE: entering parse_module_index_from_stream");
+  MMD_TRACE ("TRACE: entering parse_module_index_from_input_stream");
   yaml_parser_initialize (&parser);
 
   if (error != NULL && *error != NULL)
@@ -329,7 +1089,7 @@ parse_module_index_from_stream (FILE *iostream,
       return NULL;
     }
 
-  if (!iostream)
+  if (!stream)
     {
       g_set_error_literal (error,
                            MODULEMD_YAML_ERROR,
@@ -338,31 +1098,237 @@ parse_module_index_from_stream (FILE *iostream,
       return NULL;
     }
 
-  yaml_parser_set_input_file (&parser, iostream);
+  yaml_parser_set_input (&parser, _read_input_stream, &reader);
+
+  module_index =
+    _module_index_from_parser (&parser, 1, NULL, failures, &nested_error);
 
-  if (!_parse_yaml (&parser, &data, failures, &nested_error))
+  if (reader.error)
+    {
+      /* A failed read is more useful than the resulting parser error */
+      g_propagate_error (error, reader.error);
+      g_clear_pointer (&module_index, g_hash_table_unref);
+    }
+  else if (!module_index)
+    {
+      g_propagate_error (error, g_steal_pointer (&nested_error));
+    }
+
+  MMD_TRACE ("TRACE: exiting parse_module_index_from_input_stream");
+  return module_index;
+}
+
+
+static GHashTable *
+_module_index_from_parser (yaml_parser_t *parser,
+                           guint n_threads,
+                           ModulemdFilter *filter,
+                           GPtrArray **failures,
+                           GError **error)
+{
+  g_autoptr (GPtrArray) data = NULL;
+  g_autoptr (modulemd_string_pool) strings = NULL;
+  g_autoptr (GError) nested_error = NULL;
+  modulemd_string_pool *previous_strings = NULL;
+  GHashTable *module_index = NULL;
+
+  /* Everything that goes into the index shares one string pool, so that
+   * repeated values are only allocated once
+   */
+  strings = modulemd_string_pool_new ();
+  previous_strings = modulemd_string_pool_set_thread_default (strings);
+
+  if (!_parse_yaml (parser,
+                    n_threads,
+                    filter,
+                    NULL,
+                    NULL,
+                    NULL,
+                    &data,
+                    failures,
+                    &nested_error))
     {
       g_debug ("Could not parse YAML: %s", nested_error->message);
-      g_propagate_error (error, nested_error);
-      return NULL;
+      g_propagate_error (error, g_steal_pointer (&nested_error));
+      goto error;
     }
 
   module_index = module_index_from_data (data, &nested_error);
   if (!module_index)
     {
       g_debug ("Could not get module_index: %s", nested_error->message);
-      g_propagate_error (error, nested_error);
-      return NULL;
+      g_propagate_error (error, g_steal_pointer (&nested_error));
+      goto error;
     }
 
-  g_debug ("TRACE: exiting parse_module_index_from_stream");
-
+error:
+  modulemd_string_pool_set_thread_default (previous_strings);
   return module_index;
 }
 
 
+static gboolean
+_parser_set_input_path (yaml_parser_t *parser,
+                        const gchar *path,
+                        GMappedFile **mapped_file,
+                        FILE **yaml_file,
+                        GError **error)
+{
+  const gchar *contents = NULL;
+  gsize length = 0;
+
+  /* Prefer handing libyaml the whole file as a single read-only mapping.
+   * This avoids copying it through stdio in small chunks. Anything that
+   * can't be mapped, such as a pipe, is read through stdio as before.
+   */
+  *mapped_file = g_mapped_file_new (path, FALSE, NULL);
+  if (*mapped_file)
+    {
+      contents = g_mapped_file_get_contents (*mapped_file);
+      length = g_mapped_file_get_length (*mapped_file);
+
+#ifdef HAVE_POSIX_MADVISE
+      /* The document is read once from start to end */
+      if (length > 0)
+        posix_madvise ((void *)contents, length, POSIX_MADV_SEQUENTIAL);
+#endif
+
+      /* Empty files are mapped with NULL contents */
+      yaml_parser_set_input_string (
+        parser, (const unsigned char *)(contents ? contents : ""), length);
+      return TRUE;
+    }
+
+  errno = 0;
+  *yaml_file = g_fopen (path, "rb");
+  if (!*yaml_file)
+    {
+      g_set_error (error,
+                   MODULEMD_YAML_ERROR,
+                   MODULEMD_YAML_ERROR_OPEN,
+                   "Failed to open file: %s",
+                   g_strerror (errno));
+      return FALSE;
+    }
+
+  yaml_parser_set_input_file (parser, *yaml_file);
+  return TRUE;
+}
+
+
+static void
+_parse_job_free (modulemd_parse_job *job)
+{
+  g_clear_pointer (&job->document, g_object_unref);
+  g_clear_pointer (&job->events, g_array_unref);
+  g_clear_pointer (&job->object, g_object_unref);
+  g_clear_error (&job->error);
+  g_free (job);
+}
+
+
+static void
+_parse_job_run (gpointer data, gpointer user_data)
+{
+  modulemd_parse_job *job = (modulemd_parse_job *)data;
+  modulemd_string_pool *strings = (modulemd_string_pool *)user_data;
+  modulemd_string_pool *previous_strings = NULL;
+
+  /* Worker threads share the string pool of the thread that queued the job */
+  if (strings)
+    previous_strings = modulemd_string_pool_set_thread_default (strings);
+
+  job->result = _parse_subdocument (job->document,
+                                    job->events,
+                                    job->preserve,
+                                    job->sections,
+                                    &job->object,
+                                    &job->error);
+
+  if (strings)
+    modulemd_string_pool_set_thread_default (previous_strings);
+
+  /* The events are no longer needed unless they have to be turned back into
+   * YAML for the failures list
+   */
+  if (job->result || !job->preserve)
+    g_clear_pointer (&job->events, g_array_unref);
+}
+
+
+static gboolean
+_deliver_to_callback (ModulemdForeachFunc callback,
+                      GObject *object,
+                      gpointer user_data,
+                      GError **error)
+{
+  g_autoptr (GError) callback_error = NULL;
+
+  if (callback (object, user_data, &callback_error))
+    return TRUE;
+
+  if (callback_error)
+    {
+      g_propagate_error (error, g_steal_pointer (&callback_error));
+    }
+  else
+    {
+      g_set_error_literal (error,
+                           MODULEMD_YAML_ERROR,
+                           MODULEMD_YAML_ERROR_PARSE,
+                           "Parsing was stopped by the callback");
+    }
+
+  return FALSE;
+}
+
+
+static gboolean
+_parse_job_finish (modulemd_parse_job *job,
+                   ModulemdForeachFunc callback,
+                   gpointer user_data,
+                   GPtrArray *objects,
+                   GPtrArray *invalid_subdocuments,
+                   GError **error)
+{
+  if (job->result)
+    {
+      /* The object is released along with the job unless the callback
+       * takes its own reference
+       */
+      if (callback)
+        return _deliver_to_callback (callback, job->object, user_data, error);
+
+      g_ptr_array_add (objects, job->object);
+      job->object = NULL;
+      return TRUE;
+    }
+
+  modulemd_subdocument_set_gerror (job->document, job->error);
+
+  if (job->preserve)
+    _set_subdocument_yaml (job->document, job->events);
+
+  g_debug ("Skipping invalid document");
+
+  if (callback)
+    {
+      return _deliver_to_callback (
+        callback, G_OBJECT (job->document), user_data, error);
+    }
+
+  g_ptr_array_add (invalid_subdocuments, g_object_ref (job->document));
+  return TRUE;
+}
+
+
 static gboolean
 _parse_yaml (yaml_parser_t *parser,
+             guint n_threads,
+             ModulemdFilter *filter,
+             GByteArray *cache_records,
+             ModulemdForeachFunc callback,
+             gpointer user_data,
              GPtrArray **data,
              GPtrArray **failures,
              GError **error)
@@ -370,24 +1336,57 @@ _parse_yaml (yaml_parser_t *parser,
   gboolean result = FALSE;
   gboolean done = FALSE;
   MMD_INIT_YAML_EVENT (event);
-  g_autoptr (GPtrArray) subdocuments = NULL;
   g_autoptr (GPtrArray) failed_subdocuments = NULL;
+  g_autoptr (GPtrArray) invalid_subdocuments = NULL;
   g_autoptr (GPtrArray) objects = NULL;
+  g_autoptr (GPtrArray) jobs = NULL;
+  g_autoptr (GError) push_error = NULL;
+  GThreadPool *pool = NULL;
+  GArray *events = NULL;
   ModulemdSubdocument *document = NULL;
-  ModulemdSubdocument *subdocument = NULL;
-  g_autoptr (GError) subdocument_error = NULL;
-
-  GObject *object = NULL;
+  modulemd_parse_job *job = NULL;
+  guint sections = MODULEMD_SECTION_ALL;
 
-  g_debug ("TRACE: entering _parse_yaml");
+  MMD_TRACE ("TRACE: entering _parse_yaml");
 
-  /* Read through the complete stream once, separating subdocuments and
-   * identifying their types
+  /* Read through the stream once, separating subdocuments, identifying their
+   * types and handing the buffered events of each one directly to the parser
+   * for that type. When parsing serially, only the subdocument currently
+   * being processed is held in memory.
    */
-  subdocuments = g_ptr_array_new_full (1, g_object_unref);
   failed_subdocuments = g_ptr_array_new_with_free_func (g_object_unref);
+  invalid_subdocuments = g_ptr_array_new_with_free_func (g_object_unref);
   objects = g_ptr_array_new_full (1, g_object_unref);
 
+  if (filter)
+    sections = modulemd_filter_get_sections (filter);
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  /* The callback must see the subdocuments in order as they complete */
+  if (callback)
+    n_threads = 1;
+
+  if (n_threads > 1)
+    {
+      /* Subdocuments are parsed on the pool as soon as they have been read.
+       * The jobs are kept in input order so the results can be collected
+       * deterministically once the pool has drained.
+       */
+      jobs = g_ptr_array_new_with_free_func ((GDestroyNotify)_parse_job_free);
+      pool = g_thread_pool_new (_parse_job_run,
+                                modulemd_string_pool_get_thread_default (),
+                                n_threads,
+                                FALSE,
+                                error);
+      if (!pool)
+        {
+          MMD_YAML_ERROR_RETURN_RETHROW (error,
+                                         "Could not create thread pool");
+        }
+    }
+
   while (!done)
     {
       YAML_PARSER_PARSE_WITH_ERROR_RETURN (
@@ -405,7 +1404,15 @@ _parse_yaml (yaml_parser_t *parser,
           break;
 
         case YAML_DOCUMENT_START_EVENT:
-          if (!_read_yaml_and_type (parser, &document))
+          /* Asynchronous loads push their GCancellable while they run */
+          if (g_cancellable_set_error_if_cancelled (
+                g_cancellable_get_current (), error))
+            {
+              result = FALSE;
+              goto error;
+            }
+
+          if (!_read_yaml_and_type (parser, filter, &document, &events))
             {
               g_ptr_array_add (failed_subdocuments, document);
 
@@ -418,18 +1425,75 @@ _parse_yaml (yaml_parser_t *parser,
                 error, "Parse error during preprocessing");
             }
 
-          /* Add all valid documents to the list */
-          if (modulemd_subdocument_get_doctype (document) != G_TYPE_INVALID)
+          /* The subdocument was excluded by the filter */
+          if (!document)
+            break;
+
+          if (modulemd_subdocument_get_doctype (document) == G_TYPE_INVALID)
+            {
+              if (callback)
+                {
+                  result = _deliver_to_callback (
+                    callback, G_OBJECT (document), user_data, error);
+                  g_clear_pointer (&document, g_object_unref);
+                  if (!result)
+                    goto error;
+                  break;
+                }
+
+              /* Any documents we're skipping should also go into this list */
+              g_ptr_array_add (failed_subdocuments, document);
+              document = NULL;
+              break;
+            }
+
+          job = g_new0 (modulemd_parse_job, 1);
+          job->document = document;
+          job->events = events;
+          document = NULL;
+          events = NULL;
+
+          /* The events only need to survive parsing if the caller may want
+           * to see the YAML of a document that fails
+           */
+          job->preserve = (failures != NULL || callback != NULL);
+          job->sections = sections;
+
+          /* The events have to be recorded before they are handed to the
+           * parser, which may consume them
+           */
+          if (cache_records)
+            _cache_record_append (cache_records, job->document, job->events);
+
+          if (pool)
             {
-              g_ptr_array_add (subdocuments, g_object_ref (document));
+              g_ptr_array_add (jobs, job);
+              if (!g_thread_pool_push (pool, job, &push_error))
+                {
+                  /* The job is still queued even if no new thread could be
+                   * started for it, so the running ones will parse it
+                   */
+                  g_debug ("Could not start a parser thread: %s",
+                           push_error->message);
+                  g_clear_error (&push_error);
+                }
             }
           else
             {
-              /* Any documents we're skipping should also go into this list */
-              g_ptr_array_add (failed_subdocuments, g_object_ref (document));
+              _parse_job_run (job, NULL);
+              result = _parse_job_finish (job,
+                                          callback,
+                                          user_data,
+                                          objects,
+                                          invalid_subdocuments,
+                                          error);
+              _parse_job_free (job);
+              job = NULL;
+
+              if (!result)
+                goto error;
             }
-
-          g_clear_pointer (&document, g_object_unref);
+          job = NULL;
           break;
 
         default:
@@ -442,78 +1506,45 @@ _parse_yaml (yaml_parser_t *parser,
       yaml_event_delete (&event);
     }
 
-  /* Iterate through the subdocuments and process them by type */
-  for (gsize i = 0; i < subdocuments->len; i++)
+  result = TRUE;
+
+error:
+  if (pool)
     {
-      subdocument = g_ptr_array_index (subdocuments, i);
-      if (modulemd_subdocument_get_doctype (subdocument) ==
-          MODULEMD_TYPE_MODULESTREAM)
-        {
-          result =
-            _parse_subdocument (subdocument,
-                                _parse_module_stream,
-                                &object,
-                                modulemd_subdocument_get_version (subdocument),
-                                &subdocument_error);
-        }
-      /* Parsers for other types go here */
-      else if (modulemd_subdocument_get_doctype (subdocument) ==
-               MODULEMD_TYPE_DEFAULTS)
-        {
-          result =
-            _parse_subdocument (subdocument,
-                                _parse_defaults,
-                                &object,
-                                modulemd_subdocument_get_version (subdocument),
-                                &subdocument_error);
-        }
-      else if (modulemd_subdocument_get_doctype (subdocument) ==
-               MODULEMD_TYPE_TRANSLATION)
-        {
-          result =
-            _parse_subdocument (subdocument,
-                                _parse_translation,
-                                &object,
-                                modulemd_subdocument_get_version (subdocument),
-                                &subdocument_error);
-        }
-      /* else if (document->type == <...>) */
-      else
-        {
-          /* Unknown document type */
-          g_set_error_literal (error,
-                               MODULEMD_YAML_ERROR,
-                               MODULEMD_YAML_ERROR_PARSE,
-                               "Unknown document type");
-          result = FALSE;
-        }
+      /* Wait for every queued subdocument to be parsed. This is also needed
+       * if reading the stream failed, since the jobs must not be freed while
+       * they are still running.
+       */
+      g_thread_pool_free (pool, FALSE, TRUE);
 
-      if (result)
+      for (gsize i = 0; i < jobs->len; i++)
         {
-          g_ptr_array_add (objects, object);
-        }
-      else
-        {
-          modulemd_subdocument_set_gerror (subdocument, subdocument_error);
-          g_clear_error (&subdocument_error);
-
-          g_ptr_array_add (failed_subdocuments, g_object_ref (subdocument));
-
-          g_debug ("Skipping invalid document");
-          g_clear_error (error);
+          _parse_job_finish (g_ptr_array_index (jobs, i),
+                             NULL,
+                             NULL,
+                             objects,
+                             invalid_subdocuments,
+                             NULL);
         }
     }
 
-  if (data)
+  if (result && data)
     {
       *data = g_ptr_array_ref (objects);
     }
 
-  result = TRUE;
-
-error:
   if (failures)
     {
+      /* Documents whose type could not be determined are reported first,
+       * followed by those that failed to parse
+       */
+      for (gsize i = 0; i < invalid_subdocuments->len; i++)
+        {
+          g_ptr_array_add (
+            failed_subdocuments,
+            g_object_ref (g_ptr_array_index (invalid_subdocuments, i)));
+        }
+
       *failures = g_ptr_array_ref (failed_subdocuments);
     }
 
@@ -522,36 +1553,33 @@ error:
 
 
 static gboolean
-_read_yaml_and_type (yaml_parser_t *parser, ModulemdSubdocument **subdocument)
+_read_yaml_and_type (yaml_parser_t *parser,
+                     ModulemdFilter *filter,
+                     ModulemdSubdocument **subdocument,
+                     GArray **events)
 {
   g_autoptr (ModulemdSubdocument) document = NULL;
   g_autoptr (GError) error = NULL;
   gboolean result = FALSE;
   gboolean done = FALSE;
   gboolean finish_invalid_document = FALSE;
+  gboolean skip = FALSE;
+  gboolean data_next = FALSE;
+  gboolean data_value = FALSE;
+  gboolean in_data = FALSE;
+  gboolean data_key = FALSE;
+  gboolean have_module_name = FALSE;
+  ModulemdYamlKey key = MMD_YAML_KEY_UNKNOWN;
+  const gchar *value = NULL;
   gsize depth = 0;
-  g_autoptr (modulemd_yaml_string) yaml_string = NULL;
+  g_autoptr (GArray) document_events = NULL;
   MMD_INIT_YAML_EVENT (event);
   MMD_INIT_YAML_EVENT (value_event);
-  yaml_emitter_t emitter;
 
-  g_debug ("TRACE: entering _read_yaml_and_type");
+  MMD_TRACE ("TRACE: entering _read_yaml_and_type");
 
   document = modulemd_subdocument_new ();
-
-  yaml_string = g_malloc0_n (1, sizeof (modulemd_yaml_string));
-  yaml_emitter_initialize (&emitter);
-
-  yaml_emitter_set_output (&emitter, _write_yaml_string, (void *)yaml_string);
-
-  yaml_stream_start_event_initialize (&event, YAML_UTF8_ENCODING);
-  YAML_EMITTER_EMIT_WITH_ERROR_RETURN (
-    &emitter, &event, &error, "Error starting stream");
-
-  yaml_document_start_event_initialize (&event, NULL, NULL, NULL, 0);
-  YAML_EMITTER_EMIT_WITH_ERROR_RETURN (
-    &emitter, &event, &error, "Error starting document");
-
+  document_events = mmd_yaml_event_array_new ();
 
   while (!done)
     {
@@ -559,26 +1587,119 @@ _read_yaml_and_type (yaml_parser_t *parser, ModulemdSubdocument **subdocument)
       YAML_PARSER_PARSE_WITH_ERROR_RETURN (
         parser, &event, &error, "Parser error");
 
+      if (skip)
+        {
+          /* The rest of a subdocument excluded by the filter is discarded
+           * without being examined
+           */
+          if (event.type == YAML_DOCUMENT_END_EVENT)
+            done = TRUE;
+
+          yaml_event_delete (&event);
+          continue;
+        }
+
+      /* Whether this event starts the value of the root "data" key */
+      data_value = data_next;
+      data_next = FALSE;
+
       switch (event.type)
         {
         case YAML_DOCUMENT_END_EVENT: done = TRUE; break;
 
         case YAML_SEQUENCE_START_EVENT:
-        case YAML_MAPPING_START_EVENT: depth++; break;
+        case YAML_MAPPING_START_EVENT:
+          /* A complex value in the data mapping is followed by a key */
+          if (in_data && depth == 2)
+            data_key = TRUE;
+
+          depth++;
+
+          if (data_value && depth == 2)
+            {
+              in_data = TRUE;
+              data_key = TRUE;
+            }
+          break;
 
         case YAML_SEQUENCE_END_EVENT:
-        case YAML_MAPPING_END_EVENT: depth--; break;
+        case YAML_MAPPING_END_EVENT:
+          depth--;
+
+          if (in_data && depth == 1)
+            {
+              /* The data mapping has ended without naming a module */
+              in_data = FALSE;
+              if (!have_module_name && !finish_invalid_document &&
+                  modulemd_filter_requires_module_name (filter))
+                {
+                  skip = TRUE;
+                }
+            }
+          break;
 
         case YAML_SCALAR_EVENT:
+          if (in_data && depth == 2 && !finish_invalid_document)
+            {
+              /* Scalars in the data mapping alternate between keys and
+               * values. Only the module name and architecture are checked
+               * against the filter.
+               */
+              if (!data_key)
+                {
+                  data_key = TRUE;
+                  break;
+                }
+
+              key = MMD_YAML_EVENT_KEY (event);
+              if (key != MMD_YAML_KEY_NAME && key != MMD_YAML_KEY_MODULE &&
+                  key != MMD_YAML_KEY_ARCH)
+                {
+                  data_key = FALSE;
+                  break;
+                }
+
+              YAML_PARSER_PARSE_WITH_ERROR_RETURN (
+                parser, &value_event, &error, "Parser error");
+
+              if (value_event.type == YAML_SEQUENCE_START_EVENT ||
+                  value_event.type == YAML_MAPPING_START_EVENT)
+                {
+                  /* Invalid, but left for the type-specific parser to
+                   * report
+                   */
+                  depth++;
+                  break;
+                }
+
+              if (value_event.type != YAML_SCALAR_EVENT)
+                break;
+
+              /* Module streams use "name", while defaults and translations
+               * use "module"
+               */
+              value = (const gchar *)value_event.data.scalar.value;
+              if (key == MMD_YAML_KEY_ARCH)
+                {
+                  skip = !modulemd_filter_match_arch (filter, value);
+                }
+              else
+                {
+                  have_module_name = TRUE;
+                  skip = !modulemd_filter_match_module_name (filter, value);
+                }
+              break;
+            }
+
           if (depth == 1 && !finish_invalid_document)
             {
               /* If we're in the root of the document, check for the
                * document type and version
                */
 
-              if (!g_strcmp0 ((const gchar *)event.data.scalar.value,
-                              "document"))
+              switch (MMD_YAML_EVENT_KEY (event))
                 {
+                case MMD_YAML_KEY_DOCUMENT:
                   if (modulemd_subdocument_get_doctype (document) !=
                       G_TYPE_INVALID)
                     {
@@ -638,32 +1759,26 @@ _read_yaml_and_type (yaml_parser_t *parser, ModulemdSubdocument **subdocument)
                       break;
                     }
 
-                  if (g_strcmp0 ((const gchar *)value_event.data.scalar.value,
-                                 "modulemd") == 0)
+                  switch (MMD_YAML_EVENT_KEY (value_event))
                     {
+                    case MMD_YAML_KEY_MODULEMD:
                       modulemd_subdocument_set_doctype (
                         document, MODULEMD_TYPE_MODULESTREAM);
-                    }
+                      break;
 
-                  else if (g_strcmp0 (
-                             (const gchar *)value_event.data.scalar.value,
-                             "modulemd-defaults") == 0)
-                    {
+                    case MMD_YAML_KEY_MODULEMD_DEFAULTS:
                       modulemd_subdocument_set_doctype (
                         document, MODULEMD_TYPE_DEFAULTS);
-                    }
+                      break;
 
-                  else if (g_strcmp0 (
-                             (const gchar *)value_event.data.scalar.value,
-                             "modulemd-translations") == 0)
-                    {
+                    case MMD_YAML_KEY_MODULEMD_TRANSLATIONS:
                       modulemd_subdocument_set_doctype (
                         document, MODULEMD_TYPE_TRANSLATION);
-                    }
-                  /* Handle additional types here */
+                      break;
 
-                  else
-                    {
+                    /* Handle additional types here */
+
+                    default:
                       /* Unknown document type */
                       modulemd_subdocument_set_doctype (document,
                                                         G_TYPE_INVALID);
@@ -674,16 +1789,22 @@ _read_yaml_and_type (yaml_parser_t *parser, ModulemdSubdocument **subdocument)
                                    MODULEMD_YAML_ERROR,
                                    MODULEMD_YAML_ERROR_PARSE,
                                    "Document type is not recognized");
+                      break;
                     }
 
                   g_debug (
                     "Document type: %s",
                     g_type_name (modulemd_subdocument_get_doctype (document)));
-                }
 
-              else if (g_strcmp0 ((const gchar *)event.data.scalar.value,
-                                  "version") == 0)
-                {
+                  if (filter && !finish_invalid_document &&
+                      !modulemd_filter_match_doctype (
+                        filter, modulemd_subdocument_get_doctype (document)))
+                    {
+                      skip = TRUE;
+                    }
+                  break;
+
+                case MMD_YAML_KEY_VERSION:
                   if (modulemd_subdocument_get_version (document) != 0)
                     {
                       g_debug ("Document version specified more than once");
@@ -745,6 +1866,18 @@ _read_yaml_and_type (yaml_parser_t *parser, ModulemdSubdocument **subdocument)
 
                   g_debug ("Document version: %" PRIx64,
                            modulemd_subdocument_get_version (document));
+                  break;
+
+                case MMD_YAML_KEY_DATA:
+                  /* The contents of the data mapping only need to be
+                   * examined when filtering
+                   */
+                  data_next = (filter != NULL);
+                  break;
+
+                default:
+                  /* Nothing to do */
+                  break;
                 }
             }
           break;
@@ -754,21 +1887,33 @@ _read_yaml_and_type (yaml_parser_t *parser, ModulemdSubdocument **subdocument)
           break;
         }
 
-      /* Copy this event to the string */
-      YAML_EMITTER_EMIT_WITH_ERROR_RETURN (
-        &emitter, &event, &error, "Error storing YAML event");
+      if (skip)
+        {
+          /* Nothing that was buffered for this subdocument is needed */
+          g_debug ("Skipping subdocument excluded by the filter");
+          g_array_set_size (document_events, 0);
+          yaml_event_delete (&event);
+          yaml_event_delete (&value_event);
+          continue;
+        }
+
+      /* Keep this event for the type-specific parser */
+      mmd_yaml_event_array_take (document_events, &event);
 
       if (value_event.type != YAML_NO_EVENT)
         {
-          /* Copy this event to the string */
-          YAML_EMITTER_EMIT_WITH_ERROR_RETURN (
-            &emitter, &value_event, &error, "Error storing YAML event");
+          mmd_yaml_event_array_take (document_events, &value_event);
         }
     }
 
-  yaml_stream_end_event_initialize (&event);
-  YAML_EMITTER_EMIT_WITH_ERROR_RETURN (
-    &emitter, &event, &error, "Error ending stream");
+  if (skip)
+    {
+      if (subdocument)
+        *subdocument = NULL;
+
+      MMD_TRACE ("TRACE: exiting _read_yaml_and_type");
+      return TRUE;
+    }
 
   /* If we get here with an invalid document type and no error */
   if (modulemd_subdocument_get_doctype (document) == G_TYPE_INVALID &&
@@ -782,80 +1927,283 @@ _read_yaml_and_type (yaml_parser_t *parser, ModulemdSubdocument **subdocument)
 
   result = TRUE;
 error:
-  yaml_emitter_delete (&emitter);
-
   modulemd_subdocument_set_gerror (document, error);
 
-  /* Copy the string, even if it was only partial because it's still useful
-   * to know where parsing broke
-   */
-  modulemd_subdocument_set_yaml (document, yaml_string->str);
+  if (!result ||
+      modulemd_subdocument_get_doctype (document) == G_TYPE_INVALID)
+    {
+      /* This document will be reported as a failure, so it needs its YAML.
+       * Valid documents are handed on as events and never re-emitted.
+       */
+      _set_subdocument_yaml (document, document_events);
+    }
+  else if (events)
+    {
+      *events = g_array_ref (document_events);
+    }
+
   if (subdocument)
     *subdocument = g_object_ref (document);
 
-  g_debug ("TRACE: exiting _read_yaml_and_type");
+  MMD_TRACE ("TRACE: exiting _read_yaml_and_type");
   return result;
 }
 
+static void
+_set_subdocument_yaml (ModulemdSubdocument *subdocument, GArray *events)
+{
+  gboolean result = FALSE;
+  g_autoptr (GError) error = NULL;
+  g_autoptr (modulemd_yaml_string) yaml_string = NULL;
+  g_auto (yaml_emitter_t) emitter;
+  yaml_event_t event;
+
+  MMD_TRACE ("TRACE: entering _set_subdocument_yaml");
+
+  yaml_string = g_malloc0_n (1, sizeof (modulemd_yaml_string));
+  yaml_emitter_initialize (&emitter);
+
+  yaml_emitter_set_output (&emitter, _write_yaml_string, (void *)yaml_string);
+
+  yaml_stream_start_event_initialize (&event, YAML_UTF8_ENCODING);
+  YAML_EMITTER_EMIT_WITH_ERROR_RETURN (
+    &emitter, &event, &error, "Error starting stream");
+
+  yaml_document_start_event_initialize (&event, NULL, NULL, NULL, 0);
+  YAML_EMITTER_EMIT_WITH_ERROR_RETURN (
+    &emitter, &event, &error, "Error starting document");
+
+  for (gsize i = 0; i < events->len; i++)
+    {
+      /* The emitter takes ownership of the event */
+      event = g_array_index (events, yaml_event_t, i);
+      memset (&g_array_index (events, yaml_event_t, i),
+              0,
+              sizeof (yaml_event_t));
+
+      YAML_EMITTER_EMIT_WITH_ERROR_RETURN (
+        &emitter, &event, &error, "Error storing YAML event");
+    }
+
+  yaml_stream_end_event_initialize (&event);
+  YAML_EMITTER_EMIT_WITH_ERROR_RETURN (
+    &emitter, &event, &error, "Error ending stream");
+
+  result = TRUE;
+
+error:
+  if (!result)
+    {
+      /* Flush whatever was emitted so far */
+      yaml_emitter_flush (&emitter);
+      g_debug ("Incomplete subdocument YAML: %s", error->message);
+    }
+
+  /* Copy the string, even if it was only partial because it's still useful
+   * to know where parsing broke
+   */
+  modulemd_subdocument_set_yaml (subdocument, yaml_string->str);
+
+  MMD_TRACE ("TRACE: exiting _set_subdocument_yaml");
+}
+
+
 static gboolean
 _parse_subdocument (ModulemdSubdocument *subdocument,
-                    ModulemdParsingFunc parse_func,
+                    GArray *events,
+                    gboolean preserve,
+                    guint sections,
                     GObject **data,
-                    guint64 version,
                     GError **error)
 {
   gboolean result = FALSE;
-  MMD_INIT_YAML_EVENT (event);
-  gboolean done = FALSE;
-  GObject *object = NULL;
-  yaml_parser_t parser;
+  ModulemdParsingFunc parse_func = NULL;
+  GType doctype = modulemd_subdocument_get_doctype (subdocument);
+  modulemd_yaml_replay replay = { events, 0, preserve };
+  g_auto (yaml_parser_t) parser;
+
+  MMD_TRACE ("TRACE: entering _parse_subdocument");
+
+  if (doctype == MODULEMD_TYPE_MODULESTREAM)
+    {
+      parse_func = _parse_module_stream;
+    }
+  /* Parsers for other types go here */
+  else if (doctype == MODULEMD_TYPE_DEFAULTS)
+    {
+      parse_func = _parse_defaults;
+    }
+  else if (doctype == MODULEMD_TYPE_TRANSLATION)
+    {
+      parse_func = _parse_translation;
+    }
+  /* else if (doctype == <...>) */
+  else
+    {
+      /* Unknown document type */
+      g_set_error_literal (error,
+                           MODULEMD_YAML_ERROR,
+                           MODULEMD_YAML_ERROR_PARSE,
+                           "Unknown document type");
+      return FALSE;
+    }
 
+  /* The buffered events begin just after the DOCUMENT_START event, which is
+   * where the type-specific parsers expect to pick up
+   */
   yaml_parser_initialize (&parser);
-  yaml_parser_set_input_string (
-    &parser,
-    (const unsigned char *)modulemd_subdocument_get_yaml (subdocument),
-    strlen (modulemd_subdocument_get_yaml (subdocument)));
+  mmd_yaml_parser_set_input_replay (&parser, &replay);
 
-  while (!done)
+  if (doctype == MODULEMD_TYPE_MODULESTREAM)
     {
-      YAML_PARSER_PARSE_WITH_ERROR_RETURN (
-        &parser, &event, error, "Parser error");
+      /* Module streams may leave out the sections that weren't requested */
+      result = _parse_module_stream_sections (
+        &parser,
+        data,
+        modulemd_subdocument_get_version (subdocument),
+        sections,
+        error);
+    }
+  else
+    {
+      result = parse_func (
+        &parser, data, modulemd_subdocument_get_version (subdocument), error);
+    }
 
-      switch (event.type)
+  MMD_TRACE ("TRACE: exiting _parse_subdocument");
+  return result;
+}
+
+
+/* Records hold the serialized events of one subdocument each, in input
+ * order. They are used by the parse cache and the binary index format. A
+ * record is the document type, the document version and the length of the
+ * serialized events that follow, all in host byte order.
+ */
+enum
+{
+  MMD_CACHE_DOCTYPE_MODULESTREAM = 1,
+  MMD_CACHE_DOCTYPE_DEFAULTS,
+  MMD_CACHE_DOCTYPE_TRANSLATION
+};
+
+
+static void
+_cache_record_append (GByteArray *records,
+                      ModulemdSubdocument *subdocument,
+                      GArray *events)
+{
+  GType doctype = modulemd_subdocument_get_doctype (subdocument);
+  guint64 version = modulemd_subdocument_get_version (subdocument);
+  guint8 code = 0;
+  guint64 length = 0;
+  gsize start = 0;
+
+  if (doctype == MODULEMD_TYPE_MODULESTREAM)
+    code = MMD_CACHE_DOCTYPE_MODULESTREAM;
+  else if (doctype == MODULEMD_TYPE_DEFAULTS)
+    code = MMD_CACHE_DOCTYPE_DEFAULTS;
+  else if (doctype == MODULEMD_TYPE_TRANSLATION)
+    code = MMD_CACHE_DOCTYPE_TRANSLATION;
+
+  g_byte_array_append (records, &code, 1);
+  g_byte_array_append (records, (const guint8 *)&version, sizeof (version));
+
+  /* The length is filled in once the events have been written */
+  start = records->len;
+  g_byte_array_append (records, (const guint8 *)&length, sizeof (length));
+  mmd_yaml_event_array_serialize (events, records);
+
+  length = records->len - start - sizeof (length);
+  memcpy (records->data + start, &length, sizeof (length));
+}
+
+
+gboolean
+parse_yaml_records (GBytes *records, GPtrArray **data, GError **error)
+{
+  g_autoptr (GPtrArray) objects = NULL;
+  g_autoptr (ModulemdSubdocument) document = NULL;
+  g_autoptr (GArray) events = NULL;
+  GObject *object = NULL;
+  const guint8 *contents = NULL;
+  gsize size = 0;
+  gsize position = 0;
+  guint64 version = 0;
+  guint64 length = 0;
+  GType doctype = G_TYPE_INVALID;
+
+  MMD_TRACE ("TRACE: entering parse_yaml_records");
+
+  contents = g_bytes_get_data (records, &size);
+  objects = g_ptr_array_new_full (1, g_object_unref);
+
+  while (position < size)
+    {
+      if (size - position < 1 + sizeof (version) + sizeof (length))
+        goto corrupt;
+
+      switch (contents[position])
         {
-        case YAML_STREAM_START_EVENT:
-          /* Starting the stream here */
+        case MMD_CACHE_DOCTYPE_MODULESTREAM:
+          doctype = MODULEMD_TYPE_MODULESTREAM;
           break;
 
-        case YAML_DOCUMENT_START_EVENT:
-          if (!parse_func (&parser, &object, version, error))
-            {
-              goto error;
-            }
+        case MMD_CACHE_DOCTYPE_DEFAULTS:
+          doctype = MODULEMD_TYPE_DEFAULTS;
           break;
 
-        case YAML_DOCUMENT_END_EVENT:
-          /* This document is complete. */
+        case MMD_CACHE_DOCTYPE_TRANSLATION:
+          doctype = MODULEMD_TYPE_TRANSLATION;
           break;
 
-        case YAML_STREAM_END_EVENT: done = TRUE; break;
+        default: goto corrupt;
+        }
+      position++;
 
-        default:
-          /* We received a YAML event we shouldn't expect at this level */
-          MMD_YAML_ERROR_RETURN (error, "Unexpected YAML event at toplevel");
-          break;
+      memcpy (&version, contents + position, sizeof (version));
+      position += sizeof (version);
+      memcpy (&length, contents + position, sizeof (length));
+      position += sizeof (length);
+
+      if (size - position < length)
+        goto corrupt;
+
+      events = mmd_yaml_event_array_deserialize (
+        contents + position, length, error);
+      if (!events)
+        return FALSE;
+      position += length;
+
+      document = modulemd_subdocument_new ();
+      modulemd_subdocument_set_doctype (document, doctype);
+      modulemd_subdocument_set_version (document, version);
+
+      /* The events are not needed afterwards, so they may be consumed */
+      if (!_parse_subdocument (
+            document, events, FALSE, MODULEMD_SECTION_ALL, &object, error))
+        {
+          return FALSE;
         }
 
-      yaml_event_delete (&event);
+      g_ptr_array_add (objects, object);
+      object = NULL;
+      g_clear_pointer (&events, g_array_unref);
+      g_clear_pointer (&document, g_object_unref);
     }
 
-  *data = object;
-  result = TRUE;
+  if (data)
+    *data = g_steal_pointer (&objects);
 
-error:
-  yaml_parser_delete (&parser);
-  g_debug ("TRACE: exiting _parse_yaml");
-  return result;
+  MMD_TRACE ("TRACE: exiting parse_yaml_records");
+  return TRUE;
+
+corrupt:
+  g_set_error_literal (error,
+                       MODULEMD_YAML_ERROR,
+                       MODULEMD_YAML_ERROR_PARSE,
+                       "Cached parse is corrupt");
+  return FALSE;
 }
 
 
@@ -902,7 +2250,7 @@ _simpleset_from_sequence (yaml_parser_t *parser,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering _simpleset_from_sequence");
+  MMD_TRACE ("TRACE: entering _simpleset_from_sequence");
 
   set = modulemd_simpleset_new ();
 
@@ -945,7 +2293,7 @@ _simpleset_from_sequence (yaml_parser_t *parser,
   result = TRUE;
 
 error:
-  g_debug ("TRACE: exiting _simpleset_from_sequence");
+  MMD_TRACE ("TRACE: exiting _simpleset_from_sequence");
   return result;
 }
 
@@ -964,7 +2312,7 @@ _hashtable_from_mapping (yaml_parser_t *parser,
   gchar *value = NULL;
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
-  g_debug ("TRACE: entering _hashtable_from_mapping");
+  MMD_TRACE ("TRACE: entering _hashtable_from_mapping");
 
   htable = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
 
@@ -1023,11 +2371,13 @@ _hashtable_from_mapping (yaml_parser_t *parser,
 
 error:
 
-  g_debug ("TRACE: exiting _hashtable_from_mapping");
+  MMD_TRACE ("TRACE: exiting _hashtable_from_mapping");
   return result;
 }
 
-/* Helper function to skip over sections that aren't yet implemented */
+/* Helper function to skip over a value that isn't needed, along with
+ * anything nested inside it
+ */
 gboolean
 _parse_skip (yaml_parser_t *parser, GError **error)
 {
@@ -1050,21 +2400,23 @@ _parse_skip (yaml_parser_t *parser, GError **error)
 
         case YAML_SEQUENCE_END_EVENT:
         case YAML_MAPPING_END_EVENT:
-          depth--;
-
-          if (depth <= 0)
-            {
-              /* We've come back up to the original level from which we
-               * started
-               */
-              done = TRUE;
-            }
+          if (depth > 0)
+            depth--;
           break;
 
         default:
           /* Just fall through here. */
           break;
         }
+
+      if (depth == 0)
+        {
+          /* We've come back up to the original level from which we
+           * started. A scalar value ends here immediately.
+           */
+          done = TRUE;
+        }
+
       yaml_event_delete (&event);
     }
 
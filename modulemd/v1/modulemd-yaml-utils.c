@@ -76,7 +76,7 @@ parse_raw_yaml_mapping (yaml_parser_t *parser,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering parse_raw_yaml_mapping");
+  MMD_TRACE ("TRACE: entering parse_raw_yaml_mapping");
 
   dict = g_variant_dict_new (NULL);
 
@@ -152,7 +152,7 @@ error:
   g_free (key);
   g_variant_dict_unref (dict);
 
-  g_debug ("TRACE: exiting parse_raw_yaml_mapping");
+  MMD_TRACE ("TRACE: exiting parse_raw_yaml_mapping");
   return result;
 }
 
@@ -171,7 +171,7 @@ parse_raw_yaml_sequence (yaml_parser_t *parser,
 
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-  g_debug ("TRACE: entering parse_raw_yaml_sequence");
+  MMD_TRACE ("TRACE: entering parse_raw_yaml_sequence");
 
   while (!done)
     {
@@ -231,7 +231,7 @@ error:
   g_free (array);
   g_free (key);
 
-  g_debug ("TRACE: exiting parse_raw_yaml_sequence");
+  MMD_TRACE ("TRACE: exiting parse_raw_yaml_sequence");
   return result;
 }
 
@@ -406,3 +406,738 @@ mmd_yaml_get_event_name (yaml_event_type_t type)
   /* Should be unreachable */
   return "Unknown YAML Event";
 }
+
+
+static void
+mmd_yaml_event_clear (gpointer data)
+{
+  yaml_event_delete ((yaml_event_t *)data);
+}
+
+
+GArray *
+mmd_yaml_event_array_new (void)
+{
+  GArray *events = g_array_new (FALSE, TRUE, sizeof (yaml_event_t));
+  g_array_set_clear_func (events, mmd_yaml_event_clear);
+  return events;
+}
+
+
+void
+mmd_yaml_event_array_take (GArray *events, yaml_event_t *event)
+{
+  /* The array assumes ownership of any memory held by the event */
+  g_array_append_vals (events, event, 1);
+  memset (event, 0, sizeof (yaml_event_t));
+}
+
+
+int
+mmd_yaml_event_copy (yaml_event_t *dest, const yaml_event_t *src)
+{
+  int ret = 0;
+
+  switch (src->type)
+    {
+    case YAML_STREAM_START_EVENT:
+      ret = yaml_stream_start_event_initialize (
+        dest, src->data.stream_start.encoding);
+      break;
+
+    case YAML_STREAM_END_EVENT:
+      ret = yaml_stream_end_event_initialize (dest);
+      break;
+
+    case YAML_DOCUMENT_START_EVENT:
+      /* Directives are never buffered, so only the flag needs preserving */
+      ret = yaml_document_start_event_initialize (
+        dest, NULL, NULL, NULL, src->data.document_start.implicit);
+      break;
+
+    case YAML_DOCUMENT_END_EVENT:
+      ret = yaml_document_end_event_initialize (
+        dest, src->data.document_end.implicit);
+      break;
+
+    case YAML_ALIAS_EVENT:
+      ret = yaml_alias_event_initialize (dest, src->data.alias.anchor);
+      break;
+
+    case YAML_SCALAR_EVENT:
+      ret = yaml_scalar_event_initialize (dest,
+                                          src->data.scalar.anchor,
+                                          src->data.scalar.tag,
+                                          src->data.scalar.value,
+                                          (int)src->data.scalar.length,
+                                          src->data.scalar.plain_implicit,
+                                          src->data.scalar.quoted_implicit,
+                                          src->data.scalar.style);
+      break;
+
+    case YAML_SEQUENCE_START_EVENT:
+      ret = yaml_sequence_start_event_initialize (
+        dest,
+        src->data.sequence_start.anchor,
+        src->data.sequence_start.tag,
+        src->data.sequence_start.implicit,
+        src->data.sequence_start.style);
+      break;
+
+    case YAML_SEQUENCE_END_EVENT:
+      ret = yaml_sequence_end_event_initialize (dest);
+      break;
+
+    case YAML_MAPPING_START_EVENT:
+      ret = yaml_mapping_start_event_initialize (
+        dest,
+        src->data.mapping_start.anchor,
+        src->data.mapping_start.tag,
+        src->data.mapping_start.implicit,
+        src->data.mapping_start.style);
+      break;
+
+    case YAML_MAPPING_END_EVENT:
+      ret = yaml_mapping_end_event_initialize (dest);
+      break;
+
+    case YAML_NO_EVENT:
+      memset (dest, 0, sizeof (yaml_event_t));
+      ret = 1;
+      break;
+    }
+
+  if (ret)
+    {
+      dest->start_mark = src->start_mark;
+      dest->end_mark = src->end_mark;
+    }
+
+  return ret;
+}
+
+
+static int
+_mmd_yaml_replay_read_handler (void *data,
+                               unsigned char *buffer,
+                               size_t size,
+                               size_t *size_read)
+{
+  /* Replayed events never go through the scanner, so reaching this is a
+   * programming error. Report it as a read failure.
+   */
+  *size_read = 0;
+  return 0;
+}
+
+
+void
+mmd_yaml_parser_set_input_replay (yaml_parser_t *parser,
+                                  modulemd_yaml_replay *replay)
+{
+  yaml_parser_set_input (parser, _mmd_yaml_replay_read_handler, replay);
+}
+
+
+int
+mmd_yaml_parser_parse (yaml_parser_t *parser, yaml_event_t *event)
+{
+  modulemd_yaml_replay *replay = NULL;
+  yaml_event_t *next = NULL;
+
+  if (parser->read_handler != _mmd_yaml_replay_read_handler)
+    return yaml_parser_parse (parser, event);
+
+  replay = (modulemd_yaml_replay *)parser->read_handler_data;
+
+  if (replay->position >= replay->events->len)
+    {
+      memset (event, 0, sizeof (yaml_event_t));
+      parser->error = YAML_PARSER_ERROR;
+      parser->problem = "Unexpected end of buffered events";
+      return 0;
+    }
+
+  next = &g_array_index (replay->events, yaml_event_t, replay->position);
+  replay->position++;
+
+  if (replay->preserve)
+    return mmd_yaml_event_copy (event, next);
+
+  /* Hand the event over directly; the caller now owns its memory */
+  *event = *next;
+  memset (next, 0, sizeof (yaml_event_t));
+  return 1;
+}
+
+
+/* Serialized events are a sequence of records, each starting with the event
+ * type as a single byte. Strings are stored as a 32-bit length in host byte
+ * order, or G_MAXUINT32 for NULL, followed by that many bytes. Marks are not
+ * kept.
+ */
+
+static void
+_mmd_yaml_put_byte (GByteArray *out, guint8 value)
+{
+  g_byte_array_append (out, &value, 1);
+}
+
+
+static void
+_mmd_yaml_put_string (GByteArray *out, const yaml_char_t *str, gsize length)
+{
+  guint32 size = str ? (guint32)length : G_MAXUINT32;
+
+  g_byte_array_append (out, (const guint8 *)&size, sizeof (size));
+  if (str)
+    g_byte_array_append (out, str, size);
+}
+
+
+void
+mmd_yaml_event_array_serialize (GArray *events, GByteArray *out)
+{
+  yaml_event_t *event = NULL;
+
+  for (gsize i = 0; i < events->len; i++)
+    {
+      event = &g_array_index (events, yaml_event_t, i);
+      _mmd_yaml_put_byte (out, (guint8)event->type);
+
+      switch (event->type)
+        {
+        case YAML_DOCUMENT_START_EVENT:
+          _mmd_yaml_put_byte (out, event->data.document_start.implicit);
+          break;
+
+        case YAML_DOCUMENT_END_EVENT:
+          _mmd_yaml_put_byte (out, event->data.document_end.implicit);
+          break;
+
+        case YAML_ALIAS_EVENT:
+          _mmd_yaml_put_string (
+            out,
+            event->data.alias.anchor,
+            strlen ((const gchar *)event->data.alias.anchor));
+          break;
+
+        case YAML_SCALAR_EVENT:
+          _mmd_yaml_put_string (
+            out,
+            event->data.scalar.anchor,
+            event->data.scalar.anchor ?
+              strlen ((const gchar *)event->data.scalar.anchor) :
+              0);
+          _mmd_yaml_put_string (
+            out,
+            event->data.scalar.tag,
+            event->data.scalar.tag ?
+              strlen ((const gchar *)event->data.scalar.tag) :
+              0);
+          _mmd_yaml_put_string (
+            out, event->data.scalar.value, event->data.scalar.length);
+          _mmd_yaml_put_byte (out, event->data.scalar.plain_implicit);
+          _mmd_yaml_put_byte (out, event->data.scalar.quoted_implicit);
+          _mmd_yaml_put_byte (out, event->data.scalar.style);
+          break;
+
+        case YAML_SEQUENCE_START_EVENT:
+        case YAML_MAPPING_START_EVENT:
+          /* Both start events share the same layout */
+          _mmd_yaml_put_string (
+            out,
+            event->data.mapping_start.anchor,
+            event->data.mapping_start.anchor ?
+              strlen ((const gchar *)event->data.mapping_start.anchor) :
+              0);
+          _mmd_yaml_put_string (
+            out,
+            event->data.mapping_start.tag,
+            event->data.mapping_start.tag ?
+              strlen ((const gchar *)event->data.mapping_start.tag) :
+              0);
+          _mmd_yaml_put_byte (out, event->data.mapping_start.implicit);
+          _mmd_yaml_put_byte (out, event->data.mapping_start.style);
+          break;
+
+        default:
+          /* Nothing else carries any data */
+          break;
+        }
+    }
+}
+
+
+typedef struct _mmd_yaml_reader
+{
+  const guint8 *data;
+  gsize length;
+  gsize position;
+} mmd_yaml_reader;
+
+
+static gboolean
+_mmd_yaml_get_byte (mmd_yaml_reader *reader, guint8 *value)
+{
+  if (reader->position >= reader->length)
+    return FALSE;
+
+  *value = reader->data[reader->position++];
+  return TRUE;
+}
+
+
+/* Returns a newly-allocated, NUL-terminated copy of the string, which may be
+ * NULL if NULL was stored
+ */
+static gboolean
+_mmd_yaml_get_string (mmd_yaml_reader *reader,
+                      yaml_char_t **str,
+                      gsize *length)
+{
+  guint32 size = 0;
+
+  if (reader->length - reader->position < sizeof (size))
+    return FALSE;
+
+  memcpy (&size, reader->data + reader->position, sizeof (size));
+  reader->position += sizeof (size);
+
+  *str = NULL;
+  if (length)
+    *length = 0;
+
+  if (size == G_MAXUINT32)
+    return TRUE;
+
+  if (reader->length - reader->position < size)
+    return FALSE;
+
+  *str = (yaml_char_t *)g_strndup (
+    (const gchar *)reader->data + reader->position, size);
+  reader->position += size;
+
+  if (length)
+    *length = size;
+  return TRUE;
+}
+
+
+GArray *
+mmd_yaml_event_array_deserialize (const guint8 *data,
+                                  gsize length,
+                                  GError **error)
+{
+  g_autoptr (GArray) events = NULL;
+  mmd_yaml_reader reader = { data, length, 0 };
+  yaml_event_t event;
+  g_autofree yaml_char_t *anchor = NULL;
+  g_autofree yaml_char_t *tag = NULL;
+  g_autofree yaml_char_t *value = NULL;
+  gsize value_length = 0;
+  guint8 type = 0;
+  guint8 flags[3] = { 0 };
+  int ret = 0;
+
+  events = mmd_yaml_event_array_new ();
+
+  while (reader.position < reader.length)
+    {
+      g_clear_pointer (&anchor, g_free);
+      g_clear_pointer (&tag, g_free);
+      g_clear_pointer (&value, g_free);
+
+      if (!_mmd_yaml_get_byte (&reader, &type))
+        goto corrupt;
+
+      switch (type)
+        {
+        case YAML_DOCUMENT_START_EVENT:
+          if (!_mmd_yaml_get_byte (&reader, &flags[0]))
+            goto corrupt;
+          ret = yaml_document_start_event_initialize (
+            &event, NULL, NULL, NULL, flags[0]);
+          break;
+
+        case YAML_DOCUMENT_END_EVENT:
+          if (!_mmd_yaml_get_byte (&reader, &flags[0]))
+            goto corrupt;
+          ret = yaml_document_end_event_initialize (&event, flags[0]);
+          break;
+
+        case YAML_ALIAS_EVENT:
+          if (!_mmd_yaml_get_string (&reader, &anchor, NULL) || !anchor)
+            goto corrupt;
+          ret = yaml_alias_event_initialize (&event, anchor);
+          break;
+
+        case YAML_SCALAR_EVENT:
+          if (!_mmd_yaml_get_string (&reader, &anchor, NULL) ||
+              !_mmd_yaml_get_string (&reader, &tag, NULL) ||
+              !_mmd_yaml_get_string (&reader, &value, &value_length) ||
+              !value || !_mmd_yaml_get_byte (&reader, &flags[0]) ||
+              !_mmd_yaml_get_byte (&reader, &flags[1]) ||
+              !_mmd_yaml_get_byte (&reader, &flags[2]))
+            {
+              goto corrupt;
+            }
+          ret = yaml_scalar_event_initialize (&event,
+                                              anchor,
+                                              tag,
+                                              value,
+                                              (int)value_length,
+                                              flags[0],
+                                              flags[1],
+                                              flags[2]);
+          break;
+
+        case YAML_SEQUENCE_START_EVENT:
+        case YAML_MAPPING_START_EVENT:
+          if (!_mmd_yaml_get_string (&reader, &anchor, NULL) ||
+              !_mmd_yaml_get_string (&reader, &tag, NULL) ||
+              !_mmd_yaml_get_byte (&reader, &flags[0]) ||
+              !_mmd_yaml_get_byte (&reader, &flags[1]))
+            {
+              goto corrupt;
+            }
+
+          if (type == YAML_SEQUENCE_START_EVENT)
+            {
+              ret = yaml_sequence_start_event_initialize (
+                &event, anchor, tag, flags[0], flags[1]);
+            }
+          else
+            {
+              ret = yaml_mapping_start_event_initialize (
+                &event, anchor, tag, flags[0], flags[1]);
+            }
+          break;
+
+        case YAML_SEQUENCE_END_EVENT:
+          ret = yaml_sequence_end_event_initialize (&event);
+          break;
+
+        case YAML_MAPPING_END_EVENT:
+          ret = yaml_mapping_end_event_initialize (&event);
+          break;
+
+        default:
+          /* Stream events are never buffered */
+          goto corrupt;
+        }
+
+      if (!ret)
+        goto corrupt;
+
+      mmd_yaml_event_array_take (events, &event);
+    }
+
+  return g_steal_pointer (&events);
+
+corrupt:
+  g_set_error_literal (error,
+                       MODULEMD_YAML_ERROR,
+                       MODULEMD_YAML_ERROR_PARSE,
+                       "Serialized YAML events are corrupt");
+  return NULL;
+}
+
+
+/* Document markers are only recognized at the start of a line, so the
+ * splitter only has to look at the first bytes of each line. Lines are found
+ * with memchr(), which the C library already implements with vector
+ * instructions where they are available.
+ */
+static gboolean
+_mmd_yaml_is_marker (const gchar *line, const gchar *end, gchar c)
+{
+  if (end - line < 3 || line[0] != c || line[1] != c || line[2] != c)
+    return FALSE;
+
+  return end - line == 3 || line[3] == ' ' || line[3] == '\t' ||
+         line[3] == '\r';
+}
+
+
+/* Whether the rest of a line holds nothing but a comment */
+static gboolean
+_mmd_yaml_is_blank (const gchar *p, const gchar *end)
+{
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+    p++;
+
+  return p == end || *p == '#';
+}
+
+
+/* Whether the rest of a line is the header of a block scalar, optionally
+ * preceded by a tag or an anchor, such as "!!str |-"
+ */
+static gboolean
+_mmd_yaml_is_block_header (const gchar *p, const gchar *end)
+{
+  while (p < end && (*p == ' ' || *p == '\t'))
+    p++;
+
+  while (p < end && (*p == '!' || *p == '&'))
+    {
+      while (p < end && *p != ' ' && *p != '\t')
+        p++;
+      while (p < end && (*p == ' ' || *p == '\t'))
+        p++;
+    }
+
+  if (p == end || (*p != '|' && *p != '>'))
+    return FALSE;
+  p++;
+
+  /* Chomping and indentation indicators */
+  for (gint i = 0; i < 2 && p < end; i++)
+    {
+      if (*p == '+' || *p == '-' || g_ascii_isdigit (*p))
+        p++;
+    }
+
+  if (p < end && *p != ' ' && *p != '\t' && *p != '\r')
+    return FALSE;
+
+  return _mmd_yaml_is_blank (p, end);
+}
+
+
+gboolean
+mmd_yaml_split_documents (const gchar *buffer,
+                          gsize length,
+                          GArray *boundaries)
+{
+  const guchar *bytes = (const guchar *)buffer;
+  const gchar *end = buffer + length;
+  const gchar *line = buffer;
+  const gchar *line_end = NULL;
+  const gchar *eol = NULL;
+  gsize offset = 0;
+  gboolean expect_root = TRUE;
+  gboolean in_root_block = FALSE;
+
+  g_array_append_val (boundaries, offset);
+
+  /* The other parts would be read as UTF-8 without the byte order mark */
+  if (length >= 2 && ((bytes[0] == 0xFE && bytes[1] == 0xFF) ||
+                      (bytes[0] == 0xFF && bytes[1] == 0xFE)))
+    return FALSE;
+
+  while (line < end)
+    {
+      eol = memchr (line, '\n', end - line);
+      line_end = eol ? eol : end;
+
+      if (_mmd_yaml_is_marker (line, line_end, '-'))
+        {
+          /* A block scalar that is the root of its document may have content
+           * in the first column, where it can't be told apart from a marker
+           */
+          if (in_root_block)
+            return FALSE;
+
+          offset = line - buffer;
+          if (offset > g_array_index (boundaries, gsize, boundaries->len - 1))
+            g_array_append_val (boundaries, offset);
+
+          expect_root = _mmd_yaml_is_blank (line + 3, line_end);
+          in_root_block = _mmd_yaml_is_block_header (line + 3, line_end);
+        }
+      else if (_mmd_yaml_is_marker (line, line_end, '.'))
+        {
+          if (in_root_block)
+            return FALSE;
+
+          /* The next document starts on the following line */
+          offset = eol ? (gsize)(eol + 1 - buffer) : length;
+          if (offset < length)
+            g_array_append_val (boundaries, offset);
+
+          expect_root = TRUE;
+          in_root_block = FALSE;
+        }
+      else if (line < line_end && *line == '%')
+        {
+          /* Directives apply to the document after them, so they would have
+           * to move with it
+           */
+          return FALSE;
+        }
+      else if (expect_root && !_mmd_yaml_is_blank (line, line_end))
+        {
+          expect_root = FALSE;
+          in_root_block = _mmd_yaml_is_block_header (line, line_end);
+        }
+
+      line = eol ? eol + 1 : end;
+    }
+
+  return TRUE;
+}
+
+
+/* The length has already been matched by the time this is used, so a single
+ * memcmp() over the whole key decides it.
+ */
+#define MMD_YAML_KEY_MATCH(_literal, _key)                                    \
+  if (memcmp (key, _literal, length) == 0)                                    \
+  return _key
+
+ModulemdYamlKey
+mmd_yaml_key_lookup (const gchar *key, gsize length)
+{
+  if (key == NULL || length == 0)
+    return MMD_YAML_KEY_UNKNOWN;
+
+  switch (length)
+    {
+    case 3:
+      switch (key[0])
+        {
+        case 'a': MMD_YAML_KEY_MATCH ("api", MMD_YAML_KEY_API); break;
+        case 'e': MMD_YAML_KEY_MATCH ("eol", MMD_YAML_KEY_EOL); break;
+        case 'r': MMD_YAML_KEY_MATCH ("ref", MMD_YAML_KEY_REF); break;
+        case 'x': MMD_YAML_KEY_MATCH ("xmd", MMD_YAML_KEY_XMD); break;
+        }
+      break;
+
+    case 4:
+      switch (key[0])
+        {
+        case 'a': MMD_YAML_KEY_MATCH ("arch", MMD_YAML_KEY_ARCH); break;
+        case 'd': MMD_YAML_KEY_MATCH ("data", MMD_YAML_KEY_DATA); break;
+        case 'n': MMD_YAML_KEY_MATCH ("name", MMD_YAML_KEY_NAME); break;
+        case 'r': MMD_YAML_KEY_MATCH ("rpms", MMD_YAML_KEY_RPMS); break;
+        }
+      break;
+
+    case 5: MMD_YAML_KEY_MATCH ("cache", MMD_YAML_KEY_CACHE); break;
+
+    case 6:
+      switch (key[0])
+        {
+        case 'a': MMD_YAML_KEY_MATCH ("arches", MMD_YAML_KEY_ARCHES); break;
+        case 'f': MMD_YAML_KEY_MATCH ("filter", MMD_YAML_KEY_FILTER); break;
+        case 'm':
+          MMD_YAML_KEY_MATCH ("macros", MMD_YAML_KEY_MACROS);
+          MMD_YAML_KEY_MATCH ("module", MMD_YAML_KEY_MODULE);
+          break;
+        case 's': MMD_YAML_KEY_MATCH ("stream", MMD_YAML_KEY_STREAM); break;
+        }
+      break;
+
+    case 7:
+      switch (key[0])
+        {
+        case 'c':
+          MMD_YAML_KEY_MATCH ("content", MMD_YAML_KEY_CONTENT);
+          MMD_YAML_KEY_MATCH ("context", MMD_YAML_KEY_CONTEXT);
+          break;
+        case 'i': MMD_YAML_KEY_MATCH ("intents", MMD_YAML_KEY_INTENTS); break;
+        case 'l': MMD_YAML_KEY_MATCH ("license", MMD_YAML_KEY_LICENSE); break;
+        case 'm': MMD_YAML_KEY_MATCH ("modules", MMD_YAML_KEY_MODULES); break;
+        case 's': MMD_YAML_KEY_MATCH ("summary", MMD_YAML_KEY_SUMMARY); break;
+        case 'v': MMD_YAML_KEY_MATCH ("version", MMD_YAML_KEY_VERSION); break;
+        }
+      break;
+
+    case 8:
+      switch (key[0])
+        {
+        case 'd':
+          MMD_YAML_KEY_MATCH ("document", MMD_YAML_KEY_DOCUMENT);
+          break;
+        case 'm':
+          MMD_YAML_KEY_MATCH ("modified", MMD_YAML_KEY_MODIFIED);
+          MMD_YAML_KEY_MATCH ("modulemd", MMD_YAML_KEY_MODULEMD);
+          MMD_YAML_KEY_MATCH ("multilib", MMD_YAML_KEY_MULTILIB);
+          break;
+        case 'p':
+          MMD_YAML_KEY_MATCH ("profiles", MMD_YAML_KEY_PROFILES);
+          break;
+        case 'r':
+          MMD_YAML_KEY_MATCH ("requires", MMD_YAML_KEY_REQUIRES);
+          break;
+        }
+      break;
+
+    case 9:
+      switch (key[0])
+        {
+        case 'a':
+          MMD_YAML_KEY_MATCH ("artifacts", MMD_YAML_KEY_ARTIFACTS);
+          break;
+        case 'b':
+          MMD_YAML_KEY_MATCH ("buildopts", MMD_YAML_KEY_BUILDOPTS);
+          break;
+        case 'r':
+          MMD_YAML_KEY_MATCH ("rationale", MMD_YAML_KEY_RATIONALE);
+          break;
+        case 'w':
+          MMD_YAML_KEY_MATCH ("whitelist", MMD_YAML_KEY_WHITELIST);
+          break;
+        }
+      break;
+
+    case 10:
+      switch (key[0])
+        {
+        case 'b':
+          MMD_YAML_KEY_MATCH ("buildorder", MMD_YAML_KEY_BUILDORDER);
+          break;
+        case 'c':
+          MMD_YAML_KEY_MATCH ("components", MMD_YAML_KEY_COMPONENTS);
+          break;
+        case 'r':
+          MMD_YAML_KEY_MATCH ("references", MMD_YAML_KEY_REFERENCES);
+          MMD_YAML_KEY_MATCH ("repository", MMD_YAML_KEY_REPOSITORY);
+          break;
+        }
+      break;
+
+    case 11:
+      MMD_YAML_KEY_MATCH ("description", MMD_YAML_KEY_DESCRIPTION);
+      break;
+
+    case 12:
+      switch (key[0])
+        {
+        case 'd':
+          MMD_YAML_KEY_MATCH ("dependencies", MMD_YAML_KEY_DEPENDENCIES);
+          break;
+        case 't':
+          MMD_YAML_KEY_MATCH ("translations", MMD_YAML_KEY_TRANSLATIONS);
+          break;
+        }
+      break;
+
+    case 13:
+      switch (key[0])
+        {
+        case 'b':
+          MMD_YAML_KEY_MATCH ("buildrequires", MMD_YAML_KEY_BUILDREQUIRES);
+          break;
+        case 's':
+          MMD_YAML_KEY_MATCH ("servicelevels", MMD_YAML_KEY_SERVICELEVELS);
+          break;
+        }
+      break;
+
+    case 17:
+      MMD_YAML_KEY_MATCH ("modulemd-defaults", MMD_YAML_KEY_MODULEMD_DEFAULTS);
+      break;
+
+    case 21:
+      MMD_YAML_KEY_MATCH ("modulemd-translations",
+                          MMD_YAML_KEY_MODULEMD_TRANSLATIONS);
+      break;
+    }
+
+  return MMD_YAML_KEY_UNKNOWN;
+}
+
+#undef MMD_YAML_KEY_MATCH
@@ -0,0 +1,189 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2017-2018 Stephen Gallagher
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+#define MMD_DISABLE_DEPRECATION_WARNINGS 1
+#include "modulemd.h"
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <locale.h>
+
+typedef struct _BinaryIndexFixture
+{
+  gchar *tmp_dir;
+  gchar *path;
+  GHashTable *index;
+} BinaryIndexFixture;
+
+
+static void
+modulemd_binary_index_set_up (BinaryIndexFixture *fixture,
+                              gconstpointer user_data)
+{
+  g_autofree gchar *yaml_path = NULL;
+  g_autoptr (GError) error = NULL;
+
+  yaml_path = g_strdup_printf ("%s/test_data/long-valid.yaml",
+                               g_getenv ("MESON_SOURCE_ROOT"));
+  fixture->index = modulemd_index_from_file (yaml_path, NULL, &error);
+  g_assert_nonnull (fixture->index);
+  g_assert_null (error);
+
+  fixture->tmp_dir = g_dir_make_tmp ("modulemd-index-XXXXXX", &error);
+  g_assert_nonnull (fixture->tmp_dir);
+  fixture->path = g_build_filename (fixture->tmp_dir, "index.bin", NULL);
+
+  g_assert_true (
+    modulemd_dump_index_binary (fixture->index, fixture->path, &error));
+  g_assert_null (error);
+}
+
+
+static void
+modulemd_binary_index_tear_down (BinaryIndexFixture *fixture,
+                                 gconstpointer user_data)
+{
+  g_unlink (fixture->path);
+  g_rmdir (fixture->tmp_dir);
+
+  g_clear_pointer (&fixture->path, g_free);
+  g_clear_pointer (&fixture->tmp_dir, g_free);
+  g_clear_pointer (&fixture->index, g_hash_table_unref);
+}
+
+
+static void
+modulemd_binary_index_test_roundtrip (BinaryIndexFixture *fixture,
+                                      gconstpointer user_data)
+{
+  g_autoptr (GHashTable) index = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *expected = NULL;
+  g_autofree gchar *yaml = NULL;
+
+  index = modulemd_index_from_binary_file (fixture->path, &error);
+  g_assert_nonnull (index);
+  g_assert_null (error);
+
+  expected = modulemd_dumps_index (fixture->index, &error);
+  yaml = modulemd_dumps_index (index, &error);
+  g_assert_nonnull (yaml);
+  g_assert_cmpstr (yaml, ==, expected);
+}
+
+
+static void
+modulemd_binary_index_test_lookup (BinaryIndexFixture *fixture,
+                                   gconstpointer user_data)
+{
+  g_autoptr (ModulemdBinaryIndex) binary_index = NULL;
+  g_autoptr (ModulemdImprovedModule) module = NULL;
+  g_autoptr (ModulemdImprovedModule) missing = NULL;
+  g_autoptr (GPtrArray) names = NULL;
+  g_autoptr (GHashTable) streams = NULL;
+  g_autoptr (GHashTable) expected_streams = NULL;
+  g_autoptr (GError) error = NULL;
+  ModulemdImprovedModule *expected = NULL;
+  const gchar *name = NULL;
+
+  binary_index = modulemd_binary_index_new_from_file (fixture->path, &error);
+  g_assert_nonnull (binary_index);
+  g_assert_null (error);
+
+  g_assert_cmpuint (modulemd_binary_index_get_n_modules (binary_index),
+                    ==,
+                    g_hash_table_size (fixture->index));
+
+  /* Names are returned in sorted order */
+  names = modulemd_binary_index_get_module_names (binary_index);
+  g_assert_cmpuint (names->len, ==, g_hash_table_size (fixture->index));
+  for (gsize i = 0; i < names->len; i++)
+    {
+      name = g_ptr_array_index (names, i);
+      g_assert_true (g_hash_table_contains (fixture->index, name));
+      if (i > 0)
+        g_assert_cmpstr (g_ptr_array_index (names, i - 1), <, name);
+    }
+
+  module = modulemd_binary_index_get_module (binary_index, "nodejs", &error);
+  g_assert_nonnull (module);
+  g_assert_null (error);
+  g_assert_cmpstr (modulemd_improvedmodule_peek_name (module), ==, "nodejs");
+
+  expected = g_hash_table_lookup (fixture->index, "nodejs");
+  streams = modulemd_improvedmodule_get_streams (module);
+  expected_streams = modulemd_improvedmodule_get_streams (expected);
+  g_assert_cmpuint (
+    g_hash_table_size (streams), ==, g_hash_table_size (expected_streams));
+  g_assert_nonnull (modulemd_improvedmodule_peek_defaults (module));
+
+  /* Modules that aren't in the index are not an error */
+  missing = modulemd_binary_index_get_module (binary_index, "nosuch", &error);
+  g_assert_null (missing);
+  g_assert_null (error);
+}
+
+
+static void
+modulemd_binary_index_test_invalid (BinaryIndexFixture *fixture,
+                                    gconstpointer user_data)
+{
+  g_autoptr (ModulemdBinaryIndex) binary_index = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *yaml_path = NULL;
+
+  /* YAML is not accepted as a binary index */
+  yaml_path = g_strdup_printf ("%s/test_data/long-valid.yaml",
+                               g_getenv ("MESON_SOURCE_ROOT"));
+  binary_index = modulemd_binary_index_new_from_file (yaml_path, &error);
+  g_assert_null (binary_index);
+  g_assert_nonnull (error);
+  g_clear_error (&error);
+
+  binary_index =
+    modulemd_binary_index_new_from_file ("/nonexistent/index.bin", &error);
+  g_assert_null (binary_index);
+  g_assert_nonnull (error);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  setlocale (LC_ALL, "");
+
+  g_test_init (&argc, &argv, NULL);
+  g_test_bug_base ("https://bugzilla.redhat.com/show_bug.cgi?id=");
+
+  g_test_add ("/modulemd/binary_index/test_roundtrip",
+              BinaryIndexFixture,
+              NULL,
+              modulemd_binary_index_set_up,
+              modulemd_binary_index_test_roundtrip,
+              modulemd_binary_index_tear_down);
+
+  g_test_add ("/modulemd/binary_index/test_lookup",
+              BinaryIndexFixture,
+              NULL,
+              modulemd_binary_index_set_up,
+              modulemd_binary_index_test_lookup,
+              modulemd_binary_index_tear_down);
+
+  g_test_add ("/modulemd/binary_index/test_invalid",
+              BinaryIndexFixture,
+              NULL,
+              modulemd_binary_index_set_up,
+              modulemd_binary_index_test_invalid,
+              modulemd_binary_index_tear_down);
+
+  return g_test_run ();
+}
@@ -0,0 +1,164 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2017-2018 Stephen Gallagher
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+#define MMD_DISABLE_DEPRECATION_WARNINGS 1
+#include "modulemd.h"
+
+#include <glib.h>
+#include <locale.h>
+
+typedef struct _CatalogFixture
+{
+} CatalogFixture;
+
+
+static void
+modulemd_catalog_test_file (CatalogFixture *fixture, gconstpointer user_data)
+{
+  g_autofree gchar *yaml_path = NULL;
+  g_autoptr (ModulemdCatalog) catalog = NULL;
+  g_autoptr (ModulemdImprovedModule) module = NULL;
+  g_autoptr (GHashTable) streams = NULL;
+  g_autoptr (GError) error = NULL;
+  g_auto (GStrv) names = NULL;
+  g_auto (GStrv) nsvcs = NULL;
+
+  yaml_path = g_strdup_printf ("%s/test_data/long-valid.yaml",
+                               g_getenv ("MESON_SOURCE_ROOT"));
+
+  catalog = modulemd_catalog_new_from_file (yaml_path, &error);
+  g_assert_nonnull (catalog);
+  g_assert_null (error);
+
+  names = modulemd_catalog_dup_module_names (catalog);
+  g_assert_nonnull (names);
+  g_assert_true (g_strv_contains ((const gchar *const *)names, "django"));
+  g_assert_true (g_strv_contains ((const gchar *const *)names, "nodejs"));
+  g_assert_true (
+    g_strv_contains ((const gchar *const *)names, "reviewboard"));
+
+  /* Every NSVC must materialize into the stream it was recorded for */
+  nsvcs = modulemd_catalog_dup_nsvcs (catalog);
+  g_assert_nonnull (nsvcs);
+  g_assert_cmpuint (g_strv_length (nsvcs), ==, 5);
+
+  for (gsize i = 0; nsvcs[i]; i++)
+    {
+      g_autoptr (ModulemdModuleStream) stream = NULL;
+      g_autofree gchar *nsvc = NULL;
+
+      stream =
+        modulemd_catalog_get_stream_by_nsvc (catalog, nsvcs[i], &error);
+      g_assert_nonnull (stream);
+      g_assert_null (error);
+
+      nsvc = modulemd_modulestream_get_nsvc (stream);
+      g_assert_cmpstr (nsvc, ==, nsvcs[i]);
+    }
+
+  g_assert_null (
+    modulemd_catalog_get_stream_by_nsvc (catalog, "nosuch:1:1:1", &error));
+  g_assert_null (error);
+
+  /* Whole modules include their defaults */
+  module = modulemd_catalog_get_module (catalog, "nodejs", &error);
+  g_assert_nonnull (module);
+  g_assert_null (error);
+  g_assert_nonnull (modulemd_improvedmodule_peek_defaults (module));
+
+  streams = modulemd_improvedmodule_get_streams (module);
+  g_assert_cmpuint (g_hash_table_size (streams), ==, 3);
+
+  g_assert_null (modulemd_catalog_get_module (catalog, "nosuch", &error));
+  g_assert_null (error);
+}
+
+
+static void
+modulemd_catalog_test_offsets (CatalogFixture *fixture,
+                               gconstpointer user_data)
+{
+  g_autoptr (ModulemdCatalog) catalog = NULL;
+  g_autoptr (ModulemdModuleStream) stream = NULL;
+  g_autoptr (GError) error = NULL;
+  const gchar *yaml_string = NULL;
+
+  /* Multi-byte characters before the second document must not shift its
+   * recorded location
+   */
+  yaml_string =
+    "---\n"
+    "document: modulemd\n"
+    "version: 2\n"
+    "data:\n"
+    "  name: first\n"
+    "  stream: \"1\"\n"
+    "  version: 1\n"
+    "  context: c0ffee42\n"
+    "  summary: Ünïcödé\n"
+    "  description: Ünïcödé ünïcödé ünïcödé\n"
+    "  license:\n"
+    "    module: [MIT]\n"
+    "...\n"
+    "---\n"
+    "document: modulemd\n"
+    "version: 2\n"
+    "data:\n"
+    "  name: second\n"
+    "  stream: \"2\"\n"
+    "  version: 2\n"
+    "  context: c0ffee43\n"
+    "  summary: Second\n"
+    "  description: The second document\n"
+    "  license:\n"
+    "    module: [MIT]\n"
+    "...\n";
+
+  catalog = modulemd_catalog_new_from_string (yaml_string, &error);
+  g_assert_nonnull (catalog);
+  g_assert_null (error);
+  g_assert_cmpuint (modulemd_catalog_get_n_documents (catalog), ==, 2);
+
+  stream = modulemd_catalog_get_stream_by_nsvc (
+    catalog, "second:2:2:c0ffee43", &error);
+  g_assert_nonnull (stream);
+  g_assert_null (error);
+  g_assert_cmpstr (modulemd_modulestream_peek_name (stream), ==, "second");
+  g_assert_cmpstr (
+    modulemd_modulestream_peek_summary (stream), ==, "Second");
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  setlocale (LC_ALL, "");
+
+  g_test_init (&argc, &argv, NULL);
+  g_test_bug_base ("https://bugzilla.redhat.com/show_bug.cgi?id=");
+
+  g_test_add ("/modulemd/catalog/test_file",
+              CatalogFixture,
+              NULL,
+              NULL,
+              modulemd_catalog_test_file,
+              NULL);
+
+  g_test_add ("/modulemd/catalog/test_offsets",
+              CatalogFixture,
+              NULL,
+              NULL,
+              modulemd_catalog_test_offsets,
+              NULL);
+
+  return g_test_run ();
+}
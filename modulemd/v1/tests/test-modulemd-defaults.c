@@ -959,6 +959,138 @@ modulemd_defaults_test_index_prioritizer (DefaultsFixture *fixture,
 }
 
 
+static void
+modulemd_defaults_test_incremental_prioritizer (DefaultsFixture *fixture,
+                                                gconstpointer user_data)
+{
+  g_autofree gchar *yaml_base_path = NULL;
+  g_autofree gchar *yaml_override_path = NULL;
+  g_autoptr (GPtrArray) base_objects = NULL;
+  g_autoptr (GPtrArray) override_objects = NULL;
+  g_autoptr (GPtrArray) merged_objects = NULL;
+  g_autoptr (GPtrArray) expected_objects = NULL;
+  g_autoptr (ModulemdPrioritizer) prioritizer = NULL;
+  g_autoptr (ModulemdPrioritizer) expected = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *yaml = NULL;
+  g_autofree gchar *expected_yaml = NULL;
+
+  yaml_base_path = g_strdup_printf ("%s/test_data/defaults/merging-base.yaml",
+                                    g_getenv ("MESON_SOURCE_ROOT"));
+  base_objects = modulemd_objects_from_file (yaml_base_path, &error);
+  g_assert_nonnull (base_objects);
+
+  yaml_override_path = g_strdup_printf (
+    "%s/test_data/defaults/overriding.yaml", g_getenv ("MESON_SOURCE_ROOT"));
+  override_objects = modulemd_objects_from_file (yaml_override_path, &error);
+  g_assert_nonnull (override_objects);
+
+  /* Resolve after each addition, merging on several threads */
+  prioritizer = modulemd_prioritizer_new ();
+  modulemd_prioritizer_set_n_threads (prioritizer, 4);
+  g_assert_true (
+    modulemd_prioritizer_add (prioritizer, base_objects, 10, &error));
+  merged_objects = modulemd_prioritizer_resolve (prioritizer, &error);
+  g_assert_nonnull (merged_objects);
+  g_assert_cmpint (merged_objects->len, ==, 3);
+  g_clear_pointer (&merged_objects, g_ptr_array_unref);
+
+  /* A conflict at the same level leaves the prioritizer as it was */
+  g_assert_false (
+    modulemd_prioritizer_add (prioritizer, override_objects, 10, &error));
+  g_assert_nonnull (error);
+  g_clear_error (&error);
+
+  g_assert_true (
+    modulemd_prioritizer_add (prioritizer, override_objects, 500, &error));
+  merged_objects = modulemd_prioritizer_resolve (prioritizer, &error);
+  g_assert_nonnull (merged_objects);
+
+  /* This matches resolving everything at once */
+  expected = modulemd_prioritizer_new ();
+  g_assert_true (
+    modulemd_prioritizer_add (expected, base_objects, 10, &error));
+  g_assert_true (
+    modulemd_prioritizer_add (expected, override_objects, 500, &error));
+  expected_objects = modulemd_prioritizer_resolve (expected, &error);
+  g_assert_nonnull (expected_objects);
+
+  yaml = modulemd_dumps (merged_objects, &error);
+  g_assert_nonnull (yaml);
+  expected_yaml = modulemd_dumps (expected_objects, &error);
+  g_assert_nonnull (expected_yaml);
+  g_assert_cmpstr (yaml, ==, expected_yaml);
+
+  /* Resolving again without changes returns the same result */
+  g_clear_pointer (&merged_objects, g_ptr_array_unref);
+  g_clear_pointer (&yaml, g_free);
+  merged_objects = modulemd_prioritizer_resolve (prioritizer, &error);
+  g_assert_nonnull (merged_objects);
+  yaml = modulemd_dumps (merged_objects, &error);
+  g_assert_cmpstr (yaml, ==, expected_yaml);
+}
+
+
+static void
+modulemd_defaults_test_parallel_merge (DefaultsFixture *fixture,
+                                       gconstpointer user_data)
+{
+  g_autofree gchar *yaml_base_path = NULL;
+  g_autofree gchar *yaml_override_path = NULL;
+  g_autoptr (GPtrArray) base_objects = NULL;
+  g_autoptr (GPtrArray) override_objects = NULL;
+  g_autoptr (GPtrArray) merged_objects = NULL;
+  g_autoptr (GPtrArray) expected_objects = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autoptr (GError) expected_error = NULL;
+  g_autofree gchar *yaml = NULL;
+  g_autofree gchar *expected_yaml = NULL;
+
+  yaml_base_path = g_strdup_printf ("%s/test_data/defaults/merging-base.yaml",
+                                    g_getenv ("MESON_SOURCE_ROOT"));
+  base_objects = modulemd_objects_from_file (yaml_base_path, &error);
+  g_assert_nonnull (base_objects);
+
+  yaml_override_path = g_strdup_printf (
+    "%s/test_data/defaults/overriding.yaml", g_getenv ("MESON_SOURCE_ROOT"));
+  override_objects = modulemd_objects_from_file (yaml_override_path, &error);
+  g_assert_nonnull (override_objects);
+
+  /* The result is the same as for a serial merge */
+  expected_objects = modulemd_merge_defaults (
+    base_objects, override_objects, TRUE, &expected_error);
+  g_assert_nonnull (expected_objects);
+  merged_objects = modulemd_merge_defaults_parallel (
+    base_objects, override_objects, TRUE, 0, &error);
+  g_assert_nonnull (merged_objects);
+  g_assert_cmpint (merged_objects->len, ==, 3);
+
+  expected_yaml = modulemd_dumps (expected_objects, &error);
+  g_assert_nonnull (expected_yaml);
+  yaml = modulemd_dumps (merged_objects, &error);
+  g_assert_cmpstr (yaml, ==, expected_yaml);
+
+  /* So is the error if the modules conflict */
+  g_clear_pointer (&merged_objects, g_ptr_array_unref);
+  g_clear_pointer (&expected_objects, g_ptr_array_unref);
+  expected_objects = modulemd_merge_defaults (
+    base_objects, override_objects, FALSE, &expected_error);
+  g_assert_null (expected_objects);
+  g_assert_nonnull (expected_error);
+
+  for (guint i = 0; i < 10; i++)
+    {
+      merged_objects = modulemd_merge_defaults_parallel (
+        base_objects, override_objects, FALSE, 4, &error);
+      g_assert_null (merged_objects);
+      g_assert_nonnull (error);
+      g_assert_cmpint (error->code, ==, expected_error->code);
+      g_assert_cmpstr (error->message, ==, expected_error->message);
+      g_clear_error (&error);
+    }
+}
+
+
 static void
 modulemd_regressions_issue42 (DefaultsFixture *fixture,
                               gconstpointer user_data)
@@ -1119,6 +1251,21 @@ main (int argc, char *argv[])
               modulemd_defaults_test_index_prioritizer,
               NULL);
 
+  g_test_add (
+    "/modulemd/defaults/modulemd_defaults_test_incremental_prioritizer",
+    DefaultsFixture,
+    NULL,
+    NULL,
+    modulemd_defaults_test_incremental_prioritizer,
+    NULL);
+
+  g_test_add ("/modulemd/defaults/modulemd_defaults_test_parallel_merge",
+              DefaultsFixture,
+              NULL,
+              NULL,
+              modulemd_defaults_test_parallel_merge,
+              NULL);
+
   g_test_add ("/modulemd/defaults/modulemd_regressions_issue42",
               DefaultsFixture,
               NULL,
@@ -0,0 +1,329 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2017-2018 Stephen Gallagher
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+#define MMD_DISABLE_DEPRECATION_WARNINGS 1
+#include "modulemd.h"
+
+#include <glib.h>
+#include <locale.h>
+
+typedef struct _FilterFixture
+{
+} FilterFixture;
+
+
+static void
+modulemd_filter_test_module_names (FilterFixture *fixture,
+                                   gconstpointer user_data)
+{
+  g_autofree gchar *yaml_path = NULL;
+  g_autoptr (ModulemdFilter) filter = NULL;
+  g_autoptr (GPtrArray) objects = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GHashTable) index = NULL;
+  g_autoptr (GError) error = NULL;
+  GObject *object = NULL;
+  gsize n_streams = 0;
+
+  yaml_path = g_strdup_printf ("%s/test_data/long-valid.yaml",
+                               g_getenv ("MESON_SOURCE_ROOT"));
+
+  filter = modulemd_filter_new ();
+  modulemd_filter_add_module_name (filter, "nodejs");
+
+  objects = modulemd_objects_from_file_filtered (
+    yaml_path, filter, &failures, &error);
+  g_assert_nonnull (objects);
+  g_assert_null (error);
+  g_assert_cmpuint (failures->len, ==, 0);
+
+  /* Three streams and the defaults */
+  g_assert_cmpuint (objects->len, ==, 4);
+  for (gsize i = 0; i < objects->len; i++)
+    {
+      object = g_ptr_array_index (objects, i);
+      if (MODULEMD_IS_MODULESTREAM (object))
+        {
+          g_assert_cmpstr (modulemd_modulestream_peek_name (
+                             MODULEMD_MODULESTREAM (object)),
+                           ==,
+                           "nodejs");
+          n_streams++;
+        }
+      else
+        {
+          g_assert_true (MODULEMD_IS_DEFAULTS (object));
+          g_assert_cmpstr (modulemd_defaults_peek_module_name (
+                             MODULEMD_DEFAULTS (object)),
+                           ==,
+                           "nodejs");
+        }
+    }
+  g_assert_cmpuint (n_streams, ==, 3);
+
+  g_clear_pointer (&failures, g_ptr_array_unref);
+  index =
+    modulemd_index_from_file_filtered (yaml_path, filter, &failures, &error);
+  g_assert_nonnull (index);
+  g_assert_null (error);
+  g_assert_cmpuint (g_hash_table_size (index), ==, 1);
+  g_assert_true (g_hash_table_contains (index, "nodejs"));
+
+  /* Names may be added to widen the selection */
+  modulemd_filter_add_module_name (filter, "django");
+  g_clear_pointer (&objects, g_ptr_array_unref);
+  objects =
+    modulemd_objects_from_file_filtered (yaml_path, filter, NULL, &error);
+  g_assert_nonnull (objects);
+  g_assert_null (error);
+  g_assert_cmpuint (objects->len, ==, 6);
+}
+
+
+static void
+modulemd_filter_test_doctype (FilterFixture *fixture, gconstpointer user_data)
+{
+  g_autofree gchar *yaml_path = NULL;
+  g_autoptr (ModulemdFilter) filter = NULL;
+  g_autoptr (GPtrArray) objects = NULL;
+  g_autoptr (GError) error = NULL;
+
+  yaml_path = g_strdup_printf ("%s/test_data/long-valid.yaml",
+                               g_getenv ("MESON_SOURCE_ROOT"));
+
+  filter = modulemd_filter_new ();
+  modulemd_filter_add_doctype (filter, MODULEMD_TYPE_DEFAULTS);
+
+  objects =
+    modulemd_objects_from_file_filtered (yaml_path, filter, NULL, &error);
+  g_assert_nonnull (objects);
+  g_assert_null (error);
+  g_assert_cmpuint (objects->len, ==, 3);
+  for (gsize i = 0; i < objects->len; i++)
+    g_assert_true (MODULEMD_IS_DEFAULTS (g_ptr_array_index (objects, i)));
+
+  /* Combined with a module name, both must match */
+  modulemd_filter_add_module_name (filter, "django");
+  g_clear_pointer (&objects, g_ptr_array_unref);
+  objects =
+    modulemd_objects_from_file_filtered (yaml_path, filter, NULL, &error);
+  g_assert_nonnull (objects);
+  g_assert_null (error);
+  g_assert_cmpuint (objects->len, ==, 1);
+  g_assert_true (MODULEMD_IS_DEFAULTS (g_ptr_array_index (objects, 0)));
+}
+
+
+static void
+modulemd_filter_test_arch (FilterFixture *fixture, gconstpointer user_data)
+{
+  g_autoptr (ModulemdFilter) filter = NULL;
+  g_autoptr (GPtrArray) objects = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GError) error = NULL;
+  const gchar *yaml_string = NULL;
+
+  /* The scalar values "name" and "arch" must not be mistaken for keys, and
+   * the last document would fail to parse if it weren't skipped
+   */
+  yaml_string =
+    "---\n"
+    "document: modulemd\n"
+    "version: 2\n"
+    "data:\n"
+    "  summary: name\n"
+    "  description: arch\n"
+    "  name: first\n"
+    "  stream: \"1\"\n"
+    "  arch: x86_64\n"
+    "  license:\n"
+    "    module: [MIT]\n"
+    "...\n"
+    "---\n"
+    "document: modulemd\n"
+    "version: 2\n"
+    "data:\n"
+    "  license:\n"
+    "    module: [MIT]\n"
+    "  name: second\n"
+    "  stream: \"1\"\n"
+    "  arch: aarch64\n"
+    "  summary: Second\n"
+    "  description: The second document\n"
+    "...\n"
+    "---\n"
+    "document: modulemd\n"
+    "version: 2\n"
+    "data:\n"
+    "  name: third\n"
+    "  stream: \"1\"\n"
+    "  summary: Third\n"
+    "  description: The third document, without an arch\n"
+    "  license:\n"
+    "    module: [MIT]\n"
+    "...\n"
+    "---\n"
+    "document: modulemd\n"
+    "version: 2\n"
+    "data:\n"
+    "  name: fourth\n"
+    "  arch: s390x\n"
+    "  version: [not, valid]\n"
+    "...\n";
+
+  filter = modulemd_filter_new ();
+  modulemd_filter_set_arch (filter, "x86_64");
+  g_assert_cmpstr (modulemd_filter_peek_arch (filter), ==, "x86_64");
+
+  objects = modulemd_objects_from_string_filtered (
+    yaml_string, filter, &failures, &error);
+  g_assert_nonnull (objects);
+  g_assert_null (error);
+  g_assert_cmpuint (failures->len, ==, 0);
+  g_assert_cmpuint (objects->len, ==, 2);
+  g_assert_cmpstr (modulemd_modulestream_peek_name (
+                     MODULEMD_MODULESTREAM (g_ptr_array_index (objects, 0))),
+                   ==,
+                   "first");
+  g_assert_cmpstr (modulemd_modulestream_peek_name (
+                     MODULEMD_MODULESTREAM (g_ptr_array_index (objects, 1))),
+                   ==,
+                   "third");
+
+  /* Without an arch, every document is parsed and the last one fails */
+  modulemd_filter_set_arch (filter, NULL);
+  g_clear_pointer (&objects, g_ptr_array_unref);
+  g_clear_pointer (&failures, g_ptr_array_unref);
+  objects = modulemd_objects_from_string_filtered (
+    yaml_string, filter, &failures, &error);
+  g_assert_nonnull (objects);
+  g_assert_null (error);
+  g_assert_cmpuint (objects->len, ==, 3);
+  g_assert_cmpuint (failures->len, ==, 1);
+}
+
+
+static void
+modulemd_filter_test_sections (FilterFixture *fixture,
+                               gconstpointer user_data)
+{
+  g_autofree gchar *yaml_path = NULL;
+  g_autoptr (ModulemdFilter) filter = NULL;
+  g_autoptr (GPtrArray) objects = NULL;
+  g_autoptr (GError) error = NULL;
+  ModulemdModuleStream *stream = NULL;
+  ModulemdSimpleSet *artifacts = NULL;
+  GHashTable *components = NULL;
+  gsize n_streams = 0;
+
+  yaml_path = g_strdup_printf ("%s/test_data/good-v2.yaml",
+                               g_getenv ("MESON_SOURCE_ROOT"));
+
+  filter = modulemd_filter_new ();
+  modulemd_filter_add_doctype (filter, MODULEMD_TYPE_MODULESTREAM);
+  g_assert_cmpuint (
+    modulemd_filter_get_sections (filter), ==, MODULEMD_SECTION_ALL);
+
+  /* Every optional section is present by default */
+  objects =
+    modulemd_objects_from_file_filtered (yaml_path, filter, NULL, &error);
+  g_assert_nonnull (objects);
+  g_assert_null (error);
+  g_assert_cmpuint (objects->len, >, 0);
+
+  stream = MODULEMD_MODULESTREAM (g_ptr_array_index (objects, 0));
+  g_assert_nonnull (modulemd_modulestream_peek_description (stream));
+  g_assert_cmpuint (
+    g_hash_table_size (modulemd_modulestream_peek_xmd (stream)), >, 0);
+  g_assert_cmpuint (
+    g_hash_table_size (modulemd_modulestream_peek_rpm_components (stream)),
+    >,
+    0);
+  artifacts = modulemd_modulestream_peek_rpm_artifacts (stream);
+  g_assert_cmpuint (modulemd_simpleset_size (artifacts), >, 0);
+
+  /* Leaving them all out must not affect anything else */
+  modulemd_filter_set_sections (filter, 0);
+  g_clear_pointer (&objects, g_ptr_array_unref);
+  objects =
+    modulemd_objects_from_file_filtered (yaml_path, filter, NULL, &error);
+  g_assert_nonnull (objects);
+  g_assert_null (error);
+
+  for (gsize i = 0; i < objects->len; i++)
+    {
+      stream = MODULEMD_MODULESTREAM (g_ptr_array_index (objects, i));
+      n_streams++;
+
+      g_assert_nonnull (modulemd_modulestream_peek_summary (stream));
+      g_assert_null (modulemd_modulestream_peek_description (stream));
+      g_assert_cmpuint (
+        g_hash_table_size (modulemd_modulestream_peek_xmd (stream)), ==, 0);
+      g_assert_cmpuint (
+        g_hash_table_size (modulemd_modulestream_peek_rpm_components (stream)),
+        ==,
+        0);
+      components = modulemd_modulestream_peek_module_components (stream);
+      g_assert_cmpuint (g_hash_table_size (components), ==, 0);
+
+      artifacts = modulemd_modulestream_peek_rpm_artifacts (stream);
+      g_assert_cmpuint (modulemd_simpleset_size (artifacts), ==, 0);
+    }
+  g_assert_cmpuint (n_streams, ==, 3);
+
+  stream = MODULEMD_MODULESTREAM (g_ptr_array_index (objects, 0));
+  g_assert_cmpstr (modulemd_modulestream_peek_name (stream), ==, "foo");
+  g_assert_cmpstr (
+    modulemd_modulestream_peek_summary (stream), ==, "An example module");
+  g_assert_cmpuint (
+    g_hash_table_size (modulemd_modulestream_peek_profiles (stream)), >, 0);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  setlocale (LC_ALL, "");
+
+  g_test_init (&argc, &argv, NULL);
+  g_test_bug_base ("https://bugzilla.redhat.com/show_bug.cgi?id=");
+
+  g_test_add ("/modulemd/filter/test_module_names",
+              FilterFixture,
+              NULL,
+              NULL,
+              modulemd_filter_test_module_names,
+              NULL);
+
+  g_test_add ("/modulemd/filter/test_doctype",
+              FilterFixture,
+              NULL,
+              NULL,
+              modulemd_filter_test_doctype,
+              NULL);
+
+  g_test_add ("/modulemd/filter/test_arch",
+              FilterFixture,
+              NULL,
+              NULL,
+              modulemd_filter_test_arch,
+              NULL);
+
+  g_test_add ("/modulemd/filter/test_sections",
+              FilterFixture,
+              NULL,
+              NULL,
+              modulemd_filter_test_sections,
+              NULL);
+
+  return g_test_run ();
+}
@@ -0,0 +1,332 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2017-2018 Stephen Gallagher
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+#define MMD_DISABLE_DEPRECATION_WARNINGS 1
+#include "modulemd.h"
+
+#include <glib.h>
+#include <locale.h>
+
+typedef struct _IndexFixture
+{
+  ModulemdIndex *index;
+} IndexFixture;
+
+
+static void
+modulemd_index_set_up (IndexFixture *fixture, gconstpointer user_data)
+{
+  g_autofree gchar *yaml_path = NULL;
+  g_autoptr (GError) error = NULL;
+
+  yaml_path = g_strdup_printf ("%s/test_data/long-valid.yaml",
+                               g_getenv ("MESON_SOURCE_ROOT"));
+  fixture->index = modulemd_index_new_from_file (yaml_path, NULL, &error);
+  g_assert_nonnull (fixture->index);
+  g_assert_null (error);
+}
+
+
+static void
+modulemd_index_tear_down (IndexFixture *fixture, gconstpointer user_data)
+{
+  g_clear_object (&fixture->index);
+}
+
+
+static void
+modulemd_index_test_nsvc (IndexFixture *fixture, gconstpointer user_data)
+{
+  g_autoptr (GHashTable) modules = NULL;
+  g_autoptr (GHashTable) streams = NULL;
+  g_autoptr (ModulemdModuleStream) found = NULL;
+  g_autofree gchar *nsvc = NULL;
+  ModulemdImprovedModule *module = NULL;
+  ModulemdModuleStream *stream = NULL;
+  const gchar *name = NULL;
+  GHashTableIter iter;
+  GHashTableIter stream_iter;
+  gpointer value;
+  gpointer stream_value;
+  guint n_streams = 0;
+
+  modules = modulemd_index_get_modules (fixture->index);
+  g_assert_cmpuint (g_hash_table_size (modules), ==, 3);
+
+  /* Every stream can be found by its NSVC */
+  g_hash_table_iter_init (&iter, modules);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+      module = MODULEMD_IMPROVEDMODULE (value);
+      name = modulemd_improvedmodule_peek_name (module);
+      g_assert_true (modulemd_index_peek_module (fixture->index, name) ==
+                     module);
+
+      streams = modulemd_improvedmodule_get_streams (module);
+      g_hash_table_iter_init (&stream_iter, streams);
+      while (g_hash_table_iter_next (&stream_iter, NULL, &stream_value))
+        {
+          stream = MODULEMD_MODULESTREAM (stream_value);
+          nsvc = modulemd_modulestream_get_nsvc (stream);
+          g_assert_true (modulemd_index_peek_stream_by_nsvc (
+                           fixture->index, nsvc) == stream);
+          g_clear_pointer (&nsvc, g_free);
+          n_streams++;
+        }
+      g_clear_pointer (&streams, g_hash_table_unref);
+    }
+  g_assert_cmpuint (n_streams, ==, 5);
+
+  module = modulemd_index_peek_module (fixture->index, "nodejs");
+  stream = modulemd_improvedmodule_get_stream_by_name (module, "8");
+  nsvc = modulemd_modulestream_get_nsvc (stream);
+  found = modulemd_index_get_stream_by_nsvc (fixture->index, nsvc);
+  g_assert_nonnull (found);
+  g_assert_cmpstr (modulemd_modulestream_peek_stream (found), ==, "8");
+  g_object_unref (stream);
+
+  g_assert_null (
+    modulemd_index_peek_stream_by_nsvc (fixture->index, "nodejs:8:1:nosuch"));
+  g_assert_null (modulemd_index_peek_module (fixture->index, "nosuch"));
+  g_assert_null (modulemd_index_get_module (fixture->index, "nosuch"));
+}
+
+
+static void
+modulemd_index_test_nevra (IndexFixture *fixture, gconstpointer user_data)
+{
+  g_autoptr (GPtrArray) streams = NULL;
+  GPtrArray *peeked = NULL;
+  ModulemdModuleStream *stream = NULL;
+
+  peeked = modulemd_index_peek_streams_by_nevra (
+    fixture->index, "nodejs-1:8.10.0-3.module_1572+d7ec111e.x86_64");
+  g_assert_nonnull (peeked);
+  g_assert_cmpuint (peeked->len, ==, 1);
+  stream = g_ptr_array_index (peeked, 0);
+  g_assert_cmpstr (modulemd_modulestream_peek_name (stream), ==, "nodejs");
+  g_assert_cmpstr (modulemd_modulestream_peek_stream (stream), ==, "8");
+
+  streams = modulemd_index_get_streams_by_nevra (
+    fixture->index, "nodejs-1:8.10.0-3.module_1572+d7ec111e.x86_64");
+  g_assert_cmpuint (streams->len, ==, 1);
+  g_assert_true (g_ptr_array_index (streams, 0) == stream);
+  g_clear_pointer (&streams, g_ptr_array_unref);
+
+  /* RPM names alone are not artifacts */
+  g_assert_null (modulemd_index_peek_streams_by_nevra (fixture->index, "npm"));
+  streams = modulemd_index_get_streams_by_nevra (fixture->index, "npm");
+  g_assert_nonnull (streams);
+  g_assert_cmpuint (streams->len, ==, 0);
+}
+
+
+static void
+modulemd_index_test_profile_rpm (IndexFixture *fixture,
+                                 gconstpointer user_data)
+{
+  g_autoptr (GPtrArray) streams = NULL;
+  ModulemdModuleStream *stream = NULL;
+
+  /* Each nodejs stream appears once, although several of its profiles list
+   * the same RPM
+   */
+  streams = modulemd_index_get_streams_by_profile_rpm (fixture->index, "npm");
+  g_assert_cmpuint (streams->len, ==, 3);
+  for (gsize i = 0; i < streams->len; i++)
+    {
+      stream = g_ptr_array_index (streams, i);
+      g_assert_cmpstr (modulemd_modulestream_peek_name (stream), ==, "nodejs");
+    }
+
+  /* Streams are ordered by module name and then by stream name */
+  g_assert_cmpstr (
+    modulemd_modulestream_peek_stream (g_ptr_array_index (streams, 0)),
+    ==,
+    "6");
+  g_assert_cmpstr (
+    modulemd_modulestream_peek_stream (g_ptr_array_index (streams, 2)),
+    ==,
+    "9");
+
+  g_assert_null (
+    modulemd_index_peek_streams_by_profile_rpm (fixture->index, "nosuch"));
+}
+
+
+static void
+modulemd_index_test_dependents (IndexFixture *fixture,
+                                gconstpointer user_data)
+{
+  g_autoptr (GPtrArray) streams = NULL;
+
+  /* Every stream in the file requires and buildrequires platform:f28 */
+  streams = modulemd_index_get_dependents (
+    fixture->index, "platform", "f28", MODULEMD_DEPENDENCY_REQUIRES);
+  g_assert_cmpuint (streams->len, ==, 5);
+  g_assert_cmpstr (
+    modulemd_modulestream_peek_name (g_ptr_array_index (streams, 0)),
+    ==,
+    "django");
+  g_clear_pointer (&streams, g_ptr_array_unref);
+
+  streams = modulemd_index_get_dependents (
+    fixture->index, "platform", "f27", MODULEMD_DEPENDENCY_ALL);
+  g_assert_cmpuint (streams->len, ==, 0);
+  g_clear_pointer (&streams, g_ptr_array_unref);
+
+  streams = modulemd_index_get_dependents (
+    fixture->index, "django", "1.6", MODULEMD_DEPENDENCY_BUILDREQUIRES);
+  g_assert_cmpuint (streams->len, ==, 1);
+  g_assert_cmpstr (
+    modulemd_modulestream_peek_name (g_ptr_array_index (streams, 0)),
+    ==,
+    "reviewboard");
+}
+
+
+static ModulemdImprovedModule *
+_make_module (const gchar *name,
+              const gchar *stream_name,
+              ModulemdDependencies *deps)
+{
+  g_autoptr (ModulemdModuleStream) stream = NULL;
+  ModulemdImprovedModule *module = NULL;
+
+  stream = modulemd_modulestream_new ();
+  modulemd_modulestream_set_mdversion (stream, 2);
+  modulemd_modulestream_set_name (stream, name);
+  modulemd_modulestream_set_stream (stream, stream_name);
+  modulemd_modulestream_set_version (stream, 1);
+  if (deps)
+    modulemd_modulestream_add_dependencies (stream, deps);
+
+  module = modulemd_improvedmodule_new (name);
+  modulemd_improvedmodule_add_stream (module, stream);
+  return module;
+}
+
+
+static void
+modulemd_index_test_transitive_dependents (void)
+{
+  g_autoptr (GHashTable) modules = NULL;
+  g_autoptr (ModulemdIndex) index = NULL;
+  g_autoptr (GPtrArray) streams = NULL;
+  g_autoptr (ModulemdDependencies) base_deps = NULL;
+  g_autoptr (ModulemdDependencies) app_deps = NULL;
+  g_autoptr (ModulemdDependencies) tool_deps = NULL;
+  const gchar *not_f27[] = { "-f27", NULL };
+  const gchar *any_stream[] = { NULL };
+
+  /* base requires any platform but f27, app requires base:1 and tool
+   * buildrequires any stream of app
+   */
+  base_deps = modulemd_dependencies_new ();
+  modulemd_dependencies_add_requires (base_deps, "platform", not_f27);
+  app_deps = modulemd_dependencies_new ();
+  modulemd_dependencies_add_requires_single (app_deps, "base", "1");
+  tool_deps = modulemd_dependencies_new ();
+  modulemd_dependencies_add_buildrequires (tool_deps, "app", any_stream);
+
+  modules = g_hash_table_new_full (
+    g_str_hash, g_str_equal, g_free, g_object_unref);
+  g_hash_table_insert (
+    modules, g_strdup ("base"), _make_module ("base", "1", base_deps));
+  g_hash_table_insert (
+    modules, g_strdup ("app"), _make_module ("app", "1", app_deps));
+  g_hash_table_insert (
+    modules, g_strdup ("tool"), _make_module ("tool", "1", tool_deps));
+
+  index = modulemd_index_new (modules);
+
+  streams = modulemd_index_get_dependents (
+    index, "platform", "f27", MODULEMD_DEPENDENCY_ALL);
+  g_assert_cmpuint (streams->len, ==, 0);
+  g_clear_pointer (&streams, g_ptr_array_unref);
+
+  /* The result for app:1 is remembered and reused below */
+  streams = modulemd_index_get_transitive_dependents (
+    index, "app", "1", MODULEMD_DEPENDENCY_ALL);
+  g_assert_cmpuint (streams->len, ==, 1);
+  g_clear_pointer (&streams, g_ptr_array_unref);
+
+  streams = modulemd_index_get_transitive_dependents (
+    index, "platform", "f28", MODULEMD_DEPENDENCY_ALL);
+  g_assert_cmpuint (streams->len, ==, 3);
+  g_assert_cmpstr (
+    modulemd_modulestream_peek_name (g_ptr_array_index (streams, 0)),
+    ==,
+    "app");
+  g_assert_cmpstr (
+    modulemd_modulestream_peek_name (g_ptr_array_index (streams, 1)),
+    ==,
+    "base");
+  g_assert_cmpstr (
+    modulemd_modulestream_peek_name (g_ptr_array_index (streams, 2)),
+    ==,
+    "tool");
+  g_clear_pointer (&streams, g_ptr_array_unref);
+
+  /* Only run-time dependencies are followed */
+  streams = modulemd_index_get_transitive_dependents (
+    index, "platform", "f28", MODULEMD_DEPENDENCY_REQUIRES);
+  g_assert_cmpuint (streams->len, ==, 2);
+  g_clear_pointer (&streams, g_ptr_array_unref);
+
+  streams = modulemd_index_get_transitive_dependents (
+    index, "platform", "f27", MODULEMD_DEPENDENCY_ALL);
+  g_assert_cmpuint (streams->len, ==, 0);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  setlocale (LC_ALL, "");
+
+  g_test_init (&argc, &argv, NULL);
+  g_test_bug_base ("https://bugzilla.redhat.com/show_bug.cgi?id=");
+
+  g_test_add ("/modulemd/index/test_nsvc",
+              IndexFixture,
+              NULL,
+              modulemd_index_set_up,
+              modulemd_index_test_nsvc,
+              modulemd_index_tear_down);
+
+  g_test_add ("/modulemd/index/test_nevra",
+              IndexFixture,
+              NULL,
+              modulemd_index_set_up,
+              modulemd_index_test_nevra,
+              modulemd_index_tear_down);
+
+  g_test_add ("/modulemd/index/test_profile_rpm",
+              IndexFixture,
+              NULL,
+              modulemd_index_set_up,
+              modulemd_index_test_profile_rpm,
+              modulemd_index_tear_down);
+
+  g_test_add ("/modulemd/index/test_dependents",
+              IndexFixture,
+              NULL,
+              modulemd_index_set_up,
+              modulemd_index_test_dependents,
+              modulemd_index_tear_down);
+
+  g_test_add_func ("/modulemd/index/test_transitive_dependents",
+                   modulemd_index_test_transitive_dependents);
+
+  return g_test_run ();
+}
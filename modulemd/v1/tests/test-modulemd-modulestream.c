@@ -262,6 +262,217 @@ modulemd_stream_test_basic (StreamFixture *fixture, gconstpointer user_data)
                    "https://pagure.io/bar.git");
 }
 
+static gpointer
+_peek_xmd_thread (gpointer data)
+{
+  return modulemd_modulestream_peek_xmd (MODULEMD_MODULESTREAM (data));
+}
+
+static void
+modulemd_stream_test_lazy_xmd (StreamFixture *fixture,
+                               gconstpointer user_data)
+{
+  g_autoptr (ModulemdModuleStream) modulestream = NULL;
+  g_autoptr (ModulemdModuleStream) copy = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *yaml = NULL;
+  g_autofree gchar *copy_yaml = NULL;
+  g_autofree gchar *changed_yaml = NULL;
+  GHashTable *xmd = NULL;
+  GVariant *value = NULL;
+  GThread *threads[4];
+  const gchar *input =
+    "---\ndocument: modulemd\nversion: 2\ndata:\n  name: foo\n  stream: "
+    "bar\n  version: 1\n  summary: A module\n  description: A module\n  "
+    "license:\n    module: [MIT]\n  xmd:\n    zebra: '1'\n    alpha: [b, "
+    "a]\n    mbs:\n      enabled: true\n...\n";
+  const gchar *passed_through =
+    "  xmd:\n    zebra: '1'\n    alpha: [b, a]\n    mbs:\n      enabled: "
+    "true\n";
+
+  modulestream = modulemd_modulestream_new ();
+  g_assert_true (modulemd_modulestream_import_from_string (
+    modulestream, input, &failures, &error));
+  g_assert_null (error);
+
+  /* An xmd block that was never read is written out as it was read */
+  yaml = modulemd_modulestream_dumps (modulestream, &error);
+  g_assert_nonnull (yaml);
+  g_assert_nonnull (g_strstr_len (yaml, -1, passed_through));
+
+  /* Copies share it until one of them reads it */
+  copy = modulemd_modulestream_copy (modulestream);
+  copy_yaml = modulemd_modulestream_dumps (copy, &error);
+  g_assert_cmpstr (copy_yaml, ==, yaml);
+
+  xmd = modulemd_modulestream_peek_xmd (copy);
+  g_assert_nonnull (xmd);
+  g_assert_cmpuint (g_hash_table_size (xmd), ==, 3);
+  value = g_hash_table_lookup (xmd, "zebra");
+  g_assert_nonnull (value);
+  g_assert_cmpstr (g_variant_get_string (value, NULL), ==, "1");
+  g_assert_true (g_variant_is_of_type (g_hash_table_lookup (xmd, "mbs"),
+                                       G_VARIANT_TYPE_DICTIONARY));
+
+  /* Once it has been read, it is emitted from the hash table */
+  changed_yaml = modulemd_modulestream_dumps (copy, &error);
+  g_assert_nonnull (changed_yaml);
+  g_assert_null (g_strstr_len (changed_yaml, -1, passed_through));
+  g_assert_nonnull (g_strstr_len (changed_yaml, -1, "  xmd:\n    alpha:"));
+
+  g_clear_pointer (&yaml, g_free);
+  yaml = modulemd_modulestream_dumps (modulestream, &error);
+  g_assert_nonnull (g_strstr_len (yaml, -1, passed_through));
+
+  /* Threads reading the xmd at the same time all get the same table */
+  g_clear_object (&copy);
+  copy = modulemd_modulestream_copy (modulestream);
+  for (guint i = 0; i < G_N_ELEMENTS (threads); i++)
+    threads[i] = g_thread_new ("xmd", _peek_xmd_thread, copy);
+  xmd = g_thread_join (threads[0]);
+  g_assert_nonnull (xmd);
+  for (guint i = 1; i < G_N_ELEMENTS (threads); i++)
+    g_assert_true (g_thread_join (threads[i]) == xmd);
+  g_assert_true (modulemd_modulestream_peek_xmd (copy) == xmd);
+  g_assert_cmpuint (g_hash_table_size (xmd), ==, 3);
+
+  /* Problems with the xmd are still found while parsing */
+  g_clear_object (&modulestream);
+  g_clear_pointer (&failures, g_ptr_array_unref);
+  modulestream = modulemd_modulestream_new ();
+  g_assert_false (modulemd_modulestream_import_from_string (
+    modulestream,
+    "---\ndocument: modulemd\nversion: 2\ndata:\n  name: foo\n  summary: "
+    "A module\n  description: A module\n  license:\n    module: [MIT]\n  "
+    "xmd:\n    a: &x b\n    c: *x\n...\n",
+    &failures,
+    &error));
+  g_assert_nonnull (error);
+}
+
+static void
+modulemd_stream_test_copy_on_write (StreamFixture *fixture,
+                                    gconstpointer user_data)
+{
+  g_autoptr (ModulemdModuleStream) stream = NULL;
+  g_autoptr (ModulemdModuleStream) copy = NULL;
+  g_autoptr (ModulemdModuleStream) v1_copy = NULL;
+  g_autoptr (ModulemdProfile) profile = NULL;
+  g_autoptr (ModulemdDependencies) deps = NULL;
+  g_autoptr (ModulemdSimpleSet) api = NULL;
+  g_autoptr (GHashTable) buildrequires = NULL;
+  g_autofree gchar *yaml = NULL;
+  g_autofree gchar *copy_yaml = NULL;
+  g_autoptr (GError) error = NULL;
+  ModulemdProfile *stored_profile = NULL;
+
+  stream = modulemd_modulestream_new ();
+  modulemd_modulestream_set_mdversion (stream, MD_VERSION_2);
+  modulemd_modulestream_set_name (stream, "foo");
+  modulemd_modulestream_set_stream (stream, "bar");
+  modulemd_modulestream_set_summary (stream, "A module");
+  modulemd_modulestream_set_description (stream, "A module");
+
+  profile = modulemd_profile_new ();
+  modulemd_profile_set_name (profile, "default");
+  modulemd_profile_add_rpm (profile, "foo");
+  modulemd_modulestream_add_profile (stream, profile);
+
+  deps = modulemd_dependencies_new ();
+  modulemd_dependencies_add_buildrequires_single (deps, "platform", "f29");
+  modulemd_modulestream_add_dependencies (stream, deps);
+
+  api = modulemd_simpleset_new ();
+  modulemd_simpleset_add (api, "foo");
+  modulemd_modulestream_set_rpm_api (stream, api);
+
+  yaml = modulemd_modulestream_dumps (stream, &error);
+  g_assert_nonnull (yaml);
+
+  /* The copy shares its contents with the original */
+  copy = modulemd_modulestream_copy (stream);
+  g_assert_true (modulemd_modulestream_peek_rpm_api (copy) ==
+                 modulemd_modulestream_peek_rpm_api (stream));
+  g_assert_true (modulemd_modulestream_peek_profiles_readonly (copy) ==
+                 modulemd_modulestream_peek_profiles_readonly (stream));
+  g_assert_true (modulemd_modulestream_peek_dependencies_readonly (copy) ==
+                 modulemd_modulestream_peek_dependencies_readonly (stream));
+
+  copy_yaml = modulemd_modulestream_dumps (copy, &error);
+  g_assert_cmpstr (copy_yaml, ==, yaml);
+  g_clear_pointer (&copy_yaml, g_free);
+
+  /* Replacing a shared set only affects the stream it is replaced in */
+  modulemd_simpleset_add (api, "bar");
+  modulemd_modulestream_set_rpm_api (copy, api);
+  g_assert_true (modulemd_simpleset_contains (
+    modulemd_modulestream_peek_rpm_api (copy), "bar"));
+  g_assert_false (modulemd_simpleset_contains (
+    modulemd_modulestream_peek_rpm_api (stream), "bar"));
+
+  /* Peeking at a shared table gives the stream a private copy of it, so
+   * modifying it in place doesn't affect the other one
+   */
+  stored_profile = g_hash_table_lookup (
+    modulemd_modulestream_peek_profiles (copy), "default");
+  g_assert_true (modulemd_modulestream_peek_profiles_readonly (copy) !=
+                 modulemd_modulestream_peek_profiles_readonly (stream));
+  modulemd_profile_add_rpm (stored_profile, "baz");
+  stored_profile = g_hash_table_lookup (
+    modulemd_modulestream_peek_profiles (stream), "default");
+  g_assert_false (modulemd_simpleset_contains (
+    modulemd_profile_peek_rpms (stored_profile), "baz"));
+
+  modulemd_modulestream_add_dependencies (stream, deps);
+  g_assert_cmpuint (
+    modulemd_modulestream_peek_dependencies (stream)->len, ==, 2);
+  g_assert_cmpuint (
+    modulemd_modulestream_peek_dependencies (copy)->len, ==, 1);
+
+  /* A set that is still shared can be passed back to its own stream after
+   * the stream it was shared with is gone
+   */
+  g_clear_object (&copy);
+  copy = modulemd_modulestream_copy (stream);
+  g_clear_object (&copy);
+  modulemd_modulestream_set_rpm_api (
+    stream, modulemd_modulestream_peek_rpm_api (stream));
+  g_assert_true (modulemd_simpleset_contains (
+    modulemd_modulestream_peek_rpm_api (stream), "foo"));
+
+  /* Version 1 dependencies are shared the same way */
+  g_clear_object (&stream);
+  stream = modulemd_modulestream_new ();
+  modulemd_modulestream_set_mdversion (stream, MD_VERSION_1);
+  buildrequires =
+    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+  g_hash_table_replace (
+    buildrequires, g_strdup ("platform"), g_strdup ("f28"));
+  modulemd_modulestream_set_buildrequires (stream, buildrequires);
+
+  v1_copy = modulemd_modulestream_copy (stream);
+  g_assert_true (
+    modulemd_modulestream_peek_buildrequires_readonly (v1_copy) ==
+    modulemd_modulestream_peek_buildrequires_readonly (stream));
+  g_assert_true (modulemd_modulestream_peek_buildrequires (v1_copy) !=
+                 modulemd_modulestream_peek_buildrequires (stream));
+  g_clear_object (&v1_copy);
+
+  /* A table that was shared can be replaced after its other stream is gone */
+  v1_copy = modulemd_modulestream_copy (stream);
+  g_clear_object (&v1_copy);
+
+  g_hash_table_replace (
+    buildrequires, g_strdup ("platform"), g_strdup ("f29"));
+  modulemd_modulestream_set_buildrequires (stream, buildrequires);
+  g_assert_cmpstr (
+    g_hash_table_lookup (modulemd_modulestream_peek_buildrequires (stream),
+                         "platform"),
+    ==,
+    "f29");
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -278,5 +489,19 @@ main (int argc, char *argv[])
               modulemd_stream_test_basic,
               NULL);
 
+  g_test_add ("/modulemd/modulestream/lazy_xmd",
+              StreamFixture,
+              NULL,
+              NULL,
+              modulemd_stream_test_lazy_xmd,
+              NULL);
+
+  g_test_add ("/modulemd/modulestream/copy_on_write",
+              StreamFixture,
+              NULL,
+              NULL,
+              modulemd_stream_test_copy_on_write,
+              NULL);
+
   return g_test_run ();
 };
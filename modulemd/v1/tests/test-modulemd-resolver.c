@@ -0,0 +1,320 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2017-2018 Stephen Gallagher
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+#define MMD_DISABLE_DEPRECATION_WARNINGS 1
+#include "modulemd.h"
+
+#include <glib.h>
+#include <locale.h>
+#include <string.h>
+
+typedef struct _ResolverFixture
+{
+  ModulemdResolver *resolver;
+} ResolverFixture;
+
+
+static void
+_add_stream (GHashTable *modules,
+             const gchar *name,
+             const gchar *stream_name,
+             const gchar *context,
+             const gchar *requires_module,
+             const gchar **requires_streams)
+{
+  g_autoptr (ModulemdModuleStream) stream = NULL;
+  g_autoptr (ModulemdDependencies) deps = NULL;
+  ModulemdImprovedModule *module = NULL;
+
+  stream = modulemd_modulestream_new ();
+  modulemd_modulestream_set_mdversion (stream, 2);
+  modulemd_modulestream_set_name (stream, name);
+  modulemd_modulestream_set_stream (stream, stream_name);
+  modulemd_modulestream_set_version (stream, 1);
+  modulemd_modulestream_set_context (stream, context);
+
+  if (requires_module)
+    {
+      deps = modulemd_dependencies_new ();
+      modulemd_dependencies_add_requires (
+        deps, requires_module, requires_streams);
+      modulemd_modulestream_add_dependencies (stream, deps);
+    }
+
+  module = g_hash_table_lookup (modules, name);
+  if (!module)
+    {
+      module = modulemd_improvedmodule_new (name);
+      g_hash_table_insert (modules, g_strdup (name), module);
+    }
+  modulemd_improvedmodule_add_stream (module, stream);
+}
+
+
+static void
+modulemd_resolver_set_up (ResolverFixture *fixture, gconstpointer user_data)
+{
+  g_autoptr (GHashTable) modules = NULL;
+  g_autoptr (ModulemdDefaults) defaults = NULL;
+  g_autoptr (ModulemdIndex) index = NULL;
+  const gchar *f27[] = { "f27", NULL };
+  const gchar *not_f27[] = { "-f27", NULL };
+  const gchar *any_stream[] = { NULL };
+  const gchar *f28[] = { "f28", NULL };
+  const gchar *stream_1[] = { "1", NULL };
+
+  /* a:1 requires platform:f27 and a:2, its default stream, requires any
+   * other platform. b:1 requires any stream of a, and c:1 requires a:1. e:1
+   * has a context for each of platform:f27 and platform:f28.
+   */
+  modules = g_hash_table_new_full (
+    g_str_hash, g_str_equal, g_free, g_object_unref);
+  _add_stream (modules, "a", "1", NULL, "platform", f27);
+  _add_stream (modules, "a", "2", NULL, "platform", not_f27);
+  _add_stream (modules, "b", "1", NULL, "a", any_stream);
+  _add_stream (modules, "c", "1", NULL, "a", stream_1);
+  _add_stream (modules, "d", "1", NULL, NULL, NULL);
+  _add_stream (modules, "e", "1", "c27", "platform", f27);
+  _add_stream (modules, "e", "1", "c28", "platform", f28);
+
+  defaults = modulemd_defaults_new ();
+  modulemd_defaults_set_module_name (defaults, "a");
+  modulemd_defaults_set_default_stream (defaults, "2");
+  modulemd_improvedmodule_set_defaults (g_hash_table_lookup (modules, "a"),
+                                        defaults);
+
+  index = modulemd_index_new (modules);
+  fixture->resolver = modulemd_resolver_new (index);
+}
+
+
+static void
+modulemd_resolver_tear_down (ResolverFixture *fixture,
+                             gconstpointer user_data)
+{
+  g_clear_object (&fixture->resolver);
+}
+
+
+static gchar *
+_selection_string (GPtrArray *streams)
+{
+  g_autoptr (GString) str = g_string_new (NULL);
+  ModulemdModuleStream *stream = NULL;
+
+  for (gsize i = 0; i < streams->len; i++)
+    {
+      stream = g_ptr_array_index (streams, i);
+      g_string_append_printf (str,
+                              "%s%s:%s",
+                              i ? " " : "",
+                              modulemd_modulestream_peek_name (stream),
+                              modulemd_modulestream_peek_stream (stream));
+    }
+
+  return g_string_free (g_steal_pointer (&str), FALSE);
+}
+
+
+static void
+modulemd_resolver_test_defaults (ResolverFixture *fixture,
+                                 gconstpointer user_data)
+{
+  g_autoptr (GPtrArray) streams = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *selection = NULL;
+  const gchar *requests[] = { "platform:f28", "b", NULL };
+  const gchar *explicit_requests[] = { "platform:f28", "b:1", "d:1", NULL };
+
+  /* The default stream of a is chosen for b */
+  streams = modulemd_resolver_resolve (fixture->resolver, requests, &error);
+  g_assert_nonnull (streams);
+  g_assert_null (error);
+  selection = _selection_string (streams);
+  g_assert_cmpstr (selection, ==, "a:2 b:1");
+  g_clear_pointer (&streams, g_ptr_array_unref);
+  g_clear_pointer (&selection, g_free);
+
+  streams =
+    modulemd_resolver_resolve (fixture->resolver, explicit_requests, &error);
+  g_assert_nonnull (streams);
+  g_assert_null (error);
+  selection = _selection_string (streams);
+  g_assert_cmpstr (selection, ==, "a:2 b:1 d:1");
+}
+
+
+static void
+modulemd_resolver_test_backtrack (ResolverFixture *fixture,
+                                  gconstpointer user_data)
+{
+  g_autoptr (GPtrArray) streams = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *selection = NULL;
+  const gchar *requests[] = { "b", "platform:f27", NULL };
+  const gchar *both_requests[] = { "platform:f27", "b", "c", NULL };
+
+  /* The default stream of a excludes f27, so a:1 is chosen instead */
+  streams = modulemd_resolver_resolve (fixture->resolver, requests, &error);
+  g_assert_nonnull (streams);
+  g_assert_null (error);
+  selection = _selection_string (streams);
+  g_assert_cmpstr (selection, ==, "a:1 b:1");
+  g_clear_pointer (&streams, g_ptr_array_unref);
+  g_clear_pointer (&selection, g_free);
+
+  streams =
+    modulemd_resolver_resolve (fixture->resolver, both_requests, &error);
+  g_assert_nonnull (streams);
+  g_assert_null (error);
+  selection = _selection_string (streams);
+  g_assert_cmpstr (selection, ==, "a:1 b:1 c:1");
+}
+
+
+static void
+modulemd_resolver_test_conflicts (ResolverFixture *fixture,
+                                  gconstpointer user_data)
+{
+  g_autoptr (GPtrArray) streams = NULL;
+  g_autoptr (GError) error = NULL;
+  const gchar *conflicting[] = { "platform:f28", "c:1", NULL };
+  const gchar *two_streams[] = { "platform:f28", "a:1", "a:2", NULL };
+  const gchar *no_platform[] = { "b", NULL };
+  const gchar *two_platforms[] = { "platform:f27", "platform:f28", NULL };
+  const gchar *unknown_stream[] = { "a:3", NULL };
+  const gchar *unknown_module[] = { "nosuch", NULL };
+
+  /* c:1 needs a:1, which needs platform:f27 */
+  streams = modulemd_resolver_resolve (fixture->resolver, conflicting, &error);
+  g_assert_null (streams);
+  g_assert_error (
+    error, MODULEMD_RESOLVER_ERROR, MODULEMD_RESOLVER_UNSATISFIABLE);
+  g_assert_nonnull (strstr (error->message, "a:1"));
+  g_assert_nonnull (strstr (error->message, "platform"));
+  g_clear_error (&error);
+
+  streams = modulemd_resolver_resolve (fixture->resolver, two_streams, &error);
+  g_assert_null (streams);
+  g_assert_error (
+    error, MODULEMD_RESOLVER_ERROR, MODULEMD_RESOLVER_UNSATISFIABLE);
+  g_clear_error (&error);
+
+  /* Modules that aren't in the index are only available if requested */
+  streams = modulemd_resolver_resolve (fixture->resolver, no_platform, &error);
+  g_assert_null (streams);
+  g_assert_error (
+    error, MODULEMD_RESOLVER_ERROR, MODULEMD_RESOLVER_UNSATISFIABLE);
+  g_clear_error (&error);
+
+  streams =
+    modulemd_resolver_resolve (fixture->resolver, two_platforms, &error);
+  g_assert_null (streams);
+  g_assert_error (
+    error, MODULEMD_RESOLVER_ERROR, MODULEMD_RESOLVER_UNSATISFIABLE);
+  g_clear_error (&error);
+
+  streams =
+    modulemd_resolver_resolve (fixture->resolver, unknown_stream, &error);
+  g_assert_null (streams);
+  g_assert_error (
+    error, MODULEMD_RESOLVER_ERROR, MODULEMD_RESOLVER_INVALID_REQUEST);
+  g_clear_error (&error);
+
+  streams =
+    modulemd_resolver_resolve (fixture->resolver, unknown_module, &error);
+  g_assert_null (streams);
+  g_assert_error (
+    error, MODULEMD_RESOLVER_ERROR, MODULEMD_RESOLVER_INVALID_REQUEST);
+}
+
+
+static void
+modulemd_resolver_test_contexts (ResolverFixture *fixture,
+                                 gconstpointer user_data)
+{
+  g_autoptr (GPtrArray) streams = NULL;
+  g_autoptr (GError) error = NULL;
+  ModulemdModuleStream *stream = NULL;
+  const gchar *f27_requests[] = { "platform:f27", "e:1", NULL };
+  const gchar *f28_requests[] = { "platform:f28", "e", NULL };
+  const gchar *f29_requests[] = { "platform:f29", "e:1", NULL };
+
+  /* Each context of e:1 is a candidate of its own */
+  streams =
+    modulemd_resolver_resolve (fixture->resolver, f27_requests, &error);
+  g_assert_nonnull (streams);
+  g_assert_null (error);
+  g_assert_cmpint (streams->len, ==, 1);
+  stream = g_ptr_array_index (streams, 0);
+  g_assert_cmpstr (modulemd_modulestream_peek_name (stream), ==, "e");
+  g_assert_cmpstr (modulemd_modulestream_peek_context (stream), ==, "c27");
+  g_clear_pointer (&streams, g_ptr_array_unref);
+
+  streams =
+    modulemd_resolver_resolve (fixture->resolver, f28_requests, &error);
+  g_assert_nonnull (streams);
+  g_assert_null (error);
+  g_assert_cmpint (streams->len, ==, 1);
+  stream = g_ptr_array_index (streams, 0);
+  g_assert_cmpstr (modulemd_modulestream_peek_name (stream), ==, "e");
+  g_assert_cmpstr (modulemd_modulestream_peek_context (stream), ==, "c28");
+  g_clear_pointer (&streams, g_ptr_array_unref);
+
+  /* Neither context accepts platform:f29 */
+  streams =
+    modulemd_resolver_resolve (fixture->resolver, f29_requests, &error);
+  g_assert_null (streams);
+  g_assert_error (
+    error, MODULEMD_RESOLVER_ERROR, MODULEMD_RESOLVER_UNSATISFIABLE);
+  g_assert_nonnull (strstr (error->message, "platform"));
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  setlocale (LC_ALL, "");
+
+  g_test_init (&argc, &argv, NULL);
+  g_test_bug_base ("https://bugzilla.redhat.com/show_bug.cgi?id=");
+
+  g_test_add ("/modulemd/resolver/test_defaults",
+              ResolverFixture,
+              NULL,
+              modulemd_resolver_set_up,
+              modulemd_resolver_test_defaults,
+              modulemd_resolver_tear_down);
+
+  g_test_add ("/modulemd/resolver/test_backtrack",
+              ResolverFixture,
+              NULL,
+              modulemd_resolver_set_up,
+              modulemd_resolver_test_backtrack,
+              modulemd_resolver_tear_down);
+
+  g_test_add ("/modulemd/resolver/test_conflicts",
+              ResolverFixture,
+              NULL,
+              modulemd_resolver_set_up,
+              modulemd_resolver_test_conflicts,
+              modulemd_resolver_tear_down);
+
+  g_test_add ("/modulemd/resolver/test_contexts",
+              ResolverFixture,
+              NULL,
+              modulemd_resolver_set_up,
+              modulemd_resolver_test_contexts,
+              modulemd_resolver_tear_down);
+
+  return g_test_run ();
+}
@@ -394,6 +394,60 @@ modulemd_translation_test_index (TranslationFixture *fixture,
 }
 
 
+static void
+modulemd_translation_test_index_versions (TranslationFixture *fixture,
+                                          gconstpointer user_data)
+{
+  g_autoptr (GHashTable) index = NULL;
+  g_autoptr (GHashTable) reloaded = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GPtrArray) versions = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *result_yaml = NULL;
+  g_auto (GStrv) documents = NULL;
+  ModulemdImprovedModule *module = NULL;
+  ModulemdModuleStream *stream = NULL;
+  const gchar *yaml =
+    "---\ndocument: modulemd\nversion: 2\ndata:\n  name: foo\n  stream: "
+    "bar\n  version: 1\n  summary: A module\n  description: A module\n  "
+    "license:\n    module: [MIT]\n...\n---\ndocument: modulemd\nversion: "
+    "2\ndata:\n  name: foo\n  stream: bar\n  version: 2\n  summary: A "
+    "module\n  description: A module\n  license:\n    module: "
+    "[MIT]\n...\n---\ndocument: modulemd-translations\nversion: 1\ndata:\n "
+    " module: foo\n  stream: bar\n  modified: 201805231425\n  "
+    "translations:\n    ja:\n      summary: モジュールの例\n...\n";
+
+  index = modulemd_index_from_string (yaml, &failures, &error);
+  g_assert_nonnull (index);
+  g_assert_null (error);
+
+  /* Both versions carry the translation, but it is written out once */
+  result_yaml = modulemd_dumps_index (index, &error);
+  g_assert_nonnull (result_yaml);
+  documents = g_strsplit (result_yaml, "document: modulemd-translations", -1);
+  g_assert_cmpuint (g_strv_length (documents), ==, 2);
+
+  g_clear_pointer (&failures, g_ptr_array_unref);
+  reloaded = modulemd_index_from_string (result_yaml, &failures, &error);
+  g_assert_nonnull (reloaded);
+  g_assert_null (error);
+
+  module = g_hash_table_lookup (reloaded, "foo");
+  g_assert_nonnull (module);
+  versions = modulemd_improvedmodule_get_stream_versions (module, "bar");
+  g_assert_nonnull (versions);
+  g_assert_cmpuint (versions->len, ==, 2);
+  for (guint i = 0; i < versions->len; i++)
+    {
+      stream = g_ptr_array_index (versions, i);
+      g_assert_cmpstr (
+        modulemd_modulestream_get_localized_summary (stream, "ja"),
+        ==,
+        "モジュールの例");
+    }
+}
+
+
 int
 main (int argc, char *argv[])
 {
@@ -439,5 +493,12 @@ main (int argc, char *argv[])
               modulemd_translation_test_index,
               NULL);
 
+  g_test_add ("/modulemd/translation/test_index_versions",
+              TranslationFixture,
+              NULL,
+              NULL,
+              modulemd_translation_test_index_versions,
+              NULL);
+
   return g_test_run ();
 }
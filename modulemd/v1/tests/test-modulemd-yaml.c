@@ -18,6 +18,7 @@
 #include <glib.h>
 #include <glib/gstdio.h>
 #include <locale.h>
+#include <string.h>
 
 typedef struct _YamlFixture
 {
@@ -435,6 +436,7 @@ modulemd_yaml_test_artifact_validation (YamlFixture *fixture,
   g_autoptr (GPtrArray) objects = NULL;
   g_autoptr (GPtrArray) failures = NULL;
   g_autoptr (GError) error = NULL;
+  const gchar *failed_yaml = NULL;
 
   /* Attempt to read in a modulemd with a data.artifacts.rpm section
    * containing values without the Epoch included.
@@ -451,6 +453,16 @@ modulemd_yaml_test_artifact_validation (YamlFixture *fixture,
     modulemd_subdocument_get_gerror (g_ptr_array_index (failures, 0))->message,
     ==,
     "RPM artifacts not in NEVRA format");
+
+  /* The YAML of the failed document must be available in its entirety, even
+   * though it was parsed from buffered events
+   */
+  failed_yaml =
+    modulemd_subdocument_get_yaml (g_ptr_array_index (failures, 0));
+  g_assert_nonnull (failed_yaml);
+  g_assert_nonnull (g_strstr_len (failed_yaml, -1, "document: modulemd"));
+  g_assert_nonnull (g_strstr_len (failed_yaml, -1, "name: django"));
+  g_assert_nonnull (g_strstr_len (failed_yaml, -1, "artifacts:"));
 }
 
 
@@ -482,6 +494,520 @@ modulemd_yaml_test_index_from_file (YamlFixture *fixture,
 }
 
 
+static void
+modulemd_yaml_test_index_from_file_parallel (YamlFixture *fixture,
+                                             gconstpointer user_data)
+{
+  g_autofree gchar *yaml_path = NULL;
+  g_autoptr (GHashTable) serial_index = NULL;
+  g_autoptr (GHashTable) parallel_index = NULL;
+  g_autoptr (GHashTable) serial_mixed = NULL;
+  g_autoptr (GHashTable) parallel_mixed = NULL;
+  g_autoptr (GPtrArray) serial_failures = NULL;
+  g_autoptr (GPtrArray) parallel_failures = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autoptr (GError) parallel_error = NULL;
+  g_autoptr (GPtrArray) keys = NULL;
+  ModulemdSubdocument *serial_doc = NULL;
+  ModulemdSubdocument *parallel_doc = NULL;
+
+  yaml_path = g_strdup_printf ("%s/test_data/long-valid.yaml",
+                               g_getenv ("MESON_SOURCE_ROOT"));
+  g_assert_nonnull (yaml_path);
+
+  serial_index = parse_module_index_from_file (yaml_path, NULL, &error);
+  g_assert_nonnull (serial_index);
+  g_assert_null (error);
+
+  parallel_index =
+    modulemd_index_from_file_parallel (yaml_path, 4, NULL, &error);
+  g_assert_nonnull (parallel_index);
+  g_assert_null (error);
+
+  g_assert_cmpuint (g_hash_table_size (parallel_index),
+                    ==,
+                    g_hash_table_size (serial_index));
+
+  keys = _modulemd_ordered_str_keys (serial_index, _modulemd_strcmp_sort);
+  for (gsize i = 0; i < keys->len; i++)
+    {
+      g_assert_true (
+        g_hash_table_contains (parallel_index, g_ptr_array_index (keys, i)));
+    }
+
+  /* Failures must be reported in the same order as a serial parse */
+  g_clear_pointer (&yaml_path, g_free);
+  yaml_path = g_strdup_printf ("%s/test_data/mixed-v2.yaml",
+                               g_getenv ("MESON_SOURCE_ROOT"));
+
+  serial_mixed =
+    parse_module_index_from_file (yaml_path, &serial_failures, &error);
+  parallel_mixed = modulemd_index_from_file_parallel (
+    yaml_path, 0, &parallel_failures, &parallel_error);
+
+  g_assert_nonnull (serial_failures);
+  g_assert_nonnull (parallel_failures);
+  g_assert_cmpuint (parallel_failures->len, ==, serial_failures->len);
+
+  for (gsize i = 0; i < serial_failures->len; i++)
+    {
+      serial_doc = g_ptr_array_index (serial_failures, i);
+      parallel_doc = g_ptr_array_index (parallel_failures, i);
+
+      g_assert_cmpstr (modulemd_subdocument_get_gerror (parallel_doc)->message,
+                       ==,
+                       modulemd_subdocument_get_gerror (serial_doc)->message);
+      g_assert_cmpstr (modulemd_subdocument_get_yaml (parallel_doc),
+                       ==,
+                       modulemd_subdocument_get_yaml (serial_doc));
+    }
+}
+
+
+static gsize
+split_document_count (const gchar *yaml)
+{
+  g_autoptr (GArray) boundaries = NULL;
+
+  boundaries = g_array_new (FALSE, FALSE, sizeof (gsize));
+  if (!mmd_yaml_split_documents (yaml, strlen (yaml), boundaries))
+    return 0;
+
+  return boundaries->len;
+}
+
+
+static void
+modulemd_yaml_test_split_documents (YamlFixture *fixture,
+                                    gconstpointer user_data)
+{
+  g_autofree gchar *yaml_path = NULL;
+  g_autofree gchar *serial_yaml = NULL;
+  g_autofree gchar *parallel_yaml = NULL;
+  g_autoptr (GArray) boundaries = NULL;
+  g_autoptr (GHashTable) serial_index = NULL;
+  g_autoptr (GHashTable) parallel_index = NULL;
+  g_autoptr (GError) error = NULL;
+  const gchar *yaml = "a: 1\n---\nb: 2\n...\n# c\n--- \nc: 3\n";
+
+  boundaries = g_array_new (FALSE, FALSE, sizeof (gsize));
+  g_assert_true (mmd_yaml_split_documents (yaml, strlen (yaml), boundaries));
+  g_assert_cmpuint (boundaries->len, ==, 4);
+  g_assert_cmpuint (g_array_index (boundaries, gsize, 0), ==, 0);
+  g_assert_cmpstr (yaml + g_array_index (boundaries, gsize, 1), ==,
+                   "---\nb: 2\n...\n# c\n--- \nc: 3\n");
+  g_assert_cmpstr (yaml + g_array_index (boundaries, gsize, 2), ==,
+                   "# c\n--- \nc: 3\n");
+  g_assert_cmpstr (
+    yaml + g_array_index (boundaries, gsize, 3), ==, "--- \nc: 3\n");
+
+  /* Markers are only recognized on their own at the start of a line */
+  g_assert_cmpuint (
+    split_document_count ("a: |\n  ---\nb: ---\n----\n--- c\n"), ==, 2);
+  g_assert_cmpuint (split_document_count ("---\r\na: 1\r\n---\r\n"), ==, 2);
+
+  /* Block scalars indented under a key end before a marker line */
+  g_assert_cmpuint (
+    split_document_count ("---\na: |\n  text\n---\nb: >-\n  text\n"), ==, 2);
+
+  /* The content of a root block scalar may look like a marker */
+  g_assert_cmpuint (
+    split_document_count ("--- |\ntext\n---\nb: 2\n"), ==, 0);
+  g_assert_cmpuint (
+    split_document_count ("--- !!str >-\ntext\n...\n"), ==, 0);
+  g_assert_cmpuint (
+    split_document_count ("# comment\n|\ntext\n---\nb: 2\n"), ==, 0);
+
+  /* Directives belong to the following document */
+  g_assert_cmpuint (
+    split_document_count ("a: 1\n...\n%YAML 1.1\n---\nb: 2\n"), ==, 0);
+
+  /* A file that is split into documents must parse the same as it would
+   * serially
+   */
+  yaml_path = g_strdup_printf ("%s/test_data/long-valid.yaml",
+                               g_getenv ("MESON_SOURCE_ROOT"));
+  serial_index = parse_module_index_from_file (yaml_path, NULL, &error);
+  g_assert_nonnull (serial_index);
+  parallel_index =
+    parse_module_index_from_file_parallel (yaml_path, 4, NULL, &error);
+  g_assert_nonnull (parallel_index);
+  g_assert_null (error);
+
+  serial_yaml = modulemd_dumps_index (serial_index, &error);
+  parallel_yaml = modulemd_dumps_index (parallel_index, &error);
+  g_assert_nonnull (parallel_yaml);
+  g_assert_cmpstr (parallel_yaml, ==, serial_yaml);
+}
+
+
+static void
+modulemd_yaml_test_index_from_files (YamlFixture *fixture,
+                                     gconstpointer user_data)
+{
+  g_autofree gchar *long_path = NULL;
+  g_autofree gchar *translations_path = NULL;
+  g_autofree gchar *expected = NULL;
+  g_autofree gchar *yaml = NULL;
+  g_autoptr (GPtrArray) data = NULL;
+  g_autoptr (GPtrArray) file_data = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GPtrArray) file_failures = NULL;
+  g_autoptr (GHashTable) expected_index = NULL;
+  g_autoptr (GHashTable) index = NULL;
+  g_autoptr (GError) error = NULL;
+  const gchar *paths[4] = { NULL };
+  const gchar *missing_paths[3] = { NULL };
+  guint n_failures = 0;
+
+  long_path = g_strdup_printf ("%s/test_data/long-valid.yaml",
+                               g_getenv ("MESON_SOURCE_ROOT"));
+  translations_path = g_strdup_printf ("%s/test_data/translations.yaml",
+                                       g_getenv ("MESON_SOURCE_ROOT"));
+  paths[0] = long_path;
+  paths[1] = translations_path;
+  paths[2] = long_path;
+
+  /* The result must match merging the contents of the files in order, even
+   * when the same module appears in more than one of them
+   */
+  data = g_ptr_array_new_with_free_func (g_object_unref);
+  for (gsize i = 0; paths[i]; i++)
+    {
+      g_assert_true (
+        parse_yaml_file (paths[i], &file_data, &file_failures, &error));
+      for (gsize j = 0; j < file_data->len; j++)
+        {
+          g_ptr_array_add (data,
+                           g_object_ref (g_ptr_array_index (file_data, j)));
+        }
+      n_failures += file_failures->len;
+      g_clear_pointer (&file_data, g_ptr_array_unref);
+      g_clear_pointer (&file_failures, g_ptr_array_unref);
+    }
+
+  expected_index = module_index_from_data (data, &error);
+  g_assert_nonnull (expected_index);
+  expected = modulemd_dumps_index (expected_index, &error);
+  g_assert_nonnull (expected);
+
+  for (guint n_threads = 0; n_threads <= 3; n_threads++)
+    {
+      index = modulemd_index_from_files (paths, n_threads, &failures, &error);
+      g_assert_nonnull (index);
+      g_assert_null (error);
+      g_assert_cmpuint (failures->len, ==, n_failures);
+
+      yaml = modulemd_dumps_index (index, &error);
+      g_assert_cmpstr (yaml, ==, expected);
+
+      g_clear_pointer (&yaml, g_free);
+      g_clear_pointer (&index, g_hash_table_unref);
+      g_clear_pointer (&failures, g_ptr_array_unref);
+    }
+
+  /* A file that can't be read fails the whole load */
+  missing_paths[0] = long_path;
+  missing_paths[1] = "/nonexistent/modules.yaml";
+  index = modulemd_index_from_files (missing_paths, 2, NULL, &error);
+  g_assert_null (index);
+  g_assert_nonnull (error);
+}
+
+
+typedef struct _ForeachCounts
+{
+  guint objects;
+  guint failures;
+  guint stop_after;
+} ForeachCounts;
+
+
+static gboolean
+foreach_count_cb (GObject *object, gpointer user_data, GError **error)
+{
+  ForeachCounts *counts = (ForeachCounts *)user_data;
+
+  if (MODULEMD_IS_SUBDOCUMENT (object))
+    {
+      g_assert_nonnull (
+        modulemd_subdocument_get_gerror (MODULEMD_SUBDOCUMENT (object)));
+      counts->failures++;
+    }
+  else
+    {
+      g_assert_true (MODULEMD_IS_MODULESTREAM (object) ||
+                     MODULEMD_IS_DEFAULTS (object) ||
+                     MODULEMD_IS_TRANSLATION (object));
+      counts->objects++;
+    }
+
+  if (counts->stop_after &&
+      counts->objects + counts->failures >= counts->stop_after)
+    {
+      g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_FAILED, "Stopped");
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+static void
+modulemd_yaml_test_parse_file_foreach (YamlFixture *fixture,
+                                       gconstpointer user_data)
+{
+  g_autofree gchar *yaml_path = NULL;
+  g_autoptr (GError) error = NULL;
+  ForeachCounts counts = { 0, 0, 0 };
+
+  yaml_path = g_strdup_printf ("%s/test_data/mixed-v2.yaml",
+                               g_getenv ("MESON_SOURCE_ROOT"));
+
+  g_assert_true (modulemd_parse_file_foreach (
+    yaml_path, foreach_count_cb, &counts, &error));
+  g_assert_null (error);
+  g_assert_cmpuint (counts.objects, ==, 2);
+  g_assert_cmpuint (counts.failures, ==, 7);
+
+  /* An error from the callback stops parsing and is passed through */
+  counts.objects = counts.failures = 0;
+  counts.stop_after = 3;
+
+  g_assert_false (modulemd_parse_file_foreach (
+    yaml_path, foreach_count_cb, &counts, &error));
+  g_assert_error (error, G_FILE_ERROR, G_FILE_ERROR_FAILED);
+  g_assert_cmpuint (counts.objects + counts.failures, ==, 3);
+}
+
+
+static void
+modulemd_yaml_test_index_from_data (YamlFixture *fixture,
+                                    gconstpointer user_data)
+{
+  g_autoptr (GPtrArray) data = NULL;
+  g_autoptr (GHashTable) module_index = NULL;
+  g_autoptr (GHashTable) streams = NULL;
+  g_autoptr (ModulemdTranslation) translation = NULL;
+  g_autoptr (ModulemdTranslation) stored_translation = NULL;
+  g_autoptr (GError) error = NULL;
+  ModulemdModuleStream *stream = NULL;
+  ModulemdImprovedModule *module = NULL;
+  g_autofree gchar *stream_name = NULL;
+
+  /* A module with many streams, as from a repository with a long history */
+  data = g_ptr_array_new_with_free_func (g_object_unref);
+  for (guint i = 0; i < 500; i++)
+    {
+      stream_name = g_strdup_printf ("stream%u", i);
+      stream = modulemd_modulestream_new ();
+      modulemd_modulestream_set_name (stream, "foo");
+      modulemd_modulestream_set_stream (stream, stream_name);
+      modulemd_modulestream_set_version (stream, i);
+      g_ptr_array_add (data, stream);
+      g_clear_pointer (&stream_name, g_free);
+    }
+
+  translation = modulemd_translation_new_full ("foo", "stream7", 1, 42);
+  g_ptr_array_add (data, g_object_ref (translation));
+
+  module_index = module_index_from_data (data, &error);
+  g_assert_nonnull (module_index);
+  g_assert_null (error);
+
+  module = g_hash_table_lookup (module_index, "foo");
+  g_assert_nonnull (module);
+  streams = modulemd_improvedmodule_get_streams (module);
+  g_assert_cmpuint (g_hash_table_size (streams), ==, 500);
+
+  stream = g_hash_table_lookup (streams, "stream7");
+  g_assert_nonnull (stream);
+  g_assert_cmpuint (modulemd_modulestream_get_version (stream), ==, 7);
+  stored_translation = modulemd_modulestream_get_translation (stream);
+  g_assert_nonnull (stored_translation);
+  g_assert_cmpuint (
+    modulemd_translation_get_modified (stored_translation), ==, 42);
+
+  /* The index holds its own copies of the streams */
+  modulemd_modulestream_set_version (g_ptr_array_index (data, 7), 1000);
+  g_assert_cmpuint (modulemd_modulestream_get_version (stream), ==, 7);
+}
+
+
+static ModulemdModuleStream *
+_make_stream_version (guint64 version, const gchar *context)
+{
+  ModulemdModuleStream *stream = modulemd_modulestream_new ();
+
+  modulemd_modulestream_set_name (stream, "foo");
+  modulemd_modulestream_set_stream (stream, "1");
+  modulemd_modulestream_set_version (stream, version);
+  modulemd_modulestream_set_context (stream, context);
+  return stream;
+}
+
+
+static void
+modulemd_yaml_test_index_stream_versions (YamlFixture *fixture,
+                                          gconstpointer user_data)
+{
+  g_autoptr (GPtrArray) data = NULL;
+  g_autoptr (GHashTable) module_index = NULL;
+  g_autoptr (GPtrArray) versions = NULL;
+  g_autoptr (GPtrArray) all_streams = NULL;
+  g_autoptr (ModulemdModuleStream) copy = NULL;
+  g_autoptr (ModulemdTranslation) translation = NULL;
+  g_autoptr (ModulemdTranslation) stored_translation = NULL;
+  g_autoptr (ModulemdImprovedModule) module_copy = NULL;
+  g_autoptr (GError) error = NULL;
+  ModulemdModuleStream *stream = NULL;
+  ModulemdImprovedModule *module = NULL;
+  const guint64 expected_versions[] = { 1, 2, 2, 3 };
+  const gchar *expected_contexts[] = { "a", "a", "b", "b" };
+
+  /* Builds of the same stream, added out of order, with a rebuild of one of
+   * them that replaces it
+   */
+  data = g_ptr_array_new_with_free_func (g_object_unref);
+  g_ptr_array_add (data, _make_stream_version (3, "b"));
+  g_ptr_array_add (data, _make_stream_version (1, "a"));
+  g_ptr_array_add (data, _make_stream_version (2, "b"));
+  g_ptr_array_add (data, _make_stream_version (2, "a"));
+  stream = _make_stream_version (1, "a");
+  modulemd_modulestream_set_summary (stream, "Rebuilt");
+  g_ptr_array_add (data, stream);
+
+  translation = modulemd_translation_new_full ("foo", "1", 1, 42);
+  g_ptr_array_add (data, g_object_ref (translation));
+
+  module_index = module_index_from_data (data, &error);
+  g_assert_nonnull (module_index);
+  g_assert_null (error);
+  module = g_hash_table_lookup (module_index, "foo");
+  g_assert_nonnull (module);
+
+  /* The versions are ordered by version and then by context */
+  versions = modulemd_improvedmodule_get_stream_versions (module, "1");
+  g_assert_cmpuint (versions->len, ==, 4);
+  for (gsize i = 0; i < versions->len; i++)
+    {
+      stream = g_ptr_array_index (versions, i);
+      g_assert_cmpuint (
+        modulemd_modulestream_get_version (stream), ==, expected_versions[i]);
+      g_assert_cmpstr (
+        modulemd_modulestream_peek_context (stream), ==, expected_contexts[i]);
+
+      /* The translation applies to every version of the stream */
+      stored_translation = modulemd_modulestream_get_translation (stream);
+      g_assert_nonnull (stored_translation);
+      g_clear_object (&stored_translation);
+    }
+  g_clear_pointer (&versions, g_ptr_array_unref);
+
+  stream =
+    modulemd_improvedmodule_peek_stream_by_version (module, "1", 1, "a");
+  g_assert_nonnull (stream);
+  g_assert_cmpstr (modulemd_modulestream_peek_summary (stream), ==, "Rebuilt");
+  g_assert_null (
+    modulemd_improvedmodule_peek_stream_by_version (module, "1", 1, "b"));
+
+  /* The latest version overall, and of each context */
+  stream = modulemd_improvedmodule_peek_latest_stream (module, "1", NULL);
+  g_assert_cmpuint (modulemd_modulestream_get_version (stream), ==, 3);
+  g_assert_cmpstr (modulemd_modulestream_peek_context (stream), ==, "b");
+  copy = modulemd_improvedmodule_get_stream_by_name (module, "1");
+  g_assert_cmpuint (modulemd_modulestream_get_version (copy), ==, 3);
+  g_clear_object (&copy);
+
+  copy = modulemd_improvedmodule_get_latest_stream (module, "1", "a");
+  g_assert_nonnull (copy);
+  g_assert_cmpuint (modulemd_modulestream_get_version (copy), ==, 2);
+  g_assert_null (
+    modulemd_improvedmodule_peek_latest_stream (module, "1", "nosuch"));
+
+  versions = modulemd_improvedmodule_get_stream_versions (module, "nosuch");
+  g_assert_nonnull (versions);
+  g_assert_cmpuint (versions->len, ==, 0);
+
+  /* Copies keep every version */
+  module_copy = modulemd_improvedmodule_copy (module);
+  all_streams = modulemd_improvedmodule_get_all_streams (module_copy);
+  g_assert_cmpuint (all_streams->len, ==, 4);
+}
+
+
+static void
+modulemd_yaml_test_prune_versions (YamlFixture *fixture,
+                                   gconstpointer user_data)
+{
+  g_autoptr (GPtrArray) data = NULL;
+  g_autoptr (GPtrArray) pruned = NULL;
+  g_autoptr (GPtrArray) latest = NULL;
+  g_autoptr (GPtrArray) all_streams = NULL;
+  g_autoptr (GHashTable) module_index = NULL;
+  g_autoptr (ModulemdDefaults) defaults = NULL;
+  g_autoptr (GError) error = NULL;
+  ModulemdModuleStream *stream = NULL;
+  ModulemdImprovedModule *module = NULL;
+
+  data = g_ptr_array_new_with_free_func (g_object_unref);
+  g_ptr_array_add (data, _make_stream_version (3, "b"));
+  g_ptr_array_add (data, _make_stream_version (1, "a"));
+  g_ptr_array_add (data, _make_stream_version (2, "b"));
+  g_ptr_array_add (data, _make_stream_version (2, "a"));
+  stream = _make_stream_version (1, NULL);
+  modulemd_modulestream_set_stream (stream, "2");
+  g_ptr_array_add (data, stream);
+
+  defaults = modulemd_defaults_new ();
+  modulemd_defaults_set_module_name (defaults, "foo");
+  modulemd_defaults_set_default_stream (defaults, "1");
+  g_ptr_array_add (data, g_object_ref (defaults));
+
+  /* Both contexts of version 2 are kept, as is everything that is not a
+   * module stream
+   */
+  pruned = modulemd_prune_objects (data, 2);
+  g_assert_cmpuint (pruned->len, ==, 5);
+  g_assert_true (g_ptr_array_index (pruned, 0) == g_ptr_array_index (data, 0));
+  g_assert_true (g_ptr_array_index (pruned, 1) == g_ptr_array_index (data, 2));
+  g_assert_true (g_ptr_array_index (pruned, 4) == defaults);
+  g_clear_pointer (&pruned, g_ptr_array_unref);
+
+  pruned = modulemd_prune_objects (data, 10);
+  g_assert_cmpuint (pruned->len, ==, data->len);
+
+  module_index = module_index_from_data (data, &error);
+  g_assert_nonnull (module_index);
+  g_assert_null (error);
+
+  /* The latest version of each context of each stream */
+  latest = modulemd_get_latest_streams (module_index);
+  g_assert_cmpuint (latest->len, ==, 3);
+  stream = g_ptr_array_index (latest, 0);
+  g_assert_cmpuint (modulemd_modulestream_get_version (stream), ==, 2);
+  g_assert_cmpstr (modulemd_modulestream_peek_context (stream), ==, "a");
+  stream = g_ptr_array_index (latest, 1);
+  g_assert_cmpuint (modulemd_modulestream_get_version (stream), ==, 3);
+  g_assert_cmpstr (modulemd_modulestream_peek_context (stream), ==, "b");
+  stream = g_ptr_array_index (latest, 2);
+  g_assert_cmpstr (modulemd_modulestream_peek_stream (stream), ==, "2");
+
+  /* Context "a" has no version left once only the newest one is kept */
+  modulemd_prune_index (module_index, 1);
+  module = g_hash_table_lookup (module_index, "foo");
+  all_streams = modulemd_improvedmodule_get_all_streams (module);
+  g_assert_cmpuint (all_streams->len, ==, 2);
+  g_assert_null (
+    modulemd_improvedmodule_peek_latest_stream (module, "1", "a"));
+  g_assert_null (
+    modulemd_improvedmodule_peek_stream_by_version (module, "1", 2, "b"));
+  stream = modulemd_improvedmodule_peek_latest_stream (module, "1", NULL);
+  g_assert_cmpuint (modulemd_modulestream_get_version (stream), ==, 3);
+  g_assert_nonnull (modulemd_improvedmodule_peek_defaults (module));
+}
+
+
 static void
 modulemd_yaml_test_index_from_string (YamlFixture *fixture,
                                       gconstpointer user_data)
@@ -546,6 +1072,492 @@ modulemd_yaml_test_index_from_stream (YamlFixture *fixture,
 }
 
 
+typedef struct _AsyncIndexResult
+{
+  GMainLoop *loop;
+  GHashTable *index;
+  GPtrArray *failures;
+  GError *error;
+} AsyncIndexResult;
+
+
+static void
+async_index_result_clear (AsyncIndexResult *result)
+{
+  g_clear_pointer (&result->index, g_hash_table_unref);
+  g_clear_pointer (&result->failures, g_ptr_array_unref);
+  g_clear_error (&result->error);
+}
+
+
+static void
+gfile_index_ready (GObject *source_object,
+                   GAsyncResult *res,
+                   gpointer user_data)
+{
+  AsyncIndexResult *result = user_data;
+
+  result->index = modulemd_index_from_gfile_finish (
+    res, &result->failures, &result->error);
+  g_main_loop_quit (result->loop);
+}
+
+
+static void
+input_stream_index_ready (GObject *source_object,
+                          GAsyncResult *res,
+                          gpointer user_data)
+{
+  AsyncIndexResult *result = user_data;
+
+  result->index = modulemd_index_from_input_stream_finish (
+    res, &result->failures, &result->error);
+  g_main_loop_quit (result->loop);
+}
+
+
+static void
+modulemd_yaml_test_index_async (YamlFixture *fixture, gconstpointer user_data)
+{
+  g_autofree gchar *yaml_path = NULL;
+  g_autofree gchar *expected = NULL;
+  g_autofree gchar *yaml = NULL;
+  g_autofree gchar *contents = NULL;
+  g_autoptr (GMainLoop) loop = NULL;
+  g_autoptr (GFile) file = NULL;
+  g_autoptr (GInputStream) stream = NULL;
+  g_autoptr (GCancellable) cancellable = NULL;
+  g_autoptr (GHashTable) expected_index = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GError) error = NULL;
+  AsyncIndexResult result = { NULL };
+  gsize length = 0;
+
+  yaml_path = g_strdup_printf ("%s/test_data/long-valid.yaml",
+                               g_getenv ("MESON_SOURCE_ROOT"));
+  expected_index = modulemd_index_from_file (yaml_path, &failures, &error);
+  g_assert_nonnull (expected_index);
+  expected = modulemd_dumps_index (expected_index, &error);
+  g_assert_nonnull (expected);
+
+  loop = g_main_loop_new (NULL, FALSE);
+  result.loop = loop;
+
+  /* Load from a GFile */
+  file = g_file_new_for_path (yaml_path);
+  modulemd_index_from_gfile_async (file, NULL, gfile_index_ready, &result);
+  g_main_loop_run (loop);
+
+  g_assert_nonnull (result.index);
+  g_assert_null (result.error);
+  g_assert_cmpuint (result.failures->len, ==, failures->len);
+  yaml = modulemd_dumps_index (result.index, &error);
+  g_assert_cmpstr (yaml, ==, expected);
+  g_clear_pointer (&yaml, g_free);
+  async_index_result_clear (&result);
+
+  /* Load from a GInputStream */
+  g_assert_true (g_file_get_contents (yaml_path, &contents, &length, NULL));
+  stream = g_memory_input_stream_new_from_data (contents, length, NULL);
+  modulemd_index_from_input_stream_async (
+    stream, NULL, input_stream_index_ready, &result);
+  g_main_loop_run (loop);
+
+  g_assert_nonnull (result.index);
+  g_assert_null (result.error);
+  g_assert_cmpuint (result.failures->len, ==, failures->len);
+  yaml = modulemd_dumps_index (result.index, &error);
+  g_assert_cmpstr (yaml, ==, expected);
+  async_index_result_clear (&result);
+
+  /* A cancelled load returns an error and no index */
+  cancellable = g_cancellable_new ();
+  g_cancellable_cancel (cancellable);
+  modulemd_index_from_gfile_async (
+    file, cancellable, gfile_index_ready, &result);
+  g_main_loop_run (loop);
+
+  g_assert_null (result.index);
+  g_assert_error (result.error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+  async_index_result_clear (&result);
+
+  /* So does a file that can't be read */
+  g_clear_object (&file);
+  file = g_file_new_for_path ("/nonexistent/modules.yaml");
+  modulemd_index_from_gfile_async (file, NULL, gfile_index_ready, &result);
+  g_main_loop_run (loop);
+
+  g_assert_null (result.index);
+  g_assert_nonnull (result.error);
+  async_index_result_clear (&result);
+}
+
+
+static void
+modulemd_yaml_test_string_pool (YamlFixture *fixture, gconstpointer user_data)
+{
+  g_autoptr (modulemd_string_pool) strings = NULL;
+  g_autoptr (GHashTable) module_index = NULL;
+  g_autoptr (GHashTable) streams = NULL;
+  g_autoptr (GError) error = NULL;
+  ModulemdImprovedModule *module = NULL;
+  ModulemdComponent *component = NULL;
+  const gchar *rationale = NULL;
+  const gchar *yaml_string = NULL;
+  GHashTableIter iter;
+  gpointer value;
+  gchar *first = NULL;
+  gchar *second = NULL;
+
+  /* Without a pool, every string is a separate allocation */
+  first = modulemd_string_intern ("MIT");
+  second = modulemd_string_intern ("MIT");
+  g_assert_true (first != second);
+  g_clear_pointer (&first, g_ref_string_release);
+  g_clear_pointer (&second, g_ref_string_release);
+
+  strings = modulemd_string_pool_new ();
+  g_assert_null (modulemd_string_pool_set_thread_default (strings));
+
+  first = modulemd_string_intern ("MIT");
+  second = modulemd_string_intern ("MIT");
+  g_assert_true (first == second);
+
+  g_assert_true (modulemd_string_pool_set_thread_default (NULL) == strings);
+
+  /* The strings remain valid for as long as they are referenced */
+  g_clear_pointer (&strings, modulemd_string_pool_free);
+  g_assert_cmpstr (first, ==, "MIT");
+  g_clear_pointer (&first, g_ref_string_release);
+  g_clear_pointer (&second, g_ref_string_release);
+
+  /* Values repeated throughout an index are shared */
+  yaml_string =
+    "---\n"
+    "document: modulemd\n"
+    "version: 2\n"
+    "data:\n"
+    "  name: foo\n"
+    "  stream: a\n"
+    "  summary: Foo\n"
+    "  description: Foo\n"
+    "  license:\n"
+    "    module: [MIT]\n"
+    "  components:\n"
+    "    rpms:\n"
+    "      bar:\n"
+    "        rationale: Needed for foo\n"
+    "...\n"
+    "---\n"
+    "document: modulemd\n"
+    "version: 2\n"
+    "data:\n"
+    "  name: foo\n"
+    "  stream: b\n"
+    "  summary: Foo\n"
+    "  description: Foo\n"
+    "  license:\n"
+    "    module: [MIT]\n"
+    "  components:\n"
+    "    rpms:\n"
+    "      bar:\n"
+    "        rationale: Needed for foo\n"
+    "...\n";
+
+  module_index = parse_module_index_from_string (yaml_string, NULL, &error);
+  g_assert_nonnull (module_index);
+  g_assert_null (error);
+  g_assert_null (modulemd_string_pool_get_thread_default ());
+
+  module = g_hash_table_lookup (module_index, "foo");
+  g_assert_nonnull (module);
+
+  streams = modulemd_improvedmodule_get_streams (module);
+  g_assert_cmpuint (g_hash_table_size (streams), ==, 2);
+
+  g_hash_table_iter_init (&iter, streams);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+      component = g_hash_table_lookup (
+        modulemd_modulestream_peek_rpm_components (value), "bar");
+      g_assert_nonnull (component);
+      g_assert_cmpstr (
+        modulemd_component_peek_rationale (component), ==, "Needed for foo");
+
+      if (rationale == NULL)
+        rationale = modulemd_component_peek_rationale (component);
+      else
+        g_assert_true (rationale ==
+                       modulemd_component_peek_rationale (component));
+    }
+}
+
+
+/* Keys in the order that _parse_modulemd_data() used to compare them */
+static const gchar *key_lookup_names[] = { "name",
+                                           "stream",
+                                           "version",
+                                           "context",
+                                           "arch",
+                                           "summary",
+                                           "description",
+                                           "eol",
+                                           "servicelevels",
+                                           "license",
+                                           "xmd",
+                                           "dependencies",
+                                           "references",
+                                           "profiles",
+                                           "api",
+                                           "filter",
+                                           "buildopts",
+                                           "components",
+                                           "artifacts",
+                                           NULL };
+
+
+static gint
+key_lookup_strcmp_chain (const gchar *key)
+{
+  for (gint i = 0; key_lookup_names[i]; i++)
+    {
+      if (!g_strcmp0 (key, key_lookup_names[i]))
+        return i;
+    }
+  return -1;
+}
+
+
+static void
+modulemd_yaml_test_key_lookup (YamlFixture *fixture, gconstpointer user_data)
+{
+  const gchar *unknown[] = { "",
+                             "nam",
+                             "names",
+                             "Name",
+                             "modulemd-default",
+                             "modulemd-translation",
+                             "repositories",
+                             "buildrequire",
+                             NULL };
+  g_autoptr (GTimer) timer = NULL;
+  gsize lengths[G_N_ELEMENTS (key_lookup_names)];
+  guint64 sum = 0;
+  gdouble lookup_time, chain_time;
+  gsize n_keys = G_N_ELEMENTS (key_lookup_names) - 1;
+  guint iterations = 200000;
+
+  g_assert_cmpint (mmd_yaml_key_lookup ("name", 4), ==, MMD_YAML_KEY_NAME);
+  g_assert_cmpint (
+    mmd_yaml_key_lookup ("modulemd-translations", 21),
+    ==,
+    MMD_YAML_KEY_MODULEMD_TRANSLATIONS);
+  g_assert_cmpint (
+    mmd_yaml_key_lookup ("buildrequires", 13), ==, MMD_YAML_KEY_BUILDREQUIRES);
+  g_assert_cmpint (
+    mmd_yaml_key_lookup ("requires", 8), ==, MMD_YAML_KEY_REQUIRES);
+  g_assert_cmpint (mmd_yaml_key_lookup (NULL, 0), ==, MMD_YAML_KEY_UNKNOWN);
+
+  for (gsize i = 0; unknown[i]; i++)
+    {
+      g_assert_cmpint (mmd_yaml_key_lookup (unknown[i], strlen (unknown[i])),
+                       ==,
+                       MMD_YAML_KEY_UNKNOWN);
+    }
+
+  /* Every key must resolve to something, and no two to the same thing */
+  for (gsize i = 0; i < n_keys; i++)
+    {
+      lengths[i] = strlen (key_lookup_names[i]);
+      g_assert_cmpint (
+        mmd_yaml_key_lookup (key_lookup_names[i], lengths[i]),
+        !=,
+        MMD_YAML_KEY_UNKNOWN);
+
+      for (gsize j = 0; j < i; j++)
+        {
+          g_assert_cmpint (
+            mmd_yaml_key_lookup (key_lookup_names[i], lengths[i]),
+            !=,
+            mmd_yaml_key_lookup (key_lookup_names[j], lengths[j]));
+        }
+    }
+
+  /* Run with -m perf to compare the per-key cost against a g_strcmp0()
+   * chain over the same keys
+   */
+  if (!g_test_perf ())
+    return;
+
+  timer = g_timer_new ();
+  for (guint n = 0; n < iterations; n++)
+    {
+      for (gsize i = 0; i < n_keys; i++)
+        sum += mmd_yaml_key_lookup (key_lookup_names[i], lengths[i]);
+    }
+  lookup_time = g_timer_elapsed (timer, NULL);
+
+  g_timer_start (timer);
+  for (guint n = 0; n < iterations; n++)
+    {
+      for (gsize i = 0; i < n_keys; i++)
+        sum += key_lookup_strcmp_chain (key_lookup_names[i]);
+    }
+  chain_time = g_timer_elapsed (timer, NULL);
+
+  g_test_message ("Checksum: %" G_GUINT64_FORMAT, sum);
+  g_test_minimized_result (lookup_time * 1e9 / (iterations * n_keys),
+                           "Key lookup: %.1f ns/key",
+                           lookup_time * 1e9 / (iterations * n_keys));
+  g_test_minimized_result (chain_time * 1e9 / (iterations * n_keys),
+                           "g_strcmp0 chain: %.1f ns/key",
+                           chain_time * 1e9 / (iterations * n_keys));
+}
+
+
+static guint
+count_cache_files (const gchar *path)
+{
+  g_autoptr (GDir) dir = NULL;
+  guint count = 0;
+
+  dir = g_dir_open (path, 0, NULL);
+  if (!dir)
+    return 0;
+
+  while (g_dir_read_name (dir))
+    count++;
+
+  return count;
+}
+
+
+static gchar *
+dump_index_from_file (const gchar *path)
+{
+  g_autoptr (GHashTable) index = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GError) error = NULL;
+  gchar *yaml = NULL;
+
+  index = modulemd_index_from_file (path, &failures, &error);
+  g_assert_nonnull (index);
+  g_assert_null (error);
+  g_assert_cmpuint (failures->len, ==, 0);
+
+  yaml = modulemd_dumps_index (index, &error);
+  g_assert_nonnull (yaml);
+  g_assert_null (error);
+
+  return yaml;
+}
+
+
+static void
+modulemd_yaml_test_parse_cache (YamlFixture *fixture, gconstpointer user_data)
+{
+  g_autofree gchar *tmp_dir = NULL;
+  g_autofree gchar *cache_dir = NULL;
+  g_autofree gchar *yaml_path = NULL;
+  g_autofree gchar *other_path = NULL;
+  g_autofree gchar *mixed_path = NULL;
+  g_autofree gchar *copy_path = NULL;
+  g_autofree gchar *contents = NULL;
+  g_autofree gchar *expected = NULL;
+  g_autofree gchar *other_expected = NULL;
+  g_autofree gchar *cached = NULL;
+  g_autofree gchar *dir = NULL;
+  g_autoptr (GPtrArray) objects = NULL;
+  g_autoptr (GPtrArray) cached_objects = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GHashTable) index = NULL;
+  g_autoptr (GDir) cache = NULL;
+  g_autoptr (GError) error = NULL;
+  const gchar *name = NULL;
+  gsize length = 0;
+
+  yaml_path = g_strdup_printf ("%s/test_data/long-valid.yaml",
+                               g_getenv ("MESON_SOURCE_ROOT"));
+  other_path = g_strdup_printf ("%s/test_data/translations.yaml",
+                                g_getenv ("MESON_SOURCE_ROOT"));
+  mixed_path = g_strdup_printf ("%s/test_data/mixed-v2.yaml",
+                                g_getenv ("MESON_SOURCE_ROOT"));
+
+  g_assert_null (modulemd_get_cache_dir ());
+  expected = dump_index_from_file (yaml_path);
+  other_expected = dump_index_from_file (other_path);
+  objects = modulemd_objects_from_file_ext (yaml_path, NULL, &error);
+  g_assert_nonnull (objects);
+
+  tmp_dir = g_dir_make_tmp ("modulemd-cache-XXXXXX", &error);
+  g_assert_nonnull (tmp_dir);
+  cache_dir = g_build_filename (tmp_dir, "cache", NULL);
+  copy_path = g_build_filename (tmp_dir, "modules.yaml", NULL);
+
+  g_assert_true (g_file_get_contents (yaml_path, &contents, &length, NULL));
+  g_assert_true (g_file_set_contents (copy_path, contents, length, NULL));
+  g_clear_pointer (&contents, g_free);
+
+  modulemd_set_cache_dir (cache_dir);
+  dir = modulemd_get_cache_dir ();
+  g_assert_cmpstr (dir, ==, cache_dir);
+
+  /* The first parse fills the cache and the second one is answered from it */
+  cached = dump_index_from_file (copy_path);
+  g_assert_cmpstr (cached, ==, expected);
+  g_assert_cmpuint (count_cache_files (cache_dir), ==, 1);
+  g_clear_pointer (&cached, g_free);
+
+  cached = dump_index_from_file (copy_path);
+  g_assert_cmpstr (cached, ==, expected);
+  g_assert_cmpuint (count_cache_files (cache_dir), ==, 1);
+  g_clear_pointer (&cached, g_free);
+
+  cached_objects =
+    modulemd_objects_from_file_ext (copy_path, &failures, &error);
+  g_assert_nonnull (cached_objects);
+  g_assert_null (error);
+  g_assert_cmpuint (failures->len, ==, 0);
+  g_assert_cmpuint (cached_objects->len, ==, objects->len);
+  for (gsize i = 0; i < objects->len; i++)
+    {
+      g_assert_true (G_OBJECT_TYPE (g_ptr_array_index (cached_objects, i)) ==
+                     G_OBJECT_TYPE (g_ptr_array_index (objects, i)));
+    }
+
+  /* Replacing the file must invalidate the cached parse */
+  g_assert_true (g_file_get_contents (other_path, &contents, &length, NULL));
+  g_assert_true (g_file_set_contents (copy_path, contents, length, NULL));
+
+  cached = dump_index_from_file (copy_path);
+  g_assert_cmpstr (cached, ==, other_expected);
+  g_assert_cmpuint (count_cache_files (cache_dir), ==, 1);
+  g_clear_pointer (&cached, g_free);
+
+  /* Files with failed subdocuments are never cached */
+  g_clear_pointer (&failures, g_ptr_array_unref);
+  index = modulemd_index_from_file (mixed_path, &failures, &error);
+  g_assert_nonnull (failures);
+  g_assert_cmpuint (failures->len, >, 0);
+  g_assert_cmpuint (count_cache_files (cache_dir), ==, 1);
+
+  modulemd_set_cache_dir (NULL);
+  g_assert_null (modulemd_get_cache_dir ());
+
+  cache = g_dir_open (cache_dir, 0, NULL);
+  g_assert_nonnull (cache);
+  while ((name = g_dir_read_name (cache)))
+    {
+      g_clear_pointer (&dir, g_free);
+      dir = g_build_filename (cache_dir, name, NULL);
+      g_assert_cmpint (g_unlink (dir), ==, 0);
+    }
+  g_assert_cmpint (g_rmdir (cache_dir), ==, 0);
+  g_assert_cmpint (g_unlink (copy_path), ==, 0);
+  g_assert_cmpint (g_rmdir (tmp_dir), ==, 0);
+}
+
+
 int
 main (int argc, char *argv[])
 {
@@ -619,6 +1631,55 @@ main (int argc, char *argv[])
               modulemd_yaml_test_index_from_file,
               NULL);
 
+  g_test_add ("/modulemd/yaml/test_index_from_file_parallel",
+              YamlFixture,
+              NULL,
+              NULL,
+              modulemd_yaml_test_index_from_file_parallel,
+              NULL);
+
+  g_test_add ("/modulemd/yaml/test_split_documents",
+              YamlFixture,
+              NULL,
+              NULL,
+              modulemd_yaml_test_split_documents,
+              NULL);
+
+  g_test_add ("/modulemd/yaml/test_index_from_files",
+              YamlFixture,
+              NULL,
+              NULL,
+              modulemd_yaml_test_index_from_files,
+              NULL);
+
+  g_test_add ("/modulemd/yaml/test_parse_file_foreach",
+              YamlFixture,
+              NULL,
+              NULL,
+              modulemd_yaml_test_parse_file_foreach,
+              NULL);
+
+  g_test_add ("/modulemd/yaml/test_index_from_data",
+              YamlFixture,
+              NULL,
+              NULL,
+              modulemd_yaml_test_index_from_data,
+              NULL);
+
+  g_test_add ("/modulemd/yaml/test_index_stream_versions",
+              YamlFixture,
+              NULL,
+              NULL,
+              modulemd_yaml_test_index_stream_versions,
+              NULL);
+
+  g_test_add ("/modulemd/yaml/test_prune_versions",
+              YamlFixture,
+              NULL,
+              NULL,
+              modulemd_yaml_test_prune_versions,
+              NULL);
+
   g_test_add ("/modulemd/yaml/test_index_from_string",
               YamlFixture,
               NULL,
@@ -633,5 +1694,33 @@ main (int argc, char *argv[])
               modulemd_yaml_test_index_from_stream,
               NULL);
 
+  g_test_add ("/modulemd/yaml/test_index_async",
+              YamlFixture,
+              NULL,
+              NULL,
+              modulemd_yaml_test_index_async,
+              NULL);
+
+  g_test_add ("/modulemd/yaml/test_string_pool",
+              YamlFixture,
+              NULL,
+              NULL,
+              modulemd_yaml_test_string_pool,
+              NULL);
+
+  g_test_add ("/modulemd/yaml/test_key_lookup",
+              YamlFixture,
+              NULL,
+              NULL,
+              modulemd_yaml_test_key_lookup,
+              NULL);
+
+  g_test_add ("/modulemd/yaml/test_parse_cache",
+              YamlFixture,
+              NULL,
+              NULL,
+              modulemd_yaml_test_parse_cache,
+              NULL);
+
   return g_test_run ();
 }